@@ -0,0 +1,163 @@
+#include "EntropyCoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    int const NumSymbols = 256;
+    int const ProbabilityBits = 12;
+    uint32_t const ProbabilityScale = 1u << ProbabilityBits;
+    uint32_t const LowerBound = 1u << 23;   //lower bound of the normalized coder state
+
+    using Frequencies = std::array<uint32_t, NumSymbols>;
+
+    void writeVarint(std::string& target, uint64_t value)
+    {
+        while (value >= 0x80) {
+            target.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        target.push_back(static_cast<char>(value));
+    }
+
+    uint64_t readVarint(std::string const& source, size_t& position)
+    {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64 && position < source.size(); shift += 7) {
+            auto byte = static_cast<unsigned char>(source[position++]);
+            result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (0 == (byte & 0x80)) {
+                return result;
+            }
+        }
+        throw std::runtime_error("Corrupt entropy coded data.");
+    }
+
+    //scales the symbol counts such that they sum up to ProbabilityScale and each occurring symbol keeps a frequency
+    Frequencies calcFrequencies(std::string const& data)
+    {
+        std::array<uint64_t, NumSymbols> counts{};
+        for (auto const& symbol : data) {
+            ++counts[static_cast<unsigned char>(symbol)];
+        }
+        Frequencies result{};
+        uint32_t sum = 0;
+        for (int i = 0; i < NumSymbols; ++i) {
+            if (counts[i] > 0) {
+                result[i] = std::max(uint32_t(1), static_cast<uint32_t>(counts[i] * ProbabilityScale / data.size()));
+                sum += result[i];
+            }
+        }
+        while (sum != ProbabilityScale) {
+            if (sum < ProbabilityScale) {
+                auto maxSymbol = std::max_element(result.begin(), result.end()) - result.begin();
+                result[maxSymbol] += ProbabilityScale - sum;
+                sum = ProbabilityScale;
+            } else {
+                auto maxSymbol = std::max_element(result.begin(), result.end()) - result.begin();
+                auto decrement = std::min(sum - ProbabilityScale, result[maxSymbol] - 1);
+                if (0 == decrement) {
+                    throw std::runtime_error("Entropy coder frequencies could not be normalized.");
+                }
+                result[maxSymbol] -= decrement;
+                sum -= decrement;
+            }
+        }
+        return result;
+    }
+
+    Frequencies calcCumulativeFrequencies(Frequencies const& frequencies)
+    {
+        Frequencies result{};
+        for (int i = 1; i < NumSymbols; ++i) {
+            result[i] = result[i - 1] + frequencies[i - 1];
+        }
+        return result;
+    }
+}
+
+std::string EntropyCoder::encode(std::string const& data)
+{
+    std::string result;
+    writeVarint(result, data.size());
+    if (data.empty()) {
+        return result;
+    }
+
+    auto frequencies = calcFrequencies(data);
+    auto cumulativeFrequencies = calcCumulativeFrequencies(frequencies);
+    for (auto const& frequency : frequencies) {
+        writeVarint(result, frequency);
+    }
+
+    //symbols are encoded in reverse order such that they can be decoded in forward order
+    std::vector<char> reversedOutput;
+    reversedOutput.reserve(data.size() + 4);
+    uint32_t state = LowerBound;
+    for (auto it = data.rbegin(); it != data.rend(); ++it) {
+        auto symbol = static_cast<unsigned char>(*it);
+        auto frequency = frequencies[symbol];
+        auto maxState = ((LowerBound >> ProbabilityBits) << 8) * frequency;
+        while (state >= maxState) {
+            reversedOutput.emplace_back(static_cast<char>(state & 0xff));
+            state >>= 8;
+        }
+        state = ((state / frequency) << ProbabilityBits) + (state % frequency) + cumulativeFrequencies[symbol];
+    }
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        reversedOutput.emplace_back(static_cast<char>((state >> shift) & 0xff));
+    }
+    result.append(reversedOutput.rbegin(), reversedOutput.rend());
+    return result;
+}
+
+std::string EntropyCoder::decode(std::string const& encodedData)
+{
+    size_t position = 0;
+    auto size = readVarint(encodedData, position);
+    if (0 == size) {
+        return {};
+    }
+
+    Frequencies frequencies{};
+    uint32_t sum = 0;
+    for (auto& frequency : frequencies) {
+        frequency = static_cast<uint32_t>(readVarint(encodedData, position));
+        sum += frequency;
+    }
+    if (sum != ProbabilityScale) {
+        throw std::runtime_error("Corrupt entropy coded data.");
+    }
+    auto cumulativeFrequencies = calcCumulativeFrequencies(frequencies);
+    std::vector<unsigned char> symbolBySlot(ProbabilityScale);
+    for (int i = 0; i < NumSymbols; ++i) {
+        std::fill_n(symbolBySlot.begin() + cumulativeFrequencies[i], frequencies[i], static_cast<unsigned char>(i));
+    }
+
+    auto readByte = [&] {
+        if (position >= encodedData.size()) {
+            throw std::runtime_error("Corrupt entropy coded data.");
+        }
+        return static_cast<uint32_t>(static_cast<unsigned char>(encodedData[position++]));
+    };
+    uint32_t state = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        state |= readByte() << shift;
+    }
+
+    std::string result(size, 0);
+    for (auto& symbol : result) {
+        auto slot = state & (ProbabilityScale - 1);
+        auto decodedSymbol = symbolBySlot[slot];
+        symbol = static_cast<char>(decodedSymbol);
+        state = frequencies[decodedSymbol] * (state >> ProbabilityBits) + slot - cumulativeFrequencies[decodedSymbol];
+        while (state < LowerBound) {
+            state = (state << 8) | readByte();
+        }
+    }
+    return result;
+}
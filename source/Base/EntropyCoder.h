@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+
+#include "DllExport.h"
+
+/**
+ * Order-0 entropy coder for byte streams based on range asymmetric numeral systems. The symbol statistics are
+ * stored along with the coded data, hence it is only worthwhile for streams of at least a few kilobytes.
+ */
+class EntropyCoder
+{
+public:
+    BASE_EXPORT static std::string encode(std::string const& data);
+    BASE_EXPORT static std::string decode(std::string const& encodedData);
+};
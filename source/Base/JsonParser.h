@@ -1,5 +1,10 @@
 #pragma once
 
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <type_traits>
+
 #include <boost/property_tree/ptree.hpp>
 
 #include "Definitions.h"
@@ -8,7 +13,8 @@
 enum class ParserTask
 {
     Encode,
-    Decode
+    Decode,
+    EncodeTypes     //encodes the type names "bool", "integer", "float" or "string" instead of the values
 };
 
 class JsonParser
@@ -21,6 +27,14 @@ public:
         T const& defaultValue,
         std::string const& node,
         ParserTask task);
+
+    //shortest representation which is decoded to the same value
+    template <typename T>
+    static std::string toString(T value);
+
+private:
+    template <typename T>
+    static char const* getTypeName();
 };
 
 /**
@@ -39,10 +53,50 @@ void JsonParser::encodeDecode(
             tree.put(node, parameter ? "true" : "false");
         } else if constexpr (std::is_same<T, std::string>::value) {
             tree.put(node, parameter);
+        } else if constexpr (std::is_floating_point<T>::value) {
+            tree.put(node, toString(parameter));
         } else {
             tree.put(node, std::to_string(parameter));
         }
+    } else if (ParserTask::EncodeTypes == task) {
+        tree.put(node, getTypeName<T>());
     } else {
         parameter = tree.get<T>(node, defaultValue);
     }
 }
+
+template <typename T>
+std::string JsonParser::toString(T value)
+{
+    std::string result;
+    for (int precision = std::numeric_limits<T>::digits10; precision <= std::numeric_limits<T>::max_digits10;
+         ++precision) {
+        std::ostringstream stream;
+        stream.imbue(std::locale::classic());
+        stream.precision(precision);
+        stream << value;
+        result = stream.str();
+
+        std::istringstream decodeStream(result);
+        decodeStream.imbue(std::locale::classic());
+        T decodedValue;
+        if (decodeStream >> decodedValue && decodedValue == value) {
+            break;
+        }
+    }
+    return result;
+}
+
+template <typename T>
+char const* JsonParser::getTypeName()
+{
+    if constexpr (std::is_same<T, bool>::value) {
+        return "bool";
+    } else if constexpr (std::is_integral<T>::value) {
+        return "integer";
+    } else if constexpr (std::is_floating_point<T>::value) {
+        return "float";
+    } else {
+        return "string";
+    }
+}
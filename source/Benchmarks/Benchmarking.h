@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/**
+ * Minimal timing helpers for the benchmark executables. They are not registered as tests since their results depend
+ * on the machine.
+ */
+namespace Benchmarking
+{
+    //repeats the function until minSeconds have passed and returns the average duration of one call in seconds
+    template <typename Function>
+    double measure(Function const& function, double minSeconds = 1.0)
+    {
+        function();     //warm-up
+
+        int numRepetitions = 0;
+        auto startTime = std::chrono::steady_clock::now();
+        double elapsedSeconds = 0;
+        do {
+            function();
+            ++numRepetitions;
+            elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        } while (elapsedSeconds < minSeconds);
+        return elapsedSeconds / numRepetitions;
+    }
+
+    inline void report(std::string const& name, double seconds, double numItems, std::string const& itemName)
+    {
+        std::cout << std::left << std::setw(48) << name << std::right << std::setw(12) << std::fixed
+                  << std::setprecision(3) << seconds * 1000 << " ms" << std::setw(16) << std::setprecision(0)
+                  << numItems / seconds << " " << itemName << "/s" << std::endl;
+    }
+}
@@ -0,0 +1,104 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "EngineInterface/ElementaryTypes.h"
+#include "EngineImpl/CellComputerBatchInterpreter.h"
+
+#include "Benchmarking.h"
+
+namespace
+{
+    CellComputerInstructionSet::Type const AllInstructionSets[] = {
+        CellComputerInstructionSet::Scalar, CellComputerInstructionSet::Avx2, CellComputerInstructionSet::Avx512};
+
+    //mix of arithmetic and conditional blocks with operands in the token memory
+    std::string createRandomCode(std::mt19937& generator, int numInstructions, bool indirectAddressing)
+    {
+        std::uniform_int_distribution<int> operationDistribution(0, 15);
+        std::uniform_int_distribution<int> opTypeDistribution(0, 3);
+        std::uniform_int_distribution<int> byteDistribution(0, 255);
+        std::string result;
+        for (int i = 0; i < numInstructions; ++i) {
+            auto operation = operationDistribution(generator);
+            auto opType1 = opTypeDistribution(generator);
+            auto opType2 = opTypeDistribution(generator);
+            if (!indirectAddressing) {
+                opType1 = opType1 == Enums::ComputerOptype::MEMMEM ? Enums::ComputerOptype::MEM : opType1;
+                opType2 = opType2 == Enums::ComputerOptype::MEMMEM ? Enums::ComputerOptype::MEM : opType2;
+            }
+            result.push_back(static_cast<char>((operation << 4) | (opType1 << 2) | opType2));
+            result.push_back(static_cast<char>(byteDistribution(generator)));
+            result.push_back(static_cast<char>(byteDistribution(generator)));
+        }
+        return result;
+    }
+
+    std::vector<CellComputerComputation> createComputations(
+        std::mt19937& generator,
+        int numPrograms,
+        int numTokensPerProgram,
+        int tokenMemorySize,
+        bool indirectAddressing)
+    {
+        std::uniform_int_distribution<int> byteDistribution(0, 255);
+        std::vector<CellComputerComputation> result;
+        for (int program = 0; program < numPrograms; ++program) {
+            auto code = createRandomCode(generator, 15, indirectAddressing);
+            for (int token = 0; token < numTokensPerProgram; ++token) {
+                std::string tokenMemory(tokenMemorySize, 0);
+                for (auto& byte : tokenMemory) {
+                    byte = static_cast<char>(byteDistribution(generator));
+                }
+                result.emplace_back(CellComputerComputation{code, tokenMemory, std::string(8, 0)});
+            }
+        }
+        return result;
+    }
+
+    char const* getName(CellComputerInstructionSet::Type instructionSet)
+    {
+        switch (instructionSet) {
+        case CellComputerInstructionSet::Avx2:
+            return "AVX2";
+        case CellComputerInstructionSet::Avx512:
+            return "AVX-512";
+        default:
+            return "scalar";
+        }
+    }
+}
+
+int main()
+{
+    SimulationParameters parameters;
+    std::mt19937 generator(1);
+
+    //few programs executed by many tokens correspond to replicators, many distinct programs to a random world
+    std::pair<int, int> const programsAndTokens[] = {{16, 4096}, {1024, 64}, {16384, 4}};
+    for (auto indirectAddressing : {false, true}) {
+        for (auto [numPrograms, numTokensPerProgram] : programsAndTokens) {
+            auto computations = createComputations(
+                generator, numPrograms, numTokensPerProgram, parameters.tokenMemorySize, indirectAddressing);
+            auto numTokens = static_cast<double>(computations.size());
+            std::cout << numPrograms << " programs " << (indirectAddressing ? "with" : "without")
+                      << " indirect addressing and " << numTokensPerProgram << " tokens each" << std::endl;
+
+            CellComputerBatchInterpreter reference(parameters, CellComputerInstructionSet::Scalar);
+            //the memories are not reset between the repetitions since the throughput does not depend on their content
+            auto seconds = Benchmarking::measure([&] { reference.processSequentially(computations); });
+            Benchmarking::report("  sequential", seconds, numTokens, "tokens");
+
+            for (auto instructionSet : AllInstructionSets) {
+                if (!CellComputerBatchInterpreter::isSupported(instructionSet)) {
+                    std::cout << "  " << getName(instructionSet) << " not supported" << std::endl;
+                    continue;
+                }
+                CellComputerBatchInterpreter interpreter(parameters, instructionSet);
+                auto seconds = Benchmarking::measure([&] { interpreter.process(computations); });
+                Benchmarking::report(std::string("  batch ") + getName(instructionSet), seconds, numTokens, "tokens");
+            }
+        }
+    }
+    return 0;
+}
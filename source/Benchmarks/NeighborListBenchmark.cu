@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "EngineGpuKernels/NeighborList.cuh"
+
+#include "Benchmarking.h"
+
+namespace
+{
+    int const NumBlocks = 512;
+    int const NumThreadsPerBlock = 64;
+    int const NumRepetitions = 20;
+
+    __global__ void resetMap(CellMap map) { map.reset(); }
+
+    __global__ void cleanupMap(CellMap map) { map.cleanup_system(); }
+
+    __global__ void updateMap(CellMap map, Array<Cell*> cells)
+    {
+        auto const partition = calcPartition(cells.getNumEntries(), blockIdx.x, gridDim.x);
+        map.set_block(partition.numElements(), &cells.at(partition.startIndex));
+    }
+
+    __global__ void resetUpdateCheck(NeighborList neighborList) { neighborList.resetUpdateCheck(); }
+
+    __global__ void calcDisplacements(NeighborList neighborList, Array<Cell*> cells, CellMap map)
+    {
+        neighborList.calcDisplacements_system(cells, map);
+    }
+
+    __global__ void prepareBuild(NeighborList neighborList, Array<Cell> cells) { neighborList.prepareBuild(cells); }
+
+    __global__ void build(NeighborList neighborList, Array<Cell*> cells, CellMap map)
+    {
+        neighborList.build_system(cells, map);
+    }
+
+    __global__ void insertNewCells(NeighborList neighborList, Array<Cell*> cells, CellMap map)
+    {
+        neighborList.insertNewCells_system(cells, map);
+    }
+
+    __global__ void buildForNewCells(NeighborList neighborList, Array<Cell*> cells, CellMap map)
+    {
+        neighborList.buildForNewCells_system(cells, map);
+    }
+
+    __global__ void markAsNew(Array<Cell*> cells, int fromIndex)
+    {
+        auto const partition = calcAllThreadsPartition(cells.getNumEntries() - fromIndex);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            cells.at(fromIndex + index)->numNeighbors = NeighborListState::NotInserted;
+        }
+    }
+
+    void setCellPointers(CellMap& map, Array<Cell*>& cellPointers, int numCells)
+    {
+        cellPointers.setNumEntries_host(numCells);
+        cleanupMap<<<NumBlocks, NumThreadsPerBlock>>>(map);
+        resetMap<<<1, 1>>>(map);
+        updateMap<<<NumBlocks, NumThreadsPerBlock>>>(map, cellPointers);
+    }
+
+    //cells on a jittered grid with the density of cell clusters, the last numNewCells cells are created in the time
+    //step, the former implementation rebuilt all lists in this case
+    void runScenario(int2 const& worldSize, int numNewCells)
+    {
+        SimulationParameters parameters;
+        CHECK_FOR_CUDA_ERROR(cudaMemcpyToSymbol(cudaSimulationParameters, &parameters, sizeof(SimulationParameters)));
+
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> jitterDistribution(-0.3f, 0.3f);
+        auto numCells = worldSize.x * worldSize.y;
+        std::vector<int> cellIndices(numCells);
+        for (int i = 0; i < numCells; ++i) {
+            cellIndices[i] = i;
+        }
+        std::shuffle(cellIndices.begin(), cellIndices.end(), generator);
+        std::vector<Cell> cells(numCells);
+        for (int y = 0; y < worldSize.y; ++y) {
+            for (int x = 0; x < worldSize.x; ++x) {
+                cells[cellIndices[x + y * worldSize.x]].absPos = {
+                    static_cast<float>(x) + 0.5f + jitterDistribution(generator),
+                    static_cast<float>(y) + 0.5f + jitterDistribution(generator)};
+            }
+        }
+
+        Array<Cell> cellArray;
+        cellArray.init(numCells);
+        cellArray.setNumEntries_host(numCells);
+        CHECK_FOR_CUDA_ERROR(
+            cudaMemcpy(cellArray.getArray_host(), cells.data(), sizeof(Cell) * numCells, cudaMemcpyHostToDevice));
+        std::vector<Cell*> cellPointers(numCells);
+        for (int i = 0; i < numCells; ++i) {
+            cellPointers[i] = cellArray.getArray_host() + i;
+        }
+        Array<Cell*> cellPointerArray;
+        cellPointerArray.init(numCells);
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+            cellPointerArray.getArray_host(), cellPointers.data(), sizeof(Cell*) * numCells, cudaMemcpyHostToDevice));
+
+        CellMap map;
+        map.init(worldSize);
+        map.resize(numCells);
+        NeighborList neighborList;
+        neighborList.init();
+        neighborList.resize(numCells);
+
+        std::cout << worldSize.x << "x" << worldSize.y << ", " << numCells << " cells, " << numNewCells
+                  << " new cells per time step" << std::endl;
+
+        setCellPointers(map, cellPointerArray, numCells);
+        auto seconds = Benchmarking::measure([&] {
+            prepareBuild<<<1, 1>>>(neighborList, cellArray);
+            build<<<NumBlocks, NumThreadsPerBlock>>>(neighborList, cellPointerArray, map);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+        });
+        Benchmarking::report("  full rebuild (former update on new cells)", seconds, numCells, "cells");
+
+        seconds = Benchmarking::measure([&] {
+            resetUpdateCheck<<<1, 1>>>(neighborList);
+            calcDisplacements<<<NumBlocks, NumThreadsPerBlock>>>(neighborList, cellPointerArray, map);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+        });
+        Benchmarking::report("  update check", seconds, numCells, "cells");
+
+        //each repetition restores the lists without the new cells which is not measured
+        double totalSeconds = 0;
+        for (int i = 0; i < NumRepetitions; ++i) {
+            setCellPointers(map, cellPointerArray, numCells - numNewCells);
+            prepareBuild<<<1, 1>>>(neighborList, cellArray);
+            build<<<NumBlocks, NumThreadsPerBlock>>>(neighborList, cellPointerArray, map);
+            setCellPointers(map, cellPointerArray, numCells);
+            markAsNew<<<NumBlocks, NumThreadsPerBlock>>>(cellPointerArray, numCells - numNewCells);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+
+            auto startTime = std::chrono::steady_clock::now();
+            insertNewCells<<<NumBlocks, NumThreadsPerBlock>>>(neighborList, cellPointerArray, map);
+            buildForNewCells<<<NumBlocks, NumThreadsPerBlock>>>(neighborList, cellPointerArray, map);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+            totalSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        }
+        Benchmarking::report("  incremental insertion", totalSeconds / NumRepetitions, numNewCells, "new cells");
+
+        neighborList.free();
+        map.free();
+        cellArray.free();
+        cellPointerArray.free();
+    }
+}
+
+int main()
+{
+    runScenario({512, 512}, 250);
+    runScenario({512, 512}, 2500);
+    runScenario({1024, 1024}, 1000);
+    return 0;
+}
@@ -0,0 +1,209 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "EngineGpuKernels/SpatialIndex.cuh"
+
+#include "Benchmarking.h"
+
+namespace
+{
+    int const NumBlocks = 512;
+    int const NumThreadsPerBlock = 64;
+    int const TileSize = SPATIAL_INDEX_TILE_SIZE;
+    float const QuerySize = 100.0f;
+
+    __global__ void resetIndex(TileIndex<Cell> index) { index.reset_system(); }
+
+    __global__ void countCells(TileIndex<Cell> index, Array<Cell*> cells) { index.count_system(cells); }
+
+    __global__ void calcChunkSums(TileIndex<Cell> index) { index.calcChunkSums_system(); }
+
+    __global__ void reserveCells(TileIndex<Cell> index) { index.reserveEntities(); }
+
+    __global__ void calcTileStarts(TileIndex<Cell> index) { index.calcTileStarts_system(); }
+
+    __global__ void insertCells(TileIndex<Cell> index, Array<Cell*> cells) { index.insert_system(cells); }
+
+    //reference for the former build step in which one thread scanned all tiles
+    __global__ void scanTilesSerially(int* values, int* result, int numValues)
+    {
+        int sum = 0;
+        for (int i = 0; i < numValues; ++i) {
+            result[i] = sum;
+            sum += values[i];
+        }
+        result[numValues] = sum;
+    }
+
+    __global__ void countCellsByIndex(TileIndex<Cell> index, float2* queryPositions, int* result, int numQueries)
+    {
+        auto const partition = calcAllThreadsPartition(numQueries);
+        for (int queryIndex = partition.startIndex; queryIndex <= partition.endIndex; ++queryIndex) {
+            auto const& upperLeft = queryPositions[queryIndex];
+            float2 lowerRight{upperLeft.x + QuerySize, upperLeft.y + QuerySize};
+            auto const range = index.getTileRange(upperLeft, lowerRight);
+            int numCellsInRect = 0;
+            for (int slice = 0; slice < index.getNumSlices(range); ++slice) {
+                int numCells;
+                auto cells = index.getSlice(range, slice, numCells);
+                for (int i = 0; i < numCells; ++i) {
+                    if (isContainedInRect(upperLeft, lowerRight, cells[i]->absPos)) {
+                        ++numCellsInRect;
+                    }
+                }
+            }
+            result[queryIndex] = numCellsInRect;
+        }
+    }
+
+    __global__ void countCellsByScan(Array<Cell*> cells, float2* queryPositions, int* result, int numQueries)
+    {
+        auto const partition = calcAllThreadsPartition(numQueries);
+        for (int queryIndex = partition.startIndex; queryIndex <= partition.endIndex; ++queryIndex) {
+            auto const& upperLeft = queryPositions[queryIndex];
+            float2 lowerRight{upperLeft.x + QuerySize, upperLeft.y + QuerySize};
+            int numCellsInRect = 0;
+            for (int i = 0; i < cells.getNumEntries(); ++i) {
+                if (isContainedInRect(upperLeft, lowerRight, cells.at(i)->absPos)) {
+                    ++numCellsInRect;
+                }
+            }
+            result[queryIndex] = numCellsInRect;
+        }
+    }
+
+    //host implementation of the index build via a counting sort of the cell indices by tile
+    std::vector<int> buildIndexOnHost(std::vector<Cell> const& cells, int2 const& numTiles)
+    {
+        auto getTileIndex = [&](float2 const& pos) {
+            auto tileX = std::min(floorInt(pos.x) / TileSize, numTiles.x - 1);
+            auto tileY = std::min(floorInt(pos.y) / TileSize, numTiles.y - 1);
+            return tileX + tileY * numTiles.x;
+        };
+        std::vector<int> tileStarts(numTiles.x * numTiles.y + 1, 0);
+        for (auto const& cell : cells) {
+            ++tileStarts[getTileIndex(cell.absPos) + 1];
+        }
+        for (size_t tile = 1; tile < tileStarts.size(); ++tile) {
+            tileStarts[tile] += tileStarts[tile - 1];
+        }
+        std::vector<int> result(cells.size());
+        for (int index = 0; index < static_cast<int>(cells.size()); ++index) {
+            result[tileStarts[getTileIndex(cells[index].absPos)]++] = index;
+        }
+        return result;
+    }
+
+    void runScenario(int2 const& worldSize, int numCells, int numQueries)
+    {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> xDistribution(0, static_cast<float>(worldSize.x));
+        std::uniform_real_distribution<float> yDistribution(0, static_cast<float>(worldSize.y));
+        std::vector<Cell> cells(numCells);
+        for (auto& cell : cells) {
+            cell.absPos = {xDistribution(generator), yDistribution(generator)};
+        }
+        std::vector<float2> queryPositions(numQueries);
+        for (auto& queryPosition : queryPositions) {
+            queryPosition = {
+                xDistribution(generator) * (1.0f - QuerySize / static_cast<float>(worldSize.x)),
+                yDistribution(generator) * (1.0f - QuerySize / static_cast<float>(worldSize.y))};
+        }
+
+        Cell* cellsOnDevice;
+        CHECK_FOR_CUDA_ERROR(cudaMalloc(&cellsOnDevice, sizeof(Cell) * numCells));
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(cellsOnDevice, cells.data(), sizeof(Cell) * numCells, cudaMemcpyHostToDevice));
+        std::vector<Cell*> cellPointers(numCells);
+        for (int i = 0; i < numCells; ++i) {
+            cellPointers[i] = cellsOnDevice + i;
+        }
+        Array<Cell*> cellPointerArray;
+        cellPointerArray.init(numCells);
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+            cellPointerArray.getArray_host(), cellPointers.data(), sizeof(Cell*) * numCells, cudaMemcpyHostToDevice));
+        cellPointerArray.setNumEntries_host(numCells);
+
+        TileIndex<Cell> index;
+        index.init(worldSize, TileSize);
+        index.resize(numCells);
+
+        int2 const numTiles{(worldSize.x + TileSize - 1) / TileSize, (worldSize.y + TileSize - 1) / TileSize};
+        auto const totalNumTiles = numTiles.x * numTiles.y;
+        int* tileCounts;
+        int* tileStarts;
+        float2* queryPositionsOnDevice;
+        int* cellCountsByIndex;
+        int* cellCountsByScan;
+        CHECK_FOR_CUDA_ERROR(cudaMalloc(&tileCounts, sizeof(int) * totalNumTiles));
+        CHECK_FOR_CUDA_ERROR(cudaMalloc(&tileStarts, sizeof(int) * (totalNumTiles + 1)));
+        CHECK_FOR_CUDA_ERROR(cudaMemset(tileCounts, 0, sizeof(int) * totalNumTiles));
+        CHECK_FOR_CUDA_ERROR(cudaMalloc(&queryPositionsOnDevice, sizeof(float2) * numQueries));
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+            queryPositionsOnDevice, queryPositions.data(), sizeof(float2) * numQueries, cudaMemcpyHostToDevice));
+        CHECK_FOR_CUDA_ERROR(cudaMalloc(&cellCountsByIndex, sizeof(int) * numQueries));
+        CHECK_FOR_CUDA_ERROR(cudaMalloc(&cellCountsByScan, sizeof(int) * numQueries));
+
+        std::cout << worldSize.x << "x" << worldSize.y << ", " << numCells << " cells, " << totalNumTiles << " tiles, "
+                  << numQueries << " queries" << std::endl;
+
+        auto seconds = Benchmarking::measure([&] {
+            resetIndex<<<NumBlocks, NumThreadsPerBlock>>>(index);
+            countCells<<<NumBlocks, NumThreadsPerBlock>>>(index, cellPointerArray);
+            calcChunkSums<<<NumBlocks, NumThreadsPerBlock>>>(index);
+            reserveCells<<<1, 1>>>(index);
+            calcTileStarts<<<NumBlocks, NumThreadsPerBlock>>>(index);
+            insertCells<<<NumBlocks, NumThreadsPerBlock>>>(index, cellPointerArray);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+        });
+        Benchmarking::report("  index build", seconds, numCells, "cells");
+
+        seconds = Benchmarking::measure([&] {
+            scanTilesSerially<<<1, 1>>>(tileCounts, tileStarts, totalNumTiles);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+        });
+        Benchmarking::report("  serial tile scan (former build step)", seconds, totalNumTiles, "tiles");
+
+        seconds = Benchmarking::measure([&] { buildIndexOnHost(cells, numTiles); });
+        Benchmarking::report("  index build on host", seconds, numCells, "cells");
+
+        seconds = Benchmarking::measure([&] {
+            countCellsByIndex<<<NumBlocks, NumThreadsPerBlock>>>(
+                index, queryPositionsOnDevice, cellCountsByIndex, numQueries);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+        });
+        Benchmarking::report("  region queries by index", seconds, numQueries, "queries");
+
+        seconds = Benchmarking::measure([&] {
+            countCellsByScan<<<NumBlocks, NumThreadsPerBlock>>>(
+                cellPointerArray, queryPositionsOnDevice, cellCountsByScan, numQueries);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+        });
+        Benchmarking::report("  region queries by scan", seconds, numQueries, "queries");
+
+        std::vector<int> countsByIndex(numQueries);
+        std::vector<int> countsByScan(numQueries);
+        CHECK_FOR_CUDA_ERROR(
+            cudaMemcpy(countsByIndex.data(), cellCountsByIndex, sizeof(int) * numQueries, cudaMemcpyDeviceToHost));
+        CHECK_FOR_CUDA_ERROR(
+            cudaMemcpy(countsByScan.data(), cellCountsByScan, sizeof(int) * numQueries, cudaMemcpyDeviceToHost));
+        std::cout << "  results " << (countsByIndex == countsByScan ? "match" : "DIFFER") << std::endl;
+
+        index.free();
+        cellPointerArray.free();
+        CHECK_FOR_CUDA_ERROR(cudaFree(cellsOnDevice));
+        CHECK_FOR_CUDA_ERROR(cudaFree(tileCounts));
+        CHECK_FOR_CUDA_ERROR(cudaFree(tileStarts));
+        CHECK_FOR_CUDA_ERROR(cudaFree(queryPositionsOnDevice));
+        CHECK_FOR_CUDA_ERROR(cudaFree(cellCountsByIndex));
+        CHECK_FOR_CUDA_ERROR(cudaFree(cellCountsByScan));
+    }
+}
+
+int main()
+{
+    runScenario({2048, 1024}, 100000, 1000);
+    runScenario({8192, 8192}, 1000000, 1000);
+    runScenario({16384, 16384}, 2000000, 1000);
+    return 0;
+}
@@ -0,0 +1,451 @@
+#include "AlienCApi.h"
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <string>
+
+#include <boost/make_shared.hpp>
+
+#include "EngineGpuKernels/AccessTOs.cuh"
+#include "EngineImpl/AccessDataTOCache.h"
+#include "EngineImpl/CheckpointWriter.h"
+#include "EngineImpl/SimulationController.h"
+#include "EngineInterface/Parser.h"
+#include "EngineInterface/Serializer.h"
+#include "EngineInterface/SymbolMap.h"
+
+/**
+ * The views are reinterpretations of the transfer objects. Any change of the transfer objects has to be mirrored
+ * in AlienCApi.h.
+ */
+#define CHECK_MEMBER(CStruct, EngineStruct, cMember, engineMember) \
+    static_assert(offsetof(CStruct, cMember) == offsetof(EngineStruct, engineMember), "C API layout does not match engine")
+
+static_assert(ALIEN_MAX_CELL_BONDS == MAX_CELL_BONDS, "C API layout does not match engine");
+static_assert(ALIEN_MAX_CELL_STATIC_BYTES == MAX_CELL_STATIC_BYTES, "C API layout does not match engine");
+static_assert(ALIEN_MAX_CELL_MUTABLE_BYTES == MAX_CELL_MUTABLE_BYTES, "C API layout does not match engine");
+
+static_assert(sizeof(AlienFloat2) == sizeof(float2), "C API layout does not match engine");
+static_assert(sizeof(AlienCellConnection) == sizeof(CellConnectionTO), "C API layout does not match engine");
+static_assert(sizeof(AlienCellMetadata) == sizeof(CellMetadataAccessTO), "C API layout does not match engine");
+CHECK_MEMBER(AlienCellMetadata, CellMetadataAccessTO, sourceCodeStringIndex, sourceCodeStringIndex);
+
+static_assert(sizeof(AlienCell) == sizeof(CellAccessTO), "C API layout does not match engine");
+CHECK_MEMBER(AlienCell, CellAccessTO, pos, pos);
+CHECK_MEMBER(AlienCell, CellAccessTO, vel, vel);
+CHECK_MEMBER(AlienCell, CellAccessTO, energy, energy);
+CHECK_MEMBER(AlienCell, CellAccessTO, tokenBlocked, tokenBlocked);
+CHECK_MEMBER(AlienCell, CellAccessTO, connections, connections);
+CHECK_MEMBER(AlienCell, CellAccessTO, cellFunctionType, cellFunctionType);
+CHECK_MEMBER(AlienCell, CellAccessTO, staticData, staticData);
+CHECK_MEMBER(AlienCell, CellAccessTO, mutableData, mutableData);
+CHECK_MEMBER(AlienCell, CellAccessTO, tokenUsages, tokenUsages);
+CHECK_MEMBER(AlienCell, CellAccessTO, metadata, metadata);
+CHECK_MEMBER(AlienCell, CellAccessTO, selected, selected);
+
+static_assert(sizeof(AlienParticle) == sizeof(ParticleAccessTO), "C API layout does not match engine");
+CHECK_MEMBER(AlienParticle, ParticleAccessTO, energy, energy);
+CHECK_MEMBER(AlienParticle, ParticleAccessTO, pos, pos);
+CHECK_MEMBER(AlienParticle, ParticleAccessTO, vel, vel);
+CHECK_MEMBER(AlienParticle, ParticleAccessTO, color, metadata);
+CHECK_MEMBER(AlienParticle, ParticleAccessTO, selected, selected);
+
+static_assert(sizeof(AlienToken) == sizeof(TokenAccessTO), "C API layout does not match engine");
+CHECK_MEMBER(AlienToken, TokenAccessTO, cellIndex, cellIndex);
+
+struct AlienSimulation
+{
+    SimulationController controller;
+    CheckpointWriter checkpointWriter;  //for the file of the last checkpoint
+};
+
+struct AlienSnapshot
+{
+    AccessDataTOCache cache;
+    DataAccessTO dataTO;
+    uint64_t timestep;
+    IntVector2D worldSize;
+};
+
+namespace
+{
+    thread_local std::string lastError;
+
+    std::string const SimulationParametersKey = "simulation parameters.";
+
+    //largest integer up to which doubles represent all integers
+    double const MaxExactInteger = 9007199254740992.0;
+
+    //exceptions must not pass the C interface
+    template <typename Func>
+    AlienResult guarded(Func const& func)
+    {
+        try {
+            lastError.clear();
+            return func();
+        } catch (std::exception const& exception) {
+            lastError = exception.what();
+        } catch (...) {
+            lastError = "Unknown error.";
+        }
+        return ALIEN_ERROR_ENGINE;
+    }
+
+    AlienResult fail(AlienResult result, std::string const& message)
+    {
+        lastError = message;
+        return result;
+    }
+
+    AlienSimulation* startSimulation(uint64_t timestep, Settings const& settings, SymbolMap const& symbolMap)
+    {
+        auto result = new AlienSimulation{boost::make_shared<_SimulationController>()};
+        try {
+            result->controller->initCuda();
+            result->controller->newSimulation(timestep, settings, symbolMap);
+        } catch (...) {
+            delete result;
+            throw;
+        }
+        return result;
+    }
+
+    AlienSimulation* startSimulation(DeserializedSimulation const& deserializedData)
+    {
+        auto result = startSimulation(deserializedData.timestep, deserializedData.settings, deserializedData.symbolMap);
+        try {
+            result->controller->setSimulationData(deserializedData.content);
+        } catch (...) {
+            alien_destroy_simulation(result);
+            throw;
+        }
+        return result;
+    }
+}
+
+char const* alien_get_last_error(void)
+{
+    return lastError.c_str();
+}
+
+AlienResult alien_create_simulation(int32_t worldSizeX, int32_t worldSizeY, AlienSimulation** result)
+{
+    return guarded([&] {
+        if (!result || worldSizeX <= 0 || worldSizeY <= 0) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid world size.");
+        }
+        Settings settings;
+        settings.generalSettings.worldSizeX = worldSizeX;
+        settings.generalSettings.worldSizeY = worldSizeY;
+        settings.flowFieldSettings.centers[0].posX = toFloat(worldSizeX) / 2;
+        settings.flowFieldSettings.centers[0].posY = toFloat(worldSizeY) / 2;
+
+        *result = startSimulation(0, settings, SymbolMap());
+        return ALIEN_OK;
+    });
+}
+
+AlienResult alien_load_simulation(char const* filename, AlienSimulation** result)
+{
+    return guarded([&] {
+        if (!filename || !result) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid argument.");
+        }
+        Serializer serializer = boost::make_shared<_Serializer>();
+        DeserializedSimulation deserializedData;
+        if (!serializer->deserializeSimulationFromFile(filename, deserializedData)) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, std::string("Could not load ") + filename + ".");
+        }
+        *result = startSimulation(deserializedData);
+        return ALIEN_OK;
+    });
+}
+
+AlienResult alien_save_simulation(AlienSimulation* simulation, char const* filename)
+{
+    return guarded([&] {
+        if (!simulation || !filename) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid argument.");
+        }
+        auto const& controller = simulation->controller;
+        DeserializedSimulation sim;
+        sim.timestep = controller->getCurrentTimestep();
+        sim.settings = controller->getSettings();
+        sim.symbolMap = controller->getSymbolMap();
+        sim.content = controller->getSimulationData({0, 0}, controller->getWorldSize());
+
+        Serializer serializer = boost::make_shared<_Serializer>();
+        if (!serializer->serializeSimulationToFile(filename, sim)) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, std::string("Could not save ") + filename + ".");
+        }
+        return ALIEN_OK;
+    });
+}
+
+void alien_destroy_simulation(AlienSimulation* simulation)
+{
+    if (!simulation) {
+        return;
+    }
+    guarded([&] {
+        simulation->controller->closeSimulation();
+        return ALIEN_OK;
+    });
+    delete simulation;
+}
+
+AlienResult alien_write_checkpoint(AlienSimulation* simulation, char const* filename)
+{
+    return guarded([&] {
+        if (!simulation || !filename) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid argument.");
+        }
+        auto& writer = simulation->checkpointWriter;
+        if (!writer || writer->getSettings().filename != filename) {
+            CheckpointSettings settings;
+            settings.filename = filename;
+            writer = boost::make_shared<_CheckpointWriter>(simulation->controller, settings);
+        }
+        writer->writeCheckpoint();
+        return ALIEN_OK;
+    });
+}
+
+AlienResult alien_load_checkpoint(char const* filename, AlienSimulation** result)
+{
+    return guarded([&] {
+        if (!filename || !result) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid argument.");
+        }
+        Serializer serializer = boost::make_shared<_Serializer>();
+        DeserializedSimulation deserializedData;
+        if (!serializer->deserializeCheckpointFromFiles(
+                filename, _CheckpointWriter::getJournalFilename(filename), deserializedData)) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, std::string("Could not load ") + filename + ".");
+        }
+        *result = startSimulation(deserializedData);
+        return ALIEN_OK;
+    });
+}
+
+AlienResult
+alien_resize_world(AlienSimulation* simulation, int32_t worldSizeX, int32_t worldSizeY, AlienResizeMode mode)
+{
+    return guarded([&] {
+        if (!simulation || worldSizeX < 1 || worldSizeY < 1
+            || (mode != ALIEN_RESIZE_REMAP && mode != ALIEN_RESIZE_TILE)) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid argument.");
+        }
+        simulation->controller->resizeWorld(
+            {worldSizeX, worldSizeY}, ALIEN_RESIZE_TILE == mode ? WorldResizeMode::Tile : WorldResizeMode::Remap);
+        return ALIEN_OK;
+    });
+}
+
+AlienResult alien_calc_timesteps(AlienSimulation* simulation, int32_t numTimesteps)
+{
+    return guarded([&] {
+        if (!simulation || numTimesteps < 0) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid argument.");
+        }
+        for (int i = 0; i < numTimesteps; ++i) {
+            simulation->controller->calcSingleTimestep();
+        }
+        return ALIEN_OK;
+    });
+}
+
+AlienResult alien_get_timestep(AlienSimulation* simulation, uint64_t* result)
+{
+    return guarded([&] {
+        if (!simulation || !result) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid argument.");
+        }
+        *result = simulation->controller->getCurrentTimestep();
+        return ALIEN_OK;
+    });
+}
+
+AlienResult alien_get_parameter(AlienSimulation* simulation, char const* key, double* result)
+{
+    return guarded([&] {
+        if (!simulation || !key || !result) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid argument.");
+        }
+        auto const& controller = simulation->controller;
+        auto tree = Parser::encode(controller->getCurrentTimestep(), controller->getSettings());
+        auto value = tree.get_optional<std::string>(key);
+        auto type = Parser::encodeTypes().get_optional<std::string>(key);
+        if (!value || !type) {
+            return fail(ALIEN_ERROR_UNKNOWN_PARAMETER, std::string("Unknown parameter ") + key + ".");
+        }
+        if (*type == "bool") {
+            *result = *value == "true" ? 1.0 : 0.0;
+        } else if (*type == "integer" || *type == "float") {
+            *result = tree.get<double>(key);
+        } else {
+            return fail(ALIEN_ERROR_UNKNOWN_PARAMETER, std::string("Parameter ") + key + " is not numeric.");
+        }
+        return ALIEN_OK;
+    });
+}
+
+AlienResult alien_set_parameter(AlienSimulation* simulation, char const* key, double value)
+{
+    return guarded([&] {
+        if (!simulation || !key) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid argument.");
+        }
+        auto const& controller = simulation->controller;
+        auto tree = Parser::encode(controller->getCurrentTimestep(), controller->getSettings());
+        auto type = Parser::encodeTypes().get_optional<std::string>(key);
+        if (!type || std::string(key).rfind(SimulationParametersKey, 0) != 0) {
+            return fail(ALIEN_ERROR_UNKNOWN_PARAMETER, std::string("Unknown parameter ") + key + ".");
+        }
+
+        std::string encodedValue;
+        if (*type == "bool") {
+            encodedValue = value != 0 ? "true" : "false";
+        } else if (*type == "integer") {
+            if (value != std::floor(value) || std::fabs(value) > MaxExactInteger) {
+                return fail(ALIEN_ERROR_INVALID_ARGUMENT, std::string("Parameter ") + key + " is an integer.");
+            }
+            encodedValue = std::to_string(static_cast<int64_t>(value));
+        } else if (*type == "float") {
+            if (!std::isfinite(value) || std::fabs(value) > std::numeric_limits<float>::max()) {
+                return fail(ALIEN_ERROR_INVALID_ARGUMENT, std::string("Parameter ") + key + " must be a finite float.");
+            }
+            encodedValue = JsonParser::toString(static_cast<float>(value));
+        } else {
+            return fail(ALIEN_ERROR_UNKNOWN_PARAMETER, std::string("Parameter ") + key + " is not numeric.");
+        }
+        tree.put(key, encodedValue);
+        auto settings = Parser::decodeTimestepAndSettings(tree).second;
+        if (Parser::encode(controller->getCurrentTimestep(), settings).get<std::string>(key) != encodedValue) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, std::string("Value is out of range of parameter ") + key + ".");
+        }
+
+        //applied synchronously such that the next time step uses the new value
+        if (settings.simulationParameters != controller->getSimulationParameters()) {
+            controller->setSimulationParameters(settings.simulationParameters);
+        }
+        if (settings.simulationParametersSpots != controller->getSimulationParametersSpots()) {
+            controller->setSimulationParametersSpots(settings.simulationParametersSpots);
+        }
+        return ALIEN_OK;
+    });
+}
+
+AlienResult alien_enable_frame_export(
+    AlienSimulation* simulation,
+    char const* directory,
+    int32_t samplingRate,
+    int32_t imageWidth,
+    int32_t imageHeight)
+{
+    return guarded([&] {
+        if (!simulation || !directory || samplingRate < 1 || imageWidth < 1 || imageHeight < 1) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid argument.");
+        }
+        FrameExportSettings settings;
+        settings.directory = directory;
+        settings.samplingRate = samplingRate;
+        settings.imageWidth = imageWidth;
+        settings.imageHeight = imageHeight;
+        simulation->controller->enableFrameExport(settings);
+        return ALIEN_OK;
+    });
+}
+
+AlienResult alien_disable_frame_export(AlienSimulation* simulation)
+{
+    return guarded([&] {
+        if (!simulation) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid argument.");
+        }
+        simulation->controller->disableFrameExport();
+        return ALIEN_OK;
+    });
+}
+
+AlienResult alien_apply_bulk_transform(AlienSimulation* simulation, AlienBulkTransform const* transform)
+{
+    return guarded([&] {
+        if (!simulation || !transform || transform->operation < ALIEN_TRANSFORM_SET_COLOR_BY_CLUSTER
+            || transform->operation > ALIEN_TRANSFORM_RANDOMIZE_STATIC_BYTE || transform->scope < ALIEN_SCOPE_ALL
+            || transform->scope > ALIEN_SCOPE_REGION || transform->numColorCodes < 0 || transform->numColorCodes > 7
+            || (ALIEN_TRANSFORM_SET_COLOR_BY_CLUSTER == transform->operation && transform->numColorCodes < 1)) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid argument.");
+        }
+        BulkTransform bulkTransform;
+        bulkTransform.operation = static_cast<BulkTransformOperation::Type>(transform->operation);
+        bulkTransform.scope = static_cast<BulkTransformScope::Type>(transform->scope);
+        bulkTransform.regionTopLeftX = transform->regionTopLeft.x;
+        bulkTransform.regionTopLeftY = transform->regionTopLeft.y;
+        bulkTransform.regionBottomRightX = transform->regionBottomRight.x;
+        bulkTransform.regionBottomRightY = transform->regionBottomRight.y;
+        bulkTransform.numColorCodes = transform->numColorCodes;
+        for (int i = 0; i < transform->numColorCodes; ++i) {
+            bulkTransform.colorCodes[i] = transform->colorCodes[i];
+        }
+        bulkTransform.seed = transform->seed;
+        bulkTransform.energyFactor = transform->energyFactor;
+        bulkTransform.byteIndex = transform->byteIndex;
+        simulation->controller->applyBulkTransform(bulkTransform);
+        return ALIEN_OK;
+    });
+}
+
+AlienResult alien_acquire_snapshot(AlienSimulation* simulation, AlienSnapshot** result)
+{
+    return guarded([&] {
+        if (!simulation || !result) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid argument.");
+        }
+        auto const& controller = simulation->controller;
+
+        //each snapshot owns a cache such that its buffers are not reused or deleted by other snapshots
+        auto snapshot = new AlienSnapshot;
+        try {
+            snapshot->cache = boost::make_shared<_AccessDataTOCache>(controller->getGpuSettings());
+            snapshot->worldSize = controller->getWorldSize();
+            snapshot->dataTO = controller->getSimulationDataTO({0, 0}, snapshot->worldSize, snapshot->cache);
+            snapshot->timestep = controller->getCurrentTimestep();
+        } catch (...) {
+            delete snapshot;
+            throw;
+        }
+        *result = snapshot;
+        return ALIEN_OK;
+    });
+}
+
+AlienResult alien_get_world_view(AlienSnapshot const* snapshot, AlienWorldView* result)
+{
+    return guarded([&] {
+        if (!snapshot || !result) {
+            return fail(ALIEN_ERROR_INVALID_ARGUMENT, "Invalid argument.");
+        }
+        auto const& dataTO = snapshot->dataTO;
+        result->timestep = snapshot->timestep;
+        result->worldSizeX = snapshot->worldSize.x;
+        result->worldSizeY = snapshot->worldSize.y;
+        result->cells = reinterpret_cast<AlienCell const*>(dataTO.cells);
+        result->numCells = *dataTO.numCells;
+        result->particles = reinterpret_cast<AlienParticle const*>(dataTO.particles);
+        result->numParticles = *dataTO.numParticles;
+        result->tokens = reinterpret_cast<AlienToken const*>(dataTO.tokens);
+        result->numTokens = *dataTO.numTokens;
+        result->tokenMemory = dataTO.tokenMemory;
+        result->tokenMemorySize = dataTO.tokenMemorySize;
+        result->stringBytes = dataTO.stringBytes;
+        result->numStringBytes = *dataTO.numStringBytes;
+        return ALIEN_OK;
+    });
+}
+
+void alien_release_snapshot(AlienSnapshot* snapshot)
+{
+    delete snapshot;
+}
@@ -0,0 +1,225 @@
+#ifndef ALIEN_C_API_H
+#define ALIEN_C_API_H
+
+/**
+ * C interface for driving the simulation engine without the graphical front end.
+ *
+ * All functions returning AlienResult report failures by a result code and leave a description which can be
+ * queried by alien_get_last_error on the same thread. World data is read through snapshots whose arrays are
+ * lent to the caller without copying. The arrays remain valid until the snapshot is released.
+ */
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#ifdef ALIEN_C_API_LIB
+#define ALIEN_C_API __declspec(dllexport)
+#else
+#define ALIEN_C_API __declspec(dllimport)
+#endif
+#define ALIEN_ALIGN8 __declspec(align(8))
+#else
+#define ALIEN_C_API __attribute__((visibility("default")))
+#define ALIEN_ALIGN8 __attribute__((aligned(8)))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ALIEN_MAX_CELL_BONDS 6
+#define ALIEN_MAX_CELL_STATIC_BYTES 48
+#define ALIEN_MAX_CELL_MUTABLE_BYTES 16
+
+typedef enum
+{
+    ALIEN_OK = 0,
+    ALIEN_ERROR_INVALID_ARGUMENT = 1,
+    ALIEN_ERROR_UNKNOWN_PARAMETER = 2,
+    ALIEN_ERROR_ENGINE = 3
+} AlienResult;
+
+typedef enum
+{
+    ALIEN_TRANSFORM_SET_COLOR_BY_CLUSTER = 0,
+    ALIEN_TRANSFORM_SCALE_ENERGY = 1,
+    ALIEN_TRANSFORM_RESET_TOKEN_MEMORY = 2,
+    ALIEN_TRANSFORM_RANDOMIZE_STATIC_BYTE = 3
+} AlienTransformOperation;
+
+typedef enum
+{
+    ALIEN_SCOPE_ALL = 0,
+    ALIEN_SCOPE_SELECTION = 1,
+    ALIEN_SCOPE_REGION = 2
+} AlienTransformScope;
+
+typedef enum
+{
+    ALIEN_RESIZE_REMAP = 0,    /* entities keep their positions modulo the new world size */
+    ALIEN_RESIZE_TILE = 1      /* the new world is filled with copies of the original world */
+} AlienResizeMode;
+
+typedef struct AlienSimulation AlienSimulation;
+typedef struct AlienSnapshot AlienSnapshot;
+
+/**
+ * The following structs have the same memory layout as the transfer objects of the engine.
+ */
+typedef struct ALIEN_ALIGN8
+{
+    float x;
+    float y;
+} AlienFloat2;
+
+typedef struct
+{
+    int32_t cellIndex;  /* index in AlienWorldView::cells */
+    float distance;
+    float angleFromPrevious;
+} AlienCellConnection;
+
+typedef struct
+{
+    uint8_t color;
+
+    int32_t nameLen;
+    int32_t nameStringIndex;    /* strings are located in AlienWorldView::stringBytes */
+
+    int32_t descriptionLen;
+    int32_t descriptionStringIndex;
+
+    int32_t sourceCodeLen;
+    int32_t sourceCodeStringIndex;
+} AlienCellMetadata;
+
+typedef struct
+{
+    uint64_t id;
+    AlienFloat2 pos;
+    AlienFloat2 vel;
+    float energy;
+    int32_t maxConnections;
+    int32_t numConnections;
+    int32_t branchNumber;
+    uint8_t tokenBlocked;
+    AlienCellConnection connections[ALIEN_MAX_CELL_BONDS];
+    int32_t cellFunctionType;
+    uint8_t numStaticBytes;
+    char staticData[ALIEN_MAX_CELL_STATIC_BYTES];
+    uint8_t numMutableBytes;
+    char mutableData[ALIEN_MAX_CELL_MUTABLE_BYTES];
+    int32_t tokenUsages;
+    AlienCellMetadata metadata;
+
+    int32_t selected;
+} AlienCell;
+
+typedef struct
+{
+    uint64_t id;
+    float energy;
+    AlienFloat2 pos;
+    AlienFloat2 vel;
+    uint8_t color;
+
+    int32_t selected;
+} AlienParticle;
+
+typedef struct
+{
+    float energy;
+    int32_t cellIndex;  /* memory is located at AlienWorldView::tokenMemory[tokenIndex * tokenMemorySize] */
+} AlienToken;
+
+typedef struct
+{
+    uint64_t timestep;
+    int32_t worldSizeX;
+    int32_t worldSizeY;
+
+    AlienCell const* cells;
+    int32_t numCells;
+    AlienParticle const* particles;
+    int32_t numParticles;
+    AlienToken const* tokens;
+    int32_t numTokens;
+    char const* tokenMemory;
+    int32_t tokenMemorySize;    /* bytes per token */
+    char const* stringBytes;
+    int32_t numStringBytes;
+} AlienWorldView;
+
+ALIEN_C_API char const* alien_get_last_error(void);
+
+/* creates an empty world with default parameters */
+ALIEN_C_API AlienResult alien_create_simulation(int32_t worldSizeX, int32_t worldSizeY, AlienSimulation** result);
+ALIEN_C_API AlienResult alien_load_simulation(char const* filename, AlienSimulation** result);
+ALIEN_C_API AlienResult alien_save_simulation(AlienSimulation* simulation, char const* filename);
+ALIEN_C_API void alien_destroy_simulation(AlienSimulation* simulation);
+
+/**
+ * Incremental checkpoints: the first checkpoint of a simulation to a file writes the whole world. Later checkpoints
+ * to the same file only append the regions changed since the previous checkpoint to a journal next to it (file
+ * ending .journal) until the whole world is written again after 100 journal entries. alien_load_checkpoint loads the
+ * file and replays the journal.
+ */
+ALIEN_C_API AlienResult alien_write_checkpoint(AlienSimulation* simulation, char const* filename);
+ALIEN_C_API AlienResult alien_load_checkpoint(char const* filename, AlienSimulation** result);
+
+ALIEN_C_API AlienResult
+alien_resize_world(AlienSimulation* simulation, int32_t worldSizeX, int32_t worldSizeY, AlienResizeMode mode);
+
+ALIEN_C_API AlienResult alien_calc_timesteps(AlienSimulation* simulation, int32_t numTimesteps);
+ALIEN_C_API AlienResult alien_get_timestep(AlienSimulation* simulation, uint64_t* result);
+
+/**
+ * Parameters are addressed by their keys in the settings files, e.g. "simulation parameters.cell.max velocity".
+ * Only keys below "simulation parameters" can be set.
+ */
+ALIEN_C_API AlienResult alien_get_parameter(AlienSimulation* simulation, char const* key, double* result);
+ALIEN_C_API AlienResult alien_set_parameter(AlienSimulation* simulation, char const* key, double value);
+
+/**
+ * Writes every samplingRate time steps a PNG image of the whole world as frame_<timestep>.png into directory. The
+ * images are rasterized on the CPU, hence no graphics context is required.
+ */
+ALIEN_C_API AlienResult alien_enable_frame_export(
+    AlienSimulation* simulation,
+    char const* directory,
+    int32_t samplingRate,
+    int32_t imageWidth,
+    int32_t imageHeight);
+ALIEN_C_API AlienResult alien_disable_frame_export(AlienSimulation* simulation);
+
+typedef struct
+{
+    AlienTransformOperation operation;
+    AlienTransformScope scope;
+    AlienFloat2 regionTopLeft;      /* for ALIEN_SCOPE_REGION, continued across the world boundaries */
+    AlienFloat2 regionBottomRight;
+    int32_t numColorCodes;          /* for ALIEN_TRANSFORM_SET_COLOR_BY_CLUSTER, between 1 and 7 */
+    int32_t colorCodes[7];
+    uint32_t seed;
+    float energyFactor;             /* for ALIEN_TRANSFORM_SCALE_ENERGY */
+    int32_t byteIndex;              /* for ALIEN_TRANSFORM_RANDOMIZE_STATIC_BYTE */
+} AlienBulkTransform;
+
+/**
+ * Edits the entities in place on the GPU. The ids of the entities are kept.
+ */
+ALIEN_C_API AlienResult alien_apply_bulk_transform(AlienSimulation* simulation, AlienBulkTransform const* transform);
+
+/**
+ * A snapshot contains the whole world at the time of acquisition. It owns its arrays, may outlive the simulation and
+ * must be released by alien_release_snapshot.
+ */
+ALIEN_C_API AlienResult alien_acquire_snapshot(AlienSimulation* simulation, AlienSnapshot** result);
+ALIEN_C_API AlienResult alien_get_world_view(AlienSnapshot const* snapshot, AlienWorldView* result);
+ALIEN_C_API void alien_release_snapshot(AlienSnapshot* snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -9,6 +9,7 @@
 #include "EntityFactory.cuh"
 #include "CleanupKernels.cuh"
 #include "ActionKernels.cuh"
+#include "SpatialIndexKernels.cuh"
 
 #include "SimulationData.cuh"
 
@@ -86,6 +87,16 @@ __device__ void createCellTO(Cell* cell, DataAccessTO& accessTO, Cell* cellArray
     }
 }
 
+//the tag of a cell is only valid if it refers to the transfer object of the cell
+__device__ __inline__ int getCellTOIndex(Cell const& cell, DataAccessTO const& accessTO)
+{
+    auto const tag = cell.tag;
+    if (tag >= 0 && tag < *accessTO.numCells && accessTO.cells[tag].id == cell.id) {
+        return tag;
+    }
+    return -1;
+}
+
 __device__ void createParticleTO(Particle* particle, DataAccessTO& accessTO)
 {
     int particleTOIndex = atomicAdd(accessTO.numParticles, 1);
@@ -97,57 +108,28 @@ __device__ void createParticleTO(Particle* particle, DataAccessTO& accessTO)
     particleTO.energy = particle->energy;
 }
 
-__global__ void tagCells(int2 rectUpperLeft, int2 rectLowerRight, Array<Cell*> cells)
-{
-    auto const partition =
-        calcPartition(cells.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
-    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
-        auto& cell = cells.at(index);
-        if (isContainedInRect(rectUpperLeft, rectLowerRight, cell->absPos)) {
-            cell->tag = 1;
-        } else {
-            cell->tag = 0;
-        }
-    }
-}
-
-__global__ void rolloutTagToCellClusters(Array<Cell*> cells, int* change)
-{
-    auto const partition =
-        calcPartition(cells.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
-    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
-        auto& cell = cells.at(index);
-        auto tag = atomicAdd(&cell->tag, 0);
-        if (1 == tag) {
-            for (int i = 0; i < cell->numConnections; ++i) {
-                auto& connectingCell = cell->connections[i].cell;
-                auto origTag = atomicExch(&connectingCell->tag, 1);
-                if (0 == origTag) {
-                    atomicExch(change, 1);
-                }
-            }
-        }
-    }
-}
-
 //tags cell with cellTO index and tags cellTO connections with cell index
 __global__ void getCellAccessDataWithoutConnections(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, DataAccessTO accessTO)
 {
-    auto const& cells = data.entities.cellPointers;
-    auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+    auto const& spatialIndex = data.spatialIndex.cells;
+    auto const range = spatialIndex.getTileRange(toFloat2(rectUpperLeft), toFloat2(rectLowerRight));
     auto const cellArrayStart = data.entities.cells.getArray();
 
-    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
-        auto& cell = cells.at(index);
+    for (int slice = 0; slice < spatialIndex.getNumSlices(range); ++slice) {
+        int numCells;
+        auto cells = spatialIndex.getSlice(range, slice, numCells);
+        auto const partition = calcAllThreadsPartition(numCells);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells[index];
 
-        auto pos = cell->absPos;
-        data.cellMap.mapPosCorrection(pos);
-        if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
-            cell->tag = -1;
-            continue;
-        }
+            auto pos = cell->absPos;
+            data.cellMap.mapPosCorrection(pos);
+            if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+                continue;
+            }
 
-        createCellTO(cell, accessTO, cellArrayStart);
+            createCellTO(cell, accessTO, cellArrayStart);
+        }
     }
 }
 
@@ -179,50 +161,70 @@ __global__ void resolveConnections(SimulationData data, DataAccessTO accessTO)
         
         for (int i = 0; i < cellTO.numConnections; ++i) {
             auto const cellIndex = cellTO.connections[i].cellIndex;
-            cellTO.connections[i].cellIndex = data.entities.cells.at(cellIndex).tag;
+            cellTO.connections[i].cellIndex = getCellTOIndex(data.entities.cells.at(cellIndex), accessTO);
         }
     }
 }
 
-__global__ void getOverlayData(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, DataAccessTO accessTO)
+//elements beyond Const::MaxOverlayElements are counted but not written
+__global__ void getOverlayData(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, OverlayAccessTO overlayTO)
 {
     {
-        auto const& cells = data.entities.cellPointers;
-        auto const partition = calcAllThreadsPartition(cells.getNumEntries());
-
-        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
-            auto& cell = cells.at(index);
+        auto const& spatialIndex = data.spatialIndex.cells;
+        auto const range = spatialIndex.getTileRange(toFloat2(rectUpperLeft), toFloat2(rectLowerRight));
+
+        for (int slice = 0; slice < spatialIndex.getNumSlices(range); ++slice) {
+            int numCells;
+            auto cells = spatialIndex.getSlice(range, slice, numCells);
+            auto const partition = calcAllThreadsPartition(numCells);
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto& cell = cells[index];
+
+                auto pos = cell->absPos;
+                data.cellMap.mapPosCorrection(pos);
+                if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+                    continue;
+                }
+                auto elementIndex = atomicAdd(overlayTO.numElements, 1);
+                if (elementIndex >= Const::MaxOverlayElements) {
+                    continue;
+                }
+                auto& element = overlayTO.elements[elementIndex];
 
-            auto pos = cell->absPos;
-            data.cellMap.mapPosCorrection(pos);
-            if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
-                continue;
+                element.pos = cell->absPos;
+                element.cellFunctionType = cell->cellFunctionType;
+                element.selected = static_cast<unsigned char>(cell->selected);
+                element.cell = true;
             }
-            auto cellTOIndex = atomicAdd(accessTO.numCells, 1);
-            auto& cellTO = accessTO.cells[cellTOIndex];
-
-            cellTO.pos = cell->absPos;
-            cellTO.cellFunctionType = cell->cellFunctionType;
-            cellTO.selected = cell->selected;
         }
     }
     {
-        auto const& particles = data.entities.particlePointers;
-        auto const partition = calcAllThreadsPartition(particles.getNumEntries());
-
-        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
-            auto& particle = particles.at(index);
+        auto const& spatialIndex = data.spatialIndex.particles;
+        auto const range = spatialIndex.getTileRange(toFloat2(rectUpperLeft), toFloat2(rectLowerRight));
+
+        for (int slice = 0; slice < spatialIndex.getNumSlices(range); ++slice) {
+            int numParticles;
+            auto particles = spatialIndex.getSlice(range, slice, numParticles);
+            auto const partition = calcAllThreadsPartition(numParticles);
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto& particle = particles[index];
+
+                auto pos = particle->absPos;
+                data.particleMap.mapPosCorrection(pos);
+                if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+                    continue;
+                }
+                auto elementIndex = atomicAdd(overlayTO.numElements, 1);
+                if (elementIndex >= Const::MaxOverlayElements) {
+                    continue;
+                }
+                auto& element = overlayTO.elements[elementIndex];
 
-            auto pos = particle->absPos;
-            data.particleMap.mapPosCorrection(pos);
-            if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
-                continue;
+                element.pos = particle->absPos;
+                element.cellFunctionType = 0;
+                element.selected = static_cast<unsigned char>(particle->selected);
+                element.cell = false;
             }
-            auto particleTOIndex = atomicAdd(accessTO.numParticles, 1);
-            auto& particleTO = accessTO.particles[particleTOIndex];
-
-            particleTO.pos = particle->absPos;
-            particleTO.selected = particle->selected;
         }
     }
 }
@@ -236,7 +238,8 @@ __global__ void getTokenAccessData(SimulationData data, DataAccessTO accessTO)
     for (auto tokenIndex = partition.startIndex; tokenIndex <= partition.endIndex; ++tokenIndex) {
         auto token = tokens.at(tokenIndex);
 
-        if (token->cell->tag == -1) {
+        auto const cellTOIndex = getCellTOIndex(*token->cell, accessTO);
+        if (cellTOIndex == -1) {
             continue;
         }
 
@@ -244,27 +247,33 @@ __global__ void getTokenAccessData(SimulationData data, DataAccessTO accessTO)
         auto& tokenTO = accessTO.tokens[tokenTOIndex];
 
         tokenTO.energy = token->energy;
-        for (int i = 0; i < cudaSimulationParameters.tokenMemorySize; ++i) {
-            tokenTO.memory[i] = token->memory[i];
+        auto tokenMemoryTO = accessTO.tokenMemory + static_cast<uint64_t>(tokenTOIndex) * accessTO.tokenMemorySize;
+        for (int i = 0; i < accessTO.tokenMemorySize; ++i) {
+            tokenMemoryTO[i] = token->memory[i];
         }
-        tokenTO.cellIndex = token->cell->tag;
+        tokenTO.cellIndex = cellTOIndex;
     }
 }
 
 __global__ void getParticleAccessData(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, DataAccessTO access)
 {
-    PartitionData particleBlock = calcPartition(
-        data.entities.particlePointers.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+    auto const& spatialIndex = data.spatialIndex.particles;
+    auto const range = spatialIndex.getTileRange(toFloat2(rectUpperLeft), toFloat2(rectLowerRight));
 
-    for (int particleIndex = particleBlock.startIndex; particleIndex <= particleBlock.endIndex; ++particleIndex) {
-        auto const& particle = data.entities.particlePointers.at(particleIndex);
-        auto pos = particle->absPos;
-        data.particleMap.mapPosCorrection(pos);
-        if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
-            continue;
-        }
+    for (int slice = 0; slice < spatialIndex.getNumSlices(range); ++slice) {
+        int numParticles;
+        auto particles = spatialIndex.getSlice(range, slice, numParticles);
+        auto const partition = calcAllThreadsPartition(numParticles);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& particle = particles[index];
+            auto pos = particle->absPos;
+            data.particleMap.mapPosCorrection(pos);
+            if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+                continue;
+            }
 
-        createParticleTO(particle, access);
+            createParticleTO(particle, access);
+        }
     }
 }
 
@@ -289,7 +298,8 @@ __global__ void createDataFromTO(
     bool selectNewData,
     Particle* particleTargetArray,
     Cell* cellTargetArray,
-    Token* tokenTargetArray)
+    Token* tokenTargetArray,
+    char* tokenMemoryTargetArray)
 {
     __shared__ EntityFactory factory;
     if (0 == threadIdx.x) {
@@ -318,7 +328,13 @@ __global__ void createDataFromTO(
     auto tokenPartition =
         calcPartition(*simulationTO.numTokens, threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
     for (int index = tokenPartition.startIndex; index <= tokenPartition.endIndex; ++index) {
-        factory.createTokenFromTO(index, simulationTO.tokens[index], cellTargetArray, tokenTargetArray, &simulationTO);
+        factory.createTokenFromTO(
+            index,
+            simulationTO.tokens[index],
+            cellTargetArray,
+            tokenTargetArray,
+            tokenMemoryTargetArray,
+            &simulationTO);
     }
 }
 
@@ -369,27 +385,33 @@ cudaGetSimulationDataKernel(int2 rectUpperLeft, int2 rectLowerRight, SimulationD
     *accessTO.numTokens = 0;
     *accessTO.numStringBytes = 0;
 
+    KERNEL_CALL_1_1(updateSpatialIndex, data);
     KERNEL_CALL(getCellAccessDataWithoutConnections, rectUpperLeft, rectLowerRight, data, accessTO);
     KERNEL_CALL(resolveConnections, data, accessTO);
     KERNEL_CALL(getTokenAccessData, data, accessTO);
     KERNEL_CALL(getParticleAccessData, rectUpperLeft, rectLowerRight, data, accessTO);
 }
 
-__global__ void
-cudaGetSimulationOverlayDataKernel(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, DataAccessTO access)
+__global__ void cudaGetSimulationOverlayDataKernel(
+    int2 rectUpperLeft,
+    int2 rectLowerRight,
+    SimulationData data,
+    OverlayAccessTO overlayTO)
 {
-    *access.numCells = 0;
-    *access.numParticles = 0;
-    KERNEL_CALL(getOverlayData, rectUpperLeft, rectLowerRight, data, access);
+    *overlayTO.numElements = 0;
+    KERNEL_CALL_1_1(updateSpatialIndex, data);
+    KERNEL_CALL(getOverlayData, rectUpperLeft, rectLowerRight, data, overlayTO);
 }
 
 __global__ void cudaClearData(SimulationData data)
 {
+    data.spatialIndex.invalidate();
     data.entities.cellPointers.reset();
     data.entities.tokenPointers.reset();
     data.entities.particlePointers.reset();
     data.entities.cells.reset();
     data.entities.tokens.reset();
+    data.entities.tokenMemory.reset();
     data.entities.particles.reset();
     data.entities.strings.reset();
 }
@@ -404,7 +426,8 @@ __global__ void cudaSetSimulationAccessDataKernel(SimulationData data, DataAcces
         selectNewData,
         data.entities.particles.getNewSubarray(*access.numParticles),
         data.entities.cells.getNewSubarray(*access.numCells),
-        data.entities.tokens.getNewSubarray(*access.numTokens));
+        data.entities.tokens.getNewSubarray(*access.numTokens),
+        data.entities.tokenMemory.getNewSubarray(*access.numTokens * data.tokenMemorySize));
 
     KERNEL_CALL_1_1(cleanupAfterDataManipulationKernel, data);
 
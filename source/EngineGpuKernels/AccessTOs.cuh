@@ -5,6 +5,7 @@
 #include "CudaSimulation.cuh"
 
 #define MAX_TOKEN_MEM_SIZE 256
+#define MIN_TOKEN_MEM_SIZE 64   //fixed token memory positions of the cell functions go up to 40
 #define MAX_CELL_BONDS 6
 #define MAX_CELL_STATIC_BYTES 48
 #define MAX_CELL_MUTABLE_BYTES 16
@@ -12,8 +13,7 @@
 struct TokenAccessTO
 {
 	float energy;
-	char memory[MAX_TOKEN_MEM_SIZE];
-	int cellIndex;
+	int cellIndex;  //memory is located at DataAccessTO::tokenMemory[tokenIndex * DataAccessTO::tokenMemorySize]
 };
 
 struct ParticleMetadataAccessTO
@@ -83,6 +83,8 @@ struct DataAccessTO
 	ParticleAccessTO* particles = nullptr;
 	int* numTokens = nullptr;
 	TokenAccessTO* tokens = nullptr;
+    char* tokenMemory = nullptr;
+    int tokenMemorySize = 0;
     int* numStringBytes = nullptr;
     char* stringBytes = nullptr;
 
@@ -94,8 +96,25 @@ struct DataAccessTO
 			&& particles == other.particles
 			&& numTokens == other.numTokens
 			&& tokens == other.tokens
+            && tokenMemory == other.tokenMemory
+            && tokenMemorySize == other.tokenMemorySize
             && numStringBytes == other.numStringBytes
             && stringBytes == other.stringBytes;
 	}
 };
 
+
+//packed record for the overlay, has the same layout as OverlayElementDescription
+struct OverlayElementAccessTO
+{
+    float2 pos;
+    int cellFunctionType;
+    unsigned char selected;
+    bool cell;  //false = energy particle
+};
+
+struct OverlayAccessTO
+{
+    int* numElements = nullptr;
+    OverlayElementAccessTO* elements = nullptr;
+};
@@ -14,59 +14,98 @@
 #include "SelectionResult.cuh"
 #include "CellConnectionProcessor.cuh"
 #include "CellProcessor.cuh"
+#include "ClusterLabelKernels.cuh"
+#include "SpatialIndexKernels.cuh"
 
 #include "SimulationData.cuh"
 
-__global__ void applyForceToCells(ApplyForceData applyData, int2 universeSize, Array<Cell*> cells)
+__global__ void applyForceToCells(ApplyForceData applyData, SimulationData data)
 {
-    auto const cellBlock = calcAllThreadsPartition(cells.getNumEntries());
-
-    for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
-        auto const& cell = cells.at(index);
-        auto const& pos = cell->absPos;
-        auto distanceToSegment =
-            Math::calcDistanceToLineSegment(applyData.startPos, applyData.endPos, pos, applyData.radius);
-        if (distanceToSegment < applyData.radius) {
-            auto weightedForce = applyData.force;
-            //*(actionRadius - distanceToSegment) / actionRadius;
-            cell->vel = cell->vel + weightedForce;
+    auto const& spatialIndex = data.spatialIndex.cells;
+    auto const range = spatialIndex.getTileRange(
+        {min(applyData.startPos.x, applyData.endPos.x) - applyData.radius,
+         min(applyData.startPos.y, applyData.endPos.y) - applyData.radius},
+        {max(applyData.startPos.x, applyData.endPos.x) + applyData.radius,
+         max(applyData.startPos.y, applyData.endPos.y) + applyData.radius});
+
+    for (int slice = 0; slice < spatialIndex.getNumSlices(range); ++slice) {
+        int numCells;
+        auto cells = spatialIndex.getSlice(range, slice, numCells);
+        auto const cellBlock = calcAllThreadsPartition(numCells);
+        for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
+            auto const& cell = cells[index];
+            auto const& pos = cell->absPos;
+            auto distanceToSegment =
+                Math::calcDistanceToLineSegment(applyData.startPos, applyData.endPos, pos, applyData.radius);
+            if (distanceToSegment < applyData.radius) {
+                auto weightedForce = applyData.force;
+                //*(actionRadius - distanceToSegment) / actionRadius;
+                cell->vel = cell->vel + weightedForce;
+                cell->wakeUp();
+            }
         }
     }
 }
 
-__global__ void applyForceToParticles(ApplyForceData applyData, int2 universeSize, Array<Particle*> particles)
+__global__ void applyForceToParticles(ApplyForceData applyData, SimulationData data)
 {
-    auto const particleBlock = calcAllThreadsPartition(particles.getNumEntries());
-
-    for (int index = particleBlock.startIndex; index <= particleBlock.endIndex; ++index) {
-        auto const& particle = particles.at(index);
-        auto const& pos = particle->absPos;
-        auto distanceToSegment =
-            Math::calcDistanceToLineSegment(applyData.startPos, applyData.endPos, pos, applyData.radius);
-        if (distanceToSegment < applyData.radius) {
-            auto weightedForce = applyData.force;//*(actionRadius - distanceToSegment) / actionRadius;
-            particle->vel = particle->vel + weightedForce;
+    auto const& spatialIndex = data.spatialIndex.particles;
+    auto const range = spatialIndex.getTileRange(
+        {min(applyData.startPos.x, applyData.endPos.x) - applyData.radius,
+         min(applyData.startPos.y, applyData.endPos.y) - applyData.radius},
+        {max(applyData.startPos.x, applyData.endPos.x) + applyData.radius,
+         max(applyData.startPos.y, applyData.endPos.y) + applyData.radius});
+
+    for (int slice = 0; slice < spatialIndex.getNumSlices(range); ++slice) {
+        int numParticles;
+        auto particles = spatialIndex.getSlice(range, slice, numParticles);
+        auto const particleBlock = calcAllThreadsPartition(numParticles);
+        for (int index = particleBlock.startIndex; index <= particleBlock.endIndex; ++index) {
+            auto const& particle = particles[index];
+            auto const& pos = particle->absPos;
+            auto distanceToSegment =
+                Math::calcDistanceToLineSegment(applyData.startPos, applyData.endPos, pos, applyData.radius);
+            if (distanceToSegment < applyData.radius) {
+                auto weightedForce = applyData.force;//*(actionRadius - distanceToSegment) / actionRadius;
+                particle->vel = particle->vel + weightedForce;
+            }
         }
     }
 }
 
 __global__ void existSelection(PointSelectionData pointData, SimulationData data, int* result)
 {
-    auto const cellBlock = calcAllThreadsPartition(data.entities.cellPointers.getNumEntries());
-
-    for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
-        auto const& cell = data.entities.cellPointers.at(index);
-        if (1 == cell->selected && data.cellMap.mapDistance(pointData.pos, cell->absPos) < pointData.radius) {
-            atomicExch(result, 1);
+    auto const rectUpperLeft = pointData.pos - float2{pointData.radius, pointData.radius};
+    auto const rectLowerRight = pointData.pos + float2{pointData.radius, pointData.radius};
+    {
+        auto const& spatialIndex = data.spatialIndex.cells;
+        auto const range = spatialIndex.getTileRange(rectUpperLeft, rectLowerRight);
+        for (int slice = 0; slice < spatialIndex.getNumSlices(range); ++slice) {
+            int numCells;
+            auto cells = spatialIndex.getSlice(range, slice, numCells);
+            auto const cellBlock = calcAllThreadsPartition(numCells);
+            for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
+                auto const& cell = cells[index];
+                if (1 == cell->selected && data.cellMap.mapDistance(pointData.pos, cell->absPos) < pointData.radius) {
+                    atomicExch(result, 1);
+                }
+            }
         }
     }
-
-    auto const particleBlock = calcAllThreadsPartition(data.entities.particlePointers.getNumEntries());
-
-    for (int index = particleBlock.startIndex; index <= particleBlock.endIndex; ++index) {
-        auto const& particle = data.entities.particlePointers.at(index);
-        if (1 == particle->selected && data.cellMap.mapDistance(pointData.pos, particle->absPos) < pointData.radius) {
-            atomicExch(result, 1);
+    {
+        auto const& spatialIndex = data.spatialIndex.particles;
+        auto const range = spatialIndex.getTileRange(rectUpperLeft, rectLowerRight);
+        for (int slice = 0; slice < spatialIndex.getNumSlices(range); ++slice) {
+            int numParticles;
+            auto particles = spatialIndex.getSlice(range, slice, numParticles);
+            auto const particleBlock = calcAllThreadsPartition(numParticles);
+            for (int index = particleBlock.startIndex; index <= particleBlock.endIndex; ++index) {
+                auto const& particle = particles[index];
+                if (1 == particle->selected
+                    && data.cellMap.mapDistance(pointData.pos, particle->absPos) < pointData.radius) {
+                    atomicExch(result, 1);
+                }
+            }
         }
     }
 }
@@ -123,66 +162,85 @@ __global__ void setSelection(AreaSelectionData selectionData, SimulationData dat
 
 __global__ void swapSelection(float2 pos, float radius, SimulationData data)
 {
-    auto const cellBlock = calcAllThreadsPartition(data.entities.cellPointers.getNumEntries());
-    for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
-        auto const& cell = data.entities.cellPointers.at(index);
-        if (data.cellMap.mapDistance(pos, cell->absPos) < radius) {
-            if (cell->selected == 0) {
-                cell->selected = 1;
+    auto const rectUpperLeft = pos - float2{radius, radius};
+    auto const rectLowerRight = pos + float2{radius, radius};
+    {
+        auto const& spatialIndex = data.spatialIndex.cells;
+        auto const range = spatialIndex.getTileRange(rectUpperLeft, rectLowerRight);
+        for (int slice = 0; slice < spatialIndex.getNumSlices(range); ++slice) {
+            int numCells;
+            auto cells = spatialIndex.getSlice(range, slice, numCells);
+            auto const cellBlock = calcAllThreadsPartition(numCells);
+            for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
+                auto const& cell = cells[index];
+                if (data.cellMap.mapDistance(pos, cell->absPos) < radius) {
+                    if (cell->selected == 0) {
+                        cell->selected = 1;
+                    } else if (cell->selected == 1) {
+                        cell->selected = 0;
+                    }
+                }
             }
-            else if (cell->selected == 1) {
-                cell->selected = 0;
+        }
+    }
+    {
+        auto const& spatialIndex = data.spatialIndex.particles;
+        auto const range = spatialIndex.getTileRange(rectUpperLeft, rectLowerRight);
+        for (int slice = 0; slice < spatialIndex.getNumSlices(range); ++slice) {
+            int numParticles;
+            auto particles = spatialIndex.getSlice(range, slice, numParticles);
+            auto const particleBlock = calcAllThreadsPartition(numParticles);
+            for (int index = particleBlock.startIndex; index <= particleBlock.endIndex; ++index) {
+                auto const& particle = particles[index];
+                if (data.particleMap.mapDistance(pos, particle->absPos) < radius) {
+                    particle->selected = 1 - particle->selected;
+                }
             }
-        } 
+        }
     }
+}
 
-    auto const particleBlock = calcAllThreadsPartition(data.entities.particlePointers.getNumEntries());
-    for (int index = particleBlock.startIndex; index <= particleBlock.endIndex; ++index) {
-        auto const& particle = data.entities.particlePointers.at(index);
-        if (data.particleMap.mapDistance(pos, particle->absPos) < radius) {
-            particle->selected = 1 - particle->selected;
-        } 
+__global__ void clearCellTags(SimulationData data)
+{
+    auto const cellBlock = calcAllThreadsPartition(data.entities.cellPointers.getNumEntries());
+
+    for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
+        data.entities.cellPointers.at(index)->tag = 0;
     }
 }
 
-__global__ void rolloutSelectionStep(SimulationData data, int* result)
+//assumes updated cluster labels
+__global__ void tagSelectedClusters(SimulationData data)
 {
     auto const cellBlock = calcAllThreadsPartition(data.entities.cellPointers.getNumEntries());
 
     for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
         auto const& cell = data.entities.cellPointers.at(index);
-
         if (0 != cell->selected) {
-            auto currentCell = cell;
-            for (int i = 0; i < 10; ++i) {
-                bool found = false;
-                for (int j = 0; j < currentCell->numConnections; ++j) {
-                    auto candidateCell = currentCell->connections[j].cell;
-                    if (0 == candidateCell->selected) {
-                        currentCell = candidateCell;
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) {
-                    break;
-                }
+            atomicExch(&cell->clusterParent->tag, 1);
+        }
+    }
+}
 
-                currentCell->selected = 2;
-                atomicExch(result, 1);
-            }
+__global__ void selectTaggedClusters(SimulationData data)
+{
+    auto const cellBlock = calcAllThreadsPartition(data.entities.cellPointers.getNumEntries());
+
+    for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
+        auto const& cell = data.entities.cellPointers.at(index);
+        if (0 == cell->selected && 1 == cell->clusterParent->tag) {
+            cell->selected = 2;
         }
     }
 }
 
+//the number of passes does not depend on the size of the clusters
 __global__ void rolloutSelection(SimulationData data)
 {
-    int* result = new int;
-    do {
-        *result = 0;
-        KERNEL_CALL(rolloutSelectionStep, data, result);
-    } while (1 == *result);
-    delete result;
+    KERNEL_CALL_1_1(updateClusterLabels, data.entities.cellPointers);
+    KERNEL_CALL(clearCellTags, data);
+    KERNEL_CALL(tagSelectedClusters, data);
+    KERNEL_CALL(selectTaggedClusters, data);
 }
 
 __global__ void updatePosAndVelForSelection(ShallowUpdateSelectionData updateData, SimulationData data)
@@ -194,6 +252,7 @@ __global__ void updatePosAndVelForSelection(ShallowUpdateSelectionData updateDat
             || (1 == cell->selected && !updateData.considerClusters)) {
             cell->absPos = cell->absPos + float2{updateData.posDeltaX, updateData.posDeltaY};
             cell->vel = cell->vel + float2{updateData.velDeltaX, updateData.velDeltaY};
+            cell->wakeUp();
         }
     }
 
@@ -387,6 +446,7 @@ updateAngleAndAngularVelForSelection(ShallowUpdateSelectionData updateData, Simu
                 auto relPos = cell->absPos - center;
                 data.cellMap.mapDisplacementCorrection(relPos);
 
+                cell->wakeUp();
                 if (updateData.angleDelta != 0) {
                     cell->absPos = Math::applyMatrix(relPos, rotationMatrix) + center;
                     data.cellMap.mapPosCorrection(cell->absPos);
@@ -472,8 +532,9 @@ __global__ void removeSelectedParticles(SimulationData data)
 
 __global__ void cudaApplyForce(ApplyForceData applyData, SimulationData data)
 {
-    KERNEL_CALL(applyForceToCells, applyData, data.size, data.entities.cellPointers);
-    KERNEL_CALL(applyForceToParticles, applyData, data.size, data.entities.particlePointers);
+    KERNEL_CALL_1_1(updateSpatialIndex, data);
+    KERNEL_CALL(applyForceToCells, applyData, data);
+    KERNEL_CALL(applyForceToParticles, applyData, data);
 }
 
 __global__ void
@@ -482,6 +543,7 @@ cudaSwitchSelection(PointSelectionData switchData, SimulationData data)
     int* result = new int;
     *result = 0; 
 
+    KERNEL_CALL_1_1(updateSpatialIndex, data);
     KERNEL_CALL(existSelection, switchData, data, result);
     if (0 == *result) {
         KERNEL_CALL(setSelection, switchData.pos, switchData.radius, data);
@@ -498,6 +560,7 @@ __global__ void cudaSwapSelection(PointSelectionData switchData, SimulationData
 
     KERNEL_CALL(removeSelection, data, true);
 
+    KERNEL_CALL_1_1(updateSpatialIndex, data);
     KERNEL_CALL(swapSelection, switchData.pos, switchData.radius, data);
     KERNEL_CALL_1_1(rolloutSelection, data);
 
@@ -524,6 +587,7 @@ __global__ void cudaGetSelectionShallowData(SimulationData data, SelectionResult
 
 __global__ void cudaShallowUpdateSelection(ShallowUpdateSelectionData updateData, SimulationData data)
 {
+    data.spatialIndex.invalidate();
     int* result = new int;
 
     bool reconnectionRequired =
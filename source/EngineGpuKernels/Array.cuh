@@ -136,6 +136,17 @@ public:
         return &(*_data)[oldIndex];
     }
 
+    //returns nullptr if the array is full
+    __device__ __inline__ T* tryGetNewElement()
+    {
+        int oldIndex = atomicAdd(_numEntries, 1);
+        if (oldIndex >= *_size) {
+            atomicAdd(_numEntries, -1);
+            return nullptr;
+        }
+        return &(*_data)[oldIndex];
+    }
+
     __device__ __inline__ T& at(int index) { return (*_data)[index]; }
     __device__ __inline__ T const& at(int index) const { return (*_data)[index]; }
 
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "EngineInterface/BulkTransform.h"
+
+#include "cuda_runtime_api.h"
+#include "sm_60_atomic_functions.h"
+
+#include "Base.cuh"
+#include "ClusterLabelKernels.cuh"
+#include "ConstantMemory.cuh"
+#include "SimulationData.cuh"
+
+/************************************************************************/
+/* Helpers    															*/
+/************************************************************************/
+
+//the interval [from, to] may exceed [0, size) and is then continued on the other side of the world
+__device__ __inline__ bool isInWrappedInterval(float value, float from, float to, int size)
+{
+    if (to - from >= toFloat(size)) {
+        return true;
+    }
+    auto offset = fmodf(value - from, toFloat(size));
+    if (offset < 0) {
+        offset += toFloat(size);
+    }
+    return offset <= to - from;
+}
+
+__device__ __inline__ bool
+isInBulkTransformScope(BulkTransform const& transform, int2 const& worldSize, float2 const& pos, int selected)
+{
+    if (BulkTransformScope::Selection == transform.scope) {
+        return 0 != selected;
+    }
+    if (BulkTransformScope::Region == transform.scope) {
+        return isInWrappedInterval(pos.x, transform.regionTopLeftX, transform.regionBottomRightX, worldSize.x)
+            && isInWrappedInterval(pos.y, transform.regionTopLeftY, transform.regionBottomRightY, worldSize.y);
+    }
+    return true;
+}
+
+__device__ __inline__ int getClusterColorCode(BulkTransform const& transform, Cell* root)
+{
+    //finalizer of splitmix64 applied to the id of the root cell
+    auto value = root->id + transform.seed + 0x9e3779b97f4a7c15ull;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    value = value ^ (value >> 31);
+    return transform.colorCodes[value % transform.numColorCodes];
+}
+
+__global__ void applyBulkTransformToCells(BulkTransform transform, SimulationData data)
+{
+    auto& cells = data.entities.cellPointers;
+    auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& cell = cells.at(index);
+        if (!isInBulkTransformScope(transform, data.size, cell->absPos, cell->selected)) {
+            continue;
+        }
+        if (BulkTransformOperation::SetColorByCluster == transform.operation) {
+            cell->metadata.color = getClusterColorCode(transform, cell->clusterParent);
+        }
+        if (BulkTransformOperation::ScaleEnergy == transform.operation) {
+            cell->energy *= transform.energyFactor;
+        }
+        if (BulkTransformOperation::RandomizeStaticByte == transform.operation
+            && transform.byteIndex < cell->numStaticBytes) {
+            cell->staticData[transform.byteIndex] = static_cast<char>(data.numberGen.random(255));
+            cell->computerProgram = nullptr;
+            cell->wakeUp();
+        }
+    }
+}
+
+__global__ void applyBulkTransformToTokens(BulkTransform transform, SimulationData data)
+{
+    auto& tokens = data.entities.tokenPointers;
+    auto const partition = calcAllThreadsPartition(tokens.getNumEntries());
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& token = tokens.at(index);
+        if (!isInBulkTransformScope(transform, data.size, token->cell->absPos, token->cell->selected)) {
+            continue;
+        }
+        if (BulkTransformOperation::ScaleEnergy == transform.operation) {
+            token->energy *= transform.energyFactor;
+        }
+        if (BulkTransformOperation::ResetTokenMemory == transform.operation) {
+            //first byte is the branch number which determines the path of the token
+            for (int i = 1; i < cudaSimulationParameters.tokenMemorySize; ++i) {
+                token->memory[i] = 0;
+            }
+        }
+    }
+}
+
+__global__ void applyBulkTransformToParticles(BulkTransform transform, SimulationData data)
+{
+    auto& particles = data.entities.particlePointers;
+    auto const partition = calcAllThreadsPartition(particles.getNumEntries());
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& particle = particles.at(index);
+        if (!isInBulkTransformScope(transform, data.size, particle->absPos, particle->selected)) {
+            continue;
+        }
+        if (BulkTransformOperation::ScaleEnergy == transform.operation) {
+            particle->energy *= transform.energyFactor;
+        }
+    }
+}
+
+/************************************************************************/
+/* Main      															*/
+/************************************************************************/
+
+__global__ void cudaApplyBulkTransform(BulkTransform transform, SimulationData data)
+{
+    switch (transform.operation) {
+    case BulkTransformOperation::SetColorByCluster:
+        KERNEL_CALL_1_1(updateClusterLabels, data.entities.cellPointers);
+        KERNEL_CALL(applyBulkTransformToCells, transform, data);
+        break;
+    case BulkTransformOperation::ScaleEnergy:
+        KERNEL_CALL(applyBulkTransformToCells, transform, data);
+        KERNEL_CALL(applyBulkTransformToTokens, transform, data);
+        KERNEL_CALL(applyBulkTransformToParticles, transform, data);
+        break;
+    case BulkTransformOperation::ResetTokenMemory:
+        KERNEL_CALL(applyBulkTransformToTokens, transform, data);
+        break;
+    case BulkTransformOperation::RandomizeStaticByte:
+        KERNEL_CALL(applyBulkTransformToCells, transform, data);
+        break;
+    }
+}
@@ -4,6 +4,7 @@
 
 #include "Base.cuh"
 #include "Definitions.cuh"
+#include "CellComputerProgram.cuh"
 
 struct CellMetadata
 {
@@ -41,14 +42,27 @@ struct Cell
     char staticData[MAX_CELL_STATIC_BYTES];
     unsigned char numMutableBytes;
     char mutableData[MAX_CELL_MUTABLE_BYTES];
+    CellComputerProgram* computerProgram;   //entry in entities.computerPrograms decoded from staticData on first use,
+                                            //nullptr = not decoded, has to be reset on changes of staticData
     int tokenUsages;
     CellMetadata metadata;
     float energy;
     int cellFunctionType;
+    int restingSteps;   //number of time steps the cell and its bonded surrounding have been resting
 
     //editing data
     int selected;   //0 = no, 1 = selected, 2 = indirectly selected
 
+    //cluster label (see ClusterLabelProcessor)
+    Cell* clusterParent;
+    int clusterNeedsUpdate;  //0 = no, 1 = bonds of the cluster have been removed
+
+    //neighbor list (see NeighborList)
+    Cell** neighbors;
+    int numNeighbors;   //-1 = not yet in the neighbor lists, -2 = use cell map, -3 = deleted
+    int neighborCapacity;
+    float2 neighborListPos;
+
     //temporary data
     int locked;	//0 = unlocked, 1 = locked
     int tag;
@@ -56,6 +70,8 @@ struct Cell
     float2 temp2;
     float2 temp3;
 
+    __device__ __inline__ void wakeUp() { restingSteps = 0; }
+
     __device__ __inline__ void getLock()
     {
         while (1 == atomicExch(&locked, 1)) {}
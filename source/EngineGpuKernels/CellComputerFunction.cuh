@@ -6,16 +6,14 @@
 #include "Cell.cuh"
 #include "Token.cuh"
 #include "AccessTOs.cuh"
+#include "CellComputerProgram.cuh"
 
 class CellComputerFunction
 {
 public:
-    __inline__ __device__ static void processing(Token* token);
+    __inline__ __device__ static void processing(Token* token, SimulationData& data);
 
 private:
-    __inline__ __device__ static void
-        readInstruction(char const* data, int& instructionPointer, InstructionCoded& instructionCoded);
-
     __inline__ __device__ static uint8_t convertToAddress(int8_t addr, uint32_t size);
 
     enum class MemoryType {
@@ -30,143 +28,124 @@ private:
 
 };
 
-__inline__ __device__ void CellComputerFunction::processing(Token* token)
+__inline__ __device__ void CellComputerFunction::processing(Token* token, SimulationData& data)
 {
     auto cell = token->cell;
-    bool condTable[MAX_CELL_STATIC_BYTES / 3 + 1];
-    int condPointer(0);
-    int numStaticBytes = min(cell->numStaticBytes, cudaSimulationParameters.cellFunctionComputerMaxInstructions * 3);
-    for (int instructionPointer = 0; instructionPointer < numStaticBytes; ) {
 
-        //decode instruction
-        InstructionCoded instruction;
-        readInstruction(cell->staticData, instructionPointer, instruction);
+    //the program is decoded into a temporary if the pool is exhausted until its next cleanup
+    CellComputerProgram temporaryProgram;
+    bool isDecoded = cell->computerProgram != nullptr;
+    if (!isDecoded) {
+        cell->computerProgram = data.entities.computerPrograms.tryGetNewElement();
+    }
+    auto& program = cell->computerProgram ? *cell->computerProgram : temporaryProgram;
+    if (!isDecoded
+        || !program.isValid(
+            cudaSimulationParameters.tokenMemorySize,
+            cudaSimulationParameters.cellFunctionComputerCellMemorySize,
+            cudaSimulationParameters.cellFunctionComputerMaxInstructions)) {
+        program.decode(
+            cell->staticData,
+            cell->numStaticBytes,
+            cudaSimulationParameters.tokenMemorySize,
+            cudaSimulationParameters.cellFunctionComputerCellMemorySize,
+            cudaSimulationParameters.cellFunctionComputerMaxInstructions);
+    }
+
+    for (int pc = 0; pc < program.numInstructions;) {
+        auto const& instruction = program.instructions[pc];
+
+        //a reached ELSE means that the condition of its block was true
+        if (instruction.operation == Enums::ComputerOperation::ELSE) {
+            pc = instruction.jumpIfFalse;
+            continue;
+        }
 
         //operand 1: pointer to mem
-        uint8_t opPointer1 = 0;
+        uint8_t opPointer1 = instruction.operand1;
         MemoryType memType = MemoryType::Token;
-        if (instruction.opType1 == Enums::ComputerOptype::MEM)
-            opPointer1 = convertToAddress(instruction.operand1, cudaSimulationParameters.tokenMemorySize);
         if (instruction.opType1 == Enums::ComputerOptype::MEMMEM) {
-            instruction.operand1 = token->memory[convertToAddress(instruction.operand1, cudaSimulationParameters.tokenMemorySize)];
-            opPointer1 = convertToAddress(instruction.operand1, cudaSimulationParameters.tokenMemorySize);
+            opPointer1 = convertToAddress(token->memory[opPointer1], cudaSimulationParameters.tokenMemorySize);
         }
         if (instruction.opType1 == Enums::ComputerOptype::CMEM) {
-            opPointer1 = convertToAddress(instruction.operand1, cudaSimulationParameters.cellFunctionComputerCellMemorySize);
             memType = MemoryType::Cell;
         }
 
         //operand 2: loading value
-        if (instruction.opType2 == Enums::ComputerOptype::MEM)
-            instruction.operand2 = token->memory[convertToAddress(instruction.operand2, cudaSimulationParameters.tokenMemorySize)];
+        uint8_t operand2 = instruction.operand2;
+        if (instruction.opType2 == Enums::ComputerOptype::MEM) {
+            operand2 = token->memory[operand2];
+        }
         if (instruction.opType2 == Enums::ComputerOptype::MEMMEM) {
-            instruction.operand2 = token->memory[convertToAddress(instruction.operand2, cudaSimulationParameters.tokenMemorySize)];
-            instruction.operand2 = token->memory[convertToAddress(instruction.operand2, cudaSimulationParameters.tokenMemorySize)];
+            operand2 = token->memory[operand2];
+            operand2 = token->memory[convertToAddress(operand2, cudaSimulationParameters.tokenMemorySize)];
         }
-        if (instruction.opType2 == Enums::ComputerOptype::CMEM)
-            instruction.operand2 = cell->mutableData[convertToAddress(instruction.operand2, cudaSimulationParameters.cellFunctionComputerCellMemorySize)];
-
-        //execute instruction
-        bool execute = true;
-        for (int k = 0; k < condPointer; ++k)
-            if (!condTable[k])
-                execute = false;
-        if (execute) {
-            if (instruction.operation == Enums::ComputerOperation::MOV)
-                setMemoryByte(token->memory, cell->mutableData, opPointer1, instruction.operand2, memType);
-            if (instruction.operation == Enums::ComputerOperation::ADD)
-                setMemoryByte(token->memory, cell->mutableData, opPointer1, getMemoryByte(token->memory, cell->mutableData, opPointer1, memType) + instruction.operand2, memType);
-            if (instruction.operation == Enums::ComputerOperation::SUB)
-                setMemoryByte(token->memory, cell->mutableData, opPointer1, getMemoryByte(token->memory, cell->mutableData, opPointer1, memType) - instruction.operand2, memType);
-            if (instruction.operation == Enums::ComputerOperation::MUL)
-                setMemoryByte(token->memory, cell->mutableData, opPointer1, getMemoryByte(token->memory, cell->mutableData, opPointer1, memType) * instruction.operand2, memType);
-            if (instruction.operation == Enums::ComputerOperation::DIV) {
-                if (instruction.operand2 > 0)
-                    setMemoryByte(token->memory, cell->mutableData, opPointer1, getMemoryByte(token->memory, cell->mutableData, opPointer1, memType) / instruction.operand2, memType);
-                else
-                    setMemoryByte(token->memory, cell->mutableData, opPointer1, 0, memType);
-            }
-            if (instruction.operation == Enums::ComputerOperation::XOR)
-                setMemoryByte(token->memory, cell->mutableData, opPointer1, getMemoryByte(token->memory, cell->mutableData, opPointer1, memType) ^ instruction.operand2, memType);
-            if (instruction.operation == Enums::ComputerOperation::OR)
-                setMemoryByte(token->memory, cell->mutableData, opPointer1, getMemoryByte(token->memory, cell->mutableData, opPointer1, memType) | instruction.operand2, memType);
-            if (instruction.operation == Enums::ComputerOperation::AND)
-                setMemoryByte(token->memory, cell->mutableData, opPointer1, getMemoryByte(token->memory, cell->mutableData, opPointer1, memType) & instruction.operand2, memType);
+        if (instruction.opType2 == Enums::ComputerOptype::CMEM) {
+            operand2 = cell->mutableData[operand2];
         }
 
         //if instructions
-        instruction.operand1 = getMemoryByte(token->memory, cell->mutableData, opPointer1, memType);
-        if (instruction.operation == Enums::ComputerOperation::IFG) {
-            if (instruction.operand1 > instruction.operand2)
-                condTable[condPointer] = true;
-            else
-                condTable[condPointer] = false;
-            condPointer++;
-        }
-        if (instruction.operation == Enums::ComputerOperation::IFGE) {
-            if (instruction.operand1 >= instruction.operand2)
-                condTable[condPointer] = true;
-            else
-                condTable[condPointer] = false;
-            condPointer++;
-        }
-        if (instruction.operation == Enums::ComputerOperation::IFE) {
-            if (instruction.operand1 == instruction.operand2)
-                condTable[condPointer] = true;
-            else
-                condTable[condPointer] = false;
-            condPointer++;
-        }
-        if (instruction.operation == Enums::ComputerOperation::IFNE) {
-            if (instruction.operand1 != instruction.operand2)
-                condTable[condPointer] = true;
-            else
-                condTable[condPointer] = false;
-            condPointer++;
-        }
-        if (instruction.operation == Enums::ComputerOperation::IFLE) {
-            if (instruction.operand1 <= instruction.operand2)
-                condTable[condPointer] = true;
-            else
-                condTable[condPointer] = false;
-            condPointer++;
-        }
-        if (instruction.operation == Enums::ComputerOperation::IFL) {
-            if (instruction.operand1 < instruction.operand2)
-                condTable[condPointer] = true;
-            else
-                condTable[condPointer] = false;
-            condPointer++;
-        }
-
-        if (instruction.operation == Enums::ComputerOperation::ELSE) {
-            if (condPointer > 0)
-                condTable[condPointer - 1] = !condTable[condPointer - 1];
+        if (instruction.operation >= Enums::ComputerOperation::IFG) {
+            auto operand1 = static_cast<uint8_t>(getMemoryByte(token->memory, cell->mutableData, opPointer1, memType));
+            bool condition = false;
+            switch (instruction.operation) {
+            case Enums::ComputerOperation::IFG:
+                condition = operand1 > operand2;
+                break;
+            case Enums::ComputerOperation::IFGE:
+                condition = operand1 >= operand2;
+                break;
+            case Enums::ComputerOperation::IFE:
+                condition = operand1 == operand2;
+                break;
+            case Enums::ComputerOperation::IFNE:
+                condition = operand1 != operand2;
+                break;
+            case Enums::ComputerOperation::IFLE:
+                condition = operand1 <= operand2;
+                break;
+            case Enums::ComputerOperation::IFL:
+                condition = operand1 < operand2;
+                break;
+            }
+            pc = condition ? pc + 1 : instruction.jumpIfFalse;
+            continue;
         }
 
-        if (instruction.operation == Enums::ComputerOperation::ENDIF) {
-            if (condPointer > 0)
-                condPointer--;
+        //execute instruction
+        auto operand1 = getMemoryByte(token->memory, cell->mutableData, opPointer1, memType);
+        char result = 0;
+        switch (instruction.operation) {
+        case Enums::ComputerOperation::MOV:
+            result = operand2;
+            break;
+        case Enums::ComputerOperation::ADD:
+            result = operand1 + operand2;
+            break;
+        case Enums::ComputerOperation::SUB:
+            result = operand1 - operand2;
+            break;
+        case Enums::ComputerOperation::MUL:
+            result = operand1 * operand2;
+            break;
+        case Enums::ComputerOperation::DIV:
+            result = operand2 > 0 ? operand1 / operand2 : 0;
+            break;
+        case Enums::ComputerOperation::XOR:
+            result = operand1 ^ operand2;
+            break;
+        case Enums::ComputerOperation::OR:
+            result = operand1 | operand2;
+            break;
+        case Enums::ComputerOperation::AND:
+            result = operand1 & operand2;
+            break;
         }
+        setMemoryByte(token->memory, cell->mutableData, opPointer1, result, memType);
+        ++pc;
     }
 }
 
-__inline__ __device__ void
-    CellComputerFunction::readInstruction(char const* data, int& instructionPointer, InstructionCoded& instructionCoded)
-{
-    //machine code: [INSTR - 4 Bits][MEM/ADDR/CMEM - 2 Bit][MEM/ADDR/CMEM/CONST - 2 Bit]
-    instructionCoded.operation =
-        static_cast<Enums::ComputerOperation::Type>((data[instructionPointer] >> 4) & 0xF);
-    instructionCoded.opType1 =
-        static_cast<Enums::ComputerOptype::Type>(((data[instructionPointer] >> 2) & 0x3) % 3);
-    instructionCoded.opType2 =
-        static_cast<Enums::ComputerOptype::Type>(data[instructionPointer] & 0x3);
-    instructionCoded.operand1 = data[instructionPointer + 1];
-    instructionCoded.operand2 = data[instructionPointer + 2];
-
-    instructionPointer += 3;
-}
-
 __inline__ __device__ uint8_t CellComputerFunction::convertToAddress(int8_t addr, uint32_t size)
 {
     auto t = static_cast<uint32_t>(static_cast<uint8_t>(addr));
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+
+#include "EngineInterface/ElementaryTypes.h"
+
+#include "AccessTOs.cuh"
+
+#define MAX_COMPUTER_INSTRUCTIONS (MAX_CELL_STATIC_BYTES / 3)
+
+//instruction with resolved operand addresses and conditional blocks resolved into jumps
+struct CellComputerInstruction
+{
+    uint8_t operation;  //Enums::ComputerOperation::Type, ENDIF is never contained
+    uint8_t opType1;    //Enums::ComputerOptype::Type
+    uint8_t opType2;    //Enums::ComputerOptype::Type
+    uint8_t operand1;   //address for MEM, MEMMEM (first indirection) and CMEM
+    uint8_t operand2;   //address for MEM, MEMMEM (first indirection) and CMEM, value for CONSTANT
+    uint8_t jumpIfFalse;    //for IF* and ELSE: instruction index after the block has been left
+};
+
+struct CellComputerProgram
+{
+    CellComputerInstruction instructions[MAX_COMPUTER_INSTRUCTIONS];
+    uint8_t numInstructions;
+
+    //decoding depends on cell static data and on following parameters
+    int16_t tokenMemorySize;
+    uint8_t cellMemorySize;
+    uint8_t maxInstructions;
+
+    __host__ __device__ __inline__ bool isValid(int tokenMemorySize_, int cellMemorySize_, int maxInstructions_) const
+    {
+        return tokenMemorySize == tokenMemorySize_ && cellMemorySize == cellMemorySize_
+            && maxInstructions == clampInstructions(maxInstructions_);
+    }
+
+    /**
+     * Decodes the machine code from the cell static data.
+     * The control flow of the conditional blocks does only depend on the instruction sequence and not on the memory.
+     * Thus the blocks are resolved into jumps: if a condition is false the execution continues after the next
+     * ELSE or ENDIF belonging to the same condition. ENDIFs and unmatched ELSEs have no effect and are removed.
+     */
+    __host__ __device__ __inline__ void decode(
+        char const* staticData,
+        int numStaticBytes,
+        int tokenMemorySize_,
+        int cellMemorySize_,
+        int maxInstructions_)
+    {
+        tokenMemorySize = static_cast<int16_t>(tokenMemorySize_);
+        cellMemorySize = static_cast<uint8_t>(cellMemorySize_);
+        maxInstructions = clampInstructions(maxInstructions_);
+
+        if (numStaticBytes > maxInstructions * 3) {
+            numStaticBytes = maxInstructions * 3;
+        }
+
+        int openBlocks[MAX_COMPUTER_INSTRUCTIONS];  //instruction indices of the last IF* or ELSE for each depth
+        int depth = 0;
+        numInstructions = 0;
+        for (int instructionPointer = 0; instructionPointer < numStaticBytes; instructionPointer += 3) {
+
+            //machine code: [INSTR - 4 Bits][MEM/ADDR/CMEM - 2 Bit][MEM/ADDR/CMEM/CONST - 2 Bit]
+            auto const code = static_cast<uint8_t>(staticData[instructionPointer]);
+            auto const operation = static_cast<uint8_t>((code >> 4) & 0xF);
+
+            if (operation == Enums::ComputerOperation::ENDIF) {
+                if (depth > 0) {
+                    --depth;
+                    instructions[openBlocks[depth]].jumpIfFalse = numInstructions;
+                }
+                continue;
+            }
+            if (operation == Enums::ComputerOperation::ELSE) {
+                if (depth > 0) {
+                    auto& instruction = instructions[numInstructions];
+                    instruction.operation = operation;
+                    instructions[openBlocks[depth - 1]].jumpIfFalse = numInstructions + 1;
+                    openBlocks[depth - 1] = numInstructions;
+                    ++numInstructions;
+                }
+                continue;
+            }
+
+            auto& instruction = instructions[numInstructions];
+            instruction.operation = operation;
+            instruction.opType1 = static_cast<uint8_t>(((code >> 2) & 0x3) % 3);
+            instruction.opType2 = static_cast<uint8_t>(code & 0x3);
+            instruction.operand1 = static_cast<uint8_t>(staticData[instructionPointer + 1]);
+            instruction.operand2 = static_cast<uint8_t>(staticData[instructionPointer + 2]);
+
+            instruction.operand1 = instruction.opType1 == Enums::ComputerOptype::CMEM
+                ? convertToAddress(instruction.operand1, cellMemorySize_)
+                : convertToAddress(instruction.operand1, tokenMemorySize_);
+            if (instruction.opType2 == Enums::ComputerOptype::CMEM) {
+                instruction.operand2 = convertToAddress(instruction.operand2, cellMemorySize_);
+            } else if (instruction.opType2 != Enums::ComputerOptype::CONSTANT) {
+                instruction.operand2 = convertToAddress(instruction.operand2, tokenMemorySize_);
+            }
+
+            if (operation >= Enums::ComputerOperation::IFG) {
+                openBlocks[depth++] = numInstructions;
+            }
+            ++numInstructions;
+        }
+
+        //conditions which are never closed skip the rest of the program
+        for (int i = 0; i < depth; ++i) {
+            instructions[openBlocks[i]].jumpIfFalse = numInstructions;
+        }
+    }
+
+    __host__ __device__ __inline__ static uint8_t clampInstructions(int maxInstructions_)
+    {
+        return static_cast<uint8_t>(maxInstructions_ < MAX_COMPUTER_INSTRUCTIONS ? maxInstructions_ : MAX_COMPUTER_INSTRUCTIONS);
+    }
+
+    __host__ __device__ __inline__ static uint8_t convertToAddress(uint8_t addr, int size)
+    {
+        return static_cast<uint8_t>(static_cast<uint32_t>(addr) % static_cast<uint32_t>(size));
+    }
+};
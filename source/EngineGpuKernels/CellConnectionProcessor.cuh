@@ -1,7 +1,9 @@
 ﻿#pragma once
 
 #include "Base.cuh"
+#include "ClusterLabelProcessor.cuh"
 #include "Definitions.cuh"
+#include "EntityFactory.cuh"
 #include "SimulationData.cuh"
 #include "ConstantMemory.cuh"
 #include "SpotCalculator.cuh"
@@ -27,6 +29,8 @@ public:
         float desiredDistance,
         int angleAlignment = 0);
     __inline__ __device__ static void delConnections(Cell* cell1, Cell* cell2);
+    //the connection from cell2 to cell1 has to be removed separately
+    __inline__ __device__ static void delConnectionOneWay(Cell* cell1, Cell* cell2);
 
 private:
     __inline__ __device__ static void addConnectionsIntern(SimulationData& data, Cell* cell1, Cell* cell2, bool addTokens);
@@ -41,7 +45,6 @@ private:
 
     __inline__ __device__ static void delConnectionsIntern(Cell* cell);
     __inline__ __device__ static void delConnectionIntern(Cell* cell1, Cell* cell2);
-    __inline__ __device__ static void delConnectionOneWay(Cell* cell1, Cell* cell2);
 
     __inline__ __device__ static void delCell(SimulationData& data, Cell* cell, int cellIndex);
 };
@@ -172,6 +175,7 @@ __inline__ __device__ void CellConnectionProcessor::addConnections(
     data.cellMap.mapDisplacementCorrection(posDelta);
     addConnectionIntern(data, cell1, cell2, posDelta, desiredDistance, desiredAngleOnCell1, angleAlignment);
     addConnectionIntern(data, cell2, cell1, posDelta * (-1), desiredDistance, desiredAngleOnCell2, angleAlignment);
+    ClusterLabelProcessor::unite(cell1, cell2);
 }
 
 __inline__ __device__ void
@@ -203,6 +207,7 @@ CellConnectionProcessor::addConnectionsIntern(SimulationData& data, Cell* cell1,
             data.cellMap.mapDisplacementCorrection(posDelta);
             addConnectionIntern(data, cell1, cell2, posDelta, Math::length(posDelta));
             addConnectionIntern(data, cell2, cell1, posDelta * (-1), Math::length(posDelta));
+            ClusterLabelProcessor::unite(cell1, cell2);
 
             if (addTokens) {
                 EntityFactory factory;
@@ -238,6 +243,7 @@ __inline__ __device__ void CellConnectionProcessor::addConnectionIntern(
     float desiredAngleOnCell1,
     int angleAlignment)
 {
+    cell1->wakeUp();
     auto newAngle = Math::angleOfVector(posDelta);
 
     if (0 == cell1->numConnections) {
@@ -371,6 +377,8 @@ __inline__ __device__ void CellConnectionProcessor::delConnectionOneWay(Cell* ce
             }
 
             --cell1->numConnections;
+            cell1->wakeUp();
+            ClusterLabelProcessor::markForUpdate(cell1);
             return;
         }
     }
@@ -387,6 +395,7 @@ __inline__ __device__ void CellConnectionProcessor::delCell(SimulationData& data
             cell->energy = 0;
 
             data.entities.cellPointers.at(cellIndex) = nullptr;
+            NeighborList::markAsDeleted(cell);
         }
 
         cell->releaseLock();
@@ -27,7 +27,13 @@ public:
     __inline__ __device__ void radiation(SimulationData& data);
     __inline__ __device__ void decay(SimulationData& data);
 
+    //cells which have been resting with their bonded neighbors for cellSleepingSteps are skipped in the physics
+    __inline__ __device__ void calcRestingSteps(SimulationData& data);     //prerequisite: tag from token movement
+    __inline__ __device__ void applyRestingSteps(SimulationData& data);    //prerequisite: calcRestingSteps
+
 private:
+    __inline__ __device__ static bool isSleeping(Cell* cell);
+
     SimulationData* _data;
     PartitionData _partition;
 };
@@ -77,7 +83,11 @@ __inline__ __device__ void CellProcessor::collisions(SimulationData& data)
     int numOtherCells;
     for (int index = _partition.startIndex; index <= _partition.endIndex; ++index) {
         auto& cell = cells.at(index);
-        data.cellMap.get(otherCells, numOtherCells, cell->absPos);
+        if (isSleeping(cell)) {
+            continue;
+        }
+        data.neighborList.get(
+            otherCells, 18, numOtherCells, cell, cudaSimulationParameters.cellMaxCollisionDistance, data.cellMap);
         for (int i = 0; i < numOtherCells; ++i) {
             Cell* otherCell = otherCells[i];
 
@@ -111,6 +121,10 @@ __inline__ __device__ void CellProcessor::collisions(SimulationData& data)
                 auto velDelta = cell->vel - otherCell->vel;
                 auto isApproaching = Math::dot(posDelta, velDelta) < 0;
 
+                if (isSleeping(otherCell) && Math::length(velDelta) >= cudaSimulationParameters.cellSleepingMaxVel) {
+                    otherCell->wakeUp();
+                }
+
                 if (Math::length(cell->vel) > 0.5f /* && cell->numConnections == 0 && */ && isApproaching) {
                     auto distanceSquared = distance * distance + 0.25;
                     auto force1 = posDelta * Math::dot(velDelta, posDelta) / (-2 * distanceSquared);
@@ -178,6 +192,14 @@ __inline__ __device__ void CellProcessor::applyAndCheckForces(SimulationData& da
         auto& cell = cells.at(index);
 
         auto force = cell->temp1;
+        if (isSleeping(cell)) {
+            if (Math::length(force) < cudaSimulationParameters.cellSleepingMaxForce) {
+                cell->temp1 = {0, 0};
+                continue;
+            }
+            cell->wakeUp();
+        }
+
         if (Math::length(force)
             > SpotCalculator::calc(&SimulationParametersSpotValues::cellMaxForce, data, cell->absPos)) {
             if(data.numberGen.random() < cudaSimulationParameters.cellMaxForceDecayProb) {
@@ -201,7 +223,7 @@ __inline__ __device__ void CellProcessor::calcForces(SimulationData& data)
 
     for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
         auto& cell = cells.at(index);
-        if (0 == cell->numConnections) {
+        if (0 == cell->numConnections || isSleeping(cell)) {
             continue;
         }
         float2 force{0, 0};
@@ -268,6 +290,11 @@ __inline__ __device__ void CellProcessor::calcPositionsAndCheckBindings(Simulati
 
     for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
         auto& cell = cells.at(index);
+        if (isSleeping(cell)) {
+            cell->temp1 = {0, 0};
+            cell->temp2 = {0, 0};
+            continue;
+        }
 
         cell->absPos = cell->absPos + cell->vel * cudaSimulationParameters.timestepSize
             + cell->temp1 * cudaSimulationParameters.timestepSize * cudaSimulationParameters.timestepSize / 2;
@@ -301,6 +328,9 @@ __inline__ __device__ void CellProcessor::calcVelocities(SimulationData& data, i
 
     for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
         auto& cell = cells.at(index);
+        if (isSleeping(cell)) {
+            continue;
+        }
 
         auto acceleration = (cell->temp1 + cell->temp2) / 2;
         cell->vel = cell->vel + acceleration * cudaSimulationParameters.timestepSize;
@@ -316,6 +346,9 @@ __inline__ __device__ void CellProcessor::calcAveragedVelocities(SimulationData&
     constexpr float preserveVelocityFactor = 0.8f;
     for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
         auto& cell = cells.at(index);
+        if (isSleeping(cell)) {
+            continue;
+        }
         auto averagedVel = cell->vel * (1.0f - preserveVelocityFactor);
         for (int index = 0; index < cell->numConnections; ++index) {
             auto connectingCell = cell->connections[index].cell;
@@ -333,6 +366,9 @@ __inline__ __device__ void CellProcessor::applyAveragedVelocities(SimulationData
 
     for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
         auto& cell = cells.at(index);
+        if (isSleeping(cell)) {
+            continue;
+        }
 
         auto friction = SpotCalculator::calc(&SimulationParametersSpotValues::friction, data, cell->absPos);
         cell->vel = cell->temp1 * (1.0f - friction);
@@ -408,3 +444,45 @@ __inline__ __device__ void CellProcessor::decay(SimulationData& data)
     }
 }
 
+__inline__ __device__ void CellProcessor::calcRestingSteps(SimulationData& data)
+{
+    auto& cells = data.entities.cellPointers;
+    auto const partition =
+        calcPartition(cells.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& cell = cells.at(index);
+
+        //a cell rests if it is slow and no token has arrived in this time step
+        auto isResting = 0 == cell->tag && Math::length(cell->vel) < cudaSimulationParameters.cellSleepingMaxVel;
+        if (!isResting || 0 == cudaSimulationParameters.cellSleepingSteps) {
+            cell->tag = 0;
+            continue;
+        }
+
+        //taking the minimum of the bonded neighbors lets connected cells fall asleep and wake up together
+        auto restingSteps = cell->restingSteps;
+        for (int i = 0; i < cell->numConnections; ++i) {
+            restingSteps = min(restingSteps, cell->connections[i].cell->restingSteps);
+        }
+        cell->tag = min(restingSteps + 1, cudaSimulationParameters.cellSleepingSteps);
+    }
+}
+
+__inline__ __device__ void CellProcessor::applyRestingSteps(SimulationData& data)
+{
+    auto& cells = data.entities.cellPointers;
+    auto const partition =
+        calcPartition(cells.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& cell = cells.at(index);
+        cell->restingSteps = cell->tag;
+    }
+}
+
+__inline__ __device__ bool CellProcessor::isSleeping(Cell* cell)
+{
+    return cudaSimulationParameters.cellSleepingSteps > 0
+        && cell->restingSteps >= cudaSimulationParameters.cellSleepingSteps;
+}
@@ -5,7 +5,9 @@
 
 #include "SimulationData.cuh"
 #include "Cell.cuh"
+#include "ClusterLabelProcessor.cuh"
 #include "Token.cuh"
+#include "SpatialIndexKernels.cuh"
 
 template<typename Entity>
 __global__ void cleanupEntities(Array<Entity> entityArray, Array<Entity> newEntityArray)
@@ -83,6 +85,7 @@ __global__ void cleanupCellsStep1(Array<Cell*> cellPointers, Array<Cell> cells)
             auto& cellPointer = cellPointers.at(index);
             auto& newCell = newCells[newCellIndex];
             newCell = *cellPointer;
+            ClusterLabelProcessor::init(&newCell, true);    //parents may refer to removed cells
 
             cellPointer->tag = &newCell - cells.getArray();    //save index of new cell in old cell
             cellPointer = &newCell;
@@ -119,19 +122,47 @@ __global__ void cleanupCellsStep2(Array<Token*> tokenPointers, Array<Cell> cells
     }
 }
 
-__global__ void cleanupTokens(Array<Token*> tokenPointers, Array<Token> newToken)
+//programs of removed cells and invalidated programs are dropped
+__global__ void cleanupComputerPrograms(Array<Cell*> cellPointers, Array<CellComputerProgram> newComputerPrograms)
+{
+    auto partition =
+        calcPartition(cellPointers.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& cell = cellPointers.at(index);
+        if (cell->computerProgram) {
+            auto newComputerProgram = newComputerPrograms.getNewElement();
+            *newComputerProgram = *cell->computerProgram;
+            cell->computerProgram = newComputerProgram;
+        }
+    }
+}
+
+__global__ void cleanupTokens(
+    Array<Token*> tokenPointers,
+    Array<Token> newToken,
+    Array<char> newTokenMemory,
+    int tokenMemorySize,
+    int newTokenMemorySize)
 {
     auto partition =
         calcPartition(tokenPointers.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
 
     if (partition.numElements() > 0) {
         Token* newEntities = newToken.getNewSubarray(partition.numElements());
+        auto newMemorySize = static_cast<uint64_t>(partition.numElements()) * newTokenMemorySize;
+        char* newMemory = newTokenMemory.getNewSubarray(static_cast<int>(newMemorySize));
 
         int targetIndex = 0;
         for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
             auto& token = tokenPointers.at(index);
-            newEntities[targetIndex] = *token;
-            token = &newEntities[targetIndex];
+            auto& newTokenEntity = newEntities[targetIndex];
+            newTokenEntity = *token;
+            newTokenEntity.memory = newMemory + static_cast<uint64_t>(targetIndex) * newTokenMemorySize;
+            for (int i = 0; i < newTokenMemorySize; ++i) {
+                newTokenEntity.memory[i] = i < tokenMemorySize ? token->memory[i] : 0;
+            }
+            token = &newTokenEntity;
             ++targetIndex;
         }
     }
@@ -201,6 +232,7 @@ __global__ void cleanupMetadata(Array<Cluster*> clusterPointers, DynamicMemory s
 
 __global__ void cleanupAfterSimulationKernel(SimulationData data)
 {
+    data.spatialIndex.invalidate();
     KERNEL_CALL(cleanupCellMap, data);
     KERNEL_CALL(cleanupParticleMap, data);
 
@@ -232,10 +264,28 @@ __global__ void cleanupAfterSimulationKernel(SimulationData data)
         
     if (data.entities.tokens.getNumEntries() > data.entities.tokens.getSize() * Const::ArrayFillLevelFactor) {
         data.entitiesForCleanup.tokens.reset();
-        KERNEL_CALL(cleanupTokens, data.entities.tokenPointers, data.entitiesForCleanup.tokens);
+        data.entitiesForCleanup.tokenMemory.reset();
+        KERNEL_CALL(
+            cleanupTokens,
+            data.entities.tokenPointers,
+            data.entitiesForCleanup.tokens,
+            data.entitiesForCleanup.tokenMemory,
+            data.tokenMemorySize,
+            data.tokenMemorySize);
         data.entities.tokens.swapContent(data.entitiesForCleanup.tokens);
+        data.entities.tokenMemory.swapContent(data.entitiesForCleanup.tokenMemory);
+    }
+
+    if (data.entities.computerPrograms.getNumEntries()
+        > data.entities.computerPrograms.getSize() * Const::ArrayFillLevelFactor) {
+        data.entitiesForCleanup.computerPrograms.reset();
+        KERNEL_CALL(cleanupComputerPrograms, data.entities.cellPointers, data.entitiesForCleanup.computerPrograms);
+        data.entities.computerPrograms.swapContent(data.entitiesForCleanup.computerPrograms);
     }
 
+    //the index is rebuilt after the entities have been moved such that queries between time steps can use it directly
+    KERNEL_CALL_1_1(updateSpatialIndex, data);
+
     /*
         if (data.entities.strings.getNumBytes() > cudaConstants.METADATA_DYNAMIC_MEMORY_SIZE * Const::FillLevelFactor) {
             data.entitiesForCleanup.strings.reset();
@@ -247,6 +297,9 @@ __global__ void cleanupAfterSimulationKernel(SimulationData data)
 
 __global__ void cleanupAfterDataManipulationKernel(SimulationData data)
 {
+    data.spatialIndex.invalidate();
+    data.neighborList.invalidate();
+
     data.entitiesForCleanup.particlePointers.reset();
     KERNEL_CALL(
         cleanupEntities<Particle*>, data.entities.particlePointers, data.entitiesForCleanup.particlePointers);
@@ -270,8 +323,20 @@ __global__ void cleanupAfterDataManipulationKernel(SimulationData data)
     data.entities.cells.swapContent(data.entitiesForCleanup.cells);
 
     data.entitiesForCleanup.tokens.reset();
-    KERNEL_CALL(cleanupTokens, data.entities.tokenPointers, data.entitiesForCleanup.tokens);
+    data.entitiesForCleanup.tokenMemory.reset();
+    KERNEL_CALL(
+        cleanupTokens,
+        data.entities.tokenPointers,
+        data.entitiesForCleanup.tokens,
+        data.entitiesForCleanup.tokenMemory,
+        data.tokenMemorySize,
+        data.tokenMemorySize);
     data.entities.tokens.swapContent(data.entitiesForCleanup.tokens);
+    data.entities.tokenMemory.swapContent(data.entitiesForCleanup.tokenMemory);
+
+    data.entitiesForCleanup.computerPrograms.reset();
+    KERNEL_CALL(cleanupComputerPrograms, data.entities.cellPointers, data.entitiesForCleanup.computerPrograms);
+    data.entities.computerPrograms.swapContent(data.entitiesForCleanup.computerPrograms);
 
     data.entitiesForCleanup.strings.reset();
 /*
@@ -280,8 +345,9 @@ __global__ void cleanupAfterDataManipulationKernel(SimulationData data)
 */
 }
 
-__global__ void cudaCopyEntities(SimulationData data)
+__global__ void cudaCopyEntities(SimulationData data, int newTokenMemorySize)
 {
+    data.spatialIndex.invalidate();
     data.entitiesForCleanup.particlePointers.reset();
     KERNEL_CALL(cleanupEntities<Particle*>, data.entities.particlePointers, data.entitiesForCleanup.particlePointers);
 
@@ -299,5 +365,16 @@ __global__ void cudaCopyEntities(SimulationData data)
     KERNEL_CALL(cleanupCellsStep2, data.entitiesForCleanup.tokenPointers, data.entitiesForCleanup.cells);
 
     data.entitiesForCleanup.tokens.reset();
-    KERNEL_CALL(cleanupTokens, data.entitiesForCleanup.tokenPointers, data.entitiesForCleanup.tokens);
+    data.entitiesForCleanup.tokenMemory.reset();
+    KERNEL_CALL(
+        cleanupTokens,
+        data.entitiesForCleanup.tokenPointers,
+        data.entitiesForCleanup.tokens,
+        data.entitiesForCleanup.tokenMemory,
+        data.tokenMemorySize,
+        newTokenMemorySize);
+
+    data.entitiesForCleanup.computerPrograms.reset();
+    KERNEL_CALL(
+        cleanupComputerPrograms, data.entitiesForCleanup.cellPointers, data.entitiesForCleanup.computerPrograms);
 }
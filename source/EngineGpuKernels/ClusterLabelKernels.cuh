@@ -0,0 +1,64 @@
+#pragma once
+
+#include "cuda_runtime_api.h"
+#include "sm_60_atomic_functions.h"
+
+#include "Base.cuh"
+#include "ClusterLabelProcessor.cuh"
+#include "ConstantMemory.cuh"
+
+//tags cells whose cluster label has to be rebuilt
+__global__ void tagClusterLabelsForUpdate(Array<Cell*> cells)
+{
+    auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& cell = cells.at(index);
+        cell->tag = ClusterLabelProcessor::needsUpdate(cell) ? 1 : 0;
+    }
+}
+
+__global__ void resetClusterLabels(Array<Cell*> cells)
+{
+    auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& cell = cells.at(index);
+        if (1 == cell->tag) {
+            ClusterLabelProcessor::init(cell, false);
+        }
+    }
+}
+
+__global__ void uniteClusterLabels(Array<Cell*> cells)
+{
+    auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& cell = cells.at(index);
+        if (1 == cell->tag) {
+            for (int i = 0; i < cell->numConnections; ++i) {
+                ClusterLabelProcessor::unite(cell, cell->connections[i].cell);
+            }
+        }
+    }
+}
+
+__global__ void compressClusterLabels(Array<Cell*> cells)
+{
+    auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& cell = cells.at(index);
+        cell->clusterParent = ClusterLabelProcessor::findRoot(cell);
+    }
+}
+
+/************************************************************************/
+/* Main      															*/
+/************************************************************************/
+
+//afterwards cell->clusterParent points directly to the root of the cluster
+__global__ void updateClusterLabels(Array<Cell*> cells)
+{
+    KERNEL_CALL(tagClusterLabelsForUpdate, cells);
+    KERNEL_CALL(resetClusterLabels, cells);
+    KERNEL_CALL(uniteClusterLabels, cells);
+    KERNEL_CALL(compressClusterLabels, cells);
+}
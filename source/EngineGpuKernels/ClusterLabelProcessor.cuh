@@ -0,0 +1,108 @@
+#pragma once
+
+#include "cuda_runtime_api.h"
+#include "sm_60_atomic_functions.h"
+
+#include "Base.cuh"
+#include "Cell.cuh"
+#include "Swap.cuh"
+
+/**
+ * Maintains a concurrent union-find structure over the cells such that all cells of a cluster lead to the same root
+ * cell. Created bonds unite the trees immediately. Removed bonds can split a cluster, which is why they only mark the
+ * tree for an update. The marked trees are rebuilt lazily before clusters are queried (see updateClusterLabels).
+ */
+class ClusterLabelProcessor
+{
+public:
+    __inline__ __device__ static void init(Cell* cell, bool needsUpdate);
+
+    __inline__ __device__ static Cell* findRoot(Cell* cell);
+    __inline__ __device__ static void unite(Cell* cell1, Cell* cell2);
+    __inline__ __device__ static void markForUpdate(Cell* cell);
+    __inline__ __device__ static bool needsUpdate(Cell* cell);
+
+private:
+    __inline__ __device__ static Cell* getParent(Cell* cell);
+    __inline__ __device__ static bool exchangeParent(Cell* cell, Cell* expectedParent, Cell* newParent);
+};
+
+/************************************************************************/
+/* Implementation                                                       */
+/************************************************************************/
+
+__inline__ __device__ void ClusterLabelProcessor::init(Cell* cell, bool needsUpdate)
+{
+    cell->clusterParent = cell;
+    cell->clusterNeedsUpdate = needsUpdate ? 1 : 0;
+}
+
+__inline__ __device__ Cell* ClusterLabelProcessor::findRoot(Cell* cell)
+{
+    //path halving: concurrent callers can only shorten the paths
+    while (true) {
+        auto parent = getParent(cell);
+        if (parent == cell) {
+            return cell;
+        }
+        auto grandParent = getParent(parent);
+        if (grandParent != parent) {
+            exchangeParent(cell, parent, grandParent);
+        }
+        cell = grandParent;
+    }
+}
+
+__inline__ __device__ void ClusterLabelProcessor::unite(Cell* cell1, Cell* cell2)
+{
+    while (true) {
+        auto root1 = findRoot(cell1);
+        auto root2 = findRoot(cell2);
+        if (root1 == root2) {
+            return;
+        }
+
+        //linking in a fixed order prevents cycles
+        if (root1 < root2) {
+            swap(root1, root2);
+        }
+        if (exchangeParent(root1, root1, root2)) {
+            return;
+        }
+    }
+}
+
+//the mark remains on the paths of all cells of the tree even if the root is linked concurrently
+__inline__ __device__ void ClusterLabelProcessor::markForUpdate(Cell* cell)
+{
+    atomicExch(&findRoot(cell)->clusterNeedsUpdate, 1);
+}
+
+__inline__ __device__ bool ClusterLabelProcessor::needsUpdate(Cell* cell)
+{
+    while (true) {
+        if (1 == atomicAdd(&cell->clusterNeedsUpdate, 0)) {
+            return true;
+        }
+        auto parent = getParent(cell);
+        if (parent == cell) {
+            return false;
+        }
+        cell = parent;
+    }
+}
+
+__inline__ __device__ Cell* ClusterLabelProcessor::getParent(Cell* cell)
+{
+    return *reinterpret_cast<Cell* volatile*>(&cell->clusterParent);
+}
+
+__inline__ __device__ bool ClusterLabelProcessor::exchangeParent(Cell* cell, Cell* expectedParent, Cell* newParent)
+{
+    auto expected = reinterpret_cast<unsigned long long int>(expectedParent);
+    auto origParent = atomicCAS(
+        reinterpret_cast<unsigned long long int*>(&cell->clusterParent),
+        expected,
+        reinterpret_cast<unsigned long long int>(newParent));
+    return origParent == expected;
+}
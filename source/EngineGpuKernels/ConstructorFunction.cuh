@@ -415,16 +415,18 @@ __inline__ __device__ void ConstructorFunction::constructCell(
     auto offset = result->numStaticBytes + 1;
     result->numMutableBytes =
         static_cast<unsigned char>(
-            token->memory[(Enums::Constr::IN_CELL_FUNCTION_DATA + offset) % MAX_TOKEN_MEM_SIZE])
+            token->memory[(Enums::Constr::IN_CELL_FUNCTION_DATA + offset) % cudaSimulationParameters.tokenMemorySize])
         % (MAX_CELL_MUTABLE_BYTES + 1);
     result->metadata.color = constructionData.metaData;
 
     for (int i = 0; i < result->numStaticBytes; ++i) {
-        result->staticData[i] = token->memory[(Enums::Constr::IN_CELL_FUNCTION_DATA + i + 1) % MAX_TOKEN_MEM_SIZE];
+        result->staticData[i] =
+            token->memory[(Enums::Constr::IN_CELL_FUNCTION_DATA + i + 1) % cudaSimulationParameters.tokenMemorySize];
     }
     for (int i = 0; i <= result->numMutableBytes; ++i) {
         result->mutableData[i] =
-            token->memory[(Enums::Constr::IN_CELL_FUNCTION_DATA + offset + i + 1) % MAX_TOKEN_MEM_SIZE];
+            token->memory
+                [(Enums::Constr::IN_CELL_FUNCTION_DATA + offset + i + 1) % cudaSimulationParameters.tokenMemorySize];
     }
 }
 
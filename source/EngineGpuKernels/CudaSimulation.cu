@@ -19,6 +19,7 @@
 #include "AccessKernels.cuh"
 #include "AccessTOs.cuh"
 #include "Base.cuh"
+#include "BulkTransformKernels.cuh"
 #include "CleanupKernels.cuh"
 #include "ConstantMemory.cuh"
 #include "CudaMemoryManager.cuh"
@@ -31,6 +32,8 @@
 #include "SimulationData.cuh"
 #include "SimulationKernels.cuh"
 #include "SimulationResult.cuh"
+#include "TileHashKernels.cuh"
+#include "WorldResizeKernels.cuh"
 #include "SelectionResult.cuh"
 #include "RenderingData.cuh"
 
@@ -127,10 +130,11 @@ _CudaSimulation::_CudaSimulation(uint64_t timestep, Settings const& settings, Gp
     _cudaSimulationResult = new SimulationResult();
     _cudaSelectionResult = new SelectionResult();
     _cudaAccessTO = new DataAccessTO();
+    _cudaOverlayTO = new OverlayAccessTO();
     _cudaMonitorData = new CudaMonitorData();
 
     int2 worldSize{settings.generalSettings.worldSizeX, settings.generalSettings.worldSizeY};
-    _cudaSimulationData->init(worldSize);
+    _cudaSimulationData->init(worldSize, calcTokenMemorySize(settings.simulationParameters));
     _cudaRenderingData->init();
     _cudaMonitorData->init();
     _cudaSimulationResult->init();
@@ -141,6 +145,9 @@ _CudaSimulation::_CudaSimulation(uint64_t timestep, Settings const& settings, Gp
     CudaMemoryManager::getInstance().acquireMemory<int>(1, _cudaAccessTO->numTokens);
     CudaMemoryManager::getInstance().acquireMemory<int>(1, _cudaAccessTO->numStringBytes);
     CudaMemoryManager::getInstance().acquireMemory<char>(Const::MetadataMemorySize, _cudaAccessTO->stringBytes);
+    CudaMemoryManager::getInstance().acquireMemory<int>(1, _cudaOverlayTO->numElements);
+    CudaMemoryManager::getInstance().acquireMemory<OverlayElementAccessTO>(
+        Const::MaxOverlayElements, _cudaOverlayTO->elements);
 
     //default array sizes for empty simulation (will be resized later if not sufficient)
     resizeArrays({100000, 100000, 10000});
@@ -157,16 +164,20 @@ _CudaSimulation::~_CudaSimulation()
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->cells);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->particles);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->tokens);
+    CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->tokenMemory);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->stringBytes);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->numCells);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->numParticles);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->numTokens);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->numStringBytes);
+    CudaMemoryManager::getInstance().freeMemory(_cudaOverlayTO->numElements);
+    CudaMemoryManager::getInstance().freeMemory(_cudaOverlayTO->elements);
 
     auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
     loggingService->logMessage(Priority::Important, "close simulation");
 
     delete _cudaAccessTO;
+    delete _cudaOverlayTO;
     delete _cudaSimulationData;
     delete _cudaRenderingData;
     delete _cudaMonitorData;
@@ -227,6 +238,32 @@ void _CudaSimulation::drawVectorGraphics(
     CHECK_FOR_CUDA_ERROR(cudaGraphicsUnmapResources(1, &cudaResourceImpl));
 }
 
+void _CudaSimulation::drawVectorGraphicsToHost(
+    float2 const& rectUpperLeft,
+    float2 const& rectLowerRight,
+    int2 const& imageSize,
+    double zoom,
+    uint32_t* targetImage)
+{
+    _cudaRenderingData->resizeImageIfNecessary(imageSize);
+
+    KERNEL_CALL_HOST(
+        drawImageKernel,
+        rectUpperLeft,
+        rectLowerRight,
+        imageSize,
+        static_cast<float>(zoom),
+        *_cudaSimulationData,
+        *_cudaRenderingData);
+    KERNEL_CALL_HOST(convertImageToRgbaKernel, imageSize, *_cudaRenderingData);
+
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+        targetImage,
+        _cudaRenderingData->rgbaImageData,
+        sizeof(uint32_t) * imageSize.x * imageSize.y,
+        cudaMemcpyDeviceToHost));
+}
+
 void _CudaSimulation::getSimulationData(
     int2 const& rectUpperLeft,
     int2 const& rectLowerRight,
@@ -251,6 +288,11 @@ void _CudaSimulation::getSimulationData(
         cudaMemcpyDeviceToHost));
     CHECK_FOR_CUDA_ERROR(cudaMemcpy(
         dataTO.tokens, _cudaAccessTO->tokens, sizeof(TokenAccessTO) * (*dataTO.numTokens), cudaMemcpyDeviceToHost));
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+        dataTO.tokenMemory,
+        _cudaAccessTO->tokenMemory,
+        sizeof(char) * (*dataTO.numTokens) * _cudaAccessTO->tokenMemorySize,
+        cudaMemcpyDeviceToHost));
     CHECK_FOR_CUDA_ERROR(cudaMemcpy(
         dataTO.stringBytes,
         _cudaAccessTO->stringBytes,
@@ -277,6 +319,11 @@ void _CudaSimulation::getSelectedSimulationData(bool includeClusters, DataAccess
         cudaMemcpyDeviceToHost));
     CHECK_FOR_CUDA_ERROR(cudaMemcpy(
         dataTO.tokens, _cudaAccessTO->tokens, sizeof(TokenAccessTO) * (*dataTO.numTokens), cudaMemcpyDeviceToHost));
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+        dataTO.tokenMemory,
+        _cudaAccessTO->tokenMemory,
+        sizeof(char) * (*dataTO.numTokens) * _cudaAccessTO->tokenMemorySize,
+        cudaMemcpyDeviceToHost));
     CHECK_FOR_CUDA_ERROR(cudaMemcpy(
         dataTO.stringBytes,
         _cudaAccessTO->stringBytes,
@@ -284,20 +331,20 @@ void _CudaSimulation::getSelectedSimulationData(bool includeClusters, DataAccess
         cudaMemcpyDeviceToHost));
 }
 
-void _CudaSimulation::getOverlayData(int2 const& rectUpperLeft, int2 const& rectLowerRight, DataAccessTO const& dataTO)
+int _CudaSimulation::calcOverlayData(int2 const& rectUpperLeft, int2 const& rectLowerRight)
 {
     KERNEL_CALL_HOST(
-        cudaGetSimulationOverlayDataKernel, rectUpperLeft, rectLowerRight, *_cudaSimulationData, *_cudaAccessTO);
-    CHECK_FOR_CUDA_ERROR(cudaMemcpy(dataTO.numCells, _cudaAccessTO->numCells, sizeof(int), cudaMemcpyDeviceToHost));
-    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
-        dataTO.cells, _cudaAccessTO->cells, sizeof(CellAccessTO) * (*dataTO.numCells), cudaMemcpyDeviceToHost));
-    CHECK_FOR_CUDA_ERROR(
-        cudaMemcpy(dataTO.numParticles, _cudaAccessTO->numParticles, sizeof(int), cudaMemcpyDeviceToHost));
+        cudaGetSimulationOverlayDataKernel, rectUpperLeft, rectLowerRight, *_cudaSimulationData, *_cudaOverlayTO);
+
+    int result;
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(&result, _cudaOverlayTO->numElements, sizeof(int), cudaMemcpyDeviceToHost));
+    return std::min(result, Const::MaxOverlayElements);
+}
+
+void _CudaSimulation::getOverlayData(OverlayElementAccessTO* elements, int numElements)
+{
     CHECK_FOR_CUDA_ERROR(cudaMemcpy(
-        dataTO.particles,
-        _cudaAccessTO->particles,
-        sizeof(CellAccessTO) * (*dataTO.numParticles),
-        cudaMemcpyDeviceToHost));
+        elements, _cudaOverlayTO->elements, sizeof(OverlayElementAccessTO) * numElements, cudaMemcpyDeviceToHost));
 }
 
 void _CudaSimulation::addAndSelectSimulationData(DataAccessTO const& dataTO)
@@ -319,6 +366,56 @@ void _CudaSimulation::removeSelectedEntities(bool includeClusters)
     KERNEL_CALL_HOST(cudaRemoveSelectedEntities, *_cudaSimulationData, includeClusters);
 }
 
+void _CudaSimulation::applyBulkTransform(BulkTransform const& transform)
+{
+    KERNEL_CALL_HOST(cudaApplyBulkTransform, transform, *_cudaSimulationData);
+}
+
+void _CudaSimulation::resizeWorld(int2 const& newSize, WorldResizeMode::Type mode)
+{
+    WorldResizeData resizeData;
+    resizeData.mode = mode;
+    resizeData.origSize = _cudaSimulationData->size;
+    resizeData.newSize = newSize;
+    resizeData.numCopies = {1, 1};
+    if (WorldResizeMode::Tile == mode) {
+        resizeData.numCopies = {
+            (newSize.x + resizeData.origSize.x - 1) / resizeData.origSize.x,
+            (newSize.y + resizeData.origSize.y - 1) / resizeData.origSize.y};
+    }
+
+    //arrays have to hold the copies before they are created on the device
+    auto numAdditionalCopies = resizeData.numCopies.x * resizeData.numCopies.y - 1;
+    if (numAdditionalCopies > 0) {
+        auto const& entities = _cudaSimulationData->entities;
+        resizeArraysIfNecessary(
+            {entities.cellPointers.getNumEntries_host() * numAdditionalCopies,
+             entities.particlePointers.getNumEntries_host() * numAdditionalCopies,
+             entities.tokenPointers.getNumEntries_host() * numAdditionalCopies});
+    }
+
+    KERNEL_CALL_HOST(cudaResizeWorld, resizeData, *_cudaSimulationData);
+    _cudaSimulationData->resizeWorld(newSize);
+}
+
+void _CudaSimulation::calcTileHashes(int tileSize, float positionTolerance, std::vector<uint64_t>& hashes)
+{
+    TileHashData tileHashData;
+    tileHashData.tileSize = tileSize;
+    tileHashData.positionTolerance = positionTolerance;
+    tileHashData.numTiles = {
+        (_cudaSimulationData->size.x + tileSize - 1) / tileSize, (_cudaSimulationData->size.y + tileSize - 1) / tileSize};
+    auto numTiles = tileHashData.numTiles.x * tileHashData.numTiles.y;
+    CudaMemoryManager::getInstance().acquireMemory<unsigned long long int>(numTiles, tileHashData.hashes);
+
+    KERNEL_CALL_HOST(cudaCalcTileHashes, *_cudaSimulationData, tileHashData);
+
+    hashes.resize(numTiles);
+    CHECK_FOR_CUDA_ERROR(
+        cudaMemcpy(hashes.data(), tileHashData.hashes, sizeof(uint64_t) * numTiles, cudaMemcpyDeviceToHost));
+    CudaMemoryManager::getInstance().freeMemory(tileHashData.hashes);
+}
+
 void _CudaSimulation::applyForce(ApplyForceData const& applyData)
 {
     KERNEL_CALL_HOST(cudaApplyForce, applyData, *_cudaSimulationData);
@@ -369,6 +466,11 @@ auto _CudaSimulation::getArraySizes() const -> ArraySizes
         _cudaSimulationData->entities.tokens.getSize_host()};
 }
 
+int _CudaSimulation::getTokenMemorySize() const
+{
+    return _cudaSimulationData->tokenMemorySize;
+}
+
 OverallStatistics _CudaSimulation::getMonitorData()
 {
     KERNEL_CALL_HOST(cudaGetCudaMonitorData, *_cudaSimulationData, *_cudaMonitorData);
@@ -390,6 +492,31 @@ OverallStatistics _CudaSimulation::getMonitorData()
     return result;
 }
 
+void _CudaSimulation::getEngineMetrics(EngineMetrics& metrics)
+{
+    auto totalStatistics = _cudaSimulationResult->getTotalStatistics();
+    metrics.totalCreatedCells = totalStatistics.createdCells;
+    metrics.totalSuccessfulAttacks = totalStatistics.sucessfulAttacks;
+    metrics.totalFailedAttacks = totalStatistics.failedAttacks;
+    metrics.totalMuscleActivities = totalStatistics.muscleActivities;
+    metrics.numArrayResizes = _numArrayResizes;
+    _cudaSimulationResult->getPhaseNanoseconds(metrics.phaseNanoseconds);
+
+    metrics.gpuMemoryBytes = CudaMemoryManager::getInstance().getSizeOfAcquiredMemory();
+
+    auto setFillLevel = [&](EngineArray::Type type, auto const& array) {
+        metrics.arrayNumEntries[type] = array.getNumEntries_host();
+        metrics.arraySizes[type] = array.getSize_host();
+    };
+    auto const& entities = _cudaSimulationData->entities;
+    setFillLevel(EngineArray::Cells, entities.cells);
+    setFillLevel(EngineArray::CellPointers, entities.cellPointers);
+    setFillLevel(EngineArray::Particles, entities.particles);
+    setFillLevel(EngineArray::ParticlePointers, entities.particlePointers);
+    setFillLevel(EngineArray::Tokens, entities.tokens);
+    setFillLevel(EngineArray::TokenPointers, entities.tokenPointers);
+}
+
 uint64_t _CudaSimulation::getCurrentTimestep() const
 {
     return _currentTimestep.load();
@@ -402,8 +529,15 @@ void _CudaSimulation::setCurrentTimestep(uint64_t timestep)
 
 void _CudaSimulation::setSimulationParameters(SimulationParameters const& parameters)
 {
+    auto gpuParameters = parameters;
+    gpuParameters.tokenMemorySize = calcTokenMemorySize(parameters);
     CHECK_FOR_CUDA_ERROR(cudaMemcpyToSymbol(
-        cudaSimulationParameters, &parameters, sizeof(SimulationParameters), 0, cudaMemcpyHostToDevice));
+        cudaSimulationParameters, &gpuParameters, sizeof(SimulationParameters), 0, cudaMemcpyHostToDevice));
+
+    //token memories are stored with the configured size as stride => relayout if it has changed
+    if (_cudaSimulationData && _cudaSimulationData->tokenMemorySize != gpuParameters.tokenMemorySize) {
+        resizeArrays({0, 0, 0}, gpuParameters.tokenMemorySize);
+    }
 }
 
 void _CudaSimulation::setSimulationParametersSpots(SimulationParametersSpots const& spots)
@@ -449,6 +583,11 @@ void _CudaSimulation::copyToGpu(DataAccessTO const& dataTO)
         cudaMemcpyHostToDevice));
     CHECK_FOR_CUDA_ERROR(cudaMemcpy(
         _cudaAccessTO->tokens, dataTO.tokens, sizeof(TokenAccessTO) * (*dataTO.numTokens), cudaMemcpyHostToDevice));
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+        _cudaAccessTO->tokenMemory,
+        dataTO.tokenMemory,
+        sizeof(char) * (*dataTO.numTokens) * _cudaAccessTO->tokenMemorySize,
+        cudaMemcpyHostToDevice));
     CHECK_FOR_CUDA_ERROR(cudaMemcpy(
         _cudaAccessTO->stringBytes,
         dataTO.stringBytes,
@@ -467,36 +606,53 @@ void _CudaSimulation::automaticResizeArrays()
 }
 
 void _CudaSimulation::resizeArrays(ArraySizes const& additionals)
+{
+    resizeArrays(additionals, _cudaSimulationData->tokenMemorySize);
+}
+
+void _CudaSimulation::resizeArrays(ArraySizes const& additionals, int newTokenMemorySize)
 {
     auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
     loggingService->logMessage(Priority::Important, "resize arrays");
+    ++_numArrayResizes;
 
     _cudaSimulationData->resizeEntitiesForCleanup(
-        additionals.cellArraySize, additionals.particleArraySize, additionals.tokenArraySize);
+        additionals.cellArraySize, additionals.particleArraySize, additionals.tokenArraySize, newTokenMemorySize);
     if (!_cudaSimulationData->isEmpty()) {
-        KERNEL_CALL_HOST(cudaCopyEntities, *_cudaSimulationData);
+        KERNEL_CALL_HOST(cudaCopyEntities, *_cudaSimulationData, newTokenMemorySize);
         _cudaSimulationData->resizeRemainings();
         _cudaSimulationData->swap();
     } else {
         _cudaSimulationData->resizeRemainings();
     }
+    _cudaSimulationData->tokenMemorySize = newTokenMemorySize;
 
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->cells);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->particles);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->tokens);
+    CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->tokenMemory);
 
     auto cellArraySize = _cudaSimulationData->entities.cells.getSize_host();
     auto tokenArraySize = _cudaSimulationData->entities.tokens.getSize_host();
     CudaMemoryManager::getInstance().acquireMemory<CellAccessTO>(cellArraySize, _cudaAccessTO->cells);
     CudaMemoryManager::getInstance().acquireMemory<ParticleAccessTO>(cellArraySize, _cudaAccessTO->particles);
     CudaMemoryManager::getInstance().acquireMemory<TokenAccessTO>(tokenArraySize, _cudaAccessTO->tokens);
+    CudaMemoryManager::getInstance().acquireMemory<char>(
+        static_cast<uint64_t>(tokenArraySize) * newTokenMemorySize, _cudaAccessTO->tokenMemory);
+    _cudaAccessTO->tokenMemorySize = newTokenMemorySize;
 
     CHECK_FOR_CUDA_ERROR(cudaGetLastError());
 
     loggingService->logMessage(Priority::Unimportant, "cell array size: " + std::to_string(cellArraySize));
     loggingService->logMessage(Priority::Unimportant, "particle array size: " + std::to_string(cellArraySize));
     loggingService->logMessage(Priority::Unimportant, "token array size: " + std::to_string(tokenArraySize));
+    loggingService->logMessage(Priority::Unimportant, "token memory size: " + std::to_string(newTokenMemorySize));
 
         auto const memorySizeAfter = CudaMemoryManager::getInstance().getSizeOfAcquiredMemory();
     loggingService->logMessage(Priority::Important, std::to_string(memorySizeAfter / (1024 * 1024)) + " MB GPU memory acquired");
 }
+
+int _CudaSimulation::calcTokenMemorySize(SimulationParameters const& parameters)
+{
+    return std::min(std::max(parameters.tokenMemorySize, MIN_TOKEN_MEM_SIZE), MAX_TOKEN_MEM_SIZE);
+}
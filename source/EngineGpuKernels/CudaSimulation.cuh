@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <atomic>
+#include <vector>
 
 #if defined(_WIN32)
 #define NOMINMAX
@@ -9,10 +10,13 @@
 #endif
 #include <GL/gl.h>
 
+#include "EngineInterface/BulkTransform.h"
+#include "EngineInterface/EngineMetrics.h"
 #include "EngineInterface/OverallStatistics.h"
 #include "EngineInterface/Settings.h"
 #include "EngineInterface/SelectionShallowData.h"
 #include "EngineInterface/ShallowUpdateSelectionData.h"
+#include "EngineInterface/WorldResizeMode.h"
 
 #include "Definitions.cuh"
 #include "DllExport.h"
@@ -36,14 +40,28 @@ public:
         void* cudaResource,
         int2 const& imageSize,
         double zoom);
+    //targetImage must hold imageSize.x * imageSize.y pixels in aabbggrr format
+    ENGINEGPUKERNELS_EXPORT void drawVectorGraphicsToHost(
+        float2 const& rectUpperLeft,
+        float2 const& rectLowerRight,
+        int2 const& imageSize,
+        double zoom,
+        uint32_t* targetImage);
     ENGINEGPUKERNELS_EXPORT void
     getSimulationData(int2 const& rectUpperLeft, int2 const& rectLowerRight, DataAccessTO const& dataTO);
     ENGINEGPUKERNELS_EXPORT void getSelectedSimulationData(bool includeClusters, DataAccessTO const& dataTO);
-    ENGINEGPUKERNELS_EXPORT void
-    getOverlayData(int2 const& rectUpperLeft, int2 const& rectLowerRight, DataAccessTO const& dataTO);
+    //returns the number of overlay elements in the rectangle, which is bounded by Const::MaxOverlayElements
+    ENGINEGPUKERNELS_EXPORT int calcOverlayData(int2 const& rectUpperLeft, int2 const& rectLowerRight);
+    //copies the elements of the last calcOverlayData call
+    ENGINEGPUKERNELS_EXPORT void getOverlayData(OverlayElementAccessTO* elements, int numElements);
     ENGINEGPUKERNELS_EXPORT void addAndSelectSimulationData(DataAccessTO const& dataTO);
     ENGINEGPUKERNELS_EXPORT void setSimulationData(DataAccessTO const& dataTO);
     ENGINEGPUKERNELS_EXPORT void removeSelectedEntities(bool includeClusters);
+    ENGINEGPUKERNELS_EXPORT void applyBulkTransform(BulkTransform const& transform);
+    //remaps the entities in place, bonds which would span a seam of the new world are removed
+    ENGINEGPUKERNELS_EXPORT void resizeWorld(int2 const& newSize, WorldResizeMode::Type mode);
+    //fingerprints the entities of each tileSize x tileSize tile (row-major), positions are quantized by positionTolerance
+    ENGINEGPUKERNELS_EXPORT void calcTileHashes(int tileSize, float positionTolerance, std::vector<uint64_t>& hashes);
 
     ENGINEGPUKERNELS_EXPORT void applyForce(ApplyForceData const& applyData);
     ENGINEGPUKERNELS_EXPORT void switchSelection(PointSelectionData const& switchData);
@@ -65,8 +83,11 @@ public:
         int tokenArraySize;
     };
     ENGINEGPUKERNELS_EXPORT ArraySizes getArraySizes() const;
+    ENGINEGPUKERNELS_EXPORT int getTokenMemorySize() const;
 
     ENGINEGPUKERNELS_EXPORT OverallStatistics getMonitorData();
+    //fills all metrics except statistics and tps
+    ENGINEGPUKERNELS_EXPORT void getEngineMetrics(EngineMetrics& metrics);
     ENGINEGPUKERNELS_EXPORT uint64_t getCurrentTimestep() const;
     ENGINEGPUKERNELS_EXPORT void setCurrentTimestep(uint64_t timestep);
 
@@ -78,12 +99,17 @@ private:
     void copyToGpu(DataAccessTO const& dataTO);
     void automaticResizeArrays();
     void resizeArrays(ArraySizes const& additionals);
+    void resizeArrays(ArraySizes const& additionals, int newTokenMemorySize);
+
+    static int calcTokenMemorySize(SimulationParameters const& parameters);
 
     std::atomic<uint64_t> _currentTimestep;
-    SimulationData* _cudaSimulationData;
+    uint64_t _numArrayResizes = 0;
+    SimulationData* _cudaSimulationData = nullptr;
     RenderingData* _cudaRenderingData;
     SimulationResult* _cudaSimulationResult;
     SelectionResult* _cudaSelectionResult;
     DataAccessTO* _cudaAccessTO;
+    OverlayAccessTO* _cudaOverlayTO;
     CudaMonitorData* _cudaMonitorData;
 };
@@ -12,6 +12,8 @@ class SelectionResult;
 struct CellAccessTO;
 struct ClusterAccessTO;
 struct DataAccessTO;
+struct OverlayAccessTO;
+struct OverlayElementAccessTO;
 struct SimulationParameters;
 struct GpuSettings;
 class CudaMonitorData;
@@ -41,5 +43,7 @@ struct AreaSelectionData
 
 #define FP_PRECISION 0.00001
 
+#define CELL_FUNCTION_WEAPON_RANGE 1.6f
+
 #define CUDA_THROW_NOT_IMPLEMENTED() printf("not implemented"); \
     asm("trap;");
@@ -4,6 +4,7 @@
 
 #include "Base.cuh"
 #include "Definitions.cuh"
+#include "CellComputerProgram.cuh"
 #include "DynamicMemory.cuh"
 
 struct Entities
@@ -15,6 +16,8 @@ struct Entities
     Array<Cell> cells;
     Array<Token> tokens;
     Array<Particle> particles;
+    Array<char> tokenMemory;
+    Array<CellComputerProgram> computerPrograms;  //only for computer cells which have been executed
 
     DynamicMemory strings;
 
@@ -26,6 +29,8 @@ struct Entities
         tokens.init();
         particles.init();
         particlePointers.init();
+        tokenMemory.init();
+        computerPrograms.init();
         strings.init();
         strings.resize(Const::MetadataMemorySize);
     }
@@ -38,6 +43,8 @@ struct Entities
         tokens.free();
         particles.free();
         particlePointers.free();
+        tokenMemory.free();
+        computerPrograms.free();
         strings.free();
     }
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Base.cuh"
+#include "ClusterLabelProcessor.cuh"
 #include "AccessTOs.cuh"
 #include "Map.cuh"
 #include "Math.cuh"
@@ -25,6 +26,7 @@ public:
         TokenAccessTO const& tokenTO,
         Cell* cellArray,
         Token* tokenArray,
+        char* tokenMemoryArray,
         DataAccessTO* simulationTO);
     __inline__ __device__ Particle*
     createParticle(
@@ -114,10 +116,13 @@ EntityFactory::createCellFromTO(int targetIndex, CellAccessTO const& cellTO, Cel
     for (int i = 0; i < MAX_CELL_STATIC_BYTES; ++i) {
         cell->staticData[i] = cellTO.staticData[i];
     }
+    cell->computerProgram = nullptr;
     for (int i = 0; i < MAX_CELL_MUTABLE_BYTES; ++i) {
         cell->mutableData[i] = cellTO.mutableData[i];
     }
     cell->tokenUsages = cellTO.tokenUsages;
+    cell->restingSteps = 0;
+    cell->numNeighbors = NeighborListState::NotInserted;
     cell->metadata.color = cellTO.metadata.color;
 
     copyString(
@@ -144,6 +149,7 @@ EntityFactory::createCellFromTO(int targetIndex, CellAccessTO const& cellTO, Cel
     cell->selected = 0;
     cell->locked = 0;
     cell->temp3 = {0, 0};
+    ClusterLabelProcessor::init(cell, true);    //connections are set without uniting
 
     return cell;
 }
@@ -153,15 +159,20 @@ __inline__ __device__ Token* EntityFactory::createTokenFromTO(
     TokenAccessTO const& tokenTO,
     Cell* cellArray,
     Token* tokenArray,
+    char* tokenMemoryArray,
     DataAccessTO* simulationTO)
 {
     Token** tokenPointer = _data->entities.tokenPointers.getNewElement();
     Token* token = tokenArray + targetIndex;
     *tokenPointer = token;
 
+    auto const tokenMemorySize = _data->tokenMemorySize;
     token->energy = tokenTO.energy;
-    for (int i = 0; i < cudaSimulationParameters.tokenMemorySize; ++i) {
-        token->memory[i] = tokenTO.memory[i];
+    token->memory = tokenMemoryArray + static_cast<uint64_t>(targetIndex) * tokenMemorySize;
+    auto const tokenMemoryTO =
+        simulationTO->tokenMemory + static_cast<uint64_t>(targetIndex) * simulationTO->tokenMemorySize;
+    for (int i = 0; i < tokenMemorySize; ++i) {
+        token->memory[i] = i < simulationTO->tokenMemorySize ? tokenMemoryTO[i] : 0;
     }
     token->cell = cellArray + tokenTO.cellIndex;
     token->sourceCell = token->cell;
@@ -213,6 +224,7 @@ __inline__ __device__ Cell* EntityFactory::createRandomCell(float energy, float2
     cell->locked = 0;
     cell->selected = 0;
     cell->temp3 = {0, 0};
+    ClusterLabelProcessor::init(cell, false);
     cell->metadata.color = 0;
     cell->metadata.nameLen = 0;
     cell->metadata.descriptionLen = 0;
@@ -235,10 +247,13 @@ __inline__ __device__ Cell* EntityFactory::createRandomCell(float energy, float2
     for (int i = 0; i < MAX_CELL_STATIC_BYTES; ++i) {
         cell->staticData[i] = _data->numberGen.random(255);
     }
+    cell->computerProgram = nullptr;
     for (int i = 0; i < MAX_CELL_MUTABLE_BYTES; ++i) {
         cell->mutableData[i] = _data->numberGen.random(255);
     }
     cell->tokenUsages = 0;
+    cell->restingSteps = 0;
+    cell->numNeighbors = NeighborListState::NotInserted;
     return cell;
 }
 
@@ -248,9 +263,13 @@ __inline__ __device__ Cell* EntityFactory::createCell()
     auto cellPointer = _data->entities.cellPointers.getNewElement();
     *cellPointer = result;
     result->tokenUsages = 0;
+    result->restingSteps = 0;
+    result->numNeighbors = NeighborListState::NotInserted;
     result->id = _data->numberGen.createNewId_kernel();
     result->selected = 0;
     result->locked = 0;
+    ClusterLabelProcessor::init(result, false);
+    result->computerProgram = nullptr;
     result->temp3 = {0, 0};
     result->metadata.color = 0;
     result->metadata.nameLen = 0;
@@ -266,6 +285,10 @@ __inline__ __device__ Token* EntityFactory::duplicateToken(Cell* targetCell, Tok
     *tokenPointer = token;
 
     *token = *sourceToken;
+    token->memory = _data->entities.tokenMemory.getNewSubarray(_data->tokenMemorySize);
+    for (int i = 0; i < _data->tokenMemorySize; ++i) {
+        token->memory[i] = sourceToken->memory[i];
+    }
     token->memory[0] = targetCell->branchNumber;
     token->sourceCell = token->cell;
     token->cell = targetCell;
@@ -280,8 +303,9 @@ __inline__ __device__ Token* EntityFactory::createToken(Cell* cell, Cell* source
 
     token->cell = cell;
     token->sourceCell = sourceCell;
+    token->memory = _data->entities.tokenMemory.getNewSubarray(_data->tokenMemorySize);
     token->memory[0] = cell->branchNumber;
-    for (int i = 1; i < MAX_TOKEN_MEM_SIZE; ++i) {
+    for (int i = 1; i < _data->tokenMemorySize; ++i) {
         token->memory[i] = 0;
     }
     return token;
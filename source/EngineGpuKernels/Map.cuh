@@ -153,12 +153,12 @@ public:
 
                 auto mapEntry = (scanPos.x + scanPos.y * _size.x) * 2;
                 auto cell1 = _map[mapEntry];
-                if (cell1 && Math::length(cell1->absPos - pos) <= radius && numCells < arraySize) {
+                if (cell1 && mapDistance(cell1->absPos, pos) <= radius && numCells < arraySize) {
                     cells[numCells] = cell1;
                     ++numCells;
 
                     auto cell2 = _map[mapEntry + 1];
-                    if (cell2 && Math::length(cell2->absPos - pos) <= radius && numCells < arraySize) {
+                    if (cell2 && mapDistance(cell2->absPos, pos) <= radius && numCells < arraySize) {
                         cells[numCells] = cell2;
                         ++numCells;
                     }
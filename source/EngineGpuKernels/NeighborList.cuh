@@ -0,0 +1,284 @@
+#pragma once
+
+#include "Base.cuh"
+#include "Array.cuh"
+#include "Cell.cuh"
+#include "ConstantMemory.cuh"
+#include "Map.cuh"
+#include "Math.cuh"
+
+#define NEIGHBOR_LIST_SKIN 0.4f
+#define MAX_NEIGHBORS 32
+#define NEIGHBOR_LIST_SPARE_ENTRIES 4
+#define NEIGHBOR_LIST_ENTRIES_PER_CELL 20
+
+//values of Cell::numNeighbors for cells without a list
+namespace NeighborListState
+{
+    enum Type
+    {
+        NotInserted = -1,   //e.g. created in the current time step
+        UseCellMap = -2,    //too many neighbors or memory exhausted
+        Deleted = -3
+    };
+}
+
+/**
+ * Verlet neighbor lists which are shared by all phases of a time step that need nearby cells. Each cell refers to
+ * its slice of _neighbors containing all cells within the interaction radius plus NEIGHBOR_LIST_SKIN at build time.
+ * The lists are only rebuilt if a cell has moved more than half of the skin or the cells have been relocated in
+ * memory. New cells are inserted incrementally into the lists of their neighbors which have
+ * NEIGHBOR_LIST_SPARE_ENTRIES free entries for this purpose, deleted cells are marked and skipped. Cells without a
+ * list are looked up in the cell map instead.
+ */
+class NeighborList
+{
+public:
+    __host__ __inline__ void init()
+    {
+        CudaMemoryManager::getInstance().acquireMemory<BuildState>(1, _state);
+        _neighbors = nullptr;
+        _capacity = 0;
+        invalidate_host();
+    }
+
+    __host__ __inline__ void resize(int maxCells)
+    {
+        if (_capacity > 0) {
+            CudaMemoryManager::getInstance().freeMemory(_neighbors);
+        }
+        _capacity = maxCells * NEIGHBOR_LIST_ENTRIES_PER_CELL;
+        CudaMemoryManager::getInstance().acquireMemory<Cell*>(_capacity, _neighbors);
+        invalidate_host();
+    }
+
+    __host__ __inline__ void free()
+    {
+        CudaMemoryManager::getInstance().freeMemory(_state);
+        if (_capacity > 0) {
+            CudaMemoryManager::getInstance().freeMemory(_neighbors);
+        }
+        _capacity = 0;
+    }
+
+    __host__ __inline__ void invalidate_host()
+    {
+        CHECK_FOR_CUDA_ERROR(cudaMemset(_state, 0, sizeof(BuildState)));
+    }
+
+    __device__ __inline__ void invalidate() { atomicExch(&_state->valid, 0); }
+
+    __device__ __inline__ static void markAsDeleted(Cell* cell)
+    {
+        atomicExch(&cell->numNeighbors, NeighborListState::Deleted);
+    }
+
+    //the update check consists of resetUpdateCheck (one thread), calcDisplacements_system and
+    //needsRebuild/hasNewCells (one thread)
+    __device__ __inline__ void resetUpdateCheck()
+    {
+        _state->maxDisplacement = 0;
+        _state->numNewCells = 0;
+    }
+
+    __device__ __inline__ void calcDisplacements_system(Array<Cell*> const& cells, MapInfo const& map)
+    {
+        auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+        float maxDisplacement = 0;
+        int numNewCells = 0;
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& cell = cells.at(index);
+            if (cell->numNeighbors == NeighborListState::NotInserted) {
+                ++numNewCells;
+            }
+            if (cell->numNeighbors < 0) {
+                continue;
+            }
+            auto delta = cell->absPos - cell->neighborListPos;
+            map.mapDisplacementCorrection(delta);
+            maxDisplacement = max(maxDisplacement, Math::length(delta));
+        }
+
+        //non-negative floats are ordered like their bit patterns
+        atomicMax(&_state->maxDisplacement, __float_as_int(maxDisplacement));
+        if (numNewCells > 0) {
+            atomicAdd(&_state->numNewCells, numNewCells);
+        }
+    }
+
+    __device__ __inline__ bool needsRebuild(Array<Cell> const& cells) const
+    {
+        return !_state->valid || _state->cellArray != cells.getArray() || _state->radius != getInteractionRadius()
+            || __int_as_float(_state->maxDisplacement) > NEIGHBOR_LIST_SKIN / 2;
+    }
+
+    __device__ __inline__ bool hasNewCells() const { return _state->numNewCells > 0; }
+
+    //should be called with one thread before build_system
+    __device__ __inline__ void prepareBuild(Array<Cell> const& cells)
+    {
+        _state->numEntries = 0;
+        _state->valid = 1;
+        _state->cellArray = cells.getArray();
+        _state->radius = getInteractionRadius();
+    }
+
+    //prerequisite: cell map is up to date
+    __device__ __inline__ void build_system(Array<Cell*> const& cells, CellMap const& cellMap)
+    {
+        auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+        auto const radius = _state->radius + NEIGHBOR_LIST_SKIN;
+
+        Cell* otherCells[MAX_NEIGHBORS];
+        int numOtherCells;
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+            cellMap.get(otherCells, MAX_NEIGHBORS, numOtherCells, cell->absPos, radius);
+            createList(cell, otherCells, numOtherCells);
+        }
+    }
+
+    //the incremental update for cells which are not yet in the lists consists of insertNewCells_system and
+    //buildForNewCells_system in separate kernels, prerequisite: cell map is up to date and no rebuild is needed
+    __device__ __inline__ void insertNewCells_system(Array<Cell*> const& cells, CellMap const& cellMap)
+    {
+        auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+
+        Cell* otherCells[MAX_NEIGHBORS];
+        int numOtherCells;
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+            if (cell->numNeighbors != NeighborListState::NotInserted) {
+                continue;
+            }
+            cellMap.get(otherCells, MAX_NEIGHBORS, numOtherCells, cell->absPos, getInsertionRadius());
+            if (numOtherCells == MAX_NEIGHBORS) {
+
+                //some lists would miss the cell, the cell map is used until the rebuild in the next time step
+                invalidate();
+                continue;
+            }
+            for (int i = 0; i < numOtherCells; ++i) {
+                auto const& otherCell = otherCells[i];
+
+                //the other cell may have moved up to half of the skin since its list has been built
+                if (otherCell != cell
+                    && cellMap.mapDistance(cell->absPos, otherCell->neighborListPos)
+                        <= _state->radius + NEIGHBOR_LIST_SKIN) {
+                    insertIntoList(otherCell, cell);
+                }
+            }
+        }
+    }
+
+    __device__ __inline__ void buildForNewCells_system(Array<Cell*> const& cells, CellMap const& cellMap)
+    {
+        auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+
+        Cell* otherCells[MAX_NEIGHBORS];
+        int numOtherCells;
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+            if (cell->numNeighbors != NeighborListState::NotInserted) {
+                continue;
+            }
+
+            //the other cells may have moved up to half of the skin since their lists have been built
+            cellMap.get(otherCells, MAX_NEIGHBORS, numOtherCells, cell->absPos, getInsertionRadius());
+            createList(cell, otherCells, numOtherCells);
+        }
+    }
+
+    //returns at most arraySize cells within radius which may include the cell itself
+    __device__ __inline__ void
+    get(Cell* result[], int arraySize, int& numCells, Cell* cell, float radius, CellMap const& cellMap) const
+    {
+        if (!_state->valid || cell->numNeighbors < 0 || radius > _state->radius) {
+            cellMap.get(result, arraySize, numCells, cell->absPos, radius);
+            return;
+        }
+        numCells = 0;
+        for (int i = 0; i < cell->numNeighbors && numCells < arraySize; ++i) {
+            auto const& otherCell = cell->neighbors[i];
+            if (otherCell->numNeighbors != NeighborListState::Deleted
+                && cellMap.mapDistance(otherCell->absPos, cell->absPos) <= radius) {
+                result[numCells++] = otherCell;
+            }
+        }
+    }
+
+private:
+    struct BuildState
+    {
+        int valid;
+        int numEntries;
+        int maxDisplacement;    //float bits
+        int numNewCells;
+        Cell* cellArray;
+        float radius;
+    };
+
+    //covers collisions and weapons
+    __device__ __inline__ static float getInteractionRadius()
+    {
+        return max(cudaSimulationParameters.cellMaxCollisionDistance, CELL_FUNCTION_WEAPON_RANGE);
+    }
+
+    __device__ __inline__ float getInsertionRadius() const { return _state->radius + NEIGHBOR_LIST_SKIN * 2; }
+
+    __device__ __inline__ void createList(Cell* cell, Cell* otherCells[], int numOtherCells)
+    {
+        cell->neighborListPos = cell->absPos;
+        if (numOtherCells == MAX_NEIGHBORS) {
+            cell->numNeighbors = NeighborListState::UseCellMap;
+            return;
+        }
+        auto neighborCapacity = numOtherCells + NEIGHBOR_LIST_SPARE_ENTRIES;
+        auto neighbors = getNewSlice(neighborCapacity);
+        if (!neighbors) {
+            cell->numNeighbors = NeighborListState::UseCellMap;
+            return;
+        }
+        int numNeighbors = 0;
+        for (int i = 0; i < numOtherCells; ++i) {
+            if (otherCells[i] != cell && otherCells[i]->numNeighbors != NeighborListState::Deleted) {
+                neighbors[numNeighbors++] = otherCells[i];
+            }
+        }
+        cell->neighbors = neighbors;
+        cell->neighborCapacity = neighborCapacity;
+        cell->numNeighbors = numNeighbors;
+    }
+
+    //a list without free entries is dropped in favor of the cell map
+    __device__ __inline__ static void insertIntoList(Cell* cell, Cell* newNeighbor)
+    {
+        auto numNeighbors = cell->numNeighbors;
+        while (numNeighbors >= 0) {
+            auto hasFreeEntry = numNeighbors < cell->neighborCapacity;
+            auto newNumNeighbors = hasFreeEntry ? numNeighbors + 1 : static_cast<int>(NeighborListState::UseCellMap);
+            auto origNumNeighbors = atomicCAS(&cell->numNeighbors, numNeighbors, newNumNeighbors);
+            if (origNumNeighbors == numNeighbors) {
+                if (hasFreeEntry) {
+                    cell->neighbors[numNeighbors] = newNeighbor;
+                }
+                return;
+            }
+            numNeighbors = origNumNeighbors;
+        }
+    }
+
+    //returns nullptr if the memory is exhausted
+    __device__ __inline__ Cell** getNewSlice(int size)
+    {
+        auto oldIndex = atomicAdd(&_state->numEntries, size);
+        if (oldIndex + size > _capacity) {
+            return nullptr;
+        }
+        return &_neighbors[oldIndex];
+    }
+
+    BuildState* _state;
+    Cell** _neighbors;
+    int _capacity;
+};
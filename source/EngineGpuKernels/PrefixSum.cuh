@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+
+#include "Base.cuh"
+
+#define PREFIX_SUM_CHUNK_SIZE 128
+
+/**
+ * Exclusive prefix sum over int values which is parallelized over chunks of PREFIX_SUM_CHUNK_SIZE values. The sums of
+ * the chunks are calculated in parallel, scanned by one thread and then serve as offsets for the chunks.
+ */
+class PrefixSum
+{
+public:
+    __host__ __inline__ void init(int maxValues)
+    {
+        auto maxChunks = std::max(1, (maxValues + PREFIX_SUM_CHUNK_SIZE - 1) / PREFIX_SUM_CHUNK_SIZE);
+        CudaMemoryManager::getInstance().acquireMemory<int>(maxChunks, _chunkSums);
+    }
+
+    __host__ __inline__ void free() { CudaMemoryManager::getInstance().freeMemory(_chunkSums); }
+
+    //the prefix sums are calculated by calling calcChunkSums_system, scanChunkSums and calcPrefixSums_system in separate
+    //kernels, numValues must not exceed maxValues and result needs numValues + 1 entries
+    __device__ __inline__ void calcChunkSums_system(int const* values, int numValues)
+    {
+        auto const partition = calcAllThreadsPartition(getNumChunks(numValues));
+        for (int chunk = partition.startIndex; chunk <= partition.endIndex; ++chunk) {
+            auto const endIndex = min((chunk + 1) * PREFIX_SUM_CHUNK_SIZE, numValues);
+            int sum = 0;
+            for (int index = chunk * PREFIX_SUM_CHUNK_SIZE; index < endIndex; ++index) {
+                sum += values[index];
+            }
+            _chunkSums[chunk] = sum;
+        }
+    }
+
+    //should be called with one thread, writes and returns the sum of all values
+    __device__ __inline__ int scanChunkSums(int* result, int numValues)
+    {
+        auto numChunks = getNumChunks(numValues);
+        int sum = 0;
+        for (int chunk = 0; chunk < numChunks; ++chunk) {
+            auto chunkSum = _chunkSums[chunk];
+            _chunkSums[chunk] = sum;
+            sum += chunkSum;
+        }
+        result[numValues] = sum;
+        return sum;
+    }
+
+    __device__ __inline__ void calcPrefixSums_system(int const* values, int* result, int numValues)
+    {
+        auto const partition = calcAllThreadsPartition(getNumChunks(numValues));
+        for (int chunk = partition.startIndex; chunk <= partition.endIndex; ++chunk) {
+            auto const endIndex = min((chunk + 1) * PREFIX_SUM_CHUNK_SIZE, numValues);
+            int sum = _chunkSums[chunk];
+            for (int index = chunk * PREFIX_SUM_CHUNK_SIZE; index < endIndex; ++index) {
+                result[index] = sum;
+                sum += values[index];
+            }
+        }
+    }
+
+private:
+    __device__ __inline__ static int getNumChunks(int numValues)
+    {
+        return (numValues + PREFIX_SUM_CHUNK_SIZE - 1) / PREFIX_SUM_CHUNK_SIZE;
+    }
+
+    int* _chunkSums;
+};
@@ -9,6 +9,8 @@ struct RenderingData
 {
     int numPixels = 0;
     uint64_t* imageData = nullptr;  //pixel in bbbbggggrrrr format (3 x 16 bit + 16 bit unused)
+    uint32_t* rgbaImageData = nullptr;  //tone mapped pixel in aabbggrr format, only used for rendering to host memory
+    float3* densityImageData = nullptr; //accumulated entity colors per pixel, only used for low zoom levels
 
     void init()
     {
@@ -18,7 +20,11 @@ struct RenderingData
     {
         if (newSize.x * newSize.y > numPixels) {
             CudaMemoryManager::getInstance().freeMemory(imageData);
+            CudaMemoryManager::getInstance().freeMemory(rgbaImageData);
+            CudaMemoryManager::getInstance().freeMemory(densityImageData);
             CudaMemoryManager::getInstance().acquireMemory<uint64_t>(newSize.x * newSize.y, imageData);
+            CudaMemoryManager::getInstance().acquireMemory<uint32_t>(newSize.x * newSize.y, rgbaImageData);
+            CudaMemoryManager::getInstance().acquireMemory<float3>(newSize.x * newSize.y, densityImageData);
             numPixels = newSize.x * newSize.y;
         }
     }
@@ -26,5 +32,7 @@ struct RenderingData
     void free()
     {
         CudaMemoryManager::getInstance().freeMemory(imageData);
+        CudaMemoryManager::getInstance().freeMemory(rgbaImageData);
+        CudaMemoryManager::getInstance().freeMemory(densityImageData);
     }
 };
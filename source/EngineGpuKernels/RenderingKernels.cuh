@@ -371,6 +371,125 @@ __device__ void drawFlowCenters(uint64_t* targetImage, float2 const& rectUpperLe
     }
 }
 
+/************************************************************************/
+/* Density rendering     												*/
+/************************************************************************/
+
+//total intensity which drawCircle distributes for a radius below 1.5
+__device__ __inline__ float calcSmallCircleWeight(float radius)
+{
+    return radius * 2 * (1.0f + 4 * 0.3f);
+}
+
+__device__ __inline__ void
+addToDensityImage(float3* densityImageData, int2 const& imageSize, float2 const& imagePos, float3 const& colorToAdd)
+{
+    int2 intPos{floorInt(imagePos.x), floorInt(imagePos.y)};
+    if (intPos.x >= 0 && intPos.x < imageSize.x && intPos.y >= 0 && intPos.y < imageSize.y) {
+        auto& pixel = densityImageData[intPos.x + intPos.y * imageSize.x];
+        atomicAdd(&pixel.x, colorToAdd.x);
+        atomicAdd(&pixel.y, colorToAdd.y);
+        atomicAdd(&pixel.z, colorToAdd.z);
+    }
+}
+
+__global__ void clearDensityImage(float3* densityImageData, int2 imageSize)
+{
+    auto const partition = calcAllThreadsPartition(imageSize.x * imageSize.y);
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        densityImageData[index] = {0, 0, 0};
+    }
+}
+
+__global__ void accumulateCellDensities(
+    int2 universeSize,
+    float2 rectUpperLeft,
+    Array<Cell*> cells,
+    float3* densityImageData,
+    int2 imageSize,
+    float zoom)
+{
+    auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+
+    MapInfo map;
+    map.init(universeSize);
+
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto const& cell = cells.at(index);
+
+        auto cellPos = cell->absPos;
+        map.mapPosCorrection(cellPos);
+        auto const cellImagePos = mapUniversePosToVectorImagePos(rectUpperLeft, cellPos, zoom);
+        auto radius = 1 == cell->selected ? zoom / 2 : zoom / 3;
+        addToDensityImage(
+            densityImageData, imageSize, cellImagePos, calcColor(cell, cell->selected) * calcSmallCircleWeight(radius));
+    }
+}
+
+__global__ void accumulateTokenDensities(
+    int2 universeSize,
+    float2 rectUpperLeft,
+    Array<Token*> tokens,
+    float3* densityImageData,
+    int2 imageSize,
+    float zoom)
+{
+    auto const partition = calcAllThreadsPartition(tokens.getNumEntries());
+
+    MapInfo map;
+    map.init(universeSize);
+
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto const& token = tokens.at(index);
+
+        auto cellPos = token->cell->absPos;
+        map.mapPosCorrection(cellPos);
+        auto const cellImagePos = mapUniversePosToVectorImagePos(rectUpperLeft, cellPos, zoom);
+        addToDensityImage(
+            densityImageData, imageSize, cellImagePos, calcColor(token, false) * calcSmallCircleWeight(zoom / 2));
+    }
+}
+
+__global__ void accumulateParticleDensities(
+    float2 rectUpperLeft,
+    Array<Particle*> particles,
+    float3* densityImageData,
+    int2 imageSize,
+    float zoom)
+{
+    auto const partition = calcAllThreadsPartition(particles.getNumEntries());
+
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto const& particle = particles.at(index);
+
+        auto const particleImagePos = mapUniversePosToVectorImagePos(rectUpperLeft, particle->absPos, zoom);
+        auto radius = 1 == particle->selected ? zoom / 2 : zoom / 3;
+        addToDensityImage(
+            densityImageData,
+            imageSize,
+            particleImagePos,
+            calcColor(particle, 0 != particle->selected) * calcSmallCircleWeight(radius));
+    }
+}
+
+//adds the accumulated colors to the background with saturation instead of overflowing into the next channel
+__global__ void shadeDensityImage(uint64_t* imageData, float3* densityImageData, int2 imageSize)
+{
+    auto const partition = calcAllThreadsPartition(imageSize.x * imageSize.y);
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto const& density = densityImageData[index];
+        if (density.x == 0 && density.y == 0 && density.z == 0) {
+            continue;
+        }
+        auto const background = imageData[index];
+        auto const channel = [&](int shift, float value) {
+            auto const sum = ((background >> shift) & 0xffff) + toUInt64(value * 255.0f);
+            return (sum < 0xffff ? sum : 0xffff) << shift;
+        };
+        imageData[index] = channel(0, density.x) | channel(16, density.y) | channel(32, density.z);
+    }
+}
+
 /************************************************************************/
 /* Main      															*/
 /************************************************************************/
@@ -387,23 +506,84 @@ __global__ void drawImageKernel(
 
     KERNEL_CALL(drawBackground, targetImage, imageSize, data.size, zoom, rectUpperLeft, rectLowerRight);
 
-    KERNEL_CALL(
-        drawCells, data.size, rectUpperLeft, rectLowerRight, data.entities.cellPointers, targetImage, imageSize, zoom);
-
-    KERNEL_CALL(
-        drawTokens, data.size, rectUpperLeft, rectLowerRight, data.entities.tokenPointers, targetImage, imageSize, zoom);
-
-    KERNEL_CALL(
-        drawParticles,
-        data.size,
-        rectUpperLeft,
-        rectLowerRight,
-        data.entities.particlePointers,
-        targetImage,
-        imageSize,
-        zoom);
+    if (zoom < Const::MaxZoomLevelForDensityRendering) {
+
+        //entities are smaller than a pixel => accumulate them per pixel with one atomic operation per color channel
+        auto densityImage = renderingData.densityImageData;
+        KERNEL_CALL(clearDensityImage, densityImage, imageSize);
+        KERNEL_CALL(
+            accumulateCellDensities,
+            data.size,
+            rectUpperLeft,
+            data.entities.cellPointers,
+            densityImage,
+            imageSize,
+            zoom);
+        KERNEL_CALL(
+            accumulateTokenDensities,
+            data.size,
+            rectUpperLeft,
+            data.entities.tokenPointers,
+            densityImage,
+            imageSize,
+            zoom);
+        KERNEL_CALL(
+            accumulateParticleDensities, rectUpperLeft, data.entities.particlePointers, densityImage, imageSize, zoom);
+        KERNEL_CALL(shadeDensityImage, targetImage, densityImage, imageSize);
+    } else {
+        KERNEL_CALL(
+            drawCells,
+            data.size,
+            rectUpperLeft,
+            rectLowerRight,
+            data.entities.cellPointers,
+            targetImage,
+            imageSize,
+            zoom);
+
+        KERNEL_CALL(
+            drawTokens,
+            data.size,
+            rectUpperLeft,
+            rectLowerRight,
+            data.entities.tokenPointers,
+            targetImage,
+            imageSize,
+            zoom);
+
+        KERNEL_CALL(
+            drawParticles,
+            data.size,
+            rectUpperLeft,
+            rectLowerRight,
+            data.entities.particlePointers,
+            targetImage,
+            imageSize,
+            zoom);
+    }
 
     drawFlowCenters(targetImage, rectUpperLeft, imageSize, zoom);
 }
 
 
+
+//applies the same tone mapping as the shader of the simulation view without glow and motion effects
+__global__ void convertImageToRgba(int2 imageSize, uint64_t* imageData, uint32_t* rgbaImageData)
+{
+    auto const partition = calcAllThreadsPartition(imageSize.x * imageSize.y);
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto pixel = imageData[index];
+        uint32_t result = 0xff000000;
+        for (int channel = 0; channel < 3; ++channel) {
+            auto value = toFloat((pixel >> (channel * 16)) & 0xffff) / 65535.0f;
+            value = min(max(sqrtf(value * 256.0f) - 0.2f, 0.0f), 1.0f);
+            result |= static_cast<uint32_t>(value * 255.0f) << (channel * 8);
+        }
+        rgbaImageData[index] = result;
+    }
+}
+
+__global__ void convertImageToRgbaKernel(int2 imageSize, RenderingData renderingData)
+{
+    KERNEL_CALL(convertImageToRgba, imageSize, renderingData.imageData, renderingData.rgbaImageData);
+}
@@ -97,13 +97,18 @@ __inline__ __device__ void ScannerFunction::processing(Token* token, SimulationD
     tokenMem[Enums::Scanner::OUT_CELL_METADATA] = lookupResult.prevCell->metadata.color;
     tokenMem[Enums::Scanner::OUT_CELL_FUNCTION] = lookupResult.prevCell->getCellFunctionType();
     tokenMem[Enums::Scanner::OUT_CELL_FUNCTION_DATA] = lookupResult.prevCell->numStaticBytes;
+
+    //cell function data may exceed small token memories => wrap around
+    auto const tokenMemorySize = cudaSimulationParameters.tokenMemorySize;
     for (int i = 0; i < lookupResult.prevCell->numStaticBytes; ++i) {
-        tokenMem[Enums::Scanner::OUT_CELL_FUNCTION_DATA + 1 + i] = lookupResult.prevCell->staticData[i];
+        tokenMem[(Enums::Scanner::OUT_CELL_FUNCTION_DATA + 1 + i) % tokenMemorySize] =
+            lookupResult.prevCell->staticData[i];
     }
     int mutableDataIndex = lookupResult.prevCell->numStaticBytes + 1;
-    tokenMem[Enums::Scanner::OUT_CELL_FUNCTION_DATA + mutableDataIndex] = lookupResult.prevCell->numMutableBytes;
+    tokenMem[(Enums::Scanner::OUT_CELL_FUNCTION_DATA + mutableDataIndex) % tokenMemorySize] =
+        lookupResult.prevCell->numMutableBytes;
     for (int i = 0; i < lookupResult.prevCell->numMutableBytes; ++i) {
-        tokenMem[Enums::Scanner::OUT_CELL_FUNCTION_DATA + mutableDataIndex + 1 + i] =
+        tokenMem[(Enums::Scanner::OUT_CELL_FUNCTION_DATA + mutableDataIndex + 1 + i) % tokenMemorySize] =
             lookupResult.prevCell->mutableData[i];
     }
 }
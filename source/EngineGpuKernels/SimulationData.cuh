@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <limits>
 
 #include "EngineInterface/GpuSettings.h"
 
@@ -8,14 +9,19 @@
 #include "Definitions.cuh"
 #include "Entities.cuh"
 #include "CellFunctionData.cuh"
+#include "NeighborList.cuh"
 #include "Operation.cuh"
+#include "SpatialIndex.cuh"
 
 struct SimulationData
 {
     int2 size;
+    int tokenMemorySize;    //stride of entities.tokenMemory
 
     CellMap cellMap;
     ParticleMap particleMap;
+    NeighborList neighborList;
+    SpatialIndex spatialIndex;
     CellFunctionData cellFunctionData;
 
     Entities entities;
@@ -27,15 +33,18 @@ struct SimulationData
     DynamicMemory dynamicMemory;
     CudaNumberGenerator numberGen;
 
-    void init(int2 const& universeSize)
+    void init(int2 const& universeSize, int tokenMemorySize_)
     {
         size = universeSize;
+        tokenMemorySize = tokenMemorySize_;
 
         entities.init();
         entitiesForCleanup.init();
         cellFunctionData.init(universeSize);
         cellMap.init(size);
         particleMap.init(size);
+        neighborList.init();
+        spatialIndex.init(size);
 
         dynamicMemory.init();
         numberGen.init(40312357);   //some array size for random numbers (~ 40 MB)
@@ -43,6 +52,27 @@ struct SimulationData
         CudaMemoryManager::getInstance().acquireMemory<unsigned int>(1, numOperations);
     }
 
+    //reallocates the data structures depending on the world size, the entities have to be remapped separately
+    void resizeWorld(int2 const& newSize)
+    {
+        size = newSize;
+
+        cellFunctionData.free();
+        cellMap.free();
+        particleMap.free();
+        spatialIndex.free();
+
+        cellFunctionData.init(size);
+        cellMap.init(size);
+        particleMap.init(size);
+        spatialIndex.init(size);
+
+        auto cellArraySize = entities.cells.getSize_host();
+        cellMap.resize(cellArraySize);
+        particleMap.resize(cellArraySize);
+        spatialIndex.resize(entities.cellPointers.getSize_host(), entities.particlePointers.getSize_host());
+    }
+
     __device__ void prepareForSimulation()
     {
         cellMap.reset();
@@ -75,7 +105,11 @@ struct SimulationData
             || entities.tokens.shouldResize(0) || entities.tokenPointers.shouldResize(0);
     }
 
-    void resizeEntitiesForCleanup(int additionalCells, int additionalParticles, int additionalTokens)
+    void resizeEntitiesForCleanup(
+        int additionalCells,
+        int additionalParticles,
+        int additionalTokens,
+        int newTokenMemorySize)
     {
         auto cellAndParticleArraySizeInc = std::max(additionalCells, additionalParticles);
         auto tokenArraySizeInc = std::max(additionalTokens, cellAndParticleArraySizeInc / 3);
@@ -86,6 +120,22 @@ struct SimulationData
         resizeTargetIntern(entities.particlePointers, entitiesForCleanup.particlePointers, cellAndParticleArraySizeInc * 10);
         resizeTargetIntern(entities.tokens, entitiesForCleanup.tokens, tokenArraySizeInc);
         resizeTargetIntern(entities.tokenPointers, entitiesForCleanup.tokenPointers, tokenArraySizeInc * 10);
+
+        //the product exceeds the int range for a few million tokens with large token memories
+        auto tokenMemoryBytes = static_cast<uint64_t>(entitiesForCleanup.tokens.getSize_host()) * newTokenMemorySize;
+        if (tokenMemoryBytes > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+            throw SpecificCudaException("The token memory exceeds the maximum array size. Please reduce the token "
+                                        "memory size or the number of tokens.");
+        }
+        if (entitiesForCleanup.tokenMemory.getSize_host() != static_cast<int>(tokenMemoryBytes)) {
+            entitiesForCleanup.tokenMemory.resize(static_cast<int>(tokenMemoryBytes));
+        }
+
+        //each cell can reference at most one program
+        auto cellArraySize = entitiesForCleanup.cells.getSize_host();
+        if (entitiesForCleanup.computerPrograms.getSize_host() != cellArraySize) {
+            entitiesForCleanup.computerPrograms.resize(cellArraySize);
+        }
     }
 
     void resizeRemainings()
@@ -96,10 +146,14 @@ struct SimulationData
         entities.particlePointers.resize(entitiesForCleanup.particlePointers.getSize_host());
         entities.tokens.resize(entitiesForCleanup.tokens.getSize_host());
         entities.tokenPointers.resize(entitiesForCleanup.tokenPointers.getSize_host());
+        entities.tokenMemory.resize(entitiesForCleanup.tokenMemory.getSize_host());
+        entities.computerPrograms.resize(entitiesForCleanup.computerPrograms.getSize_host());
 
         auto cellArraySize = entities.cells.getSize_host();
         cellMap.resize(cellArraySize);
         particleMap.resize(cellArraySize);
+        neighborList.resize(cellArraySize);
+        spatialIndex.resize(entities.cellPointers.getSize_host(), entities.particlePointers.getSize_host());
 
         int upperBoundDynamicMemory = sizeof(Operation) * (cellArraySize + 1000);
         dynamicMemory.resize(upperBoundDynamicMemory);
@@ -119,6 +173,8 @@ struct SimulationData
         entities.particlePointers.swapContent_host(entitiesForCleanup.particlePointers);
         entities.tokens.swapContent_host(entitiesForCleanup.tokens);
         entities.tokenPointers.swapContent_host(entitiesForCleanup.tokenPointers);
+        entities.tokenMemory.swapContent_host(entitiesForCleanup.tokenMemory);
+        entities.computerPrograms.swapContent_host(entitiesForCleanup.computerPrograms);
     }
 
     void free()
@@ -128,6 +184,8 @@ struct SimulationData
         cellFunctionData.free();
         cellMap.free();
         particleMap.free();
+        neighborList.free();
+        spatialIndex.free();
         numberGen.free();
         dynamicMemory.free();
 
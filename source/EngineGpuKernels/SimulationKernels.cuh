@@ -16,6 +16,26 @@
 #include "SimulationResult.cuh"
 #include "FlowFieldKernel.cuh"
 
+__global__ void calcNeighborListDisplacements(SimulationData data)
+{
+    data.neighborList.calcDisplacements_system(data.entities.cellPointers, data.cellMap);
+}
+
+__global__ void buildNeighborLists(SimulationData data)
+{
+    data.neighborList.build_system(data.entities.cellPointers, data.cellMap);
+}
+
+__global__ void insertNewCellsIntoNeighborLists(SimulationData data)
+{
+    data.neighborList.insertNewCells_system(data.entities.cellPointers, data.cellMap);
+}
+
+__global__ void buildNeighborListsForNewCells(SimulationData data)
+{
+    data.neighborList.buildForNewCells_system(data.entities.cellPointers, data.cellMap);
+}
+
 __global__ void processingStep1(SimulationData data)
 {
     CellProcessor cellProcessor;
@@ -85,6 +105,7 @@ __global__ void processingStep9(SimulationData data)
 {
     CellProcessor cellProcessor;
     cellProcessor.calcAveragedVelocities(data);
+    cellProcessor.calcRestingSteps(data);
 }
 
 __global__ void processingStep10(SimulationData data)
@@ -92,6 +113,7 @@ __global__ void processingStep10(SimulationData data)
     CellProcessor cellProcessor;
     cellProcessor.applyAveragedVelocities(data);
     cellProcessor.decay(data);
+    cellProcessor.applyRestingSteps(data);
 }
 
 __global__ void processingStep11(SimulationData data)
@@ -113,25 +135,49 @@ __global__ void processingStep12(SimulationData data, int numParticlePointers)
 
 __global__ void calcSimulationTimestepKernel(SimulationData data, SimulationResult result)
 {
+    auto timepoint = SimulationResult::getGlobalTime();
     data.prepareForSimulation();
     result.resetStatistics();
 
     KERNEL_CALL_1_1(applyFlowFieldSettingsKernel, data);
     KERNEL_CALL(processingStep1, data);
+    result.measurePhase(EnginePhase::Preparation, timepoint);
+    data.neighborList.resetUpdateCheck();
+    KERNEL_CALL(calcNeighborListDisplacements, data);
+    if (data.neighborList.needsRebuild(data.entities.cells)) {
+        data.neighborList.prepareBuild(data.entities.cells);
+        KERNEL_CALL(buildNeighborLists, data);
+    } else if (data.neighborList.hasNewCells()) {
+        KERNEL_CALL(insertNewCellsIntoNeighborLists, data);
+        KERNEL_CALL(buildNeighborListsForNewCells, data);
+    }
+    result.measurePhase(EnginePhase::NeighborLists, timepoint);
     KERNEL_CALL(processingStep2, data);
+    result.measurePhase(EnginePhase::ProcessingStep2, timepoint);
     KERNEL_CALL(processingStep3, data);
+    result.measurePhase(EnginePhase::ProcessingStep3, timepoint);
     KERNEL_CALL(processingStep4, data, data.entities.tokenPointers.getNumEntries());
+    result.measurePhase(EnginePhase::ProcessingStep4, timepoint);
     KERNEL_CALL(processingStep5, data);
+    result.measurePhase(EnginePhase::ProcessingStep5, timepoint);
     KERNEL_CALL(processingStep6, data, result);
+    result.measurePhase(EnginePhase::ProcessingStep6, timepoint);
     KERNEL_CALL(processingStep7, data, data.entities.cellPointers.getNumEntries());
+    result.measurePhase(EnginePhase::ProcessingStep7, timepoint);
     KERNEL_CALL(processingStep8, data, result, data.entities.tokenPointers.getNumEntries());
+    result.measurePhase(EnginePhase::ProcessingStep8, timepoint);
     KERNEL_CALL(processingStep9, data);
+    result.measurePhase(EnginePhase::ProcessingStep9, timepoint);
     KERNEL_CALL(processingStep10, data);
+    result.measurePhase(EnginePhase::ProcessingStep10, timepoint);
     KERNEL_CALL(processingStep11, data);
+    result.measurePhase(EnginePhase::ProcessingStep11, timepoint);
     KERNEL_CALL(processingStep12, data, data.entities.particlePointers.getNumEntries());
+    result.measurePhase(EnginePhase::ProcessingStep12, timepoint);
 
     KERNEL_CALL_1_1(cleanupAfterSimulationKernel, data);
 
     result.setArrayResizeNeeded(data.shouldResize());
+    result.accumulateStatistics();
+    result.measurePhase(EnginePhase::Cleanup, timepoint);
 }
-
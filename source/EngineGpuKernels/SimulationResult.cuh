@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include "EngineInterface/EngineMetrics.h"
+
 class SimulationResult
 {
 public:
@@ -7,12 +9,18 @@ public:
     {
         CudaMemoryManager::getInstance().acquireMemory<bool>(1, _arrayResizingNeeded);
         CudaMemoryManager::getInstance().acquireMemory<Statistics>(1, _statistics);
+        CudaMemoryManager::getInstance().acquireMemory<TotalStatistics>(1, _totalStatistics);
+        CudaMemoryManager::getInstance().acquireMemory<unsigned long long>(EnginePhase::Count, _phaseNanoseconds);
         Statistics statistics;
         CHECK_FOR_CUDA_ERROR(cudaMemcpy(_statistics, &statistics, sizeof(Statistics), cudaMemcpyHostToDevice));
+        CHECK_FOR_CUDA_ERROR(cudaMemset(_totalStatistics, 0, sizeof(TotalStatistics)));
+        CHECK_FOR_CUDA_ERROR(cudaMemset(_phaseNanoseconds, 0, sizeof(unsigned long long) * EnginePhase::Count));
     }
 
     __host__ void free() {
         CudaMemoryManager::getInstance().freeMemory(_statistics);
+        CudaMemoryManager::getInstance().freeMemory(_totalStatistics);
+        CudaMemoryManager::getInstance().freeMemory(_phaseNanoseconds);
         CudaMemoryManager::getInstance().freeMemory(_arrayResizingNeeded);
     }
 
@@ -37,6 +45,28 @@ public:
         return result;
     }
 
+    struct TotalStatistics
+    {
+        unsigned long long createdCells;
+        unsigned long long sucessfulAttacks;
+        unsigned long long failedAttacks;
+        unsigned long long muscleActivities;
+    };
+    __host__ TotalStatistics getTotalStatistics()
+    {
+        TotalStatistics result;
+        CHECK_FOR_CUDA_ERROR(
+            cudaMemcpy(&result, _totalStatistics, sizeof(TotalStatistics), cudaMemcpyDeviceToHost));
+        return result;
+    }
+
+    __host__ void getPhaseNanoseconds(uint64_t (&result)[EnginePhase::Count])
+    {
+        static_assert(sizeof(unsigned long long) == sizeof(uint64_t));
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+            result, _phaseNanoseconds, sizeof(unsigned long long) * EnginePhase::Count, cudaMemcpyDeviceToHost));
+    }
+
     __device__ void setArrayResizeNeeded(bool value) { *_arrayResizingNeeded = value; }
 
     __device__ void resetStatistics() { *_statistics = Statistics(); }
@@ -45,7 +75,33 @@ public:
     __device__ void incFailedAttack() { atomicAdd(&_statistics->failedAttacks, 1); }
     __device__ void incMuscleActivity() { atomicAdd(&_statistics->muscleActivities, 1); }
 
+    //should be called with one thread at the end of a time step
+    __device__ void accumulateStatistics()
+    {
+        _totalStatistics->createdCells += _statistics->createdCells;
+        _totalStatistics->sucessfulAttacks += _statistics->sucessfulAttacks;
+        _totalStatistics->failedAttacks += _statistics->failedAttacks;
+        _totalStatistics->muscleActivities += _statistics->muscleActivities;
+    }
+
+    __device__ static unsigned long long getGlobalTime()
+    {
+        unsigned long long result;
+        asm volatile("mov.u64 %0, %%globaltimer;" : "=l"(result));
+        return result;
+    }
+
+    //adds the time since timepoint to the phase and updates timepoint, should be called with one thread
+    __device__ void measurePhase(EnginePhase::Type phase, unsigned long long& timepoint)
+    {
+        auto now = getGlobalTime();
+        _phaseNanoseconds[phase] += now - timepoint;
+        timepoint = now;
+    }
+
 private:
     Statistics* _statistics;
+    TotalStatistics* _totalStatistics;
+    unsigned long long* _phaseNanoseconds;
     bool* _arrayResizingNeeded;
 };
\ No newline at end of file
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+
+#include "Base.cuh"
+#include "Array.cuh"
+#include "Cell.cuh"
+#include "Map.cuh"
+#include "Particle.cuh"
+#include "PrefixSum.cuh"
+
+#define SPATIAL_INDEX_TILE_SIZE 32
+
+//inclusive range of tiles which is not corrected, i.e. it may exceed the world in case of wrapping
+struct TileRange
+{
+    int2 fromTile;
+    int2 toTile;
+};
+
+/**
+ * Coarse index of entities by tile. The entities are sorted by tile such that each row of tiles within a tile range
+ * refers to a contiguous slice. Queries visit the slices of the tiles overlapping the query region and test the
+ * entities exactly afterwards. The tile starts are obtained from a parallel prefix sum over the tile counts.
+ */
+template <typename Entity>
+class TileIndex : public MapInfo
+{
+public:
+    __host__ __inline__ void init(int2 const& universeSize, int tileSize)
+    {
+        MapInfo::init(universeSize);
+        _numTiles = {
+            std::max(1, (universeSize.x + tileSize - 1) / tileSize),
+            std::max(1, (universeSize.y + tileSize - 1) / tileSize)};
+        _tileSize = tileSize;
+
+        auto numTiles = _numTiles.x * _numTiles.y;
+        CudaMemoryManager::getInstance().acquireMemory<int>(numTiles, _numEntitiesByTile);
+        CudaMemoryManager::getInstance().acquireMemory<int>(numTiles + 1, _tileStarts);
+        CHECK_FOR_CUDA_ERROR(cudaMemset(_numEntitiesByTile, 0, sizeof(int) * numTiles));
+        CHECK_FOR_CUDA_ERROR(cudaMemset(_tileStarts, 0, sizeof(int) * (numTiles + 1)));
+        _prefixSum.init(numTiles);
+        _entities.init();
+    }
+
+    __host__ __inline__ void resize(int maxEntries) { _entities.resize(maxEntries); }
+
+    __host__ __inline__ void free()
+    {
+        CudaMemoryManager::getInstance().freeMemory(_numEntitiesByTile);
+        CudaMemoryManager::getInstance().freeMemory(_tileStarts);
+        _prefixSum.free();
+        _entities.free();
+    }
+
+    //the index is built by calling reset_system, count_system, calcChunkSums_system, reserveEntities,
+    //calcTileStarts_system and insert_system in separate kernels
+    __device__ __inline__ void reset_system()
+    {
+        auto const partition = calcAllThreadsPartition(getNumTiles());
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            _numEntitiesByTile[index] = 0;
+        }
+    }
+
+    __device__ __inline__ void count_system(Array<Entity*> const& entities)
+    {
+        auto const partition = calcAllThreadsPartition(entities.getNumEntries());
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            if (auto const& entity = entities.at(index)) {
+                atomicAdd(&_numEntitiesByTile[getTileIndex(entity->absPos)], 1);
+            }
+        }
+    }
+
+    __device__ __inline__ void calcChunkSums_system()
+    {
+        _prefixSum.calcChunkSums_system(_numEntitiesByTile, getNumTiles());
+    }
+
+    //should be called with one thread
+    __device__ __inline__ void reserveEntities()
+    {
+        auto numEntities = _prefixSum.scanChunkSums(_tileStarts, getNumTiles());
+        _entities.reset();
+        _entities.getNewSubarray(numEntities);
+    }
+
+    __device__ __inline__ void calcTileStarts_system()
+    {
+        _prefixSum.calcPrefixSums_system(_numEntitiesByTile, _tileStarts, getNumTiles());
+    }
+
+    //the tile counts are consumed such that each tile is filled from its end
+    __device__ __inline__ void insert_system(Array<Entity*> const& entities)
+    {
+        auto const partition = calcAllThreadsPartition(entities.getNumEntries());
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            if (auto const& entity = entities.at(index)) {
+                auto tile = getTileIndex(entity->absPos);
+                _entities.at(_tileStarts[tile] + atomicSub(&_numEntitiesByTile[tile], 1) - 1) = entity;
+            }
+        }
+    }
+
+    //the range covers the rectangle with a margin of one tile for positions which are not yet mapped into the world
+    __device__ __inline__ TileRange getTileRange(float2 const& rectUpperLeft, float2 const& rectLowerRight) const
+    {
+        TileRange result{
+            {floorInt(rectUpperLeft.x / _tileSize) - 1, floorInt(rectUpperLeft.y / _tileSize) - 1},
+            {floorInt(rectLowerRight.x / _tileSize) + 1, floorInt(rectLowerRight.y / _tileSize) + 1}};
+        if (result.toTile.x - result.fromTile.x + 1 >= _numTiles.x) {
+            result.fromTile.x = 0;
+            result.toTile.x = _numTiles.x - 1;
+        }
+        if (result.toTile.y - result.fromTile.y + 1 >= _numTiles.y) {
+            result.fromTile.y = 0;
+            result.toTile.y = _numTiles.y - 1;
+        }
+        return result;
+    }
+
+    //each row of tiles consists of at most two slices due to wrapping
+    __device__ __inline__ int getNumSlices(TileRange const& range) const
+    {
+        return max(0, range.toTile.y - range.fromTile.y + 1) * 2;
+    }
+
+    __device__ __inline__ Entity** getSlice(TileRange const& range, int slice, int& numEntities) const
+    {
+        auto const tileY = correctTile(range.fromTile.y + slice / 2, _numTiles.y);
+        auto const fromTileX = correctTile(range.fromTile.x, _numTiles.x);
+        auto const numTilesX = range.toTile.x - range.fromTile.x + 1;
+
+        int fromTile, toTile;
+        if (0 == slice % 2) {
+            fromTile = fromTileX;
+            toTile = min(fromTileX + numTilesX, _numTiles.x);
+        } else {
+            fromTile = 0;
+            toTile = max(0, fromTileX + numTilesX - _numTiles.x);
+        }
+        auto const rowOffset = tileY * _numTiles.x;
+        auto const start = _tileStarts[rowOffset + fromTile];
+        numEntities = _tileStarts[rowOffset + toTile] - start;
+        return _entities.getArray() + start;
+    }
+
+private:
+    __device__ __inline__ int getNumTiles() const { return _numTiles.x * _numTiles.y; }
+
+    __device__ __inline__ int getTileIndex(float2 pos) const
+    {
+        mapPosCorrection(pos);
+        auto tileX = min(floorInt(pos.x) / _tileSize, _numTiles.x - 1);
+        auto tileY = min(floorInt(pos.y) / _tileSize, _numTiles.y - 1);
+        return tileX + tileY * _numTiles.x;
+    }
+
+    __device__ __inline__ static int correctTile(int tile, int numTiles)
+    {
+        return ((tile % numTiles) + numTiles) % numTiles;
+    }
+
+    int2 _numTiles;
+    int _tileSize;
+    int* _numEntitiesByTile;
+    int* _tileStarts;
+    PrefixSum _prefixSum;
+    Array<Entity*> _entities;
+};
+
+/**
+ * Tile indices of the cells and particles for region queries. The index is built at the end of each time step together
+ * with the map cleanup. Data manipulations outside the time step invalidate it such that it is rebuilt on the next
+ * query (see updateSpatialIndex).
+ */
+struct SpatialIndex
+{
+    TileIndex<Cell> cells;
+    TileIndex<Particle> particles;
+
+    __host__ __inline__ void init(int2 const& universeSize)
+    {
+        cells.init(universeSize, SPATIAL_INDEX_TILE_SIZE);
+        particles.init(universeSize, SPATIAL_INDEX_TILE_SIZE);
+        CudaMemoryManager::getInstance().acquireMemory<int>(1, _valid);
+        invalidate_host();
+    }
+
+    __host__ __inline__ void resize(int maxCells, int maxParticles)
+    {
+        cells.resize(maxCells);
+        particles.resize(maxParticles);
+        invalidate_host();
+    }
+
+    __host__ __inline__ void free()
+    {
+        cells.free();
+        particles.free();
+        CudaMemoryManager::getInstance().freeMemory(_valid);
+    }
+
+    __host__ __inline__ void invalidate_host() { CHECK_FOR_CUDA_ERROR(cudaMemset(_valid, 0, sizeof(int))); }
+
+    __device__ __inline__ void invalidate() { *_valid = 0; }
+    __device__ __inline__ void validate() { *_valid = 1; }
+    __device__ __inline__ bool isValid() const { return 1 == *_valid; }
+
+private:
+    int* _valid;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "cuda_runtime_api.h"
+#include "sm_60_atomic_functions.h"
+
+#include "Base.cuh"
+#include "SimulationData.cuh"
+#include "SpatialIndex.cuh"
+
+__global__ void resetSpatialIndex(SimulationData data)
+{
+    data.spatialIndex.cells.reset_system();
+    data.spatialIndex.particles.reset_system();
+}
+
+__global__ void countEntitiesForSpatialIndex(SimulationData data)
+{
+    data.spatialIndex.cells.count_system(data.entities.cellPointers);
+    data.spatialIndex.particles.count_system(data.entities.particlePointers);
+}
+
+__global__ void calcSpatialIndexChunkSums(SimulationData data)
+{
+    data.spatialIndex.cells.calcChunkSums_system();
+    data.spatialIndex.particles.calcChunkSums_system();
+}
+
+__global__ void reserveSpatialIndex(SimulationData data)
+{
+    data.spatialIndex.cells.reserveEntities();
+    data.spatialIndex.particles.reserveEntities();
+}
+
+__global__ void calcSpatialIndexTileStarts(SimulationData data)
+{
+    data.spatialIndex.cells.calcTileStarts_system();
+    data.spatialIndex.particles.calcTileStarts_system();
+}
+
+__global__ void insertEntitiesIntoSpatialIndex(SimulationData data)
+{
+    data.spatialIndex.cells.insert_system(data.entities.cellPointers);
+    data.spatialIndex.particles.insert_system(data.entities.particlePointers);
+}
+
+/************************************************************************/
+/* Main      															*/
+/************************************************************************/
+
+//should be called with one thread before region queries, it only rebuilds an invalidated index
+__global__ void updateSpatialIndex(SimulationData data)
+{
+    if (data.spatialIndex.isValid()) {
+        return;
+    }
+    KERNEL_CALL(resetSpatialIndex, data);
+    KERNEL_CALL(countEntitiesForSpatialIndex, data);
+    KERNEL_CALL(calcSpatialIndexChunkSums, data);
+    KERNEL_CALL_1_1(reserveSpatialIndex, data);
+    KERNEL_CALL(calcSpatialIndexTileStarts, data);
+    KERNEL_CALL(insertEntitiesIntoSpatialIndex, data);
+    data.spatialIndex.validate();
+}
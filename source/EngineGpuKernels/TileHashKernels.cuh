@@ -0,0 +1,144 @@
+#pragma once
+
+#include "cuda_runtime_api.h"
+#include "sm_60_atomic_functions.h"
+
+#include "SimulationData.cuh"
+
+struct TileHashData
+{
+    int tileSize;
+    float positionTolerance;
+    int2 numTiles;
+    unsigned long long int* hashes;
+};
+
+/************************************************************************/
+/* Helpers    															*/
+/************************************************************************/
+
+__device__ __inline__ uint64_t mixTileHash(uint64_t hash, uint64_t value)
+{
+    //finalizer of splitmix64
+    value += hash + 0x9e3779b97f4a7c15ull;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+__device__ __inline__ uint64_t mixTileHash(uint64_t hash, float2 const& pos, float positionTolerance)
+{
+    hash = mixTileHash(hash, static_cast<uint32_t>(__float2int_rd(pos.x / positionTolerance)));
+    return mixTileHash(hash, static_cast<uint32_t>(__float2int_rd(pos.y / positionTolerance)));
+}
+
+__device__ __inline__ uint64_t mixTileHash(uint64_t hash, float2 const& vel)
+{
+    hash = mixTileHash(hash, __float_as_uint(vel.x));
+    return mixTileHash(hash, __float_as_uint(vel.y));
+}
+
+__device__ __inline__ uint64_t mixTileHash(uint64_t hash, char const* bytes, int numBytes)
+{
+    for (int i = 0; i < numBytes; ++i) {
+        hash = mixTileHash(hash, static_cast<unsigned char>(bytes[i]));
+    }
+    return hash;
+}
+
+__device__ __inline__ int getTileIndex(float2 const& pos, TileHashData const& tileHashData)
+{
+    auto x = min(max(__float2int_rd(pos.x) / tileHashData.tileSize, 0), tileHashData.numTiles.x - 1);
+    auto y = min(max(__float2int_rd(pos.y) / tileHashData.tileSize, 0), tileHashData.numTiles.y - 1);
+    return x + y * tileHashData.numTiles.x;
+}
+
+//the hashes of the entities are summed up such that the result does not depend on the order of the entities
+__device__ __inline__ void addToTileHash(float2 const& pos, uint64_t hash, TileHashData const& tileHashData)
+{
+    atomicAdd(&tileHashData.hashes[getTileIndex(pos, tileHashData)], static_cast<unsigned long long int>(hash));
+}
+
+__global__ void clearTileHashes(TileHashData tileHashData)
+{
+    auto const partition = calcAllThreadsPartition(tileHashData.numTiles.x * tileHashData.numTiles.y);
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        tileHashData.hashes[index] = 0;
+    }
+}
+
+//all properties which are serialized are included such that each change is written to the checkpoint journal
+__global__ void calcTileHashes(SimulationData data, TileHashData tileHashData)
+{
+    {
+        auto& cells = data.entities.cellPointers;
+        auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& cell = cells.at(index);
+            auto hash = mixTileHash(0, cell->id);
+            hash = mixTileHash(hash, cell->absPos, tileHashData.positionTolerance);
+            hash = mixTileHash(hash, cell->vel);
+            hash = mixTileHash(hash, __float_as_uint(cell->energy));
+            hash = mixTileHash(hash, cell->maxConnections);
+            hash = mixTileHash(hash, cell->numConnections);
+            for (int i = 0; i < cell->numConnections; ++i) {
+                auto const& connection = cell->connections[i];
+                hash = mixTileHash(hash, connection.cell->id);
+                hash = mixTileHash(hash, __float_as_uint(connection.distance));
+                hash = mixTileHash(hash, __float_as_uint(connection.angleFromPrevious));
+            }
+            hash = mixTileHash(hash, cell->branchNumber);
+            hash = mixTileHash(hash, cell->tokenBlocked ? 1 : 0);
+            hash = mixTileHash(hash, cell->tokenUsages);
+            hash = mixTileHash(hash, cell->cellFunctionType);
+            hash = mixTileHash(hash, cell->numStaticBytes);
+            hash = mixTileHash(hash, cell->staticData, cell->numStaticBytes);
+            hash = mixTileHash(hash, cell->numMutableBytes);
+            hash = mixTileHash(hash, cell->mutableData, cell->numMutableBytes);
+
+            auto const& metadata = cell->metadata;
+            hash = mixTileHash(hash, metadata.color);
+            hash = mixTileHash(hash, metadata.nameLen);
+            hash = mixTileHash(hash, metadata.name, metadata.nameLen);
+            hash = mixTileHash(hash, metadata.descriptionLen);
+            hash = mixTileHash(hash, metadata.description, metadata.descriptionLen);
+            hash = mixTileHash(hash, metadata.sourceCodeLen);
+            hash = mixTileHash(hash, metadata.sourceCode, metadata.sourceCodeLen);
+            addToTileHash(cell->absPos, hash, tileHashData);
+        }
+    }
+    {
+        auto& tokens = data.entities.tokenPointers;
+        auto const partition = calcAllThreadsPartition(tokens.getNumEntries());
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& token = tokens.at(index);
+            auto hash = mixTileHash(1, token->cell->id);
+            hash = mixTileHash(hash, __float_as_uint(token->energy));
+            hash = mixTileHash(hash, token->memory, data.tokenMemorySize);
+            addToTileHash(token->cell->absPos, hash, tileHashData);
+        }
+    }
+    {
+        auto& particles = data.entities.particlePointers;
+        auto const partition = calcAllThreadsPartition(particles.getNumEntries());
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& particle = particles.at(index);
+            auto hash = mixTileHash(2, particle->id);
+            hash = mixTileHash(hash, particle->absPos, tileHashData.positionTolerance);
+            hash = mixTileHash(hash, particle->vel);
+            hash = mixTileHash(hash, __float_as_uint(particle->energy));
+            hash = mixTileHash(hash, particle->metadata.color);
+            addToTileHash(particle->absPos, hash, tileHashData);
+        }
+    }
+}
+
+/************************************************************************/
+/* Main      															*/
+/************************************************************************/
+
+__global__ void cudaCalcTileHashes(SimulationData data, TileHashData tileHashData)
+{
+    KERNEL_CALL(clearTileHashes, tileHashData);
+    KERNEL_CALL(calcTileHashes, data, tileHashData);
+}
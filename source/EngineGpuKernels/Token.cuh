@@ -5,7 +5,7 @@
 
 struct Token
 {
-    char memory[MAX_TOKEN_MEM_SIZE];
+    char* memory;   //points to Entities::tokenMemory with stride cudaSimulationParameters.tokenMemorySize
     Cell* sourceCell;
     Cell* cell;
     float energy;
@@ -65,6 +65,7 @@ __inline__ __device__ void TokenProcessor::movement(SimulationData& data, int nu
                 }
 
                 auto tokenIndex = atomicAdd(&connectedCell->tag, 1);
+                connectedCell->wakeUp();
                 if (tokenIndex >= cudaSimulationParameters.cellMaxToken) {
                     continue;
                 }
@@ -77,7 +78,8 @@ __inline__ __device__ void TokenProcessor::movement(SimulationData& data, int nu
 
                     
                     if (data.numberGen.random() < tokenMutationRate) {
-                        token->memory[data.numberGen.random(MAX_TOKEN_MEM_SIZE - 1)] = data.numberGen.random(255);
+                        auto index = data.numberGen.random(cudaSimulationParameters.tokenMemorySize - 1);
+                        token->memory[index] = data.numberGen.random(255);
                     }
                 } else {
                     auto origEnergy = atomicAdd(&connectedCell->energy, -token->energy); 
@@ -142,7 +144,7 @@ TokenProcessor::executeModifyingCellFunctions(SimulationData& data, SimulationRe
 
                     EnergyGuidance::processing(data, token);
                     if (Enums::CellFunction::COMPUTER == cellFunctionType) {
-                        CellComputerFunction::processing(token);
+                        CellComputerFunction::processing(token, data);
                     }
                     if (Enums::CellFunction::CONSTRUCTOR == cellFunctionType) {
                         ConstructorFunction::processing(token, data, result);
@@ -30,7 +30,7 @@ __inline__ __device__ void WeaponFunction::processing(Token* token, SimulationDa
 
     Cell* otherCells[18];
     int numOtherCells;
-    data.cellMap.get(otherCells, 18, numOtherCells, cell->absPos, 1.6f);
+    data.neighborList.get(otherCells, 18, numOtherCells, cell, CELL_FUNCTION_WEAPON_RANGE, data.cellMap);
     for (int i = 0; i < numOtherCells; ++i) {
         Cell* otherCell = otherCells[i];
 
@@ -0,0 +1,269 @@
+#pragma once
+
+#include "EngineInterface/WorldResizeMode.h"
+
+#include "cuda_runtime_api.h"
+#include "sm_60_atomic_functions.h"
+
+#include "Base.cuh"
+#include "CellConnectionProcessor.cuh"
+#include "CleanupKernels.cuh"
+#include "ClusterLabelKernels.cuh"
+#include "Map.cuh"
+#include "SimulationData.cuh"
+
+struct WorldResizeData
+{
+    WorldResizeMode::Type mode;
+    int2 origSize;
+    int2 newSize;
+    int2 numCopies;     //copies of the original world in x and y direction, the original is the first copy
+
+    //set in cudaResizeWorld
+    int numCells;
+    int numParticles;
+    int numTokens;
+    Cell* cellCopies;   //numCells entries for each additional copy
+    Particle* particleCopies;
+    Token* tokenCopies;
+    char* tokenMemoryCopies;
+};
+
+/************************************************************************/
+/* Helpers    															*/
+/************************************************************************/
+
+__device__ __inline__ float2 getWorldCopyOffset(WorldResizeData const& resizeData, int copyIndex)
+{
+    return {
+        static_cast<float>((copyIndex % resizeData.numCopies.x) * resizeData.origSize.x),
+        static_cast<float>((copyIndex / resizeData.numCopies.x) * resizeData.origSize.y)};
+}
+
+//the decision is made for whole clusters based on the position of their root cell
+__device__ __inline__ bool isWorldCopyContained(WorldResizeData const& resizeData, float2 const& origPos, int copyIndex)
+{
+    if (WorldResizeMode::Remap == resizeData.mode) {
+        return true;
+    }
+    auto pos = origPos + getWorldCopyOffset(resizeData, copyIndex);
+    return pos.x < resizeData.newSize.x && pos.y < resizeData.newSize.y;
+}
+
+__device__ __inline__ Cell* getCellCopy(WorldResizeData const& resizeData, Cell* origCell, int copyIndex)
+{
+    return resizeData.cellCopies + (copyIndex - 1) * resizeData.numCells + origCell->tag;
+}
+
+__device__ __inline__ float2 getPosInResizedWorld(WorldResizeData const& resizeData, float2 const& pos, int copyIndex)
+{
+    MapInfo newMap;
+    newMap.init(resizeData.newSize);
+    auto result = pos + getWorldCopyOffset(resizeData, copyIndex);
+    newMap.mapPosCorrection(result);
+    return result;
+}
+
+//temp1 = position in the original world, temp2 = position relative to the cluster root without wrap-around
+__global__ void prepareCellsForWorldResize(WorldResizeData resizeData, SimulationData data)
+{
+    MapInfo origMap;
+    origMap.init(resizeData.origSize);
+
+    auto& cells = data.entities.cellPointers;
+    auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& cell = cells.at(index);
+        cell->tag = index;
+        cell->temp1 = cell->absPos;
+
+        auto root = cell->clusterParent;
+        auto displacement = cell->absPos - root->absPos;
+        origMap.mapDisplacementCorrection(displacement);
+        cell->temp2 = root->absPos + displacement;
+    }
+}
+
+//the copies are appended to the pointer arrays, hence only the first numCells/numTokens/numParticles are iterated
+__global__ void copyCellsForWorldResize(WorldResizeData resizeData, SimulationData data)
+{
+    auto& cells = data.entities.cellPointers;
+    auto const partition = calcAllThreadsPartition(resizeData.numCells);
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& cell = cells.at(index);
+        for (int copyIndex = 1; copyIndex < resizeData.numCopies.x * resizeData.numCopies.y; ++copyIndex) {
+            if (!isWorldCopyContained(resizeData, cell->clusterParent->temp1, copyIndex)) {
+                continue;
+            }
+            auto cellCopy = getCellCopy(resizeData, cell, copyIndex);
+            *cellCopy = *cell;
+            cellCopy->id = data.numberGen.createNewId_kernel();
+            cellCopy->absPos = getPosInResizedWorld(resizeData, cell->temp2, copyIndex);
+            cellCopy->selected = 0;
+            cellCopy->locked = 0;
+            cellCopy->numNeighbors = NeighborListState::NotInserted;
+            cellCopy->computerProgram = nullptr;
+            cellCopy->clusterParent = getCellCopy(resizeData, cell->clusterParent, copyIndex);
+            for (int i = 0; i < cell->numConnections; ++i) {
+                cellCopy->connections[i].cell = getCellCopy(resizeData, cell->connections[i].cell, copyIndex);
+            }
+            *data.entities.cellPointers.getNewElement() = cellCopy;
+        }
+    }
+}
+
+__global__ void copyTokensForWorldResize(WorldResizeData resizeData, SimulationData data)
+{
+    auto& tokens = data.entities.tokenPointers;
+    auto const partition = calcAllThreadsPartition(resizeData.numTokens);
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& token = tokens.at(index);
+        for (int copyIndex = 1; copyIndex < resizeData.numCopies.x * resizeData.numCopies.y; ++copyIndex) {
+            if (!isWorldCopyContained(resizeData, token->cell->clusterParent->temp1, copyIndex)) {
+                continue;
+            }
+            auto copyOffset = (copyIndex - 1) * resizeData.numTokens + index;
+            auto tokenCopy = resizeData.tokenCopies + copyOffset;
+            *tokenCopy = *token;
+            tokenCopy->memory = resizeData.tokenMemoryCopies + static_cast<uint64_t>(copyOffset) * data.tokenMemorySize;
+            for (int i = 0; i < data.tokenMemorySize; ++i) {
+                tokenCopy->memory[i] = token->memory[i];
+            }
+            tokenCopy->cell = getCellCopy(resizeData, token->cell, copyIndex);
+            tokenCopy->sourceCell = token->sourceCell->clusterParent == token->cell->clusterParent
+                ? getCellCopy(resizeData, token->sourceCell, copyIndex)
+                : tokenCopy->cell;
+            *data.entities.tokenPointers.getNewElement() = tokenCopy;
+        }
+    }
+}
+
+__global__ void copyParticlesForWorldResize(WorldResizeData resizeData, SimulationData data)
+{
+    auto& particles = data.entities.particlePointers;
+    auto const partition = calcAllThreadsPartition(resizeData.numParticles);
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& particle = particles.at(index);
+        for (int copyIndex = 1; copyIndex < resizeData.numCopies.x * resizeData.numCopies.y; ++copyIndex) {
+            if (!isWorldCopyContained(resizeData, particle->absPos, copyIndex)) {
+                continue;
+            }
+            auto particleCopy = resizeData.particleCopies + (copyIndex - 1) * resizeData.numParticles + index;
+            *particleCopy = *particle;
+            particleCopy->id = data.numberGen.createNewId_kernel();
+            particleCopy->absPos = getPosInResizedWorld(resizeData, particle->absPos, copyIndex);
+            particleCopy->selected = 0;
+            particleCopy->locked = 0;
+            *data.entities.particlePointers.getNewElement() = particleCopy;
+        }
+    }
+}
+
+//the originals are processed after the copies since their positions and pointers are changed
+__global__ void remapOriginalsForWorldResize(WorldResizeData resizeData, SimulationData data)
+{
+    {
+        auto& cells = data.entities.cellPointers;
+        auto const partition = calcAllThreadsPartition(resizeData.numCells);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+            if (isWorldCopyContained(resizeData, cell->clusterParent->temp1, 0)) {
+                cell->absPos = getPosInResizedWorld(resizeData, cell->temp2, 0);
+                cell->numNeighbors = NeighborListState::NotInserted;
+            } else {
+                cell = nullptr;
+            }
+        }
+    }
+    {
+        auto& tokens = data.entities.tokenPointers;
+        auto const partition = calcAllThreadsPartition(resizeData.numTokens);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& token = tokens.at(index);
+            if (!isWorldCopyContained(resizeData, token->cell->clusterParent->temp1, 0)) {
+                token = nullptr;
+            } else if (!isWorldCopyContained(resizeData, token->sourceCell->clusterParent->temp1, 0)) {
+                token->sourceCell = token->cell;
+            }
+        }
+    }
+    {
+        auto& particles = data.entities.particlePointers;
+        auto const partition = calcAllThreadsPartition(resizeData.numParticles);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& particle = particles.at(index);
+            if (isWorldCopyContained(resizeData, particle->absPos, 0)) {
+                particle->absPos = getPosInResizedWorld(resizeData, particle->absPos, 0);
+            } else {
+                particle = nullptr;
+            }
+        }
+    }
+}
+
+//bonds whose displacement changes in the resized world would span a seam (e.g. clusters larger than half the world)
+__global__ void removeSeamConnectionsForWorldResize(WorldResizeData resizeData, SimulationData data)
+{
+    MapInfo origMap;
+    origMap.init(resizeData.origSize);
+    MapInfo newMap;
+    newMap.init(resizeData.newSize);
+
+    auto& cells = data.entities.cellPointers;
+    auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& cell = cells.at(index);
+        if (!cell) {
+            continue;
+        }
+
+        //the criterion is symmetric, hence each cell only removes its own side of a bond and no locking is required
+        for (int i = cell->numConnections - 1; i >= 0; --i) {
+            auto connectedCell = cell->connections[i].cell;
+            auto origDisplacement = connectedCell->temp1 - cell->temp1;
+            origMap.mapDisplacementCorrection(origDisplacement);
+            auto newDisplacement = connectedCell->absPos - cell->absPos;
+            newMap.mapDisplacementCorrection(newDisplacement);
+            if (Math::length(newDisplacement - origDisplacement) > 0.5f) {
+                CellConnectionProcessor::delConnectionOneWay(cell, connectedCell);
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/* Main      															*/
+/************************************************************************/
+
+__global__ void cudaResizeWorld(WorldResizeData resizeData, SimulationData data)
+{
+    KERNEL_CALL_1_1(updateClusterLabels, data.entities.cellPointers);
+    KERNEL_CALL(prepareCellsForWorldResize, resizeData, data);
+
+    resizeData.numCells = data.entities.cellPointers.getNumEntries();
+    resizeData.numParticles = data.entities.particlePointers.getNumEntries();
+    resizeData.numTokens = data.entities.tokenPointers.getNumEntries();
+
+    auto numAdditionalCopies = resizeData.numCopies.x * resizeData.numCopies.y - 1;
+    if (numAdditionalCopies > 0) {
+        if (resizeData.numCells > 0) {
+            resizeData.cellCopies = data.entities.cells.getNewSubarray(resizeData.numCells * numAdditionalCopies);
+        }
+        if (resizeData.numParticles > 0) {
+            resizeData.particleCopies =
+                data.entities.particles.getNewSubarray(resizeData.numParticles * numAdditionalCopies);
+        }
+        if (resizeData.numTokens > 0) {
+            resizeData.tokenCopies = data.entities.tokens.getNewSubarray(resizeData.numTokens * numAdditionalCopies);
+            auto tokenMemorySize =
+                static_cast<uint64_t>(resizeData.numTokens) * numAdditionalCopies * data.tokenMemorySize;
+            resizeData.tokenMemoryCopies = data.entities.tokenMemory.getNewSubarray(static_cast<int>(tokenMemorySize));
+        }
+        KERNEL_CALL(copyCellsForWorldResize, resizeData, data);
+        KERNEL_CALL(copyTokensForWorldResize, resizeData, data);
+        KERNEL_CALL(copyParticlesForWorldResize, resizeData, data);
+    }
+    KERNEL_CALL(remapOriginalsForWorldResize, resizeData, data);
+    KERNEL_CALL(removeSeamConnectionsForWorldResize, resizeData, data);
+    KERNEL_CALL_1_1(cleanupAfterDataManipulationKernel, data);
+}
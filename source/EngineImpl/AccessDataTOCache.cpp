@@ -72,6 +72,8 @@ DataAccessTO _AccessDataTOCache::getNewDataTO()
         result.cells = new CellAccessTO[_arraySizes->cellArraySize];
         result.particles = new ParticleAccessTO[_arraySizes->particleArraySize];
         result.tokens = new TokenAccessTO[_arraySizes->tokenArraySize];
+        result.tokenMemory = new char[static_cast<uint64_t>(_arraySizes->tokenArraySize) * _arraySizes->tokenMemorySize];
+        result.tokenMemorySize = _arraySizes->tokenMemorySize;
         result.stringBytes = new char[Const::MetadataMemorySize];
         return result;
     } catch (std::bad_alloc const&) {
@@ -88,5 +90,6 @@ void _AccessDataTOCache::deleteDataTO(DataAccessTO const& dataTO)
     delete[] dataTO.cells;
     delete[] dataTO.particles;
     delete[] dataTO.tokens;
+    delete[] dataTO.tokenMemory;
     delete[] dataTO.stringBytes;
 }
@@ -17,11 +17,12 @@ public:
         int cellArraySize;
         int particleArraySize;
         int tokenArraySize;
+        int tokenMemorySize;
 
         bool operator==(ArraySizes const& other) const
         {
             return cellArraySize == other.cellArraySize && particleArraySize == other.particleArraySize
-                && tokenArraySize == other.tokenArraySize;
+                && tokenArraySize == other.tokenArraySize && tokenMemorySize == other.tokenMemorySize;
         }
 
         bool operator!=(ArraySizes const& other) const { return !operator==(other); };
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "EngineGpuKernels/CellComputerProgram.cuh"
+
+/**
+ * Lockstep execution of a cell computer program for a batch of computations. The vector primitives are provided by
+ * a policy class so that the execution can be compiled separately for each instruction set, see
+ * CellComputerBatchInterpreterAvx2.cpp and CellComputerBatchInterpreterAvx512.cpp.
+ *
+ * Code compiled with other instruction sets must not end up in functions with external linkage which are also used by
+ * the generic code. Otherwise the linker may pick the specialized copy. Hence the helpers have internal linkage and
+ * neither std containers nor the members of CellComputerProgram are used here.
+ */
+namespace CellComputerBatch
+{
+    constexpr int NumLanes = 64;
+    constexpr uint8_t LaneInactive = 0xff;
+
+    struct BatchMemory
+    {
+        //transposed memories: byte at address a of lane l is located at [a * NumLanes + l]
+        uint8_t* tokenMemory;
+        uint8_t* cellMemory;
+
+        //only the directly accessed token memory addresses are transposed, indirect accesses to the other addresses
+        //go to the token memories of the lanes
+        bool const* isTransposed;
+        char* const* laneTokenMemories;     //unused lanes refer to a scratch memory
+        int tokenMemorySize;
+    };
+
+    //lane is active at instruction index pc if skipUntil[lane] <= pc
+    using ExecuteBatchFunction =
+        void (*)(CellComputerProgram const& program, BatchMemory const& memory, uint8_t* skipUntil);
+
+    //return nullptr if the translation unit has not been compiled for the instruction set
+    ExecuteBatchFunction getExecuteBatchAvx2();
+    ExecuteBatchFunction getExecuteBatchAvx512();
+    ExecuteBatchFunction getExecuteBatchScalar();
+}
+
+namespace CellComputerBatch
+{
+namespace
+{
+    //lanes of boolean results are 0xff for true and 0 for false
+    struct alignas(64) Lanes
+    {
+        uint8_t values[NumLanes];
+    };
+
+    //unsigned comparison as in CellComputerFunction
+    inline bool calcCondition(uint8_t operation, uint8_t operand1, uint8_t operand2)
+    {
+        switch (operation) {
+        case Enums::ComputerOperation::IFG:
+            return operand1 > operand2;
+        case Enums::ComputerOperation::IFGE:
+            return operand1 >= operand2;
+        case Enums::ComputerOperation::IFE:
+            return operand1 == operand2;
+        case Enums::ComputerOperation::IFNE:
+            return operand1 != operand2;
+        case Enums::ComputerOperation::IFLE:
+            return operand1 <= operand2;
+        case Enums::ComputerOperation::IFL:
+            return operand1 < operand2;
+        }
+        return false;
+    }
+
+    inline uint8_t calcArithmetic(uint8_t operation, int8_t operand1, uint8_t operand2)
+    {
+        switch (operation) {
+        case Enums::ComputerOperation::MOV:
+            return operand2;
+        case Enums::ComputerOperation::ADD:
+            return static_cast<uint8_t>(operand1 + operand2);
+        case Enums::ComputerOperation::SUB:
+            return static_cast<uint8_t>(operand1 - operand2);
+        case Enums::ComputerOperation::MUL:
+            return static_cast<uint8_t>(operand1 * operand2);
+        case Enums::ComputerOperation::DIV:
+            return operand2 > 0 ? static_cast<uint8_t>(operand1 / operand2) : 0;
+        case Enums::ComputerOperation::XOR:
+            return static_cast<uint8_t>(operand1 ^ operand2);
+        case Enums::ComputerOperation::OR:
+            return static_cast<uint8_t>(operand1 | operand2);
+        case Enums::ComputerOperation::AND:
+            return static_cast<uint8_t>(operand1 & operand2);
+        }
+        return 0;
+    }
+
+    inline void load(uint8_t const* source, Lanes& result) { std::memcpy(result.values, source, NumLanes); }
+
+    inline void broadcast(uint8_t value, Lanes& result) { std::memset(result.values, value, NumLanes); }
+
+    inline uint8_t& getTokenByte(BatchMemory const& memory, uint8_t address, int lane)
+    {
+        return memory.isTransposed[address] ? memory.tokenMemory[address * NumLanes + lane]
+                                            : reinterpret_cast<uint8_t&>(memory.laneTokenMemories[lane][address]);
+    }
+
+    inline void gather(BatchMemory const& memory, uint8_t const* addresses, Lanes& result)
+    {
+        for (int lane = 0; lane < NumLanes; ++lane) {
+            result.values[lane] = getTokenByte(memory, addresses[lane], lane);
+        }
+    }
+
+    inline void scatter(BatchMemory const& memory, uint8_t const* addresses, Lanes const& values, Lanes const& mask)
+    {
+        for (int lane = 0; lane < NumLanes; ++lane) {
+            if (mask.values[lane]) {
+                getTokenByte(memory, addresses[lane], lane) = values.values[lane];
+            }
+        }
+    }
+
+    //same as CellComputerProgram::convertToAddress
+    inline void convertToAddresses(Lanes& addresses, int tokenMemorySize)
+    {
+        for (int lane = 0; lane < NumLanes; ++lane) {
+            auto address = static_cast<uint32_t>(addresses.values[lane]);
+            addresses.values[lane] = static_cast<uint8_t>(address % static_cast<uint32_t>(tokenMemorySize));
+        }
+    }
+
+    inline uint8_t getMinSkipUntil(uint8_t const* skipUntil)
+    {
+        auto result = skipUntil[0];
+        for (int lane = 1; lane < NumLanes; ++lane) {
+            result = skipUntil[lane] < result ? skipUntil[lane] : result;
+        }
+        return result;
+    }
+
+    /**
+     * Simd has to provide:
+     * computeActive(skipUntil, pc, result), isAnyActive(active), compare(operation, operand1, operand2, result),
+     * arithmetic(operation, operand1, operand2, result) and blend(target, values, mask)
+     */
+    template <typename Simd>
+    void executeBatch(CellComputerProgram const& program, BatchMemory const& memory, uint8_t* skipUntil)
+    {
+        auto tokenMemory = memory.tokenMemory;
+        auto cellMemory = memory.cellMemory;
+        Lanes active, addresses1, operand1, operand2, result;
+        for (int pc = 0; pc < program.numInstructions;) {
+            Simd::computeActive(skipUntil, static_cast<uint8_t>(pc), active);
+
+            //skip instructions which are not executed by any lane
+            if (!Simd::isAnyActive(active)) {
+                pc = getMinSkipUntil(skipUntil);
+                continue;
+            }
+
+            auto const& instruction = program.instructions[pc];
+
+            //a reached ELSE means that the condition of its block was true
+            if (instruction.operation == Enums::ComputerOperation::ELSE) {
+                broadcast(instruction.jumpIfFalse, result);
+                Simd::blend(skipUntil, result, active);
+                ++pc;
+                continue;
+            }
+
+            //operand 1: pointer to mem
+            auto memory1 = instruction.opType1 == Enums::ComputerOptype::CMEM ? cellMemory : tokenMemory;
+            bool isGather1 = instruction.opType1 == Enums::ComputerOptype::MEMMEM;
+            if (isGather1) {
+                load(&tokenMemory[instruction.operand1 * NumLanes], addresses1);
+                convertToAddresses(addresses1, memory.tokenMemorySize);
+                gather(memory, addresses1.values, operand1);
+            } else {
+                load(&memory1[instruction.operand1 * NumLanes], operand1);
+            }
+
+            //operand 2: loading value
+            switch (instruction.opType2) {
+            case Enums::ComputerOptype::MEM:
+                load(&tokenMemory[instruction.operand2 * NumLanes], operand2);
+                break;
+            case Enums::ComputerOptype::MEMMEM: {
+                Lanes addresses2;
+                load(&tokenMemory[instruction.operand2 * NumLanes], addresses2);
+                convertToAddresses(addresses2, memory.tokenMemorySize);
+                gather(memory, addresses2.values, operand2);
+            } break;
+            case Enums::ComputerOptype::CMEM:
+                load(&cellMemory[instruction.operand2 * NumLanes], operand2);
+                break;
+            default:
+                broadcast(instruction.operand2, operand2);
+                break;
+            }
+
+            //if instructions
+            if (instruction.operation >= Enums::ComputerOperation::IFG) {
+                Simd::compare(instruction.operation, operand1, operand2, result);
+                for (int lane = 0; lane < NumLanes; ++lane) {
+                    result.values[lane] = active.values[lane] & ~result.values[lane];
+                }
+                Lanes jumpTarget;
+                broadcast(instruction.jumpIfFalse, jumpTarget);
+                Simd::blend(skipUntil, jumpTarget, result);
+                ++pc;
+                continue;
+            }
+
+            //execute instruction
+            Simd::arithmetic(instruction.operation, operand1, operand2, result);
+            if (isGather1) {
+                scatter(memory, addresses1.values, result, active);
+            } else {
+                Simd::blend(&memory1[instruction.operand1 * NumLanes], result, active);
+            }
+            ++pc;
+        }
+    }
+}
+}
@@ -0,0 +1,390 @@
+#include "CellComputerBatchInterpreter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+#include "Base/Definitions.h"
+#include "EngineGpuKernels/CellComputerProgram.cuh"
+
+#include "CellComputerBatchExecution.h"
+
+using namespace CellComputerBatch;
+
+namespace
+{
+    struct Batch
+    {
+        std::vector<uint8_t> tokenMemory;
+        std::vector<uint8_t> cellMemory;
+        alignas(64) uint8_t skipUntil[NumLanes];
+        bool isTransposed[MAX_TOKEN_MEM_SIZE];
+        char* tokenMemories[NumLanes];
+        char* cellMemories[NumLanes];
+        char scratchTokenMemory[MAX_TOKEN_MEM_SIZE];
+    };
+
+    struct Scalar
+    {
+        static void computeActive(uint8_t const* skipUntil, uint8_t pc, Lanes& result)
+        {
+            for (int lane = 0; lane < NumLanes; ++lane) {
+                result.values[lane] = skipUntil[lane] <= pc ? 0xff : 0;
+            }
+        }
+
+        static bool isAnyActive(Lanes const& active)
+        {
+            for (int lane = 0; lane < NumLanes; ++lane) {
+                if (active.values[lane]) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static void compare(uint8_t operation, Lanes const& operand1, Lanes const& operand2, Lanes& result)
+        {
+            for (int lane = 0; lane < NumLanes; ++lane) {
+                result.values[lane] = calcCondition(operation, operand1.values[lane], operand2.values[lane]) ? 0xff : 0;
+            }
+        }
+
+        static void arithmetic(uint8_t operation, Lanes const& operand1, Lanes const& operand2, Lanes& result)
+        {
+            for (int lane = 0; lane < NumLanes; ++lane) {
+                result.values[lane] =
+                    calcArithmetic(operation, static_cast<int8_t>(operand1.values[lane]), operand2.values[lane]);
+            }
+        }
+
+        static void blend(uint8_t* target, Lanes const& values, Lanes const& mask)
+        {
+            for (int lane = 0; lane < NumLanes; ++lane) {
+                if (mask.values[lane]) {
+                    target[lane] = values.values[lane];
+                }
+            }
+        }
+    };
+
+    void executeBatchScalar(CellComputerProgram const& program, BatchMemory const& memory, uint8_t* skipUntil)
+    {
+        executeBatch<Scalar>(program, memory, skipUntil);
+    }
+
+    //the operating system has to save the extended registers as well
+    bool isCpuFeatureSupported(CellComputerInstructionSet::Type instructionSet)
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        auto hasOsxsave = (info[2] & (1 << 27)) != 0;
+        if (!hasOsxsave) {
+            return false;
+        }
+        auto xcr0 = _xgetbv(0);
+        __cpuidex(info, 7, 0);
+        if (CellComputerInstructionSet::Avx2 == instructionSet) {
+            return (xcr0 & 0x6) == 0x6 && (info[1] & (1 << 5)) != 0;
+        }
+        auto hasAvx512fAndBw = (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+        return (xcr0 & 0xe6) == 0xe6 && hasAvx512fAndBw;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        if (CellComputerInstructionSet::Avx2 == instructionSet) {
+            return __builtin_cpu_supports("avx2");
+        }
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#else
+        return false;
+#endif
+    }
+
+    ExecuteBatchFunction getExecuteBatchFunction(CellComputerInstructionSet::Type instructionSet)
+    {
+        switch (instructionSet) {
+        case CellComputerInstructionSet::Avx2:
+            return getExecuteBatchAvx2();
+        case CellComputerInstructionSet::Avx512:
+            return getExecuteBatchAvx512();
+        default:
+            return getExecuteBatchScalar();
+        }
+    }
+
+    //transposing the memories into lanes only pays off for several lanes
+    constexpr int MinLanesPerBatch = NumLanes / 2;
+
+    //only the directly accessed part of the token memories is transposed, for MEMMEM this is the address of the pointer
+    std::vector<int> getDirectTokenAddresses(CellComputerProgram const& program, int tokenMemorySize, bool* isDirect)
+    {
+        std::fill(isDirect, isDirect + tokenMemorySize, false);
+        for (int i = 0; i < program.numInstructions; ++i) {
+            auto const& instruction = program.instructions[i];
+            if (instruction.operation == Enums::ComputerOperation::ELSE) {
+                continue;
+            }
+            if (instruction.opType1 != Enums::ComputerOptype::CMEM) {
+                isDirect[instruction.operand1] = true;
+            }
+            if (instruction.opType2 == Enums::ComputerOptype::MEM
+                || instruction.opType2 == Enums::ComputerOptype::MEMMEM) {
+                isDirect[instruction.operand2] = true;
+            }
+        }
+        std::vector<int> result;
+        for (int address = 0; address < tokenMemorySize; ++address) {
+            if (isDirect[address]) {
+                result.emplace_back(address);
+            }
+        }
+        return result;
+    }
+
+    void executeSequentially(
+        CellComputerProgram const& program,
+        uint8_t* tokenMemory,
+        uint8_t* cellMemory,
+        int tokenMemorySize)
+    {
+        for (int pc = 0; pc < program.numInstructions;) {
+            auto const& instruction = program.instructions[pc];
+            if (instruction.operation == Enums::ComputerOperation::ELSE) {
+                pc = instruction.jumpIfFalse;
+                continue;
+            }
+
+            uint8_t* target = instruction.opType1 == Enums::ComputerOptype::CMEM ? &cellMemory[instruction.operand1]
+                                                                                   : &tokenMemory[instruction.operand1];
+            if (instruction.opType1 == Enums::ComputerOptype::MEMMEM) {
+                target = &tokenMemory[CellComputerProgram::convertToAddress(*target, tokenMemorySize)];
+            }
+
+            uint8_t operand2 = instruction.operand2;
+            if (instruction.opType2 == Enums::ComputerOptype::MEM) {
+                operand2 = tokenMemory[operand2];
+            }
+            if (instruction.opType2 == Enums::ComputerOptype::MEMMEM) {
+                operand2 = tokenMemory[CellComputerProgram::convertToAddress(tokenMemory[operand2], tokenMemorySize)];
+            }
+            if (instruction.opType2 == Enums::ComputerOptype::CMEM) {
+                operand2 = cellMemory[operand2];
+            }
+
+            if (instruction.operation >= Enums::ComputerOperation::IFG) {
+                pc = calcCondition(instruction.operation, *target, operand2) ? pc + 1 : instruction.jumpIfFalse;
+                continue;
+            }
+            *target = calcArithmetic(instruction.operation, static_cast<int8_t>(*target), operand2);
+            ++pc;
+        }
+    }
+}
+
+CellComputerBatchInterpreter::CellComputerBatchInterpreter(SimulationParameters const& parameters)
+    : CellComputerBatchInterpreter(parameters, getBestInstructionSet())
+{}
+
+CellComputerBatchInterpreter::CellComputerBatchInterpreter(
+    SimulationParameters const& parameters,
+    CellComputerInstructionSet::Type instructionSet)
+    : _instructionSet(instructionSet)
+{
+    if (!isSupported(instructionSet)) {
+        throw std::runtime_error("The instruction set is not supported.");
+    }
+
+    //same clamping as in the engine
+    _tokenMemorySize = std::min(std::max(parameters.tokenMemorySize, MIN_TOKEN_MEM_SIZE), MAX_TOKEN_MEM_SIZE);
+    _cellMemorySize = std::min(std::max(parameters.cellFunctionComputerCellMemorySize, 1), MAX_CELL_MUTABLE_BYTES);
+    _maxInstructions = parameters.cellFunctionComputerMaxInstructions;
+}
+
+CellComputerBatch::ExecuteBatchFunction CellComputerBatch::getExecuteBatchScalar()
+{
+    return &executeBatchScalar;
+}
+
+void CellComputerBatchInterpreter::process(std::vector<CellComputerComputation>& computations) const
+{
+    auto numStaticBytes = std::min(MAX_CELL_STATIC_BYTES, CellComputerProgram::clampInstructions(_maxInstructions) * 3);
+    auto numComputations = toInt(computations.size());
+
+    //group computations by the part of the machine code which is executed, groups are numbered by first appearance
+    std::unordered_map<std::string_view, int> groupByCode;
+    groupByCode.reserve(computations.size());
+    std::vector<int> groupOfComputations(numComputations);
+    std::vector<int> groupStarts;
+    for (int i = 0; i < numComputations; ++i) {
+        auto& computation = computations[i];
+        prepareMemories(computation);
+        auto code = std::string_view(computation.staticData).substr(0, numStaticBytes);
+        auto [groupByCodeIter, isNewGroup] = groupByCode.emplace(code, toInt(groupStarts.size()));
+        if (isNewGroup) {
+            groupStarts.emplace_back(0);
+        }
+        groupOfComputations[i] = groupByCodeIter->second;
+        ++groupStarts[groupByCodeIter->second];
+    }
+
+    //computation indices sorted by group, the sizes of the groups are converted into their start positions
+    auto numGroups = toInt(groupStarts.size());
+    int groupStart = 0;
+    for (auto& groupStartOrSize : groupStarts) {
+        auto groupSize = groupStartOrSize;
+        groupStartOrSize = groupStart;
+        groupStart += groupSize;
+    }
+    groupStarts.emplace_back(numComputations);
+    std::vector<int> computationIndices(numComputations);
+    {
+        auto nextPositions = groupStarts;
+        for (int i = 0; i < numComputations; ++i) {
+            computationIndices[nextPositions[groupOfComputations[i]]++] = i;
+        }
+    }
+
+    auto executeBatchFunction = getExecuteBatchFunction(_instructionSet);
+    Batch batch;
+    batch.tokenMemory.resize(_tokenMemorySize * NumLanes);
+    batch.cellMemory.resize(_cellMemorySize * NumLanes);
+    std::fill(std::begin(batch.scratchTokenMemory), std::end(batch.scratchTokenMemory), 0);
+    BatchMemory batchMemory{
+        batch.tokenMemory.data(), batch.cellMemory.data(), batch.isTransposed, batch.tokenMemories, _tokenMemorySize};
+    for (int group = 0; group < numGroups; ++group) {
+        auto groupComputationIndices = &computationIndices[groupStarts[group]];
+        auto numGroupComputations = groupStarts[group + 1] - groupStarts[group];
+
+        auto code =
+            std::string_view(computations[groupComputationIndices[0]].staticData).substr(0, numStaticBytes);
+        char staticData[MAX_CELL_STATIC_BYTES] = {};
+        std::memcpy(staticData, code.data(), code.size());
+        CellComputerProgram program;
+        program.decode(staticData, toInt(code.size()), _tokenMemorySize, _cellMemorySize, _maxInstructions);
+
+        auto numBatchedComputations = numGroupComputations;
+        if (numBatchedComputations % NumLanes < MinLanesPerBatch) {
+            numBatchedComputations -= numBatchedComputations % NumLanes;
+        }
+        for (int i = numBatchedComputations; i < numGroupComputations; ++i) {
+            auto& computation = computations[groupComputationIndices[i]];
+            executeSequentially(
+                program,
+                reinterpret_cast<uint8_t*>(computation.tokenMemory.data()),
+                reinterpret_cast<uint8_t*>(computation.cellMemory.data()),
+                _tokenMemorySize);
+        }
+        if (numBatchedComputations == 0) {
+            continue;
+        }
+
+        auto tokenAddresses = getDirectTokenAddresses(program, _tokenMemorySize, batch.isTransposed);
+        for (int batchStart = 0; batchStart < numBatchedComputations; batchStart += NumLanes) {
+            auto numUsedLanes = std::min(NumLanes, numBatchedComputations - batchStart);
+            for (int lane = 0; lane < NumLanes; ++lane) {
+                batch.skipUntil[lane] = lane < numUsedLanes ? 0 : LaneInactive;
+                if (lane < numUsedLanes) {
+                    auto& computation = computations[groupComputationIndices[batchStart + lane]];
+                    batch.tokenMemories[lane] = computation.tokenMemory.data();
+                    batch.cellMemories[lane] = computation.cellMemory.data();
+                } else {
+                    batch.tokenMemories[lane] = batch.scratchTokenMemory;
+                }
+            }
+
+            //transpose into lanes
+            for (auto const& address : tokenAddresses) {
+                auto row = &batch.tokenMemory[address * NumLanes];
+                for (int lane = 0; lane < numUsedLanes; ++lane) {
+                    row[lane] = static_cast<uint8_t>(batch.tokenMemories[lane][address]);
+                }
+            }
+            for (int address = 0; address < _cellMemorySize; ++address) {
+                auto row = &batch.cellMemory[address * NumLanes];
+                for (int lane = 0; lane < numUsedLanes; ++lane) {
+                    row[lane] = static_cast<uint8_t>(batch.cellMemories[lane][address]);
+                }
+            }
+
+            executeBatchFunction(program, batchMemory, batch.skipUntil);
+
+            //transpose back
+            for (auto const& address : tokenAddresses) {
+                auto row = &batch.tokenMemory[address * NumLanes];
+                for (int lane = 0; lane < numUsedLanes; ++lane) {
+                    batch.tokenMemories[lane][address] = static_cast<char>(row[lane]);
+                }
+            }
+            for (int address = 0; address < _cellMemorySize; ++address) {
+                auto row = &batch.cellMemory[address * NumLanes];
+                for (int lane = 0; lane < numUsedLanes; ++lane) {
+                    batch.cellMemories[lane][address] = static_cast<char>(row[lane]);
+                }
+            }
+        }
+    }
+}
+
+void CellComputerBatchInterpreter::processSequentially(std::vector<CellComputerComputation>& computations) const
+{
+    for (auto& computation : computations) {
+        prepareMemories(computation);
+
+        char staticData[MAX_CELL_STATIC_BYTES] = {};
+        auto numStaticBytes = std::min(toInt(computation.staticData.size()), MAX_CELL_STATIC_BYTES);
+        std::memcpy(staticData, computation.staticData.data(), numStaticBytes);
+        CellComputerProgram program;
+        program.decode(staticData, numStaticBytes, _tokenMemorySize, _cellMemorySize, _maxInstructions);
+
+        executeSequentially(
+            program,
+            reinterpret_cast<uint8_t*>(computation.tokenMemory.data()),
+            reinterpret_cast<uint8_t*>(computation.cellMemory.data()),
+            _tokenMemorySize);
+    }
+}
+
+int CellComputerBatchInterpreter::getNumLanes()
+{
+    return NumLanes;
+}
+
+CellComputerInstructionSet::Type CellComputerBatchInterpreter::getInstructionSet() const
+{
+    return _instructionSet;
+}
+
+bool CellComputerBatchInterpreter::isSupported(CellComputerInstructionSet::Type instructionSet)
+{
+    if (CellComputerInstructionSet::Scalar == instructionSet) {
+        return true;
+    }
+    return getExecuteBatchFunction(instructionSet) != nullptr && isCpuFeatureSupported(instructionSet);
+}
+
+CellComputerInstructionSet::Type CellComputerBatchInterpreter::getBestInstructionSet()
+{
+    for (auto instructionSet : {CellComputerInstructionSet::Avx512, CellComputerInstructionSet::Avx2}) {
+        if (isSupported(instructionSet)) {
+            return instructionSet;
+        }
+    }
+    return CellComputerInstructionSet::Scalar;
+}
+
+void CellComputerBatchInterpreter::prepareMemories(CellComputerComputation& computation) const
+{
+    computation.tokenMemory.resize(_tokenMemorySize, 0);
+    computation.cellMemory.resize(_cellMemorySize, 0);
+}
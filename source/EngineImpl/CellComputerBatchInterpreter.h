@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "EngineInterface/SimulationParameters.h"
+
+#include "DllExport.h"
+
+namespace CellComputerInstructionSet
+{
+    enum Type
+    {
+        Scalar,
+        Avx2,
+        Avx512
+    };
+}
+
+struct CellComputerComputation
+{
+    std::string staticData;     //machine code of the cell computer
+    std::string tokenMemory;    //is resized to the token memory size of the engine
+    std::string cellMemory;     //is resized to cellFunctionComputerCellMemorySize
+};
+
+/**
+ * Executes cell computer programs on the host with the same semantics as CellComputerFunction in the engine.
+ * Computations are independent of each other, i.e. each one operates on its own copy of the cell memory.
+ * The vector instruction set for the batches is selected at runtime depending on the CPU.
+ */
+class CellComputerBatchInterpreter
+{
+public:
+    //uses the best supported instruction set
+    ENGINEIMPL_EXPORT CellComputerBatchInterpreter(SimulationParameters const& parameters);
+
+    //throws std::runtime_error if the instruction set is not supported
+    ENGINEIMPL_EXPORT CellComputerBatchInterpreter(
+        SimulationParameters const& parameters,
+        CellComputerInstructionSet::Type instructionSet);
+
+    //computations with identical machine code are executed in lockstep where each computation occupies a SIMD lane,
+    //small groups are executed one after another, indirect accesses of the batches are gathered per lane
+    ENGINEIMPL_EXPORT void process(std::vector<CellComputerComputation>& computations) const;
+
+    //reference implementation which executes one computation after another
+    ENGINEIMPL_EXPORT void processSequentially(std::vector<CellComputerComputation>& computations) const;
+
+    ENGINEIMPL_EXPORT CellComputerInstructionSet::Type getInstructionSet() const;
+
+    ENGINEIMPL_EXPORT static int getNumLanes();
+
+    //is true if the instruction set has been compiled in and is supported by the CPU
+    ENGINEIMPL_EXPORT static bool isSupported(CellComputerInstructionSet::Type instructionSet);
+    ENGINEIMPL_EXPORT static CellComputerInstructionSet::Type getBestInstructionSet();
+
+private:
+    void prepareMemories(CellComputerComputation& computation) const;
+
+    CellComputerInstructionSet::Type _instructionSet;
+    int _tokenMemorySize;
+    int _cellMemorySize;
+    int _maxInstructions;
+};
@@ -0,0 +1,153 @@
+//compiled with AVX2 enabled, the functions are only called after a CPUID check in CellComputerBatchInterpreter.cpp
+
+#include "CellComputerBatchExecution.h"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace CellComputerBatch
+{
+namespace
+{
+    //the lanes are processed in two halves of 256 bits
+    constexpr int NumHalves = NumLanes / 32;
+
+    __m256i load256(uint8_t const* source, int half)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(source + half * 32));
+    }
+
+    void store256(uint8_t* target, int half, __m256i value)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + half * 32), value);
+    }
+
+    struct Avx2
+    {
+        static void computeActive(uint8_t const* skipUntil, uint8_t pc, Lanes& result)
+        {
+            auto pcs = _mm256_set1_epi8(static_cast<char>(pc));
+            for (int half = 0; half < NumHalves; ++half) {
+                auto skip = load256(skipUntil, half);
+                store256(result.values, half, _mm256_cmpeq_epi8(_mm256_min_epu8(skip, pcs), skip));
+            }
+        }
+
+        static bool isAnyActive(Lanes const& active)
+        {
+            for (int half = 0; half < NumHalves; ++half) {
+                if (_mm256_movemask_epi8(load256(active.values, half)) != 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static void compare(uint8_t operation, Lanes const& operand1, Lanes const& operand2, Lanes& result)
+        {
+            auto allOnes = _mm256_set1_epi8(-1);
+            for (int half = 0; half < NumHalves; ++half) {
+                auto a = load256(operand1.values, half);
+                auto b = load256(operand2.values, half);
+                auto max = _mm256_max_epu8(a, b);
+                __m256i condition;
+                switch (operation) {
+                case Enums::ComputerOperation::IFG:
+                    condition = _mm256_xor_si256(_mm256_cmpeq_epi8(max, b), allOnes);
+                    break;
+                case Enums::ComputerOperation::IFGE:
+                    condition = _mm256_cmpeq_epi8(max, a);
+                    break;
+                case Enums::ComputerOperation::IFE:
+                    condition = _mm256_cmpeq_epi8(a, b);
+                    break;
+                case Enums::ComputerOperation::IFNE:
+                    condition = _mm256_xor_si256(_mm256_cmpeq_epi8(a, b), allOnes);
+                    break;
+                case Enums::ComputerOperation::IFLE:
+                    condition = _mm256_cmpeq_epi8(max, b);
+                    break;
+                default:
+                    condition = _mm256_xor_si256(_mm256_cmpeq_epi8(max, a), allOnes);
+                    break;
+                }
+                store256(result.values, half, condition);
+            }
+        }
+
+        static void arithmetic(uint8_t operation, Lanes const& operand1, Lanes const& operand2, Lanes& result)
+        {
+            //division has no byte-wise vector instruction
+            if (operation == Enums::ComputerOperation::DIV) {
+                for (int lane = 0; lane < NumLanes; ++lane) {
+                    result.values[lane] =
+                        calcArithmetic(operation, static_cast<int8_t>(operand1.values[lane]), operand2.values[lane]);
+                }
+                return;
+            }
+            for (int half = 0; half < NumHalves; ++half) {
+                auto a = load256(operand1.values, half);
+                auto b = load256(operand2.values, half);
+                __m256i value;
+                switch (operation) {
+                case Enums::ComputerOperation::MOV:
+                    value = b;
+                    break;
+                case Enums::ComputerOperation::ADD:
+                    value = _mm256_add_epi8(a, b);
+                    break;
+                case Enums::ComputerOperation::SUB:
+                    value = _mm256_sub_epi8(a, b);
+                    break;
+                case Enums::ComputerOperation::MUL: {
+                    auto lowBytes = _mm256_set1_epi16(0xff);
+                    auto even = _mm256_and_si256(_mm256_mullo_epi16(a, b), lowBytes);
+                    auto odd =
+                        _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8)), 8);
+                    value = _mm256_or_si256(even, odd);
+                } break;
+                case Enums::ComputerOperation::XOR:
+                    value = _mm256_xor_si256(a, b);
+                    break;
+                case Enums::ComputerOperation::OR:
+                    value = _mm256_or_si256(a, b);
+                    break;
+                default:
+                    value = _mm256_and_si256(a, b);
+                    break;
+                }
+                store256(result.values, half, value);
+            }
+        }
+
+        static void blend(uint8_t* target, Lanes const& values, Lanes const& mask)
+        {
+            for (int half = 0; half < NumHalves; ++half) {
+                auto value = _mm256_blendv_epi8(
+                    load256(target, half), load256(values.values, half), load256(mask.values, half));
+                store256(target, half, value);
+            }
+        }
+    };
+
+    void executeBatchAvx2(CellComputerProgram const& program, BatchMemory const& memory, uint8_t* skipUntil)
+    {
+        executeBatch<Avx2>(program, memory, skipUntil);
+    }
+}
+
+ExecuteBatchFunction getExecuteBatchAvx2()
+{
+    return &executeBatchAvx2;
+}
+}
+
+#else
+
+CellComputerBatch::ExecuteBatchFunction CellComputerBatch::getExecuteBatchAvx2()
+{
+    return nullptr;
+}
+
+#endif
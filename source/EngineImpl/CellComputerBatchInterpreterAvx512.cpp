@@ -0,0 +1,129 @@
+//compiled with AVX-512 enabled, the functions are only called after a CPUID check in CellComputerBatchInterpreter.cpp
+
+#include "CellComputerBatchExecution.h"
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+
+#include <immintrin.h>
+
+namespace CellComputerBatch
+{
+namespace
+{
+    static_assert(NumLanes == 64, "one lane per byte of a 512 bit register");
+
+    __m512i load512(uint8_t const* source) { return _mm512_loadu_si512(source); }
+
+    void store512(uint8_t* target, __m512i value) { _mm512_storeu_si512(target, value); }
+
+    struct Avx512
+    {
+        static void computeActive(uint8_t const* skipUntil, uint8_t pc, Lanes& result)
+        {
+            auto active = _mm512_cmple_epu8_mask(load512(skipUntil), _mm512_set1_epi8(static_cast<char>(pc)));
+            store512(result.values, _mm512_movm_epi8(active));
+        }
+
+        static bool isAnyActive(Lanes const& active)
+        {
+            auto values = load512(active.values);
+            return _mm512_test_epi8_mask(values, values) != 0;
+        }
+
+        static void compare(uint8_t operation, Lanes const& operand1, Lanes const& operand2, Lanes& result)
+        {
+            auto a = load512(operand1.values);
+            auto b = load512(operand2.values);
+            __mmask64 condition;
+            switch (operation) {
+            case Enums::ComputerOperation::IFG:
+                condition = _mm512_cmpgt_epu8_mask(a, b);
+                break;
+            case Enums::ComputerOperation::IFGE:
+                condition = _mm512_cmpge_epu8_mask(a, b);
+                break;
+            case Enums::ComputerOperation::IFE:
+                condition = _mm512_cmpeq_epu8_mask(a, b);
+                break;
+            case Enums::ComputerOperation::IFNE:
+                condition = _mm512_cmpneq_epu8_mask(a, b);
+                break;
+            case Enums::ComputerOperation::IFLE:
+                condition = _mm512_cmple_epu8_mask(a, b);
+                break;
+            default:
+                condition = _mm512_cmplt_epu8_mask(a, b);
+                break;
+            }
+            store512(result.values, _mm512_movm_epi8(condition));
+        }
+
+        static void arithmetic(uint8_t operation, Lanes const& operand1, Lanes const& operand2, Lanes& result)
+        {
+            //division has no byte-wise vector instruction
+            if (operation == Enums::ComputerOperation::DIV) {
+                for (int lane = 0; lane < NumLanes; ++lane) {
+                    result.values[lane] =
+                        calcArithmetic(operation, static_cast<int8_t>(operand1.values[lane]), operand2.values[lane]);
+                }
+                return;
+            }
+            auto a = load512(operand1.values);
+            auto b = load512(operand2.values);
+            __m512i value;
+            switch (operation) {
+            case Enums::ComputerOperation::MOV:
+                value = b;
+                break;
+            case Enums::ComputerOperation::ADD:
+                value = _mm512_add_epi8(a, b);
+                break;
+            case Enums::ComputerOperation::SUB:
+                value = _mm512_sub_epi8(a, b);
+                break;
+            case Enums::ComputerOperation::MUL: {
+                auto lowBytes = _mm512_set1_epi16(0xff);
+                auto even = _mm512_and_si512(_mm512_mullo_epi16(a, b), lowBytes);
+                auto odd = _mm512_slli_epi16(_mm512_mullo_epi16(_mm512_srli_epi16(a, 8), _mm512_srli_epi16(b, 8)), 8);
+                value = _mm512_or_si512(even, odd);
+            } break;
+            case Enums::ComputerOperation::XOR:
+                value = _mm512_xor_si512(a, b);
+                break;
+            case Enums::ComputerOperation::OR:
+                value = _mm512_or_si512(a, b);
+                break;
+            default:
+                value = _mm512_and_si512(a, b);
+                break;
+            }
+            store512(result.values, value);
+        }
+
+        static void blend(uint8_t* target, Lanes const& values, Lanes const& mask)
+        {
+            auto select = _mm512_movepi8_mask(load512(mask.values));
+            store512(target, _mm512_mask_blend_epi8(select, load512(target), load512(values.values)));
+        }
+    };
+
+    void executeBatchAvx512(CellComputerProgram const& program, BatchMemory const& memory, uint8_t* skipUntil)
+    {
+        executeBatch<Avx512>(program, memory, skipUntil);
+    }
+}
+
+ExecuteBatchFunction getExecuteBatchAvx512()
+{
+    return &executeBatchAvx512;
+}
+}
+
+#else
+
+CellComputerBatch::ExecuteBatchFunction CellComputerBatch::getExecuteBatchAvx512()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,112 @@
+#include "CheckpointWriter.h"
+
+#include <cstdio>
+#include <regex>
+#include <stdexcept>
+
+#include "EngineInterface/DescriptionHelper.h"
+#include "EngineInterface/Serializer.h"
+#include "EngineInterface/SimulationFiles.h"
+
+#include "AccessDataTOCache.h"
+#include "DataConverter.h"
+#include "SimulationController.h"
+
+_CheckpointWriter::_CheckpointWriter(SimulationController const& simController, CheckpointSettings const& settings)
+    : _simController(simController)
+    , _settings(settings)
+{
+    if (_settings.tileSize < 1 || _settings.positionTolerance <= 0 || _settings.maxJournalEntries < 1) {
+        throw std::runtime_error("Invalid checkpoint settings.");
+    }
+}
+
+CheckpointSettings const& _CheckpointWriter::getSettings() const
+{
+    return _settings;
+}
+
+std::string _CheckpointWriter::getJournalFilename(std::string const& baseFilename)
+{
+    return std::regex_replace(baseFilename, std::regex("\\.\\w+$"), ".journal");
+}
+
+void _CheckpointWriter::writeCheckpoint()
+{
+    //hashes are computed before the data is copied, tiles changing in between are written again next time
+    auto tileHashes = _simController->getTileHashes(_settings.tileSize, _settings.positionTolerance);
+    if (tileHashes.size() != _tileHashes.size() || _numJournalEntries >= _settings.maxJournalEntries) {
+        writeBase(tileHashes);
+        return;
+    }
+    writeJournalEntry(tileHashes);
+}
+
+void _CheckpointWriter::writeBase()
+{
+    writeBase(_simController->getTileHashes(_settings.tileSize, _settings.positionTolerance));
+}
+
+void _CheckpointWriter::writeBase(std::vector<uint64_t> const& tileHashes)
+{
+    DeserializedSimulation sim;
+    sim.timestep = _simController->getCurrentTimestep();
+    sim.settings = _simController->getSettings();
+    sim.symbolMap = _simController->getSymbolMap();
+    auto worldSize = _simController->getWorldSize();
+    sim.content = _simController->getSimulationData({-1000, -1000}, {worldSize.x + 1000, worldSize.y + 1000});
+    auto temporaryFilename = SimulationFiles::getTemporaryFilename(_settings.filename);
+    Serializer serializer = boost::make_shared<_Serializer>();
+    if (!serializer->serializeSimulationToFile(temporaryFilename, sim)) {
+        _tileHashes.clear();
+        throw std::runtime_error("Could not write " + temporaryFilename + ".");
+    }
+    SimulationFiles::flushToDisk(temporaryFilename);
+
+    //the previous checkpoint remains loadable until the new base is in place, see
+    //_Serializer::deserializeCheckpointFromFiles for a journal which is outdated due to an interruption hereafter
+    SimulationFiles::rename(temporaryFilename, _settings.filename);
+    SimulationFiles::flushDirectoryToDisk(_settings.filename);
+    std::remove(getJournalFilename(_settings.filename).c_str());
+    _numJournalEntries = 0;
+    _tileHashes = tileHashes;
+}
+
+int _CheckpointWriter::getNumJournalEntries() const
+{
+    return _numJournalEntries;
+}
+
+void _CheckpointWriter::writeJournalEntry(std::vector<uint64_t> const& tileHashes)
+{
+    CheckpointJournalEntry entry;
+    entry.timestep = _simController->getCurrentTimestep();
+    entry.tileSize = _settings.tileSize;
+    std::vector<bool> isChanged(tileHashes.size(), false);
+    for (int i = 0; i < toInt(tileHashes.size()); ++i) {
+        if (tileHashes[i] != _tileHashes[i]) {
+            entry.tiles.emplace_back(i);
+            isChanged[i] = true;
+        }
+    }
+    if (entry.tiles.empty()) {
+        return;
+    }
+
+    auto worldSize = _simController->getWorldSize();
+    auto gpuSettings = _simController->getGpuSettings();
+    auto cache = boost::make_shared<_AccessDataTOCache>(gpuSettings);
+    auto dataTO = _simController->getSimulationDataTO({-1000, -1000}, {worldSize.x + 1000, worldSize.y + 1000}, cache);
+    DataConverter converter(_simController->getSimulationParameters(), gpuSettings);
+    entry.content = converter.convertAccessTOtoDataDescription(dataTO, [&](RealVector2D const& pos) {
+        return isChanged[DescriptionHelper::getTileIndex(pos, worldSize, _settings.tileSize)];
+    });
+    cache->releaseDataTO(dataTO);
+
+    Serializer serializer = boost::make_shared<_Serializer>();
+    if (!serializer->appendToCheckpointJournal(getJournalFilename(_settings.filename), entry)) {
+        throw std::runtime_error("Could not write " + getJournalFilename(_settings.filename) + ".");
+    }
+    _tileHashes = tileHashes;
+    ++_numJournalEntries;
+}
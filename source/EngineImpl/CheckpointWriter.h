@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Base/Definitions.h"
+#include "EngineInterface/CheckpointSettings.h"
+
+#include "Definitions.h"
+#include "DllExport.h"
+
+/**
+ * Writes incremental checkpoints of the simulation. A full base file is written first and afterwards only the
+ * entities of the tiles which have changed since the last checkpoint are appended to a journal. Checkpoints are
+ * loaded with _Serializer::deserializeCheckpointFromFiles.
+ */
+class _CheckpointWriter
+{
+public:
+    ENGINEIMPL_EXPORT _CheckpointWriter(SimulationController const& simController, CheckpointSettings const& settings);
+
+    ENGINEIMPL_EXPORT CheckpointSettings const& getSettings() const;
+    ENGINEIMPL_EXPORT static std::string getJournalFilename(std::string const& baseFilename);
+
+    //writes a base file if necessary, otherwise appends the changed tiles to the journal
+    ENGINEIMPL_EXPORT void writeCheckpoint();
+
+    //the base file is replaced atomically and the journal is truncated afterwards
+    ENGINEIMPL_EXPORT void writeBase();
+
+    ENGINEIMPL_EXPORT int getNumJournalEntries() const;
+
+private:
+    void writeBase(std::vector<uint64_t> const& tileHashes);
+    void writeJournalEntry(std::vector<uint64_t> const& tileHashes);
+
+    SimulationController _simController;
+    CheckpointSettings _settings;
+
+    std::vector<uint64_t> _tileHashes;  //of the last checkpoint
+    int _numJournalEntries = 0;
+};
@@ -0,0 +1,632 @@
+#include "CpuRasterizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+#include "EngineGpuKernels/AccessTOs.cuh"
+#include "EngineInterface/Colors.h"
+#include "EngineInterface/ZoomLevels.h"
+
+namespace
+{
+    int const TileSize = 64;
+    float const FpPrecision = 0.00001f;
+
+    struct Color
+    {
+        float x;
+        float y;
+        float z;
+
+        Color operator+(Color const& other) const { return {x + other.x, y + other.y, z + other.z}; }
+        Color operator*(float factor) const { return {x * factor, y * factor, z * factor}; }
+    };
+
+    float2 operator+(float2 const& p, float2 const& q)
+    {
+        return {p.x + q.x, p.y + q.y};
+    }
+
+    float2 operator-(float2 const& p, float2 const& q)
+    {
+        return {p.x - q.x, p.y - q.y};
+    }
+
+    float2 operator*(float2 const& p, float factor)
+    {
+        return {p.x * factor, p.y * factor};
+    }
+
+    uint64_t toUInt64(float value)
+    {
+        return static_cast<uint64_t>(value);
+    }
+
+    Color colorToFloat3(uint32_t value)
+    {
+        return {toFloat(value & 0xff) / 255, toFloat((value >> 8) & 0xff) / 255, toFloat((value >> 16) & 0xff) / 255};
+    }
+
+    Color mix(Color const& a, Color const& b, float factor)
+    {
+        return {a.x * factor + b.x * (1 - factor), a.y * factor + b.y * (1 - factor), a.z * factor + b.z * (1 - factor)};
+    }
+
+    Color mix(Color const& a, Color const& b, Color const& c, float factor1, float factor2)
+    {
+        float weight1 = factor1 * factor2;
+        float weight2 = 1 - factor1;
+        float weight3 = 1 - factor2;
+        float sum = weight1 + weight2 + weight3;
+        weight1 /= sum;
+        weight2 /= sum;
+        weight3 /= sum;
+        return {
+            a.x * weight1 + b.x * weight2 + c.x * weight3,
+            a.y * weight1 + b.y * weight2 + c.y * weight3,
+            a.z * weight1 + b.z * weight2 + c.z * weight3};
+    }
+
+    Color calcColor(CellAccessTO const& cell)
+    {
+        uint32_t const cellColors[] = {
+            Const::IndividualCellColor1,
+            Const::IndividualCellColor2,
+            Const::IndividualCellColor3,
+            Const::IndividualCellColor4,
+            Const::IndividualCellColor5,
+            Const::IndividualCellColor6,
+            Const::IndividualCellColor7};
+        auto cellColor = cellColors[cell.metadata.color % 7];
+
+        float factor = std::min(300.0f, cell.energy) / 320.0f;
+        if (1 == cell.selected) {
+            factor *= 2.5f;
+        }
+        if (2 == cell.selected) {
+            factor *= 1.75f;
+        }
+        return {
+            toFloat((cellColor >> 16) & 0xff) / 256.0f * factor,
+            toFloat((cellColor >> 8) & 0xff) / 256.0f * factor,
+            toFloat(cellColor & 0xff) / 256.0f * factor};
+    }
+
+    Color calcColor(ParticleAccessTO const& particle)
+    {
+        auto intensity = std::max(std::min((toInt(particle.energy) + 10) * 5, 150), 20) / 266.0f;
+        if (0 != particle.selected) {
+            intensity *= 2.5f;
+        }
+        return {intensity, 0, 0.08f};
+    }
+
+    Color const TokenColor{0.5f, 0.5f, 0.5f};
+
+    //total intensity which drawCircle distributes for a radius below 1.5
+    float calcSmallCircleWeight(float radius)
+    {
+        return radius * 2 * (1.0f + 4 * 0.3f);
+    }
+
+    //lower bounds are inclusive, upper bounds are exclusive
+    struct PixelRect
+    {
+        IntVector2D from;
+        IntVector2D to;
+    };
+
+    PixelRect calcCircleBounds(float2 const& pos, float radius)
+    {
+        auto extent = radius > 1.5f - FpPrecision ? radius : 1.0f;
+        return {
+            {toInt(std::floor(pos.x - extent)), toInt(std::floor(pos.y - extent))},
+            {toInt(std::floor(pos.x + extent)) + 2, toInt(std::floor(pos.y + extent)) + 2}};
+    }
+
+    void unite(PixelRect& rect, float2 const& pos)
+    {
+        rect.from = {std::min(rect.from.x, toInt(std::floor(pos.x))), std::min(rect.from.y, toInt(std::floor(pos.y)))};
+        rect.to = {std::max(rect.to.x, toInt(std::floor(pos.x)) + 2), std::max(rect.to.y, toInt(std::floor(pos.y)) + 2)};
+    }
+
+    //mirrors the drawing functions of RenderingKernels.cuh but only writes the pixels of one tile
+    class TileCanvas
+    {
+    public:
+        TileCanvas(uint64_t* imageData, IntVector2D const& imageSize, PixelRect const& tile)
+            : _imageData(imageData)
+            , _imageSize(imageSize)
+            , _tile(tile)
+        {}
+
+        void drawPixel(int x, int y, Color const& color)
+        {
+            _imageData[x + y * _imageSize.x] =
+                toUInt64(color.y * 225.0f) << 16 | toUInt64(color.x * 225.0f) << 0 | toUInt64(color.z * 225.0f) << 32;
+        }
+
+        void drawAddingPixel(int x, int y, Color const& colorToAdd)
+        {
+            if (x < _tile.from.x || x >= _tile.to.x || y < _tile.from.y || y >= _tile.to.y) {
+                return;
+            }
+            _imageData[x + y * _imageSize.x] += toUInt64(colorToAdd.y * 255.0f) << 16
+                | toUInt64(colorToAdd.x * 255.0f) << 0 | toUInt64(colorToAdd.z * 255.0f) << 32;
+        }
+
+        void drawDot(float2 const& pos, Color const& colorToAdd)
+        {
+            IntVector2D intPos{toInt(pos.x), toInt(pos.y)};
+            if (intPos.x >= 1 && intPos.x < _imageSize.x - 1 && intPos.y >= 1 && intPos.y < _imageSize.y - 1) {
+                float2 posFrac{pos.x - intPos.x, pos.y - intPos.y};
+
+                //the second portion is added to the same pixel as in drawDot of RenderingKernels.cuh
+                drawAddingPixel(intPos.x, intPos.y, colorToAdd * (1.0f - posFrac.x) * (1.0f - posFrac.y));
+                drawAddingPixel(intPos.x, intPos.y, colorToAdd * posFrac.x * (1.0f - posFrac.y));
+                drawAddingPixel(intPos.x, intPos.y + 1, colorToAdd * (1.0f - posFrac.x) * posFrac.y);
+                drawAddingPixel(intPos.x + 1, intPos.y + 1, colorToAdd * posFrac.x * posFrac.y);
+            }
+        }
+
+        void drawCircle(float2 const& pos, Color color, float radius, bool inverted = false)
+        {
+            if (radius > 1.5f - FpPrecision) {
+                auto radiusSquared = radius * radius;
+                for (float x = -radius; x <= radius; x += 1.0f) {
+                    for (float y = -radius; y <= radius; y += 1.0f) {
+                        auto rSquared = x * x + y * y;
+                        if (rSquared <= radiusSquared) {
+                            auto factor =
+                                inverted ? (rSquared / radiusSquared) * 2 : (1.0f - rSquared / radiusSquared) * 2;
+                            drawDot(pos + float2{x, y}, color * std::min(factor, 1.0f));
+                        }
+                    }
+                }
+            } else {
+                color = color * radius * 2;
+                drawDot(pos, color);
+                color = color * 0.3f;
+                drawDot(pos + float2{1, 0}, color);
+                drawDot(pos + float2{-1, 0}, color);
+                drawDot(pos + float2{0, 1}, color);
+                drawDot(pos + float2{0, -1}, color);
+            }
+        }
+
+    private:
+        uint64_t* _imageData;
+        IntVector2D _imageSize;
+        PixelRect _tile;
+    };
+
+    class Rasterization
+    {
+    public:
+        Rasterization(
+            DataAccessTO const& dataTO,
+            IntVector2D const& worldSize,
+            SimulationParametersSpots const& spots,
+            RealVector2D const& rectUpperLeft,
+            IntVector2D const& imageSize,
+            float zoom)
+            : _dataTO(dataTO)
+            , _worldSize(worldSize)
+            , _spots(spots)
+            , _rectUpperLeft{rectUpperLeft.x, rectUpperLeft.y}
+            , _rectLowerRight{rectUpperLeft.x + toFloat(imageSize.x) / zoom, rectUpperLeft.y + toFloat(imageSize.y) / zoom}
+            , _imageSize(imageSize)
+            , _zoom(zoom)
+            , _isDensityRendering(zoom < Const::MaxZoomLevelForDensityRendering)
+        {
+            _numTiles = {(imageSize.x + TileSize - 1) / TileSize, (imageSize.y + TileSize - 1) / TileSize};
+            _cellsByTile.resize(_numTiles.x * _numTiles.y);
+            _tokensByTile.resize(_numTiles.x * _numTiles.y);
+            _particlesByTile.resize(_numTiles.x * _numTiles.y);
+            _imageData.resize(imageSize.x * imageSize.y);
+            assignEntitiesToTiles();
+        }
+
+        int getNumTiles() const { return _numTiles.x * _numTiles.y; }
+
+        void rasterizeTile(int tileIndex, std::vector<uint32_t>& image)
+        {
+            IntVector2D tileIndex2D{tileIndex % _numTiles.x, tileIndex / _numTiles.x};
+            PixelRect tile{
+                {tileIndex2D.x * TileSize, tileIndex2D.y * TileSize},
+                {std::min((tileIndex2D.x + 1) * TileSize, _imageSize.x),
+                 std::min((tileIndex2D.y + 1) * TileSize, _imageSize.y)}};
+            TileCanvas canvas(_imageData.data(), _imageSize, tile);
+
+            drawBackground(canvas, tile);
+            if (_isDensityRendering) {
+                drawDensities(tileIndex, tile);
+            } else {
+                for (auto const& cellIndex : _cellsByTile[tileIndex]) {
+                    drawCell(canvas, cellIndex);
+                }
+                for (auto const& tokenIndex : _tokensByTile[tileIndex]) {
+                    drawToken(canvas, tokenIndex);
+                }
+                for (auto const& particleIndex : _particlesByTile[tileIndex]) {
+                    drawParticle(canvas, particleIndex);
+                }
+            }
+            convertToRgba(tile, image);
+        }
+
+    private:
+        void assignEntitiesToTiles()
+        {
+            if (_isDensityRendering) {
+                assignEntitiesToDensityTiles();
+                return;
+            }
+            for (int i = 0; i < *_dataTO.numCells; ++i) {
+                PixelRect bounds;
+                if (calcCellBounds(i, bounds)) {
+                    assignToTiles(_cellsByTile, bounds, i);
+                }
+            }
+            for (int i = 0; i < *_dataTO.numTokens; ++i) {
+                auto cellImagePos = getTokenImagePos(i);
+                if (isContainedInImage(cellImagePos)) {
+                    assignToTiles(_tokensByTile, calcCircleBounds(cellImagePos, _zoom / 2), i);
+                }
+            }
+            for (int i = 0; i < *_dataTO.numParticles; ++i) {
+                auto const& particle = _dataTO.particles[i];
+                auto particleImagePos = mapWorldPosToImagePos(particle.pos);
+                if (isContainedInImage(particleImagePos)) {
+                    auto radius = 1 == particle.selected ? _zoom / 2 : _zoom / 3;
+                    assignToTiles(_particlesByTile, calcCircleBounds(particleImagePos, radius), i);
+                }
+            }
+        }
+
+        //each entity only contributes to the pixel containing its position as in accumulate*Densities
+        void assignEntitiesToDensityTiles()
+        {
+            for (int i = 0; i < *_dataTO.numCells; ++i) {
+                auto cellImagePos = mapWorldPosToImagePos(getCorrectedPos(_dataTO.cells[i].pos));
+                if (isContainedInPixels(cellImagePos)) {
+                    assignToTiles(_cellsByTile, calcPixelBounds(cellImagePos), i);
+                }
+            }
+            for (int i = 0; i < *_dataTO.numTokens; ++i) {
+                auto cellImagePos = getTokenImagePos(i);
+                if (isContainedInPixels(cellImagePos)) {
+                    assignToTiles(_tokensByTile, calcPixelBounds(cellImagePos), i);
+                }
+            }
+            for (int i = 0; i < *_dataTO.numParticles; ++i) {
+                auto particleImagePos = mapWorldPosToImagePos(_dataTO.particles[i].pos);
+                if (isContainedInPixels(particleImagePos)) {
+                    assignToTiles(_particlesByTile, calcPixelBounds(particleImagePos), i);
+                }
+            }
+        }
+
+        void assignToTiles(std::vector<std::vector<int>>& entitiesByTile, PixelRect const& bounds, int entityIndex)
+        {
+            auto fromTileX = std::max(0, bounds.from.x / TileSize);
+            auto fromTileY = std::max(0, bounds.from.y / TileSize);
+            auto toTileX = std::min(_numTiles.x - 1, (bounds.to.x - 1) / TileSize);
+            auto toTileY = std::min(_numTiles.y - 1, (bounds.to.y - 1) / TileSize);
+            for (int tileY = fromTileY; tileY <= toTileY; ++tileY) {
+                for (int tileX = fromTileX; tileX <= toTileX; ++tileX) {
+                    entitiesByTile[tileX + tileY * _numTiles.x].emplace_back(entityIndex);
+                }
+            }
+        }
+
+        bool calcCellBounds(int cellIndex, PixelRect& result) const
+        {
+            auto const& cell = _dataTO.cells[cellIndex];
+            auto cellPos = getCorrectedPos(cell.pos);
+            if (!isContainedInRect(cellPos)) {
+                return false;
+            }
+            auto cellImagePos = mapWorldPosToImagePos(cellPos);
+            result = calcCircleBounds(cellImagePos, 1 == cell.selected ? _zoom / 2 : _zoom / 3);
+            if (_zoom > 1 - FpPrecision) {
+                for (int i = 0; i < cell.numConnections; ++i) {
+                    unite(result, mapWorldPosToImagePos(_dataTO.cells[cell.connections[i].cellIndex].pos));
+                }
+            }
+            return true;
+        }
+
+        void drawBackground(TileCanvas& canvas, PixelRect const& tile) const
+        {
+            IntVector2D outsideRectUpperLeft{
+                -std::min(toInt(_rectUpperLeft.x * _zoom), 0), -std::min(toInt(_rectUpperLeft.y * _zoom), 0)};
+            IntVector2D outsideRectLowerRight{
+                _imageSize.x - std::max(toInt((_rectLowerRight.x - _worldSize.x) * _zoom), 0),
+                _imageSize.y - std::max(toInt((_rectLowerRight.y - _worldSize.y) * _zoom), 0)};
+
+            auto spaceColor = colorToFloat3(Const::SpaceColor);
+            auto spotColor1 = colorToFloat3(_spots.spots[0].color);
+            auto spotColor2 = colorToFloat3(_spots.spots[1].color);
+
+            for (int y = tile.from.y; y < tile.to.y; ++y) {
+                for (int x = tile.from.x; x < tile.to.x; ++x) {
+                    if (x < outsideRectUpperLeft.x || y < outsideRectUpperLeft.y || x >= outsideRectLowerRight.x
+                        || y >= outsideRectLowerRight.y) {
+                        canvas.drawPixel(x, y, {0, 0, 0});
+                        continue;
+                    }
+                    float2 worldPos{toFloat(x) / _zoom + _rectUpperLeft.x, toFloat(y) / _zoom + _rectUpperLeft.y};
+                    if (0 == _spots.numSpots) {
+                        canvas.drawPixel(x, y, spaceColor);
+                    }
+                    if (1 == _spots.numSpots) {
+                        auto factor = calcSpotFactor(worldPos, _spots.spots[0]);
+                        canvas.drawPixel(x, y, mix(spaceColor, spotColor1, factor));
+                    }
+                    if (2 == _spots.numSpots) {
+                        auto factor1 = calcSpotFactor(worldPos, _spots.spots[0]);
+                        auto factor2 = calcSpotFactor(worldPos, _spots.spots[1]);
+                        canvas.drawPixel(x, y, mix(spaceColor, spotColor1, spotColor2, factor1, factor2));
+                    }
+                }
+            }
+        }
+
+        void drawCell(TileCanvas& canvas, int cellIndex) const
+        {
+            auto const& cell = _dataTO.cells[cellIndex];
+            auto cellPos = getCorrectedPos(cell.pos);
+            auto cellImagePos = mapWorldPosToImagePos(cellPos);
+            auto color = calcColor(cell);
+            auto radius = 1 == cell.selected ? _zoom / 2 : _zoom / 3;
+            canvas.drawCircle(cellImagePos, color, radius, true);
+
+            if (_zoom > 1 - FpPrecision) {
+                color = color * std::min((_zoom - 1.0f) / 3, 1.0f);
+                for (int i = 0; i < cell.numConnections; ++i) {
+                    auto const& otherCellPos = _dataTO.cells[cell.connections[i].cellIndex].pos;
+                    if (!isTopologyCorrectionNeeded(cellPos, otherCellPos)) {
+                        auto otherCellImagePos = mapWorldPosToImagePos(otherCellPos);
+                        auto delta = otherCellImagePos - cellImagePos;
+                        float dist = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+                        auto v = delta * (1.8f / dist);
+                        auto pos = cellImagePos;
+                        for (float d = 0; d <= dist; d += 1.8f) {
+                            canvas.drawDot(pos, color);
+                            pos = pos + v;
+                        }
+                    }
+                }
+            }
+        }
+
+        //accumulates the entities of the tile per pixel and adds the sums to the background as shadeDensityImage
+        void drawDensities(int tileIndex, PixelRect const& tile)
+        {
+            auto tileWidth = tile.to.x - tile.from.x;
+            std::vector<Color> densities(tileWidth * (tile.to.y - tile.from.y), Color{0, 0, 0});
+            auto addDensity = [&](float2 const& imagePos, Color const& colorToAdd) {
+                auto index = toInt(std::floor(imagePos.x)) - tile.from.x
+                    + (toInt(std::floor(imagePos.y)) - tile.from.y) * tileWidth;
+                densities[index] = densities[index] + colorToAdd;
+            };
+
+            for (auto const& cellIndex : _cellsByTile[tileIndex]) {
+                auto const& cell = _dataTO.cells[cellIndex];
+                auto radius = 1 == cell.selected ? _zoom / 2 : _zoom / 3;
+                addDensity(
+                    mapWorldPosToImagePos(getCorrectedPos(cell.pos)), calcColor(cell) * calcSmallCircleWeight(radius));
+            }
+            for (auto const& tokenIndex : _tokensByTile[tileIndex]) {
+                addDensity(getTokenImagePos(tokenIndex), TokenColor * calcSmallCircleWeight(_zoom / 2));
+            }
+            for (auto const& particleIndex : _particlesByTile[tileIndex]) {
+                auto const& particle = _dataTO.particles[particleIndex];
+                auto radius = 1 == particle.selected ? _zoom / 2 : _zoom / 3;
+                addDensity(mapWorldPosToImagePos(particle.pos), calcColor(particle) * calcSmallCircleWeight(radius));
+            }
+
+            for (int y = tile.from.y; y < tile.to.y; ++y) {
+                for (int x = tile.from.x; x < tile.to.x; ++x) {
+                    auto const& density = densities[x - tile.from.x + (y - tile.from.y) * tileWidth];
+                    if (density.x == 0 && density.y == 0 && density.z == 0) {
+                        continue;
+                    }
+                    auto& pixel = _imageData[x + y * _imageSize.x];
+                    auto channel = [&](int shift, float value) {
+                        auto sum = ((pixel >> shift) & 0xffff) + toUInt64(value * 255.0f);
+                        return std::min(sum, uint64_t(0xffff)) << shift;
+                    };
+                    pixel = channel(0, density.x) | channel(16, density.y) | channel(32, density.z);
+                }
+            }
+        }
+
+        void drawToken(TileCanvas& canvas, int tokenIndex) const
+        {
+            canvas.drawCircle(getTokenImagePos(tokenIndex), TokenColor, _zoom / 2);
+        }
+
+        void drawParticle(TileCanvas& canvas, int particleIndex) const
+        {
+            auto const& particle = _dataTO.particles[particleIndex];
+            auto radius = 1 == particle.selected ? _zoom / 2 : _zoom / 3;
+            canvas.drawCircle(mapWorldPosToImagePos(particle.pos), calcColor(particle), radius);
+        }
+
+        //same tone mapping as convertImageToRgba in RenderingKernels.cuh
+        void convertToRgba(PixelRect const& tile, std::vector<uint32_t>& image) const
+        {
+            for (int y = tile.from.y; y < tile.to.y; ++y) {
+                for (int x = tile.from.x; x < tile.to.x; ++x) {
+                    auto index = x + y * _imageSize.x;
+                    auto pixel = _imageData[index];
+                    uint32_t result = 0xff000000;
+                    for (int channel = 0; channel < 3; ++channel) {
+                        auto value = toFloat((pixel >> (channel * 16)) & 0xffff) / 65535.0f;
+                        value = std::min(std::max(std::sqrt(value * 256.0f) - 0.2f, 0.0f), 1.0f);
+                        result |= static_cast<uint32_t>(value * 255.0f) << (channel * 8);
+                    }
+                    image[index] = result;
+                }
+            }
+        }
+
+        float calcSpotFactor(float2 const& worldPos, SimulationParametersSpot const& spot) const
+        {
+            float2 delta{
+                std::remainder(worldPos.x - spot.posX, toFloat(_worldSize.x)),
+                std::remainder(worldPos.y - spot.posY, toFloat(_worldSize.y))};
+            auto distance = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+            auto fadeoutRadius = spot.fadeoutRadius + 1;
+            return distance < spot.coreRadius ? 0.0f : std::min(1.0f, (distance - spot.coreRadius) / fadeoutRadius);
+        }
+
+        float2 getTokenImagePos(int tokenIndex) const
+        {
+            auto const& cell = _dataTO.cells[_dataTO.tokens[tokenIndex].cellIndex];
+            return mapWorldPosToImagePos(getCorrectedPos(cell.pos));
+        }
+
+        float2 getCorrectedPos(float2 const& pos) const
+        {
+            auto intPartX = toInt(std::floor(pos.x));
+            auto intPartY = toInt(std::floor(pos.y));
+            return {
+                toFloat(((intPartX % _worldSize.x) + _worldSize.x) % _worldSize.x) + pos.x - intPartX,
+                toFloat(((intPartY % _worldSize.y) + _worldSize.y) % _worldSize.y) + pos.y - intPartY};
+        }
+
+        bool isTopologyCorrectionNeeded(float2 const& pos1, float2 const& pos2) const
+        {
+            return pos2.x - pos1.x > _worldSize.x / 2 || pos1.x - pos2.x > _worldSize.x / 2
+                || pos2.y - pos1.y > _worldSize.y / 2 || pos1.y - pos2.y > _worldSize.y / 2;
+        }
+
+        float2 mapWorldPosToImagePos(float2 const& pos) const { return (pos - _rectUpperLeft) * _zoom; }
+
+        bool isContainedInRect(float2 const& pos) const
+        {
+            return pos.x >= _rectUpperLeft.x && pos.x <= _rectLowerRight.x && pos.y >= _rectUpperLeft.y
+                && pos.y <= _rectLowerRight.y;
+        }
+
+        PixelRect calcPixelBounds(float2 const& imagePos) const
+        {
+            IntVector2D pixel{toInt(std::floor(imagePos.x)), toInt(std::floor(imagePos.y))};
+            return {pixel, {pixel.x + 1, pixel.y + 1}};
+        }
+
+        bool isContainedInPixels(float2 const& imagePos) const
+        {
+            return std::floor(imagePos.x) >= 0 && std::floor(imagePos.x) < _imageSize.x && std::floor(imagePos.y) >= 0
+                && std::floor(imagePos.y) < _imageSize.y;
+        }
+
+        bool isContainedInImage(float2 const& imagePos) const
+        {
+            return imagePos.x >= 0 && imagePos.x <= _imageSize.x && imagePos.y >= 0 && imagePos.y <= _imageSize.y;
+        }
+
+        DataAccessTO const& _dataTO;
+        IntVector2D _worldSize;
+        SimulationParametersSpots const& _spots;
+        float2 _rectUpperLeft;
+        float2 _rectLowerRight;
+        IntVector2D _imageSize;
+        float _zoom;
+        bool _isDensityRendering;
+
+        IntVector2D _numTiles;
+        std::vector<std::vector<int>> _cellsByTile;
+        std::vector<std::vector<int>> _tokensByTile;
+        std::vector<std::vector<int>> _particlesByTile;
+        std::vector<uint64_t> _imageData;   //pixel in bbbbggggrrrr format as in RenderingData
+    };
+}
+
+CpuRasterizer::CpuRasterizer(int numThreads)
+{
+    auto numPoolThreads = (numThreads > 0 ? numThreads : toInt(std::thread::hardware_concurrency())) - 1;
+    for (int i = 0; i < numPoolThreads; ++i) {
+        _threads.emplace_back(&CpuRasterizer::processTasks, this);
+    }
+}
+
+CpuRasterizer::~CpuRasterizer()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutexForTasks);
+        _isShutdown = true;
+    }
+    _conditionForTasks.notify_all();
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void CpuRasterizer::rasterize(
+    DataAccessTO const& dataTO,
+    IntVector2D const& worldSize,
+    SimulationParametersSpots const& spots,
+    RealVector2D const& rectUpperLeft,
+    IntVector2D const& imageSize,
+    float zoom,
+    std::vector<uint32_t>& image)
+{
+    image.resize(imageSize.x * imageSize.y);
+    if (imageSize.x <= 0 || imageSize.y <= 0) {
+        return;
+    }
+    Rasterization rasterization(dataTO, worldSize, spots, rectUpperLeft, imageSize, zoom);
+
+    //tiles are written by exactly one thread
+    std::atomic<int> nextTile{0};
+    runOnAllThreads([&] {
+        for (int tile = nextTile++; tile < rasterization.getNumTiles(); tile = nextTile++) {
+            rasterization.rasterizeTile(tile, image);
+        }
+    });
+}
+
+void CpuRasterizer::runOnAllThreads(std::function<void()> const& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutexForTasks);
+        _task = &task;
+        ++_taskNumber;
+        _numBusyThreads = toInt(_threads.size());
+    }
+    _conditionForTasks.notify_all();
+    task();
+
+    std::unique_lock<std::mutex> lock(_mutexForTasks);
+    _conditionForFinishedTasks.wait(lock, [this] { return 0 == _numBusyThreads; });
+    _task = nullptr;
+}
+
+void CpuRasterizer::processTasks()
+{
+    uint64_t lastTaskNumber = 0;
+    while (true) {
+        std::function<void()> const* task;
+        {
+            std::unique_lock<std::mutex> lock(_mutexForTasks);
+            _conditionForTasks.wait(lock, [&] { return _isShutdown || _taskNumber != lastTaskNumber; });
+            if (_isShutdown) {
+                return;
+            }
+            lastTaskNumber = _taskNumber;
+            task = _task;
+        }
+        (*task)();
+        {
+            std::lock_guard<std::mutex> lock(_mutexForTasks);
+            --_numBusyThreads;
+        }
+        _conditionForFinishedTasks.notify_one();
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Base/Definitions.h"
+#include "EngineInterface/SimulationParametersSpots.h"
+
+#include "Definitions.h"
+#include "DllExport.h"
+
+struct DataAccessTO;
+
+/**
+ * Renders transfer objects on the host with the coloring of RenderingKernels.cuh. The image is divided into tiles
+ * which are rasterized in parallel, each tile only by the entities overlapping it. Neither a GPU nor a GL context is
+ * needed. Below Const::MaxZoomLevelForDensityRendering, the entities are accumulated per pixel as on the GPU.
+ * The threads are started on construction and reused for all images.
+ */
+class CpuRasterizer
+{
+public:
+    ENGINEIMPL_EXPORT CpuRasterizer(int numThreads = 0);  //0 = number of hardware threads
+    ENGINEIMPL_EXPORT ~CpuRasterizer();
+
+    CpuRasterizer(CpuRasterizer const&) = delete;
+    CpuRasterizer& operator=(CpuRasterizer const&) = delete;
+
+    //zoom is given in pixels per world unit, the pixels of image are in aabbggrr format
+    ENGINEIMPL_EXPORT void rasterize(
+        DataAccessTO const& dataTO,
+        IntVector2D const& worldSize,
+        SimulationParametersSpots const& spots,
+        RealVector2D const& rectUpperLeft,
+        IntVector2D const& imageSize,
+        float zoom,
+        std::vector<uint32_t>& image);
+
+private:
+    //executes task on all threads of the pool including the calling one and waits for them
+    void runOnAllThreads(std::function<void()> const& task);
+    void processTasks();
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutexForTasks;
+    std::condition_variable _conditionForTasks;
+    std::condition_variable _conditionForFinishedTasks;
+    std::function<void()> const* _task = nullptr;
+    uint64_t _taskNumber = 0;
+    int _numBusyThreads = 0;
+    bool _isShutdown = false;
+};
@@ -1,6 +1,8 @@
 #include "DataConverter.h"
 
 #include <algorithm>
+#include <cstddef>
+#include <cstring>
 #include <boost/range/adaptor/map.hpp>
 
 #include "Base/NumberGenerator.h"
@@ -49,10 +51,8 @@ DataDescription DataConverter::convertAccessTOtoDataDescription(DataAccessTO con
     for (int i = 0; i < *dataTO.numTokens; ++i) {
         TokenAccessTO const& token = dataTO.tokens[i];
 
-        std::string data(_parameters.tokenMemorySize, 0);
-        for (int i = 0; i < _parameters.tokenMemorySize; ++i) {
-            data[i] = token.memory[i];
-        }
+        std::string data(
+            &dataTO.tokenMemory[static_cast<uint64_t>(i) * dataTO.tokenMemorySize], dataTO.tokenMemorySize);
         auto clusterDescIndex = cellTOIndexToClusterDescIndex.at(token.cellIndex);
         auto cellDescIndex = cellTOIndexToCellDescIndex.at(token.cellIndex);
         CellDescription& cell = result.clusters.at(clusterDescIndex).cells.at(cellDescIndex);
@@ -76,31 +76,60 @@ DataDescription DataConverter::convertAccessTOtoDataDescription(DataAccessTO con
     return result;
 }
 
-OverlayDescription DataConverter::convertAccessTOtoOverlayDescription(DataAccessTO const& dataTO)
+DataDescription DataConverter::convertAccessTOtoDataDescription(
+    DataAccessTO const& dataTO,
+    std::function<bool(RealVector2D const&)> const& filter)
 {
-    OverlayDescription result;
-    result.elements.reserve(*dataTO.numCells + *dataTO.numParticles);
+    DataDescription result;
+
+    ClusterDescription cluster;
+    std::unordered_map<int, int> cellTOIndexToCellDescIndex;
     for (int i = 0; i < *dataTO.numCells; ++i) {
         auto const& cellTO = dataTO.cells[i];
-        OverlayElementDescription element;
-        element.cell = true;
-        element.pos = {cellTO.pos.x, cellTO.pos.y};
-        element.cellType = static_cast<Enums::CellFunction::Type>(cellTO.cellFunctionType);
-        element.selected = cellTO.selected;
-        result.elements.emplace_back(element);
+        if (filter({cellTO.pos.x, cellTO.pos.y})) {
+            cellTOIndexToCellDescIndex.emplace(i, toInt(cluster.cells.size()));
+            cluster.addCell(createCellDescription(dataTO, i));
+        }
+    }
+    for (int i = 0; i < *dataTO.numTokens; ++i) {
+        TokenAccessTO const& token = dataTO.tokens[i];
+        auto findResult = cellTOIndexToCellDescIndex.find(token.cellIndex);
+        if (findResult != cellTOIndexToCellDescIndex.end()) {
+            std::string data(
+            &dataTO.tokenMemory[static_cast<uint64_t>(i) * dataTO.tokenMemorySize], dataTO.tokenMemorySize);
+            cluster.cells.at(findResult->second).addToken(TokenDescription().setEnergy(token.energy).setData(data));
+        }
+    }
+    if (!cluster.cells.empty()) {
+        cluster.id = NumberGenerator::getInstance().getId();
+        result.addCluster(cluster);
     }
 
     for (int i = 0; i < *dataTO.numParticles; ++i) {
-        auto const& particleTO = dataTO.particles[i];
-        OverlayElementDescription element;
-        element.cell = false;
-        element.pos = {particleTO.pos.x, particleTO.pos.y};
-        element.selected = particleTO.selected;
-        result.elements.emplace_back(element);
+        ParticleAccessTO const& particle = dataTO.particles[i];
+        if (filter({particle.pos.x, particle.pos.y})) {
+            result.addParticle(ParticleDescription()
+                                   .setId(particle.id)
+                                   .setPos({particle.pos.x, particle.pos.y})
+                                   .setVel({particle.vel.x, particle.vel.y})
+                                   .setEnergy(particle.energy)
+                                   .setMetadata(ParticleMetadata().setColor(particle.metadata.color)));
+        }
     }
     return result;
 }
 
+OverlayElementAccessTO* DataConverter::convertOverlayDescriptionToAccessTO(OverlayDescription& overlay)
+{
+    static_assert(sizeof(OverlayElementDescription) == sizeof(OverlayElementAccessTO));
+    static_assert(offsetof(OverlayElementDescription, pos) == offsetof(OverlayElementAccessTO, pos));
+    static_assert(offsetof(OverlayElementDescription, cellType) == offsetof(OverlayElementAccessTO, cellFunctionType));
+    static_assert(offsetof(OverlayElementDescription, selected) == offsetof(OverlayElementAccessTO, selected));
+    static_assert(offsetof(OverlayElementDescription, cell) == offsetof(OverlayElementAccessTO, cell));
+
+    return reinterpret_cast<OverlayElementAccessTO*>(overlay.elements.data());
+}
+
 void DataConverter::convertDataDescriptionToAccessTO(DataAccessTO& result, DataChangeDescription const& description)
 {
     unordered_map<uint64_t, int> cellIndexByIds;
@@ -125,24 +154,13 @@ void DataConverter::convertDataDescriptionToAccessTO(DataAccessTO& result, DataC
 
 namespace
 {
-    std::string convertToString(char const* data, int size) {
-        std::string result(size, 0);
-        for (int i = 0; i < size; ++i) {
-            result[i] = data[i];
-        }
-        return result;
-    }
+    std::string convertToString(char const* data, int size) { return std::string(data, size); }
 
     void convertToArray(std::string const& source, char* target, int size)
     {
-        for (int i = 0; i < size; ++i) {
-            if (i < source.size()) {
-                target[i] = source.at(i);
-            }
-            else {
-                target[i] = 0;
-            }
-        }
+        auto numBytesToCopy = std::min(static_cast<int>(source.size()), size);
+        std::memcpy(target, source.data(), numBytesToCopy);
+        std::memset(target + numBytesToCopy, 0, size - numBytesToCopy);
     }
 }
 
@@ -332,7 +350,10 @@ void DataConverter::addCell(
             TokenAccessTO& tokenTO = dataTO.tokens[tokenIndex];
             tokenTO.energy = toFloat(tokenDesc.energy);
             tokenTO.cellIndex = cellIndex;
-            convertToArray(tokenDesc.data, tokenTO.memory, _parameters.tokenMemorySize);
+            convertToArray(
+                tokenDesc.data,
+                &dataTO.tokenMemory[static_cast<uint64_t>(tokenIndex) * dataTO.tokenMemorySize],
+                dataTO.tokenMemorySize);
         }
     }
 	cellIndexTOByIds.insert_or_assign(cellTO.id, cellIndex);
@@ -8,6 +8,7 @@
 #include "EngineGpuKernels/AccessTOs.cuh"
 #include "Definitions.h"
 
+#include <functional>
 #include <unordered_map>
 
 class DataConverter
@@ -16,7 +17,12 @@ public:
     DataConverter(SimulationParameters const& parameters, GpuSettings const& gpuConstants);
 
     DataDescription convertAccessTOtoDataDescription(DataAccessTO const& dataTO);
-    OverlayDescription convertAccessTOtoOverlayDescription(DataAccessTO const& dataTO);
+    //converts the cells and particles at positions satisfying filter, the cells are put into a single cluster
+    DataDescription convertAccessTOtoDataDescription(
+        DataAccessTO const& dataTO,
+        std::function<bool(RealVector2D const&)> const& filter);
+    //views the elements of the overlay as transfer objects such that they can be filled without conversion
+    static OverlayElementAccessTO* convertOverlayDescriptionToAccessTO(OverlayDescription& overlay);
     void convertDataDescriptionToAccessTO(DataAccessTO& result, DataChangeDescription const& description);
 
 private:
@@ -7,3 +7,27 @@ using SimulationController = boost::shared_ptr<_SimulationController>;
 
 class _AccessDataTOCache;
 using AccessDataTOCache = boost::shared_ptr<_AccessDataTOCache>;
+
+class _ObserverStreamWriter;
+using ObserverStreamWriter = boost::shared_ptr<_ObserverStreamWriter>;
+
+class _FrameStreamServer;
+using FrameStreamServer = boost::shared_ptr<_FrameStreamServer>;
+
+class _MetricsServer;
+using MetricsServer = boost::shared_ptr<_MetricsServer>;
+
+class _StepHistory;
+using StepHistory = boost::shared_ptr<_StepHistory>;
+
+class _CheckpointWriter;
+using CheckpointWriter = boost::shared_ptr<_CheckpointWriter>;
+
+class _FrameExporter;
+using FrameExporter = boost::shared_ptr<_FrameExporter>;
+
+class _Operation;
+using Operation = boost::shared_ptr<_Operation>;
+
+class _OperationRunner;
+using OperationRunner = boost::shared_ptr<_OperationRunner>;
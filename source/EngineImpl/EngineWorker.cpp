@@ -1,30 +1,48 @@
 #include "EngineWorker.h"
 
 #include <chrono>
+#include <memory>
+
+#include "Base/LoggingService.h"
+#include "Base/ServiceLocator.h"
 
 #include "EngineGpuKernels/AccessTOs.cuh"
 #include "EngineInterface/ChangeDescriptions.h"
 #include "AccessDataTOCache.h"
 #include "DataConverter.h"
+#include "FrameExporter.h"
+#include "ObserverStreamWriter.h"
 
 namespace
 {
     std::chrono::milliseconds const FrameTimeout(30);
     std::chrono::milliseconds const MonitorUpdate(30);
+    std::chrono::milliseconds const SelectionUpdate(250);
 
     class CudaAccess
     {
     public:
+        //accesses from different threads are serialized by mutexForAccess
         CudaAccess(
+            std::timed_mutex& mutexForAccess,
             std::condition_variable& conditionForAccess,
             std::condition_variable& conditionForWorkerLoop,
             std::atomic<bool>& accessFlag,
             std::atomic<bool> const& isSimulationRunning,
             ExceptionData const& exceptionData,
             boost::optional<std::chrono::milliseconds> const& maxDuration = boost::none)
-            : _accessFlag(accessFlag)
+            : _lockForAccess(mutexForAccess, std::defer_lock)
+            , _accessFlag(accessFlag)
             , _conditionForWorkerLoop(conditionForWorkerLoop)
         {
+            if (maxDuration) {
+                if (!_lockForAccess.try_lock_for(*maxDuration)) {
+                    _isTimeout = true;
+                    return;
+                }
+            } else {
+                _lockForAccess.lock();
+            }
             if (!isSimulationRunning.load()) {
                 return;
             }
@@ -47,6 +65,9 @@ namespace
 
         ~CudaAccess()
         {
+            if (!_lockForAccess.owns_lock()) {
+                return;
+            }
             _accessFlag.store(false);
             _conditionForWorkerLoop.notify_all();
         }
@@ -62,6 +83,7 @@ namespace
             }
         }
 
+        std::unique_lock<std::timed_mutex> _lockForAccess;
         std::atomic<bool>& _accessFlag;
         std::condition_variable& _conditionForWorkerLoop;
 
@@ -85,13 +107,23 @@ void EngineWorker::newSimulation(uint64_t timestep, Settings const& settings, Gp
         _cudaResource = _cudaSimulation->registerImageResource(*_imageResourceToRegister);
         _imageResourceToRegister = boost::none;
     }
+    ++_dataVersion;
+    ++_dataLayoutVersion;
+    publishSelectionIntern();
 }
 
 void EngineWorker::clear()
 {
     CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
-    return _cudaSimulation->clear();
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
+    _cudaSimulation->clear();
+    ++_dataVersion;
+    publishSelectionIntern();
 }
 
 void EngineWorker::registerImageResource(GLuint image)
@@ -103,19 +135,25 @@ void EngineWorker::registerImageResource(GLuint image)
     } else {
 
         CudaAccess access(
-            _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+            _mutexForAccess,
+            _conditionForAccess,
+            _conditionForWorkerLoop,
+            _requireAccess,
+            _isSimulationRunning,
+            _exceptionData);
 
         _cudaResource = _cudaSimulation->registerImageResource(image);
     }
 }
 
-void EngineWorker::tryDrawVectorGraphics(
+bool EngineWorker::tryDrawVectorGraphics(
     RealVector2D const& rectUpperLeft,
     RealVector2D const& rectLowerRight,
     IntVector2D const& imageSize,
     double zoom)
 {
     CudaAccess access(
+        _mutexForAccess,
         _conditionForAccess,
         _conditionForWorkerLoop,
         _requireAccess,
@@ -130,7 +168,9 @@ void EngineWorker::tryDrawVectorGraphics(
             _cudaResource,
             {imageSize.x, imageSize.y},
             zoom);
+        return true;
     }
+    return false;
 }
 
 boost::optional<OverlayDescription> EngineWorker::tryDrawVectorGraphicsAndReturnOverlay(
@@ -140,6 +180,7 @@ boost::optional<OverlayDescription> EngineWorker::tryDrawVectorGraphicsAndReturn
     double zoom)
 {
     CudaAccess access(
+        _mutexForAccess,
         _conditionForAccess,
         _conditionForWorkerLoop,
         _requireAccess,
@@ -155,32 +196,63 @@ boost::optional<OverlayDescription> EngineWorker::tryDrawVectorGraphicsAndReturn
             {imageSize.x, imageSize.y},
             zoom);
 
-        auto arraySizes = _cudaSimulation->getArraySizes();
-        DataAccessTO dataTO = _dataTOCache->getDataTO(
-            {arraySizes.cellArraySize, arraySizes.particleArraySize, arraySizes.tokenArraySize});
+        auto numElements = _cudaSimulation->calcOverlayData(
+            {toInt(rectUpperLeft.x), toInt(rectUpperLeft.y)}, {toInt(rectLowerRight.x), toInt(rectLowerRight.y)});
 
-        _cudaSimulation->getOverlayData(
-            {toInt(rectUpperLeft.x), toInt(rectUpperLeft.y)},
-            int2{toInt(rectLowerRight.x), toInt(rectLowerRight.y)},
-            dataTO);
-
-        DataConverter converter(_settings.simulationParameters, _gpuConstants);
-        auto result = converter.convertAccessTOtoOverlayDescription(dataTO);
-        _dataTOCache->releaseDataTO(dataTO);
+        OverlayDescription result;
+        result.elements.resize(numElements);
+        _cudaSimulation->getOverlayData(DataConverter::convertOverlayDescriptionToAccessTO(result), numElements);
 
         return result;
     }
     return boost::none;
 }
 
+bool EngineWorker::tryDrawVectorGraphicsToHost(
+    RealVector2D const& rectUpperLeft,
+    RealVector2D const& rectLowerRight,
+    IntVector2D const& imageSize,
+    double zoom,
+    std::vector<uint32_t>& image)
+{
+    CudaAccess access(
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData,
+        FrameTimeout);
+
+    if (access.isTimeout()) {
+        return false;
+    }
+    image.resize(static_cast<size_t>(imageSize.x) * imageSize.y);
+    _cudaSimulation->drawVectorGraphicsToHost(
+        {rectUpperLeft.x, rectUpperLeft.y},
+        {rectLowerRight.x, rectLowerRight.y},
+        {imageSize.x, imageSize.y},
+        zoom,
+        image.data());
+    return true;
+}
+
 DataDescription EngineWorker::getSimulationData(IntVector2D const& rectUpperLeft, IntVector2D const& rectLowerRight)
 {
     CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
 
     auto arraySizes = _cudaSimulation->getArraySizes();
-    DataAccessTO dataTO =
-        _dataTOCache->getDataTO({arraySizes.cellArraySize, arraySizes.particleArraySize, arraySizes.tokenArraySize});
+    DataAccessTO dataTO = _dataTOCache->getDataTO(
+        {arraySizes.cellArraySize,
+         arraySizes.particleArraySize,
+         arraySizes.tokenArraySize,
+         _cudaSimulation->getTokenMemorySize()});
     _cudaSimulation->getSimulationData(
         {rectUpperLeft.x, rectUpperLeft.y}, int2{rectLowerRight.x, rectLowerRight.y}, dataTO);
 
@@ -192,14 +264,62 @@ DataDescription EngineWorker::getSimulationData(IntVector2D const& rectUpperLeft
     return result;
 }
 
+DataAccessTO EngineWorker::getSimulationDataTO(
+    IntVector2D const& rectUpperLeft,
+    IntVector2D const& rectLowerRight,
+    AccessDataTOCache const& cache)
+{
+    CudaAccess access(
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
+
+    auto arraySizes = _cudaSimulation->getArraySizes();
+    DataAccessTO dataTO = cache->getDataTO(
+        {arraySizes.cellArraySize,
+         arraySizes.particleArraySize,
+         arraySizes.tokenArraySize,
+         _cudaSimulation->getTokenMemorySize()});
+    _cudaSimulation->getSimulationData(
+        {rectUpperLeft.x, rectUpperLeft.y}, int2{rectLowerRight.x, rectLowerRight.y}, dataTO);
+
+    return dataTO;
+}
+
+std::vector<uint64_t> EngineWorker::getTileHashes(int tileSize, float positionTolerance)
+{
+    CudaAccess access(
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
+
+    std::vector<uint64_t> result;
+    _cudaSimulation->calcTileHashes(tileSize, positionTolerance, result);
+    return result;
+}
+
 DataDescription EngineWorker::getSelectedSimulationData(bool includeClusters)
 {
     CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
 
     auto arraySizes = _cudaSimulation->getArraySizes();
-    DataAccessTO dataTO =
-        _dataTOCache->getDataTO({arraySizes.cellArraySize, arraySizes.particleArraySize, arraySizes.tokenArraySize});
+    DataAccessTO dataTO = _dataTOCache->getDataTO(
+        {arraySizes.cellArraySize,
+         arraySizes.particleArraySize,
+         arraySizes.tokenArraySize,
+         _cudaSimulation->getTokenMemorySize()});
     _cudaSimulation->getSelectedSimulationData(includeClusters, dataTO);
 
     DataConverter converter(_settings.simulationParameters, _gpuConstants);
@@ -225,6 +345,37 @@ OverallStatistics EngineWorker::getMonitorData() const
     return result;
 }
 
+EngineMetrics EngineWorker::getEngineMetrics() const
+{
+    EngineMetrics result;
+    result.statistics = getMonitorData();
+    result.tps = _tps.load();
+    result.totalCreatedCells = _totalCreatedCells.load();
+    result.totalSuccessfulAttacks = _totalSuccessfulAttacks.load();
+    result.totalFailedAttacks = _totalFailedAttacks.load();
+    result.totalMuscleActivities = _totalMuscleActivities.load();
+    result.numArrayResizes = _numArrayResizes.load();
+    for (int i = 0; i < EnginePhase::Count; ++i) {
+        result.phaseNanoseconds[i] = _phaseNanoseconds[i].load();
+    }
+    result.gpuMemoryBytes = _gpuMemoryBytes.load();
+    for (int i = 0; i < EngineArray::Count; ++i) {
+        result.arrayNumEntries[i] = _arrayNumEntries[i].load();
+        result.arraySizes[i] = _arraySizes[i].load();
+    }
+    return result;
+}
+
+void EngineWorker::addMetricsConsumer()
+{
+    ++_numMetricsConsumers;
+}
+
+void EngineWorker::removeMetricsConsumer()
+{
+    --_numMetricsConsumers;
+}
+
 namespace
 {
     struct NumberOfEntities
@@ -254,13 +405,21 @@ void EngineWorker::addAndSelectSimulationData(DataDescription const& dataToUpdat
     auto numberOfEntities = getNumberOfEntities(rolloutData);
 
     CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
     _cudaSimulation->resizeArraysIfNecessary(
         {numberOfEntities.cells, numberOfEntities.particles, numberOfEntities.tokens});
 
     auto arraySizes = _cudaSimulation->getArraySizes();
-    DataAccessTO dataTO =
-        _dataTOCache->getDataTO({arraySizes.cellArraySize, arraySizes.particleArraySize, arraySizes.tokenArraySize});
+    DataAccessTO dataTO = _dataTOCache->getDataTO(
+        {arraySizes.cellArraySize,
+         arraySizes.particleArraySize,
+         arraySizes.tokenArraySize,
+         _cudaSimulation->getTokenMemorySize()});
     int2 worldSize{_settings.generalSettings.worldSizeX, _settings.generalSettings.worldSizeY};
 
     DataConverter converter(_settings.simulationParameters, _gpuConstants);
@@ -269,7 +428,9 @@ void EngineWorker::addAndSelectSimulationData(DataDescription const& dataToUpdat
     _dataTOCache->releaseDataTO(dataTO);
 
     _cudaSimulation->addAndSelectSimulationData(dataTO);
+    ++_dataVersion;
     updateMonitorDataIntern();
+    publishSelectionIntern();
 }
 
 void EngineWorker::setSimulationData(DataDescription const& dataToUpdate)
@@ -279,13 +440,21 @@ void EngineWorker::setSimulationData(DataDescription const& dataToUpdate)
     auto numberOfEntities = getNumberOfEntities(rolloutData);
 
     CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
     _cudaSimulation->resizeArraysIfNecessary(
         {numberOfEntities.cells, numberOfEntities.particles, numberOfEntities.tokens});
 
     auto arraySizes = _cudaSimulation->getArraySizes();
     DataAccessTO dataTO = _dataTOCache->getDataTO(
-        {arraySizes.cellArraySize, arraySizes.particleArraySize, arraySizes.tokenArraySize});
+        {arraySizes.cellArraySize,
+         arraySizes.particleArraySize,
+         arraySizes.tokenArraySize,
+         _cudaSimulation->getTokenMemorySize()});
     int2 worldSize{_settings.generalSettings.worldSizeX, _settings.generalSettings.worldSizeY};
 
     DataConverter converter(_settings.simulationParameters, _gpuConstants);
@@ -294,25 +463,113 @@ void EngineWorker::setSimulationData(DataDescription const& dataToUpdate)
     _dataTOCache->releaseDataTO(dataTO);
 
     _cudaSimulation->setSimulationData(dataTO);
+    ++_dataVersion;
     updateMonitorDataIntern();
+    publishSelectionIntern();
+}
+
+void EngineWorker::setSimulationDataTO(DataAccessTO const& dataTO)
+{
+    CudaAccess access(
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
+
+    if (dataTO.tokenMemorySize != _cudaSimulation->getTokenMemorySize()) {
+        throw std::runtime_error("The token memory size of the data does not match the simulation.");
+    }
+    _cudaSimulation->resizeArraysIfNecessary({*dataTO.numCells, *dataTO.numParticles, *dataTO.numTokens});
+    _cudaSimulation->setSimulationData(dataTO);
+    ++_dataVersion;
+    updateMonitorDataIntern();
+    publishSelectionIntern();
 }
 
 void EngineWorker::removeSelectedEntities(bool includeClusters)
 {
     CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
 
     _cudaSimulation->removeSelectedEntities(includeClusters);
+    ++_dataVersion;
+    updateMonitorDataIntern();
+    publishSelectionIntern();
+}
+
+void EngineWorker::applyBulkTransform(BulkTransform const& transform)
+{
+    if (BulkTransformOperation::SetColorByCluster == transform.operation
+        && (transform.numColorCodes < 1 || transform.numColorCodes > 7)) {
+        throw std::runtime_error("Invalid bulk transform.");
+    }
+    if (BulkTransformOperation::RandomizeStaticByte == transform.operation
+        && (transform.byteIndex < 0 || transform.byteIndex >= MAX_CELL_STATIC_BYTES)) {
+        throw std::runtime_error("Invalid bulk transform.");
+    }
+    if (BulkTransformOperation::ScaleEnergy == transform.operation && transform.energyFactor < 0) {
+        throw std::runtime_error("Invalid bulk transform.");
+    }
+
+    CudaAccess access(
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
+
+    _cudaSimulation->applyBulkTransform(transform);
+    ++_dataVersion;
     updateMonitorDataIntern();
 }
 
+void EngineWorker::resizeWorld(IntVector2D const& newSize, WorldResizeMode::Type mode)
+{
+    if (newSize.x < 1 || newSize.y < 1) {
+        throw std::runtime_error("Invalid world size.");
+    }
+
+    CudaAccess access(
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
+
+    _cudaSimulation->resizeWorld({newSize.x, newSize.y}, mode);
+    _settings.generalSettings.worldSizeX = newSize.x;
+    _settings.generalSettings.worldSizeY = newSize.y;
+    ++_dataVersion;
+    ++_dataLayoutVersion;
+    updateMonitorDataIntern();
+    publishSelectionIntern();
+}
+
 void EngineWorker::calcSingleTimestep()
 {
     CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
 
     _cudaSimulation->calcCudaTimestep();
+    ++_dataVersion;
     updateMonitorDataIntern();
+    publishSelectionIntern();
+    publishObserverFrameIntern();
+    exportFrameIntern();
 }
 
 void EngineWorker::beginShutdown()
@@ -327,7 +584,12 @@ void EngineWorker::endShutdown()
     _isShutdown = false;
     _requireAccess = false;
 
+    _observerStreamWriter.reset();
+    _frameExporter.reset();
+    _isFrameExportEnabled.store(false);
     _cudaSimulation.reset();
+    std::atomic_store(&_selectionShallowData, std::shared_ptr<SelectionShallowData const>());
+    ++_selectionVersion;
 }
 
 int EngineWorker::getTpsRestriction() const
@@ -351,13 +613,66 @@ uint64_t EngineWorker::getCurrentTimestep() const
     return _cudaSimulation->getCurrentTimestep();
 }
 
+uint64_t EngineWorker::getDataVersion() const
+{
+    return _dataVersion.load();
+}
+
+uint64_t EngineWorker::getDataLayoutVersion() const
+{
+    return _dataLayoutVersion.load();
+}
+
 void EngineWorker::setCurrentTimestep(uint64_t value)
 {
     CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
     _cudaSimulation->setCurrentTimestep(value);
 }
 
+void EngineWorker::setSimulationParameters(SimulationParameters const& parameters)
+{
+    CudaAccess access(
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
+
+    {
+        //a pending asynchronous update must not override the parameters afterwards
+        std::unique_lock<std::mutex> uniqueLock(_mutexForAsyncJobs);
+        _updateSimulationParametersJob = boost::none;
+    }
+    setSimulationParametersIntern(parameters);
+    ++_dataVersion;
+}
+
+void EngineWorker::setSimulationParametersSpots(SimulationParametersSpots const& spots)
+{
+    CudaAccess access(
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
+
+    {
+        std::unique_lock<std::mutex> uniqueLock(_mutexForAsyncJobs);
+        _updateSimulationParametersSpotsJob = boost::none;
+    }
+    _cudaSimulation->setSimulationParametersSpots(spots);
+    _settings.simulationParametersSpots = spots;
+    ++_dataVersion;
+}
+
 void EngineWorker::setSimulationParameters_async(SimulationParameters const& parameters)
 {
     {
@@ -410,43 +725,138 @@ void EngineWorker::applyForce_async(
 void EngineWorker::switchSelection(RealVector2D const& pos, float radius)
 {
     CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
     _cudaSimulation->switchSelection(PointSelectionData{{pos.x, pos.y}, radius});
+    ++_dataVersion;
+    publishSelectionIntern();
 }
 
 void EngineWorker::swapSelection(RealVector2D const& pos, float radius)
 {
     CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
     _cudaSimulation->swapSelection(PointSelectionData{{pos.x, pos.y}, radius});
+    ++_dataVersion;
+    publishSelectionIntern();
 }
 
-SelectionShallowData EngineWorker::getSelectionShallowData()
+SelectionShallowData EngineWorker::getSelectionShallowData() const
 {
-    CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
-    return _cudaSimulation->getSelectionShallowData();
+    auto result = std::atomic_load(&_selectionShallowData);
+    return result ? *result : SelectionShallowData();
+}
+
+uint64_t EngineWorker::getSelectionVersion() const
+{
+    return _selectionVersion.load();
 }
 
 void EngineWorker::setSelection(RealVector2D const& startPos, RealVector2D const& endPos)
 {
     CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
     _cudaSimulation->setSelection(AreaSelectionData{{startPos.x, startPos.y}, {endPos.x, endPos.y}});
+    ++_dataVersion;
+    publishSelectionIntern();
 }
 
 void EngineWorker::shallowUpdateSelection(ShallowUpdateSelectionData const& updateData)
 {
     CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
     _cudaSimulation->shallowUpdateSelection(updateData);
+    ++_dataVersion;
+    publishSelectionIntern();
 }
 
 void EngineWorker::removeSelection()
 {
     CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
     _cudaSimulation->removeSelection();
+    ++_dataVersion;
+    publishSelectionIntern();
+}
+
+void EngineWorker::enableObserverStream(ObserverStreamSettings const& settings)
+{
+    CudaAccess access(
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
+    _observerStreamWriter.reset();
+    _observerStreamWriter = boost::make_shared<_ObserverStreamWriter>(settings);
+}
+
+void EngineWorker::disableObserverStream()
+{
+    CudaAccess access(
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
+    _observerStreamWriter.reset();
+}
+
+void EngineWorker::enableFrameExport(FrameExportSettings const& settings)
+{
+    CudaAccess access(
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
+    _frameExporter = boost::make_shared<_FrameExporter>(settings);
+    _isFrameExportEnabled.store(true);
+}
+
+void EngineWorker::disableFrameExport()
+{
+    CudaAccess access(
+        _mutexForAccess,
+        _conditionForAccess,
+        _conditionForWorkerLoop,
+        _requireAccess,
+        _isSimulationRunning,
+        _exceptionData);
+    _frameExporter.reset();
+    _isFrameExportEnabled.store(false);
+}
+
+bool EngineWorker::isFrameExportEnabled() const
+{
+    return _isFrameExportEnabled.load();
 }
 
 void EngineWorker::runThreadLoop()
@@ -502,7 +912,11 @@ void EngineWorker::runThreadLoop()
 
                 startTimestepTime = std::chrono::steady_clock::now();
                 _cudaSimulation->calcCudaTimestep();
+                ++_dataVersion;
                 updateMonitorDataIntern();
+                updateSelectionIntern();
+                publishObserverFrameIntern();
+                exportFrameIntern();
                 ++_timestepsSinceTimepoint;
             }
             processJobs();
@@ -530,6 +944,15 @@ bool EngineWorker::isSimulationRunning() const
     return _isSimulationRunning.load();
 }
 
+void EngineWorker::setSimulationParametersIntern(SimulationParameters const& parameters)
+{
+    auto tokenMemorySize = _cudaSimulation->getTokenMemorySize();
+    _cudaSimulation->setSimulationParameters(parameters);
+    if (tokenMemorySize != _cudaSimulation->getTokenMemorySize()) {
+        ++_dataLayoutVersion;
+    }
+}
+
 void EngineWorker::updateMonitorDataIntern()
 {
     auto now = std::chrono::steady_clock::now();
@@ -546,19 +969,122 @@ void EngineWorker::updateMonitorDataIntern()
         _numFailedAttacks.store(data.numFailedAttacks);
         _numMuscleActivities.store(data.numMuscleActivities);
 
+        //reading the metrics requires several copies from the GPU
+        if (_numMetricsConsumers.load() > 0) {
+            EngineMetrics metrics;
+            _cudaSimulation->getEngineMetrics(metrics);
+            _totalCreatedCells.store(metrics.totalCreatedCells);
+            _totalSuccessfulAttacks.store(metrics.totalSuccessfulAttacks);
+            _totalFailedAttacks.store(metrics.totalFailedAttacks);
+            _totalMuscleActivities.store(metrics.totalMuscleActivities);
+            _numArrayResizes.store(metrics.numArrayResizes);
+            for (int i = 0; i < EnginePhase::Count; ++i) {
+                _phaseNanoseconds[i].store(metrics.phaseNanoseconds[i]);
+            }
+            _gpuMemoryBytes.store(metrics.gpuMemoryBytes);
+            for (int i = 0; i < EngineArray::Count; ++i) {
+                _arrayNumEntries[i].store(metrics.arrayNumEntries[i]);
+                _arraySizes[i].store(metrics.arraySizes[i]);
+            }
+        }
+
         _lastMonitorUpdate = now;
     }
 }
 
+void EngineWorker::updateSelectionIntern()
+{
+    //selected entities only move while the simulation is running, hence an empty selection remains empty
+    auto selectionShallowData = std::atomic_load(&_selectionShallowData);
+    if (!selectionShallowData || 0 == selectionShallowData->numCells + selectionShallowData->numParticles) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (!_lastSelectionUpdate || now - *_lastSelectionUpdate > SelectionUpdate) {
+        publishSelectionIntern();
+        _lastSelectionUpdate = now;
+    }
+}
+
+void EngineWorker::publishSelectionIntern()
+{
+    auto selectionShallowData = _cudaSimulation->getSelectionShallowData();
+    auto prevSelectionShallowData = std::atomic_load(&_selectionShallowData);
+    if (!prevSelectionShallowData || *prevSelectionShallowData != selectionShallowData) {
+        std::atomic_store(&_selectionShallowData, std::make_shared<SelectionShallowData const>(selectionShallowData));
+        ++_selectionVersion;
+    }
+}
+
+void EngineWorker::publishObserverFrameIntern()
+{
+    if (!_observerStreamWriter) {
+        return;
+    }
+    auto timestep = _cudaSimulation->getCurrentTimestep();
+    if (!_observerStreamWriter->isFrameDue(timestep)) {
+        return;
+    }
+
+    auto arraySizes = _cudaSimulation->getArraySizes();
+    DataAccessTO dataTO = _dataTOCache->getDataTO(
+        {arraySizes.cellArraySize,
+         arraySizes.particleArraySize,
+         arraySizes.tokenArraySize,
+         _cudaSimulation->getTokenMemorySize()});
+    IntVector2D worldSize{_settings.generalSettings.worldSizeX, _settings.generalSettings.worldSizeY};
+    _cudaSimulation->getSimulationData({0, 0}, int2{worldSize.x, worldSize.y}, dataTO);
+
+    _observerStreamWriter->publish(dataTO, timestep, worldSize);
+    _dataTOCache->releaseDataTO(dataTO);
+}
+
+void EngineWorker::exportFrameIntern()
+{
+    if (!_frameExporter) {
+        return;
+    }
+    auto timestep = _cudaSimulation->getCurrentTimestep();
+    if (!_frameExporter->isFrameDue(timestep)) {
+        return;
+    }
+
+    auto arraySizes = _cudaSimulation->getArraySizes();
+    DataAccessTO dataTO = _dataTOCache->getDataTO(
+        {arraySizes.cellArraySize,
+         arraySizes.particleArraySize,
+         arraySizes.tokenArraySize,
+         _cudaSimulation->getTokenMemorySize()});
+    IntVector2D worldSize{_settings.generalSettings.worldSizeX, _settings.generalSettings.worldSizeY};
+    _cudaSimulation->getSimulationData({0, 0}, int2{worldSize.x, worldSize.y}, dataTO);
+
+    //a failed export must not end the simulation, the export is disabled instead
+    try {
+        _frameExporter->exportFrame(dataTO, timestep, worldSize, _settings.simulationParametersSpots);
+    } catch (std::exception const& e) {
+        _frameExporter.reset();
+        _isFrameExportEnabled.store(false);
+        if (auto loggingService = ServiceLocator::getInstance().getService<LoggingService>()) {
+            loggingService->logMessage(Priority::Important, std::string("frame export disabled: ") + e.what());
+        }
+    }
+    _dataTOCache->releaseDataTO(dataTO);
+}
+
 void EngineWorker::processJobs()
 {
     std::unique_lock<std::mutex> asyncJobsLock(_mutexForAsyncJobs);
+    if (_updateSimulationParametersJob || _updateSimulationParametersSpotsJob || _flowFieldSettings
+        || !_applyForceJobs.empty()) {
+        ++_dataVersion;
+    }
     if (_updateSimulationParametersJob) {
-        _cudaSimulation->setSimulationParameters(*_updateSimulationParametersJob);
+        setSimulationParametersIntern(*_updateSimulationParametersJob);
         _updateSimulationParametersJob = boost::none;
     }
     if (_updateSimulationParametersSpotsJob) {
         _cudaSimulation->setSimulationParametersSpots(*_updateSimulationParametersSpotsJob);
+        _settings.simulationParametersSpots = *_updateSimulationParametersSpotsJob;
         _updateSimulationParametersSpotsJob = boost::none;
     }
     if (_updateGpuSettingsJob) {
@@ -579,5 +1105,8 @@ void EngineWorker::processJobs()
                  false});
         }
         _applyForceJobs.clear();
+
+        //forces move selected entities also while the simulation is paused
+        publishSelectionIntern();
     }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
 
@@ -13,19 +14,26 @@
 #include "Base/Definitions.h"
 
 #include "EngineInterface/Definitions.h"
+#include "EngineInterface/BulkTransform.h"
 #include "EngineInterface/SimulationParameters.h"
 #include "EngineInterface/GpuSettings.h"
 #include "EngineInterface/OverallStatistics.h"
+#include "EngineInterface/EngineMetrics.h"
 #include "EngineInterface/OverlayDescriptions.h"
 #include "EngineInterface/FlowFieldSettings.h"
 #include "EngineInterface/Settings.h"
 #include "EngineInterface/SelectionShallowData.h"
+#include "EngineInterface/ObserverStreamSettings.h"
+#include "EngineInterface/FrameExportSettings.h"
 #include "EngineInterface/ShallowUpdateSelectionData.h"
+#include "EngineInterface/WorldResizeMode.h"
 #include "EngineGpuKernels/Definitions.h"
 
 #include "Definitions.h"
 #include "DllExport.h"
 
+struct DataAccessTO;
+
 struct ExceptionData
 {
     mutable std::mutex mutex;
@@ -42,7 +50,8 @@ public:
 
     void registerImageResource(GLuint image);
 
-    void tryDrawVectorGraphics(
+    //returns false if the GPU has been busy for too long
+    bool tryDrawVectorGraphics(
         RealVector2D const& rectUpperLeft,
         RealVector2D const& rectLowerRight,
         IntVector2D const& imageSize,
@@ -52,14 +61,33 @@ public:
         RealVector2D const& rectLowerRight,
         IntVector2D const& imageSize,
         double zoom);
+    //returns false if the GPU has been busy for too long, otherwise image contains the pixels in aabbggrr format
+    bool tryDrawVectorGraphicsToHost(
+        RealVector2D const& rectUpperLeft,
+        RealVector2D const& rectLowerRight,
+        IntVector2D const& imageSize,
+        double zoom,
+        std::vector<uint32_t>& image);
 
     DataDescription getSimulationData(IntVector2D const& rectUpperLeft, IntVector2D const& rectLowerRight);
     DataDescription getSelectedSimulationData(bool includeClusters);
+    DataAccessTO getSimulationDataTO(
+        IntVector2D const& rectUpperLeft,
+        IntVector2D const& rectLowerRight,
+        AccessDataTOCache const& cache);
+    std::vector<uint64_t> getTileHashes(int tileSize, float positionTolerance);
     OverallStatistics getMonitorData() const;
+    //does not require GPU access, the values read from the GPU are only updated while a metrics consumer is added
+    EngineMetrics getEngineMetrics() const;
+    void addMetricsConsumer();
+    void removeMetricsConsumer();
 
     void addAndSelectSimulationData(DataDescription const& dataToUpdate);
     void setSimulationData(DataDescription const& dataToUpdate);
+    void setSimulationDataTO(DataAccessTO const& dataTO);
     void removeSelectedEntities(bool includeClusters);
+    void applyBulkTransform(BulkTransform const& transform);
+    void resizeWorld(IntVector2D const& newSize, WorldResizeMode::Type mode);
 
     void calcSingleTimestep();
 
@@ -71,8 +99,14 @@ public:
 
     float getTps() const;
     uint64_t getCurrentTimestep() const;
+    //is increased whenever the simulation data or the parameters affecting the rendering may have changed
+    uint64_t getDataVersion() const;
+    //is increased whenever stored simulation data can no longer be set, see _SimulationController
+    uint64_t getDataLayoutVersion() const;
     void setCurrentTimestep(uint64_t value);
 
+    void setSimulationParameters(SimulationParameters const& parameters);
+    void setSimulationParametersSpots(SimulationParametersSpots const& spots);
     void setSimulationParameters_async(SimulationParameters const& parameters);
     void setSimulationParametersSpots_async(SimulationParametersSpots const& spots);
     void setGpuSettings_async(GpuSettings const& gpuSettings);
@@ -82,18 +116,32 @@ public:
 
     void switchSelection(RealVector2D const& pos, float radius);
     void swapSelection(RealVector2D const& pos, float radius);
-    SelectionShallowData getSelectionShallowData();
+    //does not require GPU access, the data is published by the engine whenever the selection may have changed
+    SelectionShallowData getSelectionShallowData() const;
+    uint64_t getSelectionVersion() const;
     void setSelection(RealVector2D const& startPos, RealVector2D const& endPos);
     void shallowUpdateSelection(ShallowUpdateSelectionData const& updateData);
     void removeSelection();
 
+    void enableObserverStream(ObserverStreamSettings const& settings);
+    void disableObserverStream();
+
+    void enableFrameExport(FrameExportSettings const& settings);
+    void disableFrameExport();
+    bool isFrameExportEnabled() const;  //false after the export has been disabled due to an error
+
     void runThreadLoop();
     void runSimulation();
     void pauseSimulation();
     bool isSimulationRunning() const;
 
 private:
+    void setSimulationParametersIntern(SimulationParameters const& parameters);
     void updateMonitorDataIntern();
+    void updateSelectionIntern();
+    void publishSelectionIntern();
+    void publishObserverFrameIntern();
+    void exportFrameIntern();
     void processJobs();
 
     CudaSimulation _cudaSimulation;
@@ -102,6 +150,7 @@ private:
     mutable std::mutex _mutexForLoop;
     std::condition_variable _conditionForWorkerLoop;
     std::condition_variable _conditionForAccess;
+    std::timed_mutex _mutexForAccess;
 
     std::atomic<bool> _isSimulationRunning{false};
     std::atomic<bool> _isShutdown{false};
@@ -138,6 +187,8 @@ private:
     //monitor data
     boost::optional<std::chrono::steady_clock::time_point> _lastMonitorUpdate;
     std::atomic<uint64_t> _timeStep{0};
+    std::atomic<uint64_t> _dataVersion{0};
+    std::atomic<uint64_t> _dataLayoutVersion{0};
     std::atomic<int> _numCells{0};
     std::atomic<int> _numParticles{0};
     std::atomic<int> _numTokens{0};
@@ -146,8 +197,26 @@ private:
     std::atomic<int> _numSuccessfulAttacks{0};
     std::atomic<int> _numFailedAttacks{0};
     std::atomic<int> _numMuscleActivities{0};
+    std::atomic<uint64_t> _totalCreatedCells{0};
+    std::atomic<uint64_t> _totalSuccessfulAttacks{0};
+    std::atomic<uint64_t> _totalFailedAttacks{0};
+    std::atomic<uint64_t> _totalMuscleActivities{0};
+    std::atomic<uint64_t> _numArrayResizes{0};
+    std::atomic<uint64_t> _phaseNanoseconds[EnginePhase::Count] = {};
+    std::atomic<uint64_t> _gpuMemoryBytes{0};
+    std::atomic<int> _arrayNumEntries[EngineArray::Count] = {};
+    std::atomic<int> _arraySizes[EngineArray::Count] = {};
+    std::atomic<int> _numMetricsConsumers{0};
+
+    //selection snapshot, swapped by std::atomic_load/std::atomic_store
+    boost::optional<std::chrono::steady_clock::time_point> _lastSelectionUpdate;
+    std::shared_ptr<SelectionShallowData const> _selectionShallowData;
+    std::atomic<uint64_t> _selectionVersion{0};
 
     //internals
     void* _cudaResource;
     AccessDataTOCache _dataTOCache;
+    ObserverStreamWriter _observerStreamWriter;
+    FrameExporter _frameExporter;
+    std::atomic<bool> _isFrameExportEnabled{false};
 };
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "FrameExporter.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+_FrameExporter::_FrameExporter(FrameExportSettings const& settings)
+    : _settings(settings)
+    , _rasterizer(settings.numThreads)
+{
+    if (_settings.samplingRate < 1 || _settings.imageWidth < 1 || _settings.imageHeight < 1
+        || _settings.numThreads < 0) {
+        throw std::runtime_error("Invalid frame export settings.");
+    }
+    if (_settings.worldRect
+        && (_settings.worldRect->bottomRight.x <= _settings.worldRect->topLeft.x
+            || _settings.worldRect->bottomRight.y <= _settings.worldRect->topLeft.y)) {
+        throw std::runtime_error("Invalid frame export settings.");
+    }
+    std::error_code error;
+    std::filesystem::create_directories(_settings.directory, error);
+    if (error) {
+        throw std::runtime_error("Frame export directory could not be created: " + _settings.directory);
+    }
+    _writerThread = std::thread(&_FrameExporter::writeFrames, this);
+}
+
+_FrameExporter::~_FrameExporter()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutexForFrames);
+        _isShutdown = true;
+    }
+    _conditionForFrames.notify_all();
+    _writerThread.join();
+}
+
+FrameExportSettings const& _FrameExporter::getSettings() const
+{
+    return _settings;
+}
+
+bool _FrameExporter::isFrameDue(uint64_t timestep) const
+{
+    return 0 == timestep % _settings.samplingRate;
+}
+
+void _FrameExporter::exportFrame(
+    DataAccessTO const& dataTO,
+    uint64_t timestep,
+    IntVector2D const& worldSize,
+    SimulationParametersSpots const& spots)
+{
+    auto worldRect = _settings.worldRect.value_or(RealRect{{0, 0}, {toFloat(worldSize.x), toFloat(worldSize.y)}});
+    RealVector2D rectSize{
+        worldRect.bottomRight.x - worldRect.topLeft.x, worldRect.bottomRight.y - worldRect.topLeft.y};
+
+    //the world rectangle is scaled to fit and centered in the image
+    auto zoom = std::min(toFloat(_settings.imageWidth) / rectSize.x, toFloat(_settings.imageHeight) / rectSize.y);
+    RealVector2D rectUpperLeft{
+        worldRect.topLeft.x - (toFloat(_settings.imageWidth) / zoom - rectSize.x) / 2,
+        worldRect.topLeft.y - (toFloat(_settings.imageHeight) / zoom - rectSize.y) / 2};
+
+    Frame frame;
+    {
+        std::unique_lock<std::mutex> lock(_mutexForFrames);
+        _conditionForWrittenFrames.wait(lock, [this] {
+            return toInt(_pendingFrames.size()) < MaxPendingFrames || !_writeError.empty();
+        });
+        if (!_writeError.empty()) {
+            auto writeError = _writeError;
+            _writeError.clear();
+            throw std::runtime_error(writeError);
+        }
+        if (!_freeImages.empty()) {
+            frame.image = std::move(_freeImages.back());
+            _freeImages.pop_back();
+        }
+    }
+
+    _rasterizer.rasterize(
+        dataTO, worldSize, spots, rectUpperLeft, {_settings.imageWidth, _settings.imageHeight}, zoom, frame.image);
+
+    auto extension = FrameExportFormat::Png == _settings.format ? ".png" : ".ppm";
+    frame.filename = (std::filesystem::path(_settings.directory)
+                      / ("frame_" + std::to_string(timestep) + extension))
+                         .string();
+    {
+        std::lock_guard<std::mutex> lock(_mutexForFrames);
+        _pendingFrames.emplace_back(std::move(frame));
+    }
+    _conditionForFrames.notify_one();
+}
+
+void _FrameExporter::writeFrames()
+{
+    while (true) {
+        Frame frame;
+        {
+            std::unique_lock<std::mutex> lock(_mutexForFrames);
+            _conditionForFrames.wait(lock, [this] { return _isShutdown || !_pendingFrames.empty(); });
+            if (_pendingFrames.empty()) {
+                return;
+            }
+            frame = std::move(_pendingFrames.front());
+            _pendingFrames.pop_front();
+        }
+
+        std::string writeError;
+        try {
+            writeImage(frame);
+        } catch (std::exception const& exception) {
+            writeError = exception.what();
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutexForFrames);
+            if (_writeError.empty()) {
+                _writeError = writeError;
+            }
+            _freeImages.emplace_back(std::move(frame.image));
+        }
+        _conditionForWrittenFrames.notify_all();
+    }
+}
+
+void _FrameExporter::writeImage(Frame const& frame) const
+{
+    auto const& filename = frame.filename;
+    if (FrameExportFormat::Png == _settings.format) {
+        //pixels in aabbggrr format are laid out as r, g, b, a in memory on little-endian machines
+        if (!stbi_write_png(
+                filename.c_str(),
+                _settings.imageWidth,
+                _settings.imageHeight,
+                4,
+                frame.image.data(),
+                _settings.imageWidth * sizeof(uint32_t))) {
+            throw std::runtime_error("Frame could not be written: " + filename);
+        }
+        return;
+    }
+
+    std::ofstream stream(filename, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("Frame could not be written: " + filename);
+    }
+    stream << "P6\n" << _settings.imageWidth << " " << _settings.imageHeight << "\n255\n";
+    std::vector<char> row(_settings.imageWidth * 3);
+    for (int y = 0; y < _settings.imageHeight; ++y) {
+        for (int x = 0; x < _settings.imageWidth; ++x) {
+            auto pixel = frame.image[x + y * _settings.imageWidth];
+            row[x * 3] = static_cast<char>(pixel & 0xff);
+            row[x * 3 + 1] = static_cast<char>((pixel >> 8) & 0xff);
+            row[x * 3 + 2] = static_cast<char>((pixel >> 16) & 0xff);
+        }
+        stream.write(row.data(), row.size());
+    }
+}
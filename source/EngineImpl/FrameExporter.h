@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "Base/Definitions.h"
+#include "EngineInterface/FrameExportSettings.h"
+#include "EngineInterface/SimulationParametersSpots.h"
+
+#include "CpuRasterizer.h"
+#include "Definitions.h"
+
+struct DataAccessTO;
+
+/**
+ * Writes rendered frames of the world into a directory every samplingRate time steps. The frames are rasterized on
+ * the host by CpuRasterizer, so that offscreen runs do not require a GL context.
+ * The images are encoded and written by a background thread. If it falls behind by MaxPendingFrames frames,
+ * exportFrame waits. Write errors are thrown by the next call of exportFrame.
+ */
+class _FrameExporter
+{
+public:
+    _FrameExporter(FrameExportSettings const& settings);
+    ~_FrameExporter();  //writes the pending frames
+
+    FrameExportSettings const& getSettings() const;
+
+    bool isFrameDue(uint64_t timestep) const;
+    void exportFrame(
+        DataAccessTO const& dataTO,
+        uint64_t timestep,
+        IntVector2D const& worldSize,
+        SimulationParametersSpots const& spots);
+
+private:
+    static int const MaxPendingFrames = 4;
+
+    struct Frame
+    {
+        std::string filename;
+        std::vector<uint32_t> image;
+    };
+
+    void writeFrames();
+    void writeImage(Frame const& frame) const;
+
+    FrameExportSettings _settings;
+    CpuRasterizer _rasterizer;
+
+    std::thread _writerThread;
+    std::mutex _mutexForFrames;
+    std::condition_variable _conditionForFrames;
+    std::condition_variable _conditionForWrittenFrames;
+    std::deque<Frame> _pendingFrames;
+    std::vector<std::vector<uint32_t>> _freeImages;     //written images whose buffers are reused
+    std::string _writeError;
+    bool _isShutdown = false;
+};
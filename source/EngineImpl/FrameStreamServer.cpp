@@ -0,0 +1,211 @@
+#include "FrameStreamServer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "EngineWorker.h"
+
+namespace
+{
+    std::chrono::milliseconds const PollInterval(100);
+}
+
+_FrameStreamServer::_FrameStreamServer(FrameStreamSettings const& settings, EngineWorker& worker)
+    : _settings(settings)
+    , _worker(worker)
+{
+    if (_settings.maxClients < 1 || _settings.maxFps < 1 || _settings.tileSize < 1 || _settings.maxImageWidth < 1
+        || _settings.maxImageHeight < 1
+        || (_settings.maxImageWidth + _settings.tileSize - 1) / _settings.tileSize > 0xffff
+        || (_settings.maxImageHeight + _settings.tileSize - 1) / _settings.tileSize > 0xffff) {
+        throw std::runtime_error("Invalid frame stream settings.");
+    }
+    _listener = _settings.useUnixSocket ? Socket::listenUnix(_settings.unixSocketPath)
+                                        : Socket::listenTcp(_settings.host, _settings.port);
+    _acceptThread = std::thread(&_FrameStreamServer::acceptClients, this);
+}
+
+_FrameStreamServer::~_FrameStreamServer()
+{
+    _isShutdown.store(true);
+    _acceptThread.join();
+    for (auto const& client : _clients) {
+        client->thread.join();
+    }
+}
+
+FrameStreamSettings const& _FrameStreamServer::getSettings() const
+{
+    return _settings;
+}
+
+void _FrameStreamServer::acceptClients()
+{
+    while (!_isShutdown.load()) {
+        auto socket = _listener.accept(PollInterval);
+        joinFinishedClients();
+        if (!socket.isValid()) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutexForClients);
+        if (toInt(_clients.size()) >= _settings.maxClients) {
+            continue;   //socket is closed on destruction
+        }
+        auto client = boost::make_shared<Client>();
+        client->socket = std::move(socket);
+        client->thread = std::thread(&_FrameStreamServer::serveClient, this, std::ref(*client));
+        _clients.emplace_back(client);
+    }
+}
+
+void _FrameStreamServer::serveClient(Client& client)
+{
+    boost::optional<FrameStreamRequest> request;
+    bool isKeyFrameRequired = true;
+    uint64_t frameNumber = 0;
+    auto frameDuration = std::chrono::microseconds(1000000 / _settings.maxFps);
+    boost::optional<std::chrono::steady_clock::time_point> lastFrameTime;
+
+    std::vector<uint32_t> image;
+    std::vector<uint32_t> previousImage;
+    std::vector<char> buffer;
+
+    try {
+        while (!_isShutdown.load()) {
+
+            //a new request may change the viewport at any time
+            while (client.socket.waitForData(request ? std::chrono::milliseconds(0) : PollInterval)) {
+                if (!receiveRequest(client.socket, request)) {
+                    client.isFinished.store(true);
+                    return;
+                }
+                isKeyFrameRequired = true;
+            }
+            if (!request) {
+                continue;
+            }
+
+            if (lastFrameTime) {
+                auto remainingTime = frameDuration - (std::chrono::steady_clock::now() - *lastFrameTime);
+                if (remainingTime > std::chrono::microseconds(0)) {
+                    std::this_thread::sleep_for(std::min(
+                        std::chrono::duration_cast<std::chrono::microseconds>(remainingTime),
+                        std::chrono::duration_cast<std::chrono::microseconds>(PollInterval)));
+                    continue;
+                }
+            }
+            lastFrameTime = std::chrono::steady_clock::now();
+
+            IntVector2D imageSize{request->imageWidth, request->imageHeight};
+            RealVector2D worldSize{toFloat(imageSize.x) / request->zoom, toFloat(imageSize.y) / request->zoom};
+            RealVector2D center{request->centerX, request->centerY};
+            auto timestep = _worker.getCurrentTimestep();
+            if (!_worker.tryDrawVectorGraphicsToHost(
+                    center - worldSize / 2, center + worldSize / 2, imageSize, request->zoom, image)) {
+                continue;
+            }
+
+            auto isKeyFrame = isKeyFrameRequired || previousImage.size() != image.size();
+            buffer.resize(sizeof(FrameStreamFrameHeader));
+            auto numTiles = encodeChangedTiles(image, previousImage, imageSize, isKeyFrame, buffer);
+            std::swap(image, previousImage);
+            if (0 == numTiles && !isKeyFrame) {
+                continue;
+            }
+
+            FrameStreamFrameHeader header;
+            std::memcpy(header.magic, FrameStream::FrameMagic, sizeof(header.magic));
+            header.flags = isKeyFrame ? FrameStream::FrameFlag::KeyFrame : 0;
+            header.frameNumber = ++frameNumber;
+            header.timestep = timestep;
+            header.imageWidth = imageSize.x;
+            header.imageHeight = imageSize.y;
+            header.tileSize = _settings.tileSize;
+            header.numTiles = numTiles;
+            std::memcpy(buffer.data(), &header, sizeof(header));
+
+            //blocks this thread only, the simulation continues
+            if (!client.socket.sendAll(buffer.data(), buffer.size(), _isShutdown)) {
+                break;
+            }
+            isKeyFrameRequired = false;
+        }
+    } catch (std::exception const&) {
+        //engine errors are reported to the user interface by the worker, the client is disconnected
+    }
+    client.isFinished.store(true);
+}
+
+bool _FrameStreamServer::receiveRequest(Socket& socket, boost::optional<FrameStreamRequest>& request)
+{
+    FrameStreamRequest newRequest;
+    if (!socket.receiveAll(&newRequest, sizeof(newRequest), _isShutdown) || !isValid(newRequest)) {
+        return false;
+    }
+    request = newRequest;
+    return true;
+}
+
+bool _FrameStreamServer::isValid(FrameStreamRequest const& request) const
+{
+    return 0 == std::memcmp(request.magic, FrameStream::RequestMagic, sizeof(request.magic))
+        && FrameStream::Version == request.version && request.zoom > 0 && request.imageWidth > 0
+        && request.imageHeight > 0 && request.imageWidth <= _settings.maxImageWidth
+        && request.imageHeight <= _settings.maxImageHeight;
+}
+
+uint32_t _FrameStreamServer::encodeChangedTiles(
+    std::vector<uint32_t> const& image,
+    std::vector<uint32_t> const& previousImage,
+    IntVector2D const& imageSize,
+    bool isKeyFrame,
+    std::vector<char>& buffer) const
+{
+    auto tileSize = _settings.tileSize;
+    uint32_t result = 0;
+    for (int tileY = 0; tileY * tileSize < imageSize.y; ++tileY) {
+        for (int tileX = 0; tileX * tileSize < imageSize.x; ++tileX) {
+            auto startX = tileX * tileSize;
+            auto startY = tileY * tileSize;
+            auto width = std::min(tileSize, imageSize.x - startX);
+            auto height = std::min(tileSize, imageSize.y - startY);
+            auto rowBytes = sizeof(uint32_t) * width;
+
+            auto isChanged = isKeyFrame;
+            for (int y = startY; y < startY + height && !isChanged; ++y) {
+                auto offset = static_cast<size_t>(y) * imageSize.x + startX;
+                isChanged = 0 != std::memcmp(&image[offset], &previousImage[offset], rowBytes);
+            }
+            if (!isChanged) {
+                continue;
+            }
+
+            FrameStreamTileHeader tileHeader{static_cast<uint16_t>(tileX), static_cast<uint16_t>(tileY)};
+            auto position = buffer.size();
+            buffer.resize(position + sizeof(tileHeader) + rowBytes * height);
+            std::memcpy(&buffer[position], &tileHeader, sizeof(tileHeader));
+            position += sizeof(tileHeader);
+            for (int y = startY; y < startY + height; ++y) {
+                std::memcpy(&buffer[position], &image[static_cast<size_t>(y) * imageSize.x + startX], rowBytes);
+                position += rowBytes;
+            }
+            ++result;
+        }
+    }
+    return result;
+}
+
+void _FrameStreamServer::joinFinishedClients()
+{
+    std::lock_guard<std::mutex> lock(_mutexForClients);
+    for (auto it = _clients.begin(); it != _clients.end();) {
+        if ((*it)->isFinished.load()) {
+            (*it)->thread.join();
+            it = _clients.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
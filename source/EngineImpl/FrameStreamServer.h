@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "Base/Definitions.h"
+#include "EngineInterface/FrameStreamProtocol.h"
+#include "EngineInterface/FrameStreamSettings.h"
+
+#include "Definitions.h"
+#include "Socket.h"
+
+class EngineWorker;
+
+/**
+ * Serves rendered and delta encoded images of the simulation to remote viewers. See FrameStreamProtocol.h for the
+ * wire format. Each client is served by its own thread which renders a new frame only after the previous one has
+ * been sent.
+ */
+class _FrameStreamServer
+{
+public:
+    _FrameStreamServer(FrameStreamSettings const& settings, EngineWorker& worker);
+    ~_FrameStreamServer();
+
+    FrameStreamSettings const& getSettings() const;
+
+private:
+    struct Client
+    {
+        Socket socket;
+        std::thread thread;
+        std::atomic<bool> isFinished{false};
+    };
+
+    void acceptClients();
+    void serveClient(Client& client);
+
+    bool receiveRequest(Socket& socket, boost::optional<FrameStreamRequest>& request);
+    bool isValid(FrameStreamRequest const& request) const;
+
+    //returns the number of encoded tiles
+    uint32_t encodeChangedTiles(
+        std::vector<uint32_t> const& image,
+        std::vector<uint32_t> const& previousImage,
+        IntVector2D const& imageSize,
+        bool isKeyFrame,
+        std::vector<char>& buffer) const;
+
+    void joinFinishedClients();
+
+    FrameStreamSettings _settings;
+    EngineWorker& _worker;
+
+    Socket _listener;
+    std::thread _acceptThread;
+    std::atomic<bool> _isShutdown{false};
+
+    std::mutex _mutexForClients;
+    std::list<boost::shared_ptr<Client>> _clients;
+};
@@ -0,0 +1,170 @@
+#include "MetricsServer.h"
+
+#include <sstream>
+
+#include "EngineWorker.h"
+
+namespace
+{
+    std::chrono::milliseconds const PollInterval(100);
+    std::chrono::milliseconds const RequestTimeout(1000);
+    size_t const MaxRequestSize = 8192;
+
+    class MetricsWriter
+    {
+    public:
+        MetricsWriter() { _stream.precision(15); }
+
+        void addMetric(std::string const& name, std::string const& type, std::string const& help)
+        {
+            _stream << "# HELP " << name << " " << help << "\n";
+            _stream << "# TYPE " << name << " " << type << "\n";
+        }
+
+        template <typename T>
+        void addValue(std::string const& name, T value, std::string const& labels = "")
+        {
+            _stream << name;
+            if (!labels.empty()) {
+                _stream << "{" << labels << "}";
+            }
+            _stream << " " << value << "\n";
+        }
+
+        template <typename T>
+        void addSingleMetric(std::string const& name, std::string const& type, std::string const& help, T value)
+        {
+            addMetric(name, type, help);
+            addValue(name, value);
+        }
+
+        std::string getText() const { return _stream.str(); }
+
+    private:
+        std::ostringstream _stream;
+    };
+}
+
+_MetricsServer::_MetricsServer(MetricsServerSettings const& settings, EngineWorker& worker)
+    : _settings(settings)
+    , _worker(worker)
+{
+    _listener = Socket::listenTcp(_settings.host, _settings.port);
+    _worker.addMetricsConsumer();
+    _thread = std::thread(&_MetricsServer::serve, this);
+}
+
+_MetricsServer::~_MetricsServer()
+{
+    _isShutdown.store(true);
+    _thread.join();
+    _worker.removeMetricsConsumer();
+}
+
+MetricsServerSettings const& _MetricsServer::getSettings() const
+{
+    return _settings;
+}
+
+void _MetricsServer::serve()
+{
+    while (!_isShutdown.load()) {
+        auto socket = _listener.accept(PollInterval);
+        if (socket.isValid()) {
+            serveRequest(socket);
+        }
+    }
+}
+
+void _MetricsServer::serveRequest(Socket& socket)
+{
+    std::string request;
+    auto deadline = std::chrono::steady_clock::now() + RequestTimeout;
+    while (request.find("\r\n\r\n") == std::string::npos) {
+        if (std::chrono::steady_clock::now() > deadline || request.size() > MaxRequestSize || _isShutdown.load()) {
+            return;
+        }
+        char buffer[1024];
+        auto numReceived = socket.receiveSome(buffer, sizeof(buffer));
+        if (numReceived < 0) {
+            return;
+        }
+        if (0 == numReceived) {
+            socket.waitForData(PollInterval);
+            continue;
+        }
+        request.append(buffer, numReceived);
+    }
+
+    std::string status;
+    std::string contentType = "text/plain; charset=utf-8";
+    std::string body;
+    auto requestLine = request.substr(0, request.find("\r\n"));
+    if (requestLine.rfind("GET /metrics ", 0) == 0) {
+        status = "200 OK";
+        contentType = "text/plain; version=0.0.4; charset=utf-8";
+        body = getMetricsText();
+    } else if (requestLine.rfind("GET ", 0) == 0) {
+        status = "404 Not Found";
+        body = "Not found\n";
+    } else {
+        status = "405 Method Not Allowed";
+        body = "Method not allowed\n";
+    }
+
+    std::ostringstream response;
+    response << "HTTP/1.1 " << status << "\r\n"
+             << "Content-Type: " << contentType << "\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    auto responseText = response.str();
+    socket.sendAll(responseText.data(), responseText.size(), _isShutdown);
+}
+
+std::string _MetricsServer::getMetricsText() const
+{
+    auto metrics = _worker.getEngineMetrics();
+    auto const& statistics = metrics.statistics;
+
+    MetricsWriter writer;
+    writer.addSingleMetric("alien_tps", "gauge", "Time steps per second.", metrics.tps);
+    writer.addSingleMetric("alien_timestep", "gauge", "Current time step.", statistics.timeStep);
+
+    writer.addMetric("alien_entities", "gauge", "Number of entities.");
+    writer.addValue("alien_entities", statistics.numCells, "type=\"cell\"");
+    writer.addValue("alien_entities", statistics.numParticles, "type=\"particle\"");
+    writer.addValue("alien_entities", statistics.numTokens, "type=\"token\"");
+
+    writer.addSingleMetric(
+        "alien_created_cells_total", "counter", "Number of cells created by constructors.", metrics.totalCreatedCells);
+    writer.addMetric("alien_attacks_total", "counter", "Number of attacks by weapons.");
+    writer.addValue("alien_attacks_total", metrics.totalSuccessfulAttacks, "result=\"success\"");
+    writer.addValue("alien_attacks_total", metrics.totalFailedAttacks, "result=\"failure\"");
+    writer.addSingleMetric(
+        "alien_muscle_activities_total", "counter", "Number of muscle activities.", metrics.totalMuscleActivities);
+
+    writer.addSingleMetric(
+        "alien_gpu_memory_bytes", "gauge", "GPU memory acquired by the engine.", metrics.gpuMemoryBytes);
+    writer.addMetric("alien_array_entries", "gauge", "Number of used entries of the engine arrays.");
+    for (int i = 0; i < EngineArray::Count; ++i) {
+        writer.addValue(
+            "alien_array_entries", metrics.arrayNumEntries[i], std::string("array=\"") + EngineArray::Names[i] + "\"");
+    }
+    writer.addMetric("alien_array_size", "gauge", "Capacity of the engine arrays.");
+    for (int i = 0; i < EngineArray::Count; ++i) {
+        writer.addValue(
+            "alien_array_size", metrics.arraySizes[i], std::string("array=\"") + EngineArray::Names[i] + "\"");
+    }
+    writer.addSingleMetric(
+        "alien_array_resizes_total", "counter", "Number of resizes of the engine arrays.", metrics.numArrayResizes);
+
+    writer.addMetric("alien_phase_seconds_total", "counter", "GPU time spent in the phases of the time steps.");
+    for (int i = 0; i < EnginePhase::Count; ++i) {
+        writer.addValue(
+            "alien_phase_seconds_total",
+            static_cast<double>(metrics.phaseNanoseconds[i]) / 1e9,
+            std::string("phase=\"") + EnginePhase::Names[i] + "\"");
+    }
+    return writer.getText();
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "EngineInterface/MetricsServerSettings.h"
+
+#include "Definitions.h"
+#include "Socket.h"
+
+class EngineWorker;
+
+/**
+ * Serves the metrics of the engine in the Prometheus text format at http://<host>:<port>/metrics.
+ * The metrics are read from atomics of the worker such that scraping never interrupts the simulation. The server is
+ * registered as a metrics consumer of the worker during its lifetime.
+ */
+class _MetricsServer
+{
+public:
+    _MetricsServer(MetricsServerSettings const& settings, EngineWorker& worker);
+    ~_MetricsServer();
+
+    MetricsServerSettings const& getSettings() const;
+
+private:
+    void serve();
+    void serveRequest(Socket& socket);
+    std::string getMetricsText() const;
+
+    MetricsServerSettings _settings;
+    EngineWorker& _worker;
+
+    Socket _listener;
+    std::thread _thread;
+    std::atomic<bool> _isShutdown{false};
+};
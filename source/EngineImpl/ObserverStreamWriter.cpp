@@ -0,0 +1,260 @@
+#include "ObserverStreamWriter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "EngineGpuKernels/AccessTOs.cuh"
+
+static_assert(ObserverStream::MaxConnections == MAX_CELL_BONDS, "observer stream layout does not match engine");
+
+namespace
+{
+    uint64_t alignOffset(uint64_t offset)
+    {
+        return (offset + 63) / 64 * 64;
+    }
+
+    void setSequence(ObserverFrameHeader* frame, uint64_t value)
+    {
+        std::atomic_thread_fence(std::memory_order_release);
+        *static_cast<uint64_t volatile*>(&frame->sequence) = value;
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+}
+
+_ObserverStreamWriter::_ObserverStreamWriter(ObserverStreamSettings const& settings)
+    : _settings(settings)
+{
+    if (_settings.samplingRate < 1 || _settings.numSlots < 1 || _settings.maxCells < 0 || _settings.maxParticles < 0
+        || _settings.maxTokens < 0 || _settings.maxTokenMemorySize < 0) {
+        throw std::runtime_error("Invalid observer stream settings.");
+    }
+    if (!(_settings.fieldMask & ObserverStream::Field::Cells)) {
+        _settings.fieldMask &= ~ObserverStream::Field::CellConnections;
+    }
+    if (!(_settings.fieldMask & ObserverStream::Field::Tokens)) {
+        _settings.fieldMask &= ~ObserverStream::Field::TokenMemory;
+    }
+
+    uint64_t offset = alignOffset(sizeof(ObserverFrameHeader));
+    auto addArray = [&](ObserverStream::Field::Type field, uint64_t arraySize, uint64_t& arrayOffset) {
+        if (_settings.fieldMask & field) {
+            arrayOffset = offset;
+            offset = alignOffset(offset + arraySize);
+        }
+    };
+    addArray(ObserverStream::Field::Cells, sizeof(ObserverCell) * _settings.maxCells, _cellsOffset);
+    addArray(
+        ObserverStream::Field::CellConnections,
+        sizeof(ObserverCellConnections) * _settings.maxCells,
+        _connectionsOffset);
+    addArray(ObserverStream::Field::Particles, sizeof(ObserverParticle) * _settings.maxParticles, _particlesOffset);
+    addArray(ObserverStream::Field::Tokens, sizeof(ObserverToken) * _settings.maxTokens, _tokensOffset);
+    addArray(
+        ObserverStream::Field::TokenMemory,
+        static_cast<uint64_t>(_settings.maxTokens) * _settings.maxTokenMemorySize,
+        _tokenMemoryOffset);
+    _slotSize = offset;
+
+    auto headerSize = alignOffset(sizeof(ObserverStreamHeader));
+    _segmentSize = headerSize + _slotSize * _settings.numSlots;
+    createSegment();
+
+    std::memset(_segment, 0, _segmentSize);
+    auto header = reinterpret_cast<ObserverStreamHeader*>(_segment);
+    std::memcpy(header->magic, ObserverStream::Magic, sizeof(header->magic));
+    header->version = ObserverStream::Version;
+    header->numSlots = _settings.numSlots;
+    header->headerSize = headerSize;
+    header->slotSize = _slotSize;
+    header->numFrames = 0;
+}
+
+_ObserverStreamWriter::~_ObserverStreamWriter()
+{
+    destroySegment();
+}
+
+ObserverStreamSettings const& _ObserverStreamWriter::getSettings() const
+{
+    return _settings;
+}
+
+bool _ObserverStreamWriter::isFrameDue(uint64_t timestep) const
+{
+    return 0 == timestep % _settings.samplingRate;
+}
+
+void _ObserverStreamWriter::publish(DataAccessTO const& dataTO, uint64_t timestep, IntVector2D const& worldSize)
+{
+    auto header = reinterpret_cast<ObserverStreamHeader*>(_segment);
+    auto frameNumber = _numFrames + 1;
+    auto slot = _segment + header->headerSize + ((frameNumber - 1) % _settings.numSlots) * _slotSize;
+    auto frame = reinterpret_cast<ObserverFrameHeader*>(slot);
+
+    setSequence(frame, frameNumber * 2 - 1);
+
+    auto numCells = std::min(*dataTO.numCells, _settings.maxCells);
+    auto numParticles = std::min(*dataTO.numParticles, _settings.maxParticles);
+    auto numTokens = std::min(*dataTO.numTokens, _settings.maxTokens);
+    auto tokenMemorySize = std::min(dataTO.tokenMemorySize, _settings.maxTokenMemorySize);
+
+    frame->frameNumber = frameNumber;
+    frame->timestep = timestep;
+    frame->fieldMask = _settings.fieldMask;
+    frame->flags = 0;
+    if (numCells < *dataTO.numCells || numParticles < *dataTO.numParticles || numTokens < *dataTO.numTokens
+        || tokenMemorySize < dataTO.tokenMemorySize) {
+        frame->flags |= ObserverStream::FrameFlag::Truncated;
+    }
+    frame->worldSizeX = worldSize.x;
+    frame->worldSizeY = worldSize.y;
+    frame->numCells = (_settings.fieldMask & ObserverStream::Field::Cells) ? numCells : 0;
+    frame->numParticles = (_settings.fieldMask & ObserverStream::Field::Particles) ? numParticles : 0;
+    frame->numTokens = (_settings.fieldMask & ObserverStream::Field::Tokens) ? numTokens : 0;
+    frame->tokenMemorySize = (_settings.fieldMask & ObserverStream::Field::TokenMemory) ? tokenMemorySize : 0;
+    frame->cellsOffset = _cellsOffset;
+    frame->connectionsOffset = _connectionsOffset;
+    frame->particlesOffset = _particlesOffset;
+    frame->tokensOffset = _tokensOffset;
+    frame->tokenMemoryOffset = _tokenMemoryOffset;
+
+    if (_settings.fieldMask & ObserverStream::Field::Cells) {
+        auto cells = reinterpret_cast<ObserverCell*>(slot + _cellsOffset);
+        for (int i = 0; i < numCells; ++i) {
+            auto const& cellTO = dataTO.cells[i];
+            auto& cell = cells[i];
+            cell.id = cellTO.id;
+            cell.posX = cellTO.pos.x;
+            cell.posY = cellTO.pos.y;
+            cell.velX = cellTO.vel.x;
+            cell.velY = cellTO.vel.y;
+            cell.energy = cellTO.energy;
+            cell.cellFunctionType = cellTO.cellFunctionType;
+            cell.numConnections = cellTO.numConnections;
+            cell.branchNumber = cellTO.branchNumber;
+            cell.tokenUsages = cellTO.tokenUsages;
+            cell.color = cellTO.metadata.color;
+        }
+    }
+    if (_settings.fieldMask & ObserverStream::Field::CellConnections) {
+        auto connections = reinterpret_cast<ObserverCellConnections*>(slot + _connectionsOffset);
+        for (int i = 0; i < numCells; ++i) {
+            auto const& cellTO = dataTO.cells[i];
+            for (int j = 0; j < ObserverStream::MaxConnections; ++j) {
+                auto isValid = j < cellTO.numConnections && cellTO.connections[j].cellIndex < numCells;
+                connections[i].cellIndex[j] = isValid ? cellTO.connections[j].cellIndex : -1;
+                connections[i].distance[j] = isValid ? cellTO.connections[j].distance : 0;
+            }
+        }
+    }
+    if (_settings.fieldMask & ObserverStream::Field::Particles) {
+        auto particles = reinterpret_cast<ObserverParticle*>(slot + _particlesOffset);
+        for (int i = 0; i < numParticles; ++i) {
+            auto const& particleTO = dataTO.particles[i];
+            auto& particle = particles[i];
+            particle.id = particleTO.id;
+            particle.posX = particleTO.pos.x;
+            particle.posY = particleTO.pos.y;
+            particle.velX = particleTO.vel.x;
+            particle.velY = particleTO.vel.y;
+            particle.energy = particleTO.energy;
+            particle.color = particleTO.metadata.color;
+        }
+    }
+    if (_settings.fieldMask & ObserverStream::Field::Tokens) {
+        auto tokens = reinterpret_cast<ObserverToken*>(slot + _tokensOffset);
+        for (int i = 0; i < numTokens; ++i) {
+            auto const& tokenTO = dataTO.tokens[i];
+            tokens[i].energy = tokenTO.energy;
+            tokens[i].cellIndex = tokenTO.cellIndex < numCells ? tokenTO.cellIndex : -1;
+        }
+    }
+    if (_settings.fieldMask & ObserverStream::Field::TokenMemory) {
+        auto tokenMemory = slot + _tokenMemoryOffset;
+        for (int i = 0; i < numTokens; ++i) {
+            std::memcpy(
+                tokenMemory + i * tokenMemorySize, dataTO.tokenMemory + i * dataTO.tokenMemorySize, tokenMemorySize);
+        }
+    }
+
+    setSequence(frame, frameNumber * 2);
+    *static_cast<uint64_t volatile*>(&header->numFrames) = frameNumber;
+    _numFrames = frameNumber;
+}
+
+#if defined(_WIN32)
+void _ObserverStreamWriter::createSegment()
+{
+    auto name = _settings.name;
+    if (!name.empty() && name.front() == '/') {
+        name.erase(0, 1);
+    }
+    auto handle = CreateFileMappingA(
+        INVALID_HANDLE_VALUE,
+        nullptr,
+        PAGE_READWRITE,
+        static_cast<DWORD>(_segmentSize >> 32),
+        static_cast<DWORD>(_segmentSize & 0xffffffff),
+        name.c_str());
+    if (!handle) {
+        throw std::runtime_error("Could not create shared memory segment " + _settings.name + ".");
+    }
+    auto segment = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, _segmentSize);
+    if (!segment) {
+        CloseHandle(handle);
+        throw std::runtime_error("Could not map shared memory segment " + _settings.name + ".");
+    }
+    _handle = handle;
+    _segment = static_cast<char*>(segment);
+}
+
+void _ObserverStreamWriter::destroySegment()
+{
+    if (_segment) {
+        UnmapViewOfFile(_segment);
+        CloseHandle(static_cast<HANDLE>(_handle));
+        _segment = nullptr;
+    }
+}
+#else
+void _ObserverStreamWriter::createSegment()
+{
+    auto fd = shm_open(_settings.name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+    if (fd < 0) {
+        throw std::runtime_error("Could not create shared memory segment " + _settings.name + ".");
+    }
+    if (ftruncate(fd, static_cast<off_t>(_segmentSize)) != 0) {
+        close(fd);
+        shm_unlink(_settings.name.c_str());
+        throw std::runtime_error("Could not resize shared memory segment " + _settings.name + ".");
+    }
+    auto segment = mmap(nullptr, _segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == segment) {
+        shm_unlink(_settings.name.c_str());
+        throw std::runtime_error("Could not map shared memory segment " + _settings.name + ".");
+    }
+    _segment = static_cast<char*>(segment);
+}
+
+void _ObserverStreamWriter::destroySegment()
+{
+    if (_segment) {
+        munmap(_segment, _segmentSize);
+        shm_unlink(_settings.name.c_str());
+        _segment = nullptr;
+    }
+}
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Base/Definitions.h"
+#include "EngineInterface/ObserverStreamSettings.h"
+
+#include "Definitions.h"
+
+struct DataAccessTO;
+
+/**
+ * Publishes world frames into a shared memory segment with the layout described in ObserverStreamLayout.h.
+ * The segment is created on construction and removed on destruction.
+ */
+class _ObserverStreamWriter
+{
+public:
+    _ObserverStreamWriter(ObserverStreamSettings const& settings);
+    ~_ObserverStreamWriter();
+
+    ObserverStreamSettings const& getSettings() const;
+
+    bool isFrameDue(uint64_t timestep) const;
+    void publish(DataAccessTO const& dataTO, uint64_t timestep, IntVector2D const& worldSize);
+
+private:
+    void createSegment();
+    void destroySegment();
+
+    ObserverStreamSettings _settings;
+
+    uint64_t _slotSize = 0;
+    uint64_t _cellsOffset = 0;
+    uint64_t _connectionsOffset = 0;
+    uint64_t _particlesOffset = 0;
+    uint64_t _tokensOffset = 0;
+    uint64_t _tokenMemoryOffset = 0;
+
+    uint64_t _numFrames = 0;
+    uint64_t _segmentSize = 0;
+    char* _segment = nullptr;
+    void* _handle = nullptr;    //only used on Windows
+};
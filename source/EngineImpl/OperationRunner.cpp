@@ -0,0 +1,120 @@
+#include "OperationRunner.h"
+
+#include <algorithm>
+
+#include <boost/make_shared.hpp>
+
+_Operation::_Operation(std::string const& name, bool cancellable)
+    : _name(name)
+    , _cancellable(cancellable)
+{}
+
+std::string const& _Operation::getName() const
+{
+    return _name;
+}
+
+bool _Operation::isCancellable() const
+{
+    return _cancellable;
+}
+
+void _Operation::setProgress(float value)
+{
+    _progress.store(std::min(std::max(value, 0.0f), 1.0f));
+}
+
+void _Operation::checkCancellation() const
+{
+    if (_cancelled.load()) {
+        throw OperationCancelledException(_name);
+    }
+}
+
+float _Operation::getProgress() const
+{
+    return _progress.load();
+}
+
+void _Operation::cancel()
+{
+    if (_cancellable) {
+        _cancelled.store(true);
+    }
+}
+
+bool _Operation::isCancelled() const
+{
+    return _cancelled.load();
+}
+
+bool _Operation::isFinished() const
+{
+    return _future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void _Operation::get()
+{
+    _future.get();
+}
+
+_OperationRunner::_OperationRunner(int numThreads)
+{
+    for (int i = 0; i < std::max(1, numThreads); ++i) {
+        _threads.emplace_back(&_OperationRunner::processJobs, this);
+    }
+}
+
+_OperationRunner::~_OperationRunner()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutexForJobs);
+        for (auto& job : _jobs) {
+            job.operation->cancel();
+        }
+        _isShutdown = true;
+    }
+    _conditionForJobs.notify_all();
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+Operation _OperationRunner::run(std::string const& name, std::function<void(_Operation&)> const& body, bool cancellable)
+{
+    auto operation = boost::make_shared<_Operation>(name, cancellable);
+
+    //the job keeps the operation alive while the task is executed
+    _Operation* operationPtr = operation.get();
+    std::packaged_task<void()> task([operationPtr, body] {
+        operationPtr->checkCancellation();
+        body(*operationPtr);
+        operationPtr->setProgress(1.0f);
+    });
+    operation->_future = task.get_future().share();
+    {
+        std::lock_guard<std::mutex> lock(_mutexForJobs);
+        _jobs.emplace_back(Job{operation, std::move(task)});
+    }
+    _conditionForJobs.notify_one();
+    return operation;
+}
+
+void _OperationRunner::processJobs()
+{
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(_mutexForJobs);
+            _conditionForJobs.wait(lock, [this] { return _isShutdown || !_jobs.empty(); });
+            if (_jobs.empty()) {
+                return;
+            }
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        //exceptions are stored in the future
+        job.task();
+    }
+}
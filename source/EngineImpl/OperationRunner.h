@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Definitions.h"
+#include "DllExport.h"
+
+class OperationCancelledException : public std::runtime_error
+{
+public:
+    OperationCancelledException(std::string const& name)
+        : std::runtime_error((name + " has been cancelled.").c_str())
+    {}
+};
+
+/**
+ * Handle of an operation executed by _OperationRunner. The body of the operation reports its progress and checks
+ * for cancellation between its chunks of work, hence a cancellation takes effect only at the next check.
+ */
+class _Operation
+{
+public:
+    ENGINEIMPL_EXPORT _Operation(std::string const& name, bool cancellable);
+
+    ENGINEIMPL_EXPORT std::string const& getName() const;
+    ENGINEIMPL_EXPORT bool isCancellable() const;
+
+    //called by the body of the operation
+    ENGINEIMPL_EXPORT void setProgress(float value);  //between 0 and 1
+    ENGINEIMPL_EXPORT void checkCancellation() const;  //throws OperationCancelledException
+
+    //called by observers
+    ENGINEIMPL_EXPORT float getProgress() const;
+    ENGINEIMPL_EXPORT void cancel();
+    ENGINEIMPL_EXPORT bool isCancelled() const;
+    ENGINEIMPL_EXPORT bool isFinished() const;
+    ENGINEIMPL_EXPORT void get();  //waits for the operation and rethrows its exception
+
+private:
+    friend class _OperationRunner;
+
+    std::string _name;
+    bool _cancellable;
+    std::atomic<float> _progress{0};
+    std::atomic<bool> _cancelled{false};
+    std::shared_future<void> _future;
+};
+
+/**
+ * Executes long-running operations on a pool of threads in the order of their submission.
+ */
+class _OperationRunner
+{
+public:
+    ENGINEIMPL_EXPORT _OperationRunner(int numThreads = 1);
+    ENGINEIMPL_EXPORT ~_OperationRunner();  //cancels pending operations and waits for the running ones
+
+    ENGINEIMPL_EXPORT Operation
+    run(std::string const& name, std::function<void(_Operation&)> const& body, bool cancellable = true);
+
+private:
+    struct Job
+    {
+        Operation operation;
+        std::packaged_task<void()> task;
+    };
+
+    void processJobs();
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutexForJobs;
+    std::condition_variable _conditionForJobs;
+    std::deque<Job> _jobs;
+    bool _isShutdown = false;
+};
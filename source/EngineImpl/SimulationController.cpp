@@ -1,7 +1,11 @@
 #include "SimulationController.h"
 
+#include "EngineGpuKernels/AccessTOs.cuh"
 #include "EngineInterface/Descriptions.h"
 
+#include "FrameStreamServer.h"
+#include "MetricsServer.h"
+
 void _SimulationController::initCuda()
 {
     _worker.initCuda();
@@ -20,6 +24,26 @@ void _SimulationController::newSimulation(uint64_t timestep, Settings const& set
     _isSelectionInvalid = true;
 }
 
+void _SimulationController::replaceSimulation(uint64_t timestep, Settings const& settings, SymbolMap const& symbolMap)
+{
+    auto observerStreamSettings = _observerStreamSettings;
+    auto frameExportSettings = getFrameExportSettings();
+    auto frameStreamSettings = getFrameStreamSettings();
+
+    closeSimulation();
+    newSimulation(timestep, settings, symbolMap);
+
+    if (observerStreamSettings) {
+        enableObserverStream(*observerStreamSettings);
+    }
+    if (frameExportSettings) {
+        enableFrameExport(*frameExportSettings);
+    }
+    if (frameStreamSettings) {
+        enableFrameStream(*frameStreamSettings);
+    }
+}
+
 void _SimulationController::clear()
 {
     _worker.clear();
@@ -32,13 +56,13 @@ void _SimulationController::registerImageResource(GLuint image)
     _worker.registerImageResource(image);
 }
 
-void _SimulationController::tryDrawVectorGraphics(
+bool _SimulationController::tryDrawVectorGraphics(
     RealVector2D const& rectUpperLeft,
     RealVector2D const& rectLowerRight,
     IntVector2D const& imageSize,
     double zoom)
 {
-    _worker.tryDrawVectorGraphics(rectUpperLeft, rectLowerRight, imageSize, zoom);
+    return _worker.tryDrawVectorGraphics(rectUpperLeft, rectLowerRight, imageSize, zoom);
 }
 
 boost::optional<OverlayDescription> _SimulationController::tryDrawVectorGraphicsAndReturnOverlay(
@@ -50,11 +74,34 @@ boost::optional<OverlayDescription> _SimulationController::tryDrawVectorGraphics
     return _worker.tryDrawVectorGraphicsAndReturnOverlay(rectUpperLeft, rectLowerRight, imageSize, zoom);
 }
 
+bool _SimulationController::tryDrawVectorGraphicsToHost(
+    RealVector2D const& rectUpperLeft,
+    RealVector2D const& rectLowerRight,
+    IntVector2D const& imageSize,
+    double zoom,
+    std::vector<uint32_t>& image)
+{
+    return _worker.tryDrawVectorGraphicsToHost(rectUpperLeft, rectLowerRight, imageSize, zoom, image);
+}
+
 DataDescription _SimulationController::getSimulationData(IntVector2D const& rectUpperLeft, IntVector2D const& rectLowerRight)
 {
     return _worker.getSimulationData(rectUpperLeft, rectLowerRight);
 }
 
+DataAccessTO _SimulationController::getSimulationDataTO(
+    IntVector2D const& rectUpperLeft,
+    IntVector2D const& rectLowerRight,
+    AccessDataTOCache const& cache)
+{
+    return _worker.getSimulationDataTO(rectUpperLeft, rectLowerRight, cache);
+}
+
+std::vector<uint64_t> _SimulationController::getTileHashes(int tileSize, float positionTolerance)
+{
+    return _worker.getTileHashes(tileSize, positionTolerance);
+}
+
 DataDescription _SimulationController::getSelectedSimulationData(bool includeClusters)
 {
     return _worker.getSelectedSimulationData(includeClusters);
@@ -71,12 +118,31 @@ void _SimulationController::setSimulationData(DataDescription const& dataToUpdat
     _isSelectionInvalid = true;
 }
 
+void _SimulationController::setSimulationDataTO(DataAccessTO const& dataTO)
+{
+    _worker.setSimulationDataTO(dataTO);
+    _isSelectionInvalid = true;
+}
+
 void _SimulationController::removeSelectedEntities(bool includeClusters)
 {
     _worker.removeSelectedEntities(includeClusters);
     _isSelectionInvalid = true;
 }
 
+void _SimulationController::applyBulkTransform(BulkTransform const& transform)
+{
+    _worker.applyBulkTransform(transform);
+}
+
+void _SimulationController::resizeWorld(IntVector2D const& newSize, WorldResizeMode::Type mode)
+{
+    _worker.resizeWorld(newSize, mode);
+    _settings.generalSettings.worldSizeX = newSize.x;
+    _settings.generalSettings.worldSizeY = newSize.y;
+    _isSelectionInvalid = true;
+}
+
 void _SimulationController::calcSingleTimestep()
 {
     _worker.calcSingleTimestep();
@@ -101,10 +167,13 @@ bool _SimulationController::isSimulationRunning() const
 
 void _SimulationController::closeSimulation()
 {
+    _frameStreamServer.reset();
     _worker.beginShutdown();
     _thread->join();
     delete _thread;
     _worker.endShutdown();
+    _observerStreamSettings = boost::none;
+    _frameExportSettings = boost::none;
     _isSelectionInvalid = true;
 }
 
@@ -113,6 +182,16 @@ uint64_t _SimulationController::getCurrentTimestep() const
     return _worker.getCurrentTimestep();
 }
 
+uint64_t _SimulationController::getDataVersion() const
+{
+    return _worker.getDataVersion();
+}
+
+uint64_t _SimulationController::getDataLayoutVersion() const
+{
+    return _worker.getDataLayoutVersion();
+}
+
 void _SimulationController::setCurrentTimestep(uint64_t value)
 {
     _worker.setCurrentTimestep(value);
@@ -128,6 +207,12 @@ SimulationParameters _SimulationController::getOriginalSimulationParameters() co
     return _origSettings.simulationParameters;
 }
 
+void _SimulationController::setSimulationParameters(SimulationParameters const& parameters)
+{
+    _settings.simulationParameters = parameters;
+    _worker.setSimulationParameters(parameters);
+}
+
 void _SimulationController::setSimulationParameters_async(
     SimulationParameters const& parameters)
 {
@@ -150,6 +235,12 @@ void _SimulationController::setOriginalSimulationParametersSpot(SimulationParame
     _origSettings.simulationParametersSpots.spots[index] = value;
 }
 
+void _SimulationController::setSimulationParametersSpots(SimulationParametersSpots const& value)
+{
+    _settings.simulationParametersSpots = value;
+    _worker.setSimulationParametersSpots(value);
+}
+
 void _SimulationController::setSimulationParametersSpots_async(SimulationParametersSpots const& value)
 {
     _settings.simulationParametersSpots = value;
@@ -212,11 +303,16 @@ void _SimulationController::swapSelection(RealVector2D const& pos, float radius)
     _worker.swapSelection(pos, radius);
 }
 
-SelectionShallowData _SimulationController::getSelectionShallowData()
+SelectionShallowData _SimulationController::getSelectionShallowData() const
 {
     return _worker.getSelectionShallowData();
 }
 
+uint64_t _SimulationController::getSelectionVersion() const
+{
+    return _worker.getSelectionVersion();
+}
+
 void _SimulationController::shallowUpdateSelection(ShallowUpdateSelectionData const& updateData)
 {
     _worker.shallowUpdateSelection(updateData);
@@ -242,6 +338,81 @@ bool _SimulationController::removeSelectionIfInvalid()
     return result;
 }
 
+void _SimulationController::enableObserverStream(ObserverStreamSettings const& settings)
+{
+    _worker.enableObserverStream(settings);
+    _observerStreamSettings = settings;
+}
+
+void _SimulationController::disableObserverStream()
+{
+    _worker.disableObserverStream();
+    _observerStreamSettings = boost::none;
+}
+
+boost::optional<ObserverStreamSettings> _SimulationController::getObserverStreamSettings() const
+{
+    return _observerStreamSettings;
+}
+
+void _SimulationController::enableFrameExport(FrameExportSettings const& settings)
+{
+    _worker.enableFrameExport(settings);
+    _frameExportSettings = settings;
+}
+
+void _SimulationController::disableFrameExport()
+{
+    _worker.disableFrameExport();
+    _frameExportSettings = boost::none;
+}
+
+boost::optional<FrameExportSettings> _SimulationController::getFrameExportSettings() const
+{
+    if (!_worker.isFrameExportEnabled()) {
+        return boost::none;
+    }
+    return _frameExportSettings;
+}
+
+void _SimulationController::enableFrameStream(FrameStreamSettings const& settings)
+{
+    _frameStreamServer.reset();
+    _frameStreamServer = boost::make_shared<_FrameStreamServer>(settings, _worker);
+}
+
+void _SimulationController::disableFrameStream()
+{
+    _frameStreamServer.reset();
+}
+
+boost::optional<FrameStreamSettings> _SimulationController::getFrameStreamSettings() const
+{
+    if (!_frameStreamServer) {
+        return boost::none;
+    }
+    return _frameStreamServer->getSettings();
+}
+
+void _SimulationController::enableMetricsServer(MetricsServerSettings const& settings)
+{
+    _metricsServer.reset();
+    _metricsServer = boost::make_shared<_MetricsServer>(settings, _worker);
+}
+
+void _SimulationController::disableMetricsServer()
+{
+    _metricsServer.reset();
+}
+
+boost::optional<MetricsServerSettings> _SimulationController::getMetricsServerSettings() const
+{
+    if (!_metricsServer) {
+        return boost::none;
+    }
+    return _metricsServer->getSettings();
+}
+
 GeneralSettings _SimulationController::getGeneralSettings() const
 {
     return _settings.generalSettings;
@@ -267,6 +438,11 @@ OverallStatistics _SimulationController::getStatistics() const
     return _worker.getMonitorData();
 }
 
+EngineMetrics _SimulationController::getEngineMetrics() const
+{
+    return _worker.getEngineMetrics();
+}
+
 boost::optional<int> _SimulationController::getTpsRestriction() const
 {
     auto result = _worker.getTpsRestriction();
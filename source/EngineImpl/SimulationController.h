@@ -3,11 +3,18 @@
 #include <thread>
 
 #include "EngineInterface/Definitions.h"
+#include "EngineInterface/BulkTransform.h"
 #include "EngineInterface/SymbolMap.h"
+#include "EngineInterface/WorldResizeMode.h"
 #include "EngineInterface/Settings.h"
 #include "EngineInterface/SelectionShallowData.h"
 #include "EngineInterface/ShallowUpdateSelectionData.h"
 #include "EngineInterface/OverlayDescriptions.h"
+#include "EngineInterface/ObserverStreamSettings.h"
+#include "EngineInterface/FrameExportSettings.h"
+#include "EngineInterface/FrameStreamSettings.h"
+#include "EngineInterface/MetricsServerSettings.h"
+#include "EngineInterface/EngineMetrics.h"
 #include "EngineWorker.h"
 
 #include "Definitions.h"
@@ -19,15 +26,18 @@ public:
     ENGINEIMPL_EXPORT void initCuda();
 
     ENGINEIMPL_EXPORT void newSimulation(uint64_t timestep, Settings const& settings, SymbolMap const& symbolMap);
+    //closes the current simulation and creates a new one, enabled observer stream, frame export and frame stream are
+    //continued for the new simulation
+    ENGINEIMPL_EXPORT void replaceSimulation(uint64_t timestep, Settings const& settings, SymbolMap const& symbolMap);
     ENGINEIMPL_EXPORT void clear();
 
     ENGINEIMPL_EXPORT void registerImageResource(GLuint image);
 
     /**
      * Draws section of simulation to registered texture.
-     * If the GPU is busy for specific time, the texture will not be updated.
+     * If the GPU is busy for specific time, the texture will not be updated and false is returned.
      */
-    ENGINEIMPL_EXPORT void tryDrawVectorGraphics(
+    ENGINEIMPL_EXPORT bool tryDrawVectorGraphics(
         RealVector2D const& rectUpperLeft,
         RealVector2D const& rectLowerRight,
         IntVector2D const& imageSize,
@@ -37,14 +47,43 @@ public:
         RealVector2D const& rectLowerRight,
         IntVector2D const& imageSize,
         double zoom);
+    //draws into host memory instead, the pixels of image are in aabbggrr format
+    ENGINEIMPL_EXPORT bool tryDrawVectorGraphicsToHost(
+        RealVector2D const& rectUpperLeft,
+        RealVector2D const& rectLowerRight,
+        IntVector2D const& imageSize,
+        double zoom,
+        std::vector<uint32_t>& image);
 
     ENGINEIMPL_EXPORT DataDescription
     getSimulationData(IntVector2D const& rectUpperLeft, IntVector2D const& rectLowerRight);
     ENGINEIMPL_EXPORT DataDescription getSelectedSimulationData(bool includeClusters);
 
+    /**
+     * Copies the simulation data of a rectangle into buffers taken from the given cache without converting them
+     * into descriptions. The buffers stay valid until they are released to the cache or the cache is destroyed.
+     */
+    ENGINEIMPL_EXPORT DataAccessTO getSimulationDataTO(
+        IntVector2D const& rectUpperLeft,
+        IntVector2D const& rectLowerRight,
+        AccessDataTOCache const& cache);
+
+    /**
+     * Returns a fingerprint of the entities in each tileSize x tileSize tile (see DescriptionHelper::getTileIndex).
+     * A fingerprint changes if an entity moves beyond positionTolerance or any other of its serialized properties
+     * changes, e.g. velocity, energy, bonds, tokens, metadata or cell function data.
+     */
+    ENGINEIMPL_EXPORT std::vector<uint64_t> getTileHashes(int tileSize, float positionTolerance);
+
     ENGINEIMPL_EXPORT void addAndSelectSimulationData(DataDescription const& dataToAdd);
     ENGINEIMPL_EXPORT void setSimulationData(DataDescription const& dataToUpdate);
+    //replaces the whole simulation data, the token memory size of dataTO must match the simulation parameters
+    ENGINEIMPL_EXPORT void setSimulationDataTO(DataAccessTO const& dataTO);
     ENGINEIMPL_EXPORT void removeSelectedEntities(bool includeClusters);
+    //edits the entities in place, e.g. colorizes clusters, without a download of the simulation data
+    ENGINEIMPL_EXPORT void applyBulkTransform(BulkTransform const& transform);
+    //changes the world size without recreating the simulation
+    ENGINEIMPL_EXPORT void resizeWorld(IntVector2D const& newSize, WorldResizeMode::Type mode);
 
     ENGINEIMPL_EXPORT void calcSingleTimestep();
     ENGINEIMPL_EXPORT void runSimulation();
@@ -57,13 +96,27 @@ public:
     ENGINEIMPL_EXPORT uint64_t getCurrentTimestep() const;
     ENGINEIMPL_EXPORT void setCurrentTimestep(uint64_t value);
 
+    /**
+     * Returns a counter which is increased whenever the simulation data or the parameters affecting the rendering may
+     * have changed. Views can compare it with the value of their last drawing to skip redundant redraws.
+     */
+    ENGINEIMPL_EXPORT uint64_t getDataVersion() const;
+
+    /**
+     * Returns a counter which is increased whenever previously read simulation data can no longer be set since the
+     * simulation has been replaced, the world has been resized or the token memory size has changed.
+     */
+    ENGINEIMPL_EXPORT uint64_t getDataLayoutVersion() const;
+
     ENGINEIMPL_EXPORT SimulationParameters getSimulationParameters() const;
     ENGINEIMPL_EXPORT SimulationParameters getOriginalSimulationParameters() const;
+    ENGINEIMPL_EXPORT void setSimulationParameters(SimulationParameters const& parameters);
     ENGINEIMPL_EXPORT void setSimulationParameters_async(SimulationParameters const& parameters);
 
     ENGINEIMPL_EXPORT SimulationParametersSpots getSimulationParametersSpots() const;
     ENGINEIMPL_EXPORT SimulationParametersSpots getOriginalSimulationParametersSpots() const;
     ENGINEIMPL_EXPORT void setOriginalSimulationParametersSpot(SimulationParametersSpot const& value, int index);
+    ENGINEIMPL_EXPORT void setSimulationParametersSpots(SimulationParametersSpots const& value);
     ENGINEIMPL_EXPORT void setSimulationParametersSpots_async(SimulationParametersSpots const& value);
 
     ENGINEIMPL_EXPORT GpuSettings getGpuSettings() const;
@@ -80,17 +133,54 @@ public:
 
     ENGINEIMPL_EXPORT void switchSelection(RealVector2D const& pos, float radius);
     ENGINEIMPL_EXPORT void swapSelection(RealVector2D const& pos, float radius);
-    ENGINEIMPL_EXPORT SelectionShallowData getSelectionShallowData();
+    //returns the last data published by the engine without waiting for the GPU
+    ENGINEIMPL_EXPORT SelectionShallowData getSelectionShallowData() const;
+    //is increased whenever the published selection data has changed
+    ENGINEIMPL_EXPORT uint64_t getSelectionVersion() const;
     ENGINEIMPL_EXPORT void shallowUpdateSelection(ShallowUpdateSelectionData const& updateData);
     ENGINEIMPL_EXPORT void setSelection(RealVector2D const& startPos, RealVector2D const& endPos);
     ENGINEIMPL_EXPORT void removeSelection();
     ENGINEIMPL_EXPORT bool removeSelectionIfInvalid();
 
+    /**
+     * Publishes every samplingRate time steps a frame of the world into a shared memory segment which can be read
+     * by external processes. See ObserverStreamLayout.h for the memory layout.
+     */
+    ENGINEIMPL_EXPORT void enableObserverStream(ObserverStreamSettings const& settings);
+    ENGINEIMPL_EXPORT void disableObserverStream();
+    ENGINEIMPL_EXPORT boost::optional<ObserverStreamSettings> getObserverStreamSettings() const;
+
+    /**
+     * Writes every samplingRate time steps a rendered image of the world into a directory. The images are rasterized
+     * on the CPU and therefore also available in headless runs.
+     */
+    ENGINEIMPL_EXPORT void enableFrameExport(FrameExportSettings const& settings);
+    ENGINEIMPL_EXPORT void disableFrameExport();
+    ENGINEIMPL_EXPORT boost::optional<FrameExportSettings> getFrameExportSettings() const;
+
+    /**
+     * Serves rendered images of requested viewports to remote viewers over a socket. See FrameStreamProtocol.h for
+     * the wire format.
+     */
+    ENGINEIMPL_EXPORT void enableFrameStream(FrameStreamSettings const& settings);
+    ENGINEIMPL_EXPORT void disableFrameStream();
+    ENGINEIMPL_EXPORT boost::optional<FrameStreamSettings> getFrameStreamSettings() const;
+
+    /**
+     * Serves the engine metrics in the Prometheus text format over HTTP. The server is independent of the current
+     * simulation and keeps running when simulations are closed or created.
+     */
+    ENGINEIMPL_EXPORT void enableMetricsServer(MetricsServerSettings const& settings);
+    ENGINEIMPL_EXPORT void disableMetricsServer();
+    ENGINEIMPL_EXPORT boost::optional<MetricsServerSettings> getMetricsServerSettings() const;
+
     ENGINEIMPL_EXPORT GeneralSettings getGeneralSettings() const;
     ENGINEIMPL_EXPORT IntVector2D getWorldSize() const;
     ENGINEIMPL_EXPORT Settings getSettings() const;
     ENGINEIMPL_EXPORT SymbolMap getSymbolMap() const;
     ENGINEIMPL_EXPORT OverallStatistics getStatistics() const;
+    //the values which are read from the GPU are only updated while the metrics server is enabled
+    ENGINEIMPL_EXPORT EngineMetrics getEngineMetrics() const;
 
     ENGINEIMPL_EXPORT boost::optional<int> getTpsRestriction() const;
     ENGINEIMPL_EXPORT void setTpsRestriction(boost::optional<int> const& value);
@@ -105,7 +195,13 @@ private:
     GpuSettings _gpuSettings; 
     GpuSettings _origGpuSettings;
     SymbolMap _symbolMap;
+    boost::optional<ObserverStreamSettings> _observerStreamSettings;
+    boost::optional<FrameExportSettings> _frameExportSettings;
 
     EngineWorker _worker;
     std::thread* _thread = nullptr;
+
+    //servers refer to the worker and must be destroyed first
+    FrameStreamServer _frameStreamServer;
+    MetricsServer _metricsServer;
 };
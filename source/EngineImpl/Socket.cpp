@@ -0,0 +1,351 @@
+#include "Socket.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace
+{
+    std::chrono::milliseconds const CancellationCheckInterval(100);
+
+#if defined(_WIN32)
+    using NativeHandle = SOCKET;
+
+    void initSockets()
+    {
+        static bool initialized = [] {
+            WSADATA data;
+            return 0 == WSAStartup(MAKEWORD(2, 2), &data);
+        }();
+        if (!initialized) {
+            throw std::runtime_error("Could not initialize sockets.");
+        }
+    }
+
+    NativeHandle toNative(intptr_t handle)
+    {
+        return static_cast<SOCKET>(handle);
+    }
+
+    bool isWouldBlock()
+    {
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+    }
+
+    void closeNative(intptr_t handle)
+    {
+        closesocket(toNative(handle));
+    }
+
+    void setNonBlocking(intptr_t handle)
+    {
+        u_long mode = 1;
+        ioctlsocket(toNative(handle), FIONBIO, &mode);
+    }
+
+    int pollNative(intptr_t handle, short events, int timeoutMs)
+    {
+        WSAPOLLFD pollFd{toNative(handle), events, 0};
+        return WSAPoll(&pollFd, 1, timeoutMs);
+    }
+
+    int const SendFlags = 0;
+#else
+    using NativeHandle = int;
+
+    void initSockets() {}
+
+    NativeHandle toNative(intptr_t handle)
+    {
+        return static_cast<int>(handle);
+    }
+
+    bool isWouldBlock()
+    {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+
+    void closeNative(intptr_t handle)
+    {
+        ::close(toNative(handle));
+    }
+
+    void setNonBlocking(intptr_t handle)
+    {
+        fcntl(toNative(handle), F_SETFL, fcntl(toNative(handle), F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    int pollNative(intptr_t handle, short events, int timeoutMs)
+    {
+        pollfd pollFd{toNative(handle), events, 0};
+        return poll(&pollFd, 1, timeoutMs);
+    }
+
+#if defined(MSG_NOSIGNAL)
+    int const SendFlags = MSG_NOSIGNAL;
+#else
+    int const SendFlags = 0;
+#endif
+#endif
+
+    sockaddr_in toTcpAddress(std::string const& host, int port)
+    {
+        sockaddr_in result;
+        std::memset(&result, 0, sizeof(result));
+        result.sin_family = AF_INET;
+        result.sin_port = htons(static_cast<uint16_t>(port));
+        if (inet_pton(AF_INET, host.c_str(), &result.sin_addr) != 1) {
+            throw std::runtime_error("Invalid address " + host + ".");
+        }
+        return result;
+    }
+
+#if !defined(_WIN32)
+    sockaddr_un toUnixAddress(std::string const& path)
+    {
+        sockaddr_un result;
+        std::memset(&result, 0, sizeof(result));
+        result.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(result.sun_path)) {
+            throw std::runtime_error("Invalid socket path " + path + ".");
+        }
+        std::strncpy(result.sun_path, path.c_str(), sizeof(result.sun_path) - 1);
+        return result;
+    }
+#endif
+}
+
+Socket Socket::listenTcp(std::string const& host, int port)
+{
+    initSockets();
+    auto address = toTcpAddress(host, port);
+
+    auto handle = socket(AF_INET, SOCK_STREAM, 0);
+    Socket result(static_cast<intptr_t>(handle));
+    if (!result.isValid()) {
+        throw std::runtime_error("Could not create socket.");
+    }
+    int reuseAddress = 1;
+    setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<char const*>(&reuseAddress), sizeof(reuseAddress));
+    if (bind(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(handle, 8) != 0) {
+        throw std::runtime_error("Could not listen on " + host + ":" + std::to_string(port) + ".");
+    }
+    setNonBlocking(result._handle);
+    return result;
+}
+
+Socket Socket::listenUnix(std::string const& path)
+{
+#if defined(_WIN32)
+    throw std::runtime_error("Unix domain sockets are not supported on this platform.");
+#else
+    auto address = toUnixAddress(path);
+
+    Socket result(static_cast<intptr_t>(socket(AF_UNIX, SOCK_STREAM, 0)));
+    if (!result.isValid()) {
+        throw std::runtime_error("Could not create socket.");
+    }
+    unlink(path.c_str());
+    if (bind(toNative(result._handle), reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(toNative(result._handle), 8) != 0) {
+        throw std::runtime_error("Could not listen on " + path + ".");
+    }
+    result._unixSocketPath = path;
+    setNonBlocking(result._handle);
+    return result;
+#endif
+}
+
+Socket Socket::connectTcp(std::string const& host, int port)
+{
+    initSockets();
+    auto address = toTcpAddress(host, port);
+
+    auto handle = socket(AF_INET, SOCK_STREAM, 0);
+    Socket result(static_cast<intptr_t>(handle));
+    if (!result.isValid()) {
+        throw std::runtime_error("Could not create socket.");
+    }
+    if (connect(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        throw std::runtime_error("Could not connect to " + host + ":" + std::to_string(port) + ".");
+    }
+    int noDelay = 1;
+    setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char const*>(&noDelay), sizeof(noDelay));
+    setNonBlocking(result._handle);
+    return result;
+}
+
+Socket Socket::connectUnix(std::string const& path)
+{
+#if defined(_WIN32)
+    throw std::runtime_error("Unix domain sockets are not supported on this platform.");
+#else
+    auto address = toUnixAddress(path);
+
+    Socket result(static_cast<intptr_t>(socket(AF_UNIX, SOCK_STREAM, 0)));
+    if (!result.isValid()) {
+        throw std::runtime_error("Could not create socket.");
+    }
+    if (connect(toNative(result._handle), reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        throw std::runtime_error("Could not connect to " + path + ".");
+    }
+    setNonBlocking(result._handle);
+    return result;
+#endif
+}
+
+Socket::Socket(intptr_t handle)
+    : _handle(handle)
+{}
+
+Socket::Socket(Socket&& other) noexcept
+    : _handle(other._handle)
+    , _unixSocketPath(std::move(other._unixSocketPath))
+{
+    other._handle = -1;
+    other._unixSocketPath.clear();
+}
+
+Socket& Socket::operator=(Socket&& other) noexcept
+{
+    if (this != &other) {
+        close();
+        _handle = other._handle;
+        _unixSocketPath = std::move(other._unixSocketPath);
+        other._handle = -1;
+        other._unixSocketPath.clear();
+    }
+    return *this;
+}
+
+Socket::~Socket()
+{
+    close();
+}
+
+bool Socket::isValid() const
+{
+    return _handle >= 0;
+}
+
+void Socket::close()
+{
+    if (!isValid()) {
+        return;
+    }
+    closeNative(_handle);
+    _handle = -1;
+#if !defined(_WIN32)
+    if (!_unixSocketPath.empty()) {
+        unlink(_unixSocketPath.c_str());
+        _unixSocketPath.clear();
+    }
+#endif
+}
+
+Socket Socket::accept(std::chrono::milliseconds const& timeout)
+{
+    if (!wait(WaitFor::Read, timeout)) {
+        return Socket();
+    }
+    Socket result(static_cast<intptr_t>(::accept(toNative(_handle), nullptr, nullptr)));
+    if (result.isValid()) {
+        setNonBlocking(result._handle);
+        if (_unixSocketPath.empty()) {
+            int noDelay = 1;
+            setsockopt(
+                toNative(result._handle),
+                IPPROTO_TCP,
+                TCP_NODELAY,
+                reinterpret_cast<char const*>(&noDelay),
+                sizeof(noDelay));
+        }
+    }
+    return result;
+}
+
+bool Socket::waitForData(std::chrono::milliseconds const& timeout)
+{
+    return wait(WaitFor::Read, timeout);
+}
+
+bool Socket::sendAll(void const* data, size_t size, std::atomic<bool> const& isCancelled)
+{
+    auto bytes = static_cast<char const*>(data);
+    while (size > 0) {
+        if (isCancelled.load() || !isValid()) {
+            return false;
+        }
+        auto numSent = send(toNative(_handle), bytes, static_cast<int>(size), SendFlags);
+        if (numSent < 0) {
+            if (!isWouldBlock()) {
+                return false;
+            }
+            wait(WaitFor::Write, CancellationCheckInterval);
+            continue;
+        }
+        bytes += numSent;
+        size -= numSent;
+    }
+    return true;
+}
+
+bool Socket::receiveAll(void* data, size_t size, std::atomic<bool> const& isCancelled)
+{
+    auto bytes = static_cast<char*>(data);
+    while (size > 0) {
+        if (isCancelled.load()) {
+            return false;
+        }
+        auto numReceived = receiveSome(bytes, size);
+        if (numReceived < 0) {
+            return false;
+        }
+        if (0 == numReceived) {
+            wait(WaitFor::Read, CancellationCheckInterval);
+            continue;
+        }
+        bytes += numReceived;
+        size -= numReceived;
+    }
+    return true;
+}
+
+int Socket::receiveSome(void* data, size_t size)
+{
+    if (!isValid()) {
+        return -1;
+    }
+    auto numReceived = recv(toNative(_handle), static_cast<char*>(data), static_cast<int>(size), 0);
+    if (numReceived < 0) {
+        return isWouldBlock() ? 0 : -1;
+    }
+    if (0 == numReceived) {
+        return -1;  //closed by peer
+    }
+    return static_cast<int>(numReceived);
+}
+
+bool Socket::wait(WaitFor waitFor, std::chrono::milliseconds const& timeout)
+{
+    if (!isValid()) {
+        return false;
+    }
+    short events = WaitFor::Read == waitFor ? POLLIN : POLLOUT;
+    return pollNative(_handle, events, static_cast<int>(timeout.count())) > 0;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "DllExport.h"
+
+/**
+ * Non-blocking stream socket for the servers of the engine and their clients (TCP on all platforms, Unix domain
+ * sockets on POSIX). All operations which may wait take a timeout or a cancellation flag such that serving threads
+ * can be stopped.
+ */
+class ENGINEIMPL_EXPORT Socket
+{
+public:
+    static Socket listenTcp(std::string const& host, int port);  //throws std::runtime_error
+    static Socket listenUnix(std::string const& path);  //throws std::runtime_error
+
+    //used by clients such as tests, the connection is established blocking
+    static Socket connectTcp(std::string const& host, int port);  //throws std::runtime_error
+    static Socket connectUnix(std::string const& path);  //throws std::runtime_error
+
+    Socket() = default;
+    Socket(Socket&& other) noexcept;
+    Socket& operator=(Socket&& other) noexcept;
+    Socket(Socket const&) = delete;
+    Socket& operator=(Socket const&) = delete;
+    ~Socket();
+
+    bool isValid() const;
+    void close();
+
+    //returns an invalid socket if no connection has been requested within the timeout
+    Socket accept(std::chrono::milliseconds const& timeout);
+
+    bool waitForData(std::chrono::milliseconds const& timeout);
+
+    //return false if the connection has been closed or the operation has been cancelled
+    bool sendAll(void const* data, size_t size, std::atomic<bool> const& isCancelled);
+    bool receiveAll(void* data, size_t size, std::atomic<bool> const& isCancelled);
+
+    //returns the number of received bytes, 0 if no data is available and -1 if the connection has been closed
+    int receiveSome(void* data, size_t size);
+
+private:
+    explicit Socket(intptr_t handle);
+
+    enum class WaitFor
+    {
+        Read,
+        Write
+    };
+    bool wait(WaitFor waitFor, std::chrono::milliseconds const& timeout);
+
+    intptr_t _handle = -1;
+    std::string _unixSocketPath;   //removed on close
+};
@@ -0,0 +1,429 @@
+#include "StepHistory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "AccessDataTOCache.h"
+#include "SimulationController.h"
+
+namespace
+{
+    int const KeyFrameInterval = 16;
+
+    uint32_t getWord(void const* block, size_t size, size_t index)
+    {
+        uint32_t result = 0;
+        auto offset = index * sizeof(uint32_t);
+        if (block && offset < size) {
+            std::memcpy(&result, static_cast<char const*>(block) + offset, std::min(sizeof(uint32_t), size - offset));
+        }
+        return result;
+    }
+
+    void setWord(void* block, size_t size, size_t index, uint32_t value)
+    {
+        auto offset = index * sizeof(uint32_t);
+        std::memcpy(static_cast<char*>(block) + offset, &value, std::min(sizeof(uint32_t), size - offset));
+    }
+
+    uint64_t toZigZag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t fromZigZag(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    boost::optional<uint64_t> getId(CellAccessTO const& cell)
+    {
+        return cell.id;
+    }
+
+    boost::optional<uint64_t> getId(ParticleAccessTO const& particle)
+    {
+        return particle.id;
+    }
+
+    boost::optional<uint64_t> getId(TokenAccessTO const&)
+    {
+        return boost::none;
+    }
+
+    class Writer
+    {
+    public:
+        Writer(std::vector<uint8_t>& data)
+            : _data(data)
+        {}
+
+        void writeVarint(uint64_t value)
+        {
+            while (value >= 0x80) {
+                _data.emplace_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            _data.emplace_back(static_cast<uint8_t>(value));
+        }
+
+        //writes the words of block XOR reference as alternating runs of zero words and varint encoded literals
+        void writeBlock(void const* block, size_t size, void const* reference, size_t referenceSize)
+        {
+            auto getXorWord = [&](size_t index) {
+                return getWord(block, size, index) ^ getWord(reference, referenceSize, index);
+            };
+            auto numWords = (size + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+            size_t index = 0;
+            while (index < numWords) {
+                auto zeroStart = index;
+                while (index < numWords && 0 == getXorWord(index)) {
+                    ++index;
+                }
+                auto literalStart = index;
+                while (index < numWords && 0 != getXorWord(index)) {
+                    ++index;
+                }
+                writeVarint(literalStart - zeroStart);
+                writeVarint(index - literalStart);
+                for (auto i = literalStart; i < index; ++i) {
+                    writeVarint(getXorWord(i));
+                }
+            }
+        }
+
+        //records are matched against the previous records by id if available, otherwise by index
+        template <typename T>
+        void writeRecords(std::vector<T> const& records, std::vector<T> const* previousRecords)
+        {
+            writeVarint(records.size());
+            std::unordered_map<uint64_t, int> previousIndexById;
+            for (int i = 0; i < toInt(records.size()); ++i) {
+                auto previousIndex =
+                    previousRecords ? findPreviousIndex(records, *previousRecords, i, previousIndexById) : -1;
+                if (previousIndex < 0) {
+                    writeVarint(0);
+                    writeBlock(&records[i], sizeof(T), nullptr, 0);
+                } else {
+                    writeVarint(toZigZag(previousIndex - i) + 1);
+                    writeBlock(&records[i], sizeof(T), &(*previousRecords)[previousIndex], sizeof(T));
+                }
+            }
+        }
+
+        void writeBytes(std::vector<char> const& bytes, std::vector<char> const* previousBytes)
+        {
+            writeVarint(bytes.size());
+            writeBlock(
+                bytes.data(),
+                bytes.size(),
+                previousBytes ? previousBytes->data() : nullptr,
+                previousBytes ? previousBytes->size() : 0);
+        }
+
+    private:
+        template <typename T>
+        int findPreviousIndex(
+            std::vector<T> const& records,
+            std::vector<T> const& previousRecords,
+            int index,
+            std::unordered_map<uint64_t, int>& previousIndexById)
+        {
+            auto id = getId(records[index]);
+            if (index < toInt(previousRecords.size()) && getId(previousRecords[index]) == id) {
+                return index;
+            }
+            if (!id) {
+                return -1;
+            }
+            if (previousIndexById.empty()) {
+                for (int i = 0; i < toInt(previousRecords.size()); ++i) {
+                    previousIndexById.emplace(*getId(previousRecords[i]), i);
+                }
+            }
+            auto findResult = previousIndexById.find(*id);
+            return findResult != previousIndexById.end() ? findResult->second : -1;
+        }
+
+        std::vector<uint8_t>& _data;
+    };
+
+    class Reader
+    {
+    public:
+        Reader(std::vector<uint8_t> const& data)
+            : _data(data)
+        {}
+
+        uint64_t readVarint()
+        {
+            uint64_t result = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (_position >= _data.size()) {
+                    break;
+                }
+                auto byte = _data[_position++];
+                result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if (0 == (byte & 0x80)) {
+                    return result;
+                }
+            }
+            throw std::runtime_error("Corrupt step history entry.");
+        }
+
+        void readBlock(void* block, size_t size, void const* reference, size_t referenceSize)
+        {
+            auto numWords = (size + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+            size_t index = 0;
+            while (index < numWords) {
+                auto numZeros = readVarint();
+                auto numLiterals = readVarint();
+                if (numZeros + numLiterals > numWords - index) {
+                    throw std::runtime_error("Corrupt step history entry.");
+                }
+                for (uint64_t i = 0; i < numZeros; ++i, ++index) {
+                    setWord(block, size, index, getWord(reference, referenceSize, index));
+                }
+                for (uint64_t i = 0; i < numLiterals; ++i, ++index) {
+                    auto value = static_cast<uint32_t>(readVarint());
+                    setWord(block, size, index, getWord(reference, referenceSize, index) ^ value);
+                }
+            }
+        }
+
+        template <typename T>
+        void readRecords(std::vector<T>& records, std::vector<T> const* previousRecords)
+        {
+            records.resize(readVarint());
+            for (int i = 0; i < toInt(records.size()); ++i) {
+                auto code = readVarint();
+                if (0 == code) {
+                    readBlock(&records[i], sizeof(T), nullptr, 0);
+                    continue;
+                }
+                auto previousIndex = i + fromZigZag(code - 1);
+                if (!previousRecords || previousIndex < 0 || previousIndex >= toInt(previousRecords->size())) {
+                    throw std::runtime_error("Corrupt step history entry.");
+                }
+                readBlock(&records[i], sizeof(T), &(*previousRecords)[previousIndex], sizeof(T));
+            }
+        }
+
+        void readBytes(std::vector<char>& bytes, std::vector<char> const* previousBytes)
+        {
+            bytes.resize(readVarint());
+            readBlock(
+                bytes.data(),
+                bytes.size(),
+                previousBytes ? previousBytes->data() : nullptr,
+                previousBytes ? previousBytes->size() : 0);
+        }
+
+    private:
+        std::vector<uint8_t> const& _data;
+        size_t _position = 0;
+    };
+}
+
+uint64_t _StepHistory::State::getMemorySize() const
+{
+    return sizeof(CellAccessTO) * cells.size() + sizeof(ParticleAccessTO) * particles.size()
+        + sizeof(TokenAccessTO) * tokens.size() + tokenMemory.size() + stringBytes.size();
+}
+
+_StepHistory::_StepHistory(SimulationController const& simController)
+    : _simController(simController)
+{}
+
+uint64_t _StepHistory::getMemoryBudget() const
+{
+    return _memoryBudget;
+}
+
+void _StepHistory::setMemoryBudget(uint64_t bytes)
+{
+    _memoryBudget = bytes;
+    while (getMemorySize() > _memoryBudget && _entries.size() > 1) {
+        removeOldestEntry();
+    }
+}
+
+uint64_t _StepHistory::getMemorySize() const
+{
+    return _entriesMemorySize + (_lastState ? _lastState->getMemorySize() : 0);
+}
+
+bool _StepHistory::isEmpty() const
+{
+    return _entries.empty() || isOutdated();
+}
+
+int _StepHistory::getNumEntries() const
+{
+    return isOutdated() ? 0 : toInt(_entries.size());
+}
+
+void _StepHistory::clear()
+{
+    _entries.clear();
+    _entriesMemorySize = 0;
+    _lastState = boost::none;
+}
+
+void _StepHistory::push()
+{
+    clearIfOutdated();
+    _dataLayoutVersion = _simController->getDataLayoutVersion();
+    auto state = captureState();
+
+    auto numEntriesSinceKeyFrame = 0;
+    for (auto it = _entries.rbegin(); it != _entries.rend() && !it->isKeyFrame; ++it) {
+        ++numEntriesSinceKeyFrame;
+    }
+    auto isKeyFrame = !_lastState || numEntriesSinceKeyFrame + 1 >= KeyFrameInterval;
+    auto entry = encode(state, isKeyFrame ? nullptr : &*_lastState);
+
+    _entriesMemorySize += entry.data.size();
+    _entries.emplace_back(std::move(entry));
+    _lastState = std::move(state);
+
+    //the last state is always kept in order to allow at least one step back
+    while (getMemorySize() > _memoryBudget && _entries.size() > 1) {
+        removeOldestEntry();
+    }
+}
+
+void _StepHistory::restore()
+{
+    clearIfOutdated();
+    if (!_lastState) {
+        return;
+    }
+    auto& state = *_lastState;
+    auto numCells = toInt(state.cells.size());
+    auto numParticles = toInt(state.particles.size());
+    auto numTokens = toInt(state.tokens.size());
+    auto numStringBytes = toInt(state.stringBytes.size());
+
+    DataAccessTO dataTO;
+    dataTO.numCells = &numCells;
+    dataTO.cells = state.cells.data();
+    dataTO.numParticles = &numParticles;
+    dataTO.particles = state.particles.data();
+    dataTO.numTokens = &numTokens;
+    dataTO.tokens = state.tokens.data();
+    dataTO.tokenMemory = state.tokenMemory.data();
+    dataTO.tokenMemorySize = state.tokenMemorySize;
+    dataTO.numStringBytes = &numStringBytes;
+    dataTO.stringBytes = state.stringBytes.data();
+
+    _simController->setCurrentTimestep(state.timestep);
+    _simController->setSimulationDataTO(dataTO);
+
+    _entriesMemorySize -= _entries.back().data.size();
+    _entries.pop_back();
+    if (_entries.empty()) {
+        _lastState = boost::none;
+    } else {
+        _lastState = decodeLastState();
+    }
+}
+
+bool _StepHistory::isOutdated() const
+{
+    return !_entries.empty() && _dataLayoutVersion != _simController->getDataLayoutVersion();
+}
+
+void _StepHistory::clearIfOutdated()
+{
+    if (isOutdated()) {
+        clear();
+    }
+}
+
+auto _StepHistory::encode(State const& state, State const* previousState) -> Entry
+{
+    Entry result;
+    result.isKeyFrame = !previousState;
+
+    Writer writer(result.data);
+    writer.writeVarint(state.timestep);
+    writer.writeVarint(state.tokenMemorySize);
+    writer.writeRecords(state.cells, previousState ? &previousState->cells : nullptr);
+    writer.writeRecords(state.particles, previousState ? &previousState->particles : nullptr);
+    writer.writeRecords(state.tokens, previousState ? &previousState->tokens : nullptr);
+    writer.writeBytes(state.tokenMemory, previousState ? &previousState->tokenMemory : nullptr);
+    writer.writeBytes(state.stringBytes, previousState ? &previousState->stringBytes : nullptr);
+    result.data.shrink_to_fit();
+    return result;
+}
+
+auto _StepHistory::decode(Entry const& entry, State const* previousState) -> State
+{
+    if (entry.isKeyFrame) {
+        previousState = nullptr;
+    }
+    State result;
+    Reader reader(entry.data);
+    result.timestep = reader.readVarint();
+    result.tokenMemorySize = static_cast<int>(reader.readVarint());
+    reader.readRecords(result.cells, previousState ? &previousState->cells : nullptr);
+    reader.readRecords(result.particles, previousState ? &previousState->particles : nullptr);
+    reader.readRecords(result.tokens, previousState ? &previousState->tokens : nullptr);
+    reader.readBytes(result.tokenMemory, previousState ? &previousState->tokenMemory : nullptr);
+    reader.readBytes(result.stringBytes, previousState ? &previousState->stringBytes : nullptr);
+    return result;
+}
+
+auto _StepHistory::captureState() -> State
+{
+    if (!_cache) {
+        _cache = boost::make_shared<_AccessDataTOCache>(_simController->getGpuSettings());
+    }
+    auto dataTO = _simController->getSimulationDataTO({0, 0}, _simController->getWorldSize(), _cache);
+
+    State result;
+    result.timestep = _simController->getCurrentTimestep();
+    result.tokenMemorySize = dataTO.tokenMemorySize;
+    result.cells.assign(dataTO.cells, dataTO.cells + *dataTO.numCells);
+    result.particles.assign(dataTO.particles, dataTO.particles + *dataTO.numParticles);
+    result.tokens.assign(dataTO.tokens, dataTO.tokens + *dataTO.numTokens);
+    result.tokenMemory.assign(
+        dataTO.tokenMemory, dataTO.tokenMemory + static_cast<size_t>(*dataTO.numTokens) * dataTO.tokenMemorySize);
+    result.stringBytes.assign(dataTO.stringBytes, dataTO.stringBytes + *dataTO.numStringBytes);
+
+    _cache->releaseDataTO(dataTO);
+    return result;
+}
+
+auto _StepHistory::decodeLastState() const -> State
+{
+    auto keyFrameIndex = toInt(_entries.size()) - 1;
+    while (!_entries[keyFrameIndex].isKeyFrame) {
+        --keyFrameIndex;
+    }
+    auto result = decode(_entries[keyFrameIndex], nullptr);
+    for (int i = keyFrameIndex + 1; i < toInt(_entries.size()); ++i) {
+        result = decode(_entries[i], &result);
+    }
+    return result;
+}
+
+void _StepHistory::removeOldestEntry()
+{
+    auto oldestEntry = std::move(_entries.front());
+    _entries.pop_front();
+    _entriesMemorySize -= oldestEntry.data.size();
+
+    //the new oldest entry has to become a key frame since its predecessor is gone
+    auto& entry = _entries.front();
+    if (!entry.isKeyFrame) {
+        auto oldestState = decode(oldestEntry, nullptr);
+        auto state = decode(entry, &oldestState);
+        _entriesMemorySize -= entry.data.size();
+        entry = encode(state, nullptr);
+        _entriesMemorySize += entry.data.size();
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <deque>
+
+#include "Base/Definitions.h"
+#include "EngineGpuKernels/AccessTOs.cuh"
+
+#include "Definitions.h"
+#include "DllExport.h"
+
+/**
+ * Stores the simulation states before single time steps in order to step back. Only every KeyFrameInterval-th
+ * state is stored completely, the states in between are stored as compact deltas against their predecessors.
+ * The oldest states are discarded if the memory budget is exceeded. The stored states are discarded as well when
+ * they can no longer be set, i.e. when the data layout version of the simulation has changed.
+ */
+class _StepHistory
+{
+public:
+    ENGINEIMPL_EXPORT _StepHistory(SimulationController const& simController);
+
+    ENGINEIMPL_EXPORT uint64_t getMemoryBudget() const;
+    ENGINEIMPL_EXPORT void setMemoryBudget(uint64_t bytes);
+    ENGINEIMPL_EXPORT uint64_t getMemorySize() const;
+
+    ENGINEIMPL_EXPORT bool isEmpty() const;
+    ENGINEIMPL_EXPORT int getNumEntries() const;
+    ENGINEIMPL_EXPORT void clear();
+
+    //stores the current simulation state
+    ENGINEIMPL_EXPORT void push();
+
+    //sets the simulation to the last stored state and removes it from the history
+    ENGINEIMPL_EXPORT void restore();
+
+private:
+    struct State
+    {
+        uint64_t timestep = 0;
+        int tokenMemorySize = 0;
+        std::vector<CellAccessTO> cells;
+        std::vector<ParticleAccessTO> particles;
+        std::vector<TokenAccessTO> tokens;
+        std::vector<char> tokenMemory;
+        std::vector<char> stringBytes;
+
+        uint64_t getMemorySize() const;
+    };
+
+    struct Entry
+    {
+        bool isKeyFrame = false;
+        std::vector<uint8_t> data;
+    };
+
+    static Entry encode(State const& state, State const* previousState);
+    static State decode(Entry const& entry, State const* previousState);
+
+    bool isOutdated() const;
+    void clearIfOutdated();
+
+    State captureState();
+    State decodeLastState() const;
+    void removeOldestEntry();
+
+    SimulationController _simController;
+    AccessDataTOCache _cache;   //reused for all captures since its buffers hold entire simulation states
+    uint64_t _memoryBudget = 1024ull * 1024 * 1024;
+
+    std::deque<Entry> _entries;
+    uint64_t _entriesMemorySize = 0;
+    boost::optional<State> _lastState;  //decoded state of _entries.back()
+    uint64_t _dataLayoutVersion = 0;    //of the stored states
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BulkTransformOperation
+{
+    enum Type
+    {
+        SetColorByCluster,      //each cluster gets one of colorCodes
+        ScaleEnergy,            //energies of cells, particles and tokens are multiplied by energyFactor
+        ResetTokenMemory,       //token memory is zeroed except for the branch number
+        RandomizeStaticByte     //cell static byte at byteIndex is randomized if present
+    };
+}
+
+namespace BulkTransformScope
+{
+    enum Type
+    {
+        All,
+        Selection,
+        Region
+    };
+}
+
+/**
+ * Declarative edit which is applied to the entity arrays of the engine in place. Hence it keeps the ids of the
+ * entities and does not require to download and re-upload the simulation data.
+ */
+struct BulkTransform
+{
+    BulkTransformOperation::Type operation = BulkTransformOperation::SetColorByCluster;
+    BulkTransformScope::Type scope = BulkTransformScope::All;
+
+    //for BulkTransformScope::Region, a region exceeding the world is continued on the other side
+    float regionTopLeftX = 0;
+    float regionTopLeftY = 0;
+    float regionBottomRightX = 0;
+    float regionBottomRightY = 0;
+
+    //for BulkTransformOperation::SetColorByCluster
+    int numColorCodes = 0;
+    int colorCodes[7] = {0, 0, 0, 0, 0, 0, 0};
+    uint32_t seed = 0;  //colors depend only on the seed and the cluster
+
+    //for BulkTransformOperation::ScaleEnergy
+    float energyFactor = 1.0f;
+
+    //for BulkTransformOperation::RandomizeStaticByte
+    int byteIndex = 0;
+
+    bool operator==(BulkTransform const& other) const
+    {
+        for (int i = 0; i < numColorCodes; ++i) {
+            if (colorCodes[i] != other.colorCodes[i]) {
+                return false;
+            }
+        }
+        return operation == other.operation && scope == other.scope && regionTopLeftX == other.regionTopLeftX
+            && regionTopLeftY == other.regionTopLeftY && regionBottomRightX == other.regionBottomRightX
+            && regionBottomRightY == other.regionBottomRightY && numColorCodes == other.numColorCodes
+            && seed == other.seed && energyFactor == other.energyFactor && byteIndex == other.byteIndex;
+    }
+    bool operator!=(BulkTransform const& other) const { return !operator==(other); }
+};
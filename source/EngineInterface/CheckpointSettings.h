@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+
+struct CheckpointSettings
+{
+    std::string filename;           //base simulation file, the journal is stored next to it
+    int tileSize = 256;
+    float positionTolerance = 1.0f;   //movements within a cell of this size are not considered as change
+    int maxJournalEntries = 100;    //a new base file is written afterwards
+
+    bool operator==(CheckpointSettings const& other) const
+    {
+        return filename == other.filename && tileSize == other.tileSize
+            && positionTolerance == other.positionTolerance && maxJournalEntries == other.maxJournalEntries;
+    }
+    bool operator!=(CheckpointSettings const& other) const { return !operator==(other); }
+};
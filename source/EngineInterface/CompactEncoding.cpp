@@ -0,0 +1,515 @@
+#include "CompactEncoding.h"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "Base/EntropyCoder.h"
+
+namespace
+{
+    char const Signature[] = {'A', 'L', 'C', 'E'};
+    uint64_t const Version = 1;
+
+    enum class ChunkType
+    {
+        Clusters,
+        Particles,
+        End
+    };
+
+    //the values of different kinds are kept apart since they have different statistics
+    enum StreamType
+    {
+        Structure,
+        Positions,
+        Velocities,
+        Floats,
+        Bytes,
+        NumStreamTypes
+    };
+
+    uint64_t toZigZag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t fromZigZag(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    int64_t quantize(double value, float precision)
+    {
+        return std::llround(value / precision);
+    }
+
+    float dequantize(int64_t value, float precision)
+    {
+        return static_cast<float>(static_cast<double>(value) * precision);
+    }
+
+    class StreamWriter
+    {
+    public:
+        void writeVarint(uint64_t value)
+        {
+            while (value >= 0x80) {
+                _data.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            _data.push_back(static_cast<char>(value));
+        }
+
+        void writeSignedVarint(int64_t value) { writeVarint(toZigZag(value)); }
+
+        void writeByte(uint8_t value) { _data.push_back(static_cast<char>(value)); }
+
+        void writeFloat(float value)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            for (int i = 0; i < 4; ++i) {
+                writeByte(static_cast<uint8_t>(bits >> (i * 8)));
+            }
+        }
+
+        void writeString(std::string const& value)
+        {
+            writeVarint(value.size());
+            _data.append(value);
+        }
+
+        std::string const& getData() const { return _data; }
+
+    private:
+        std::string _data;
+    };
+
+    class StreamReader
+    {
+    public:
+        StreamReader() = default;
+        StreamReader(std::string data)
+            : _data(std::move(data))
+        {}
+
+        uint64_t readVarint()
+        {
+            uint64_t result = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                auto byte = readByte();
+                result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if (0 == (byte & 0x80)) {
+                    return result;
+                }
+            }
+            throw std::runtime_error("Corrupt compact encoded data.");
+        }
+
+        int64_t readSignedVarint() { return fromZigZag(readVarint()); }
+
+        uint8_t readByte()
+        {
+            if (_position >= _data.size()) {
+                throw std::runtime_error("Corrupt compact encoded data.");
+            }
+            return static_cast<uint8_t>(_data[_position++]);
+        }
+
+        float readFloat()
+        {
+            uint32_t bits = 0;
+            for (int i = 0; i < 4; ++i) {
+                bits |= static_cast<uint32_t>(readByte()) << (i * 8);
+            }
+            float result;
+            std::memcpy(&result, &bits, sizeof(result));
+            return result;
+        }
+
+        std::string readString()
+        {
+            auto size = readVarint();
+            if (size > _data.size() - _position) {
+                throw std::runtime_error("Corrupt compact encoded data.");
+            }
+            auto result = _data.substr(_position, size);
+            _position += size;
+            return result;
+        }
+
+    private:
+        std::string _data;
+        size_t _position = 0;
+    };
+
+    void writeVarint(std::ostream& stream, uint64_t value)
+    {
+        StreamWriter writer;
+        writer.writeVarint(value);
+        stream.write(writer.getData().data(), writer.getData().size());
+    }
+
+    uint64_t readVarint(std::istream& stream)
+    {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            char byte;
+            if (!stream.get(byte)) {
+                break;
+            }
+            result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (0 == (byte & 0x80)) {
+                return result;
+            }
+        }
+        throw std::runtime_error("Corrupt compact encoded data.");
+    }
+
+    void writeChunk(std::ostream& stream, ChunkType chunkType, StreamWriter const (&writers)[NumStreamTypes])
+    {
+        writeVarint(stream, static_cast<uint64_t>(chunkType));
+        for (auto const& writer : writers) {
+            auto encodedData = EntropyCoder::encode(writer.getData());
+            writeVarint(stream, encodedData.size());
+            stream.write(encodedData.data(), encodedData.size());
+        }
+    }
+
+    void readChunk(std::istream& stream, StreamReader (&readers)[NumStreamTypes])
+    {
+        for (auto& reader : readers) {
+            std::string encodedData(readVarint(stream), 0);
+            if (!stream.read(encodedData.data(), encodedData.size())) {
+                throw std::runtime_error("Corrupt compact encoded data.");
+            }
+            reader = StreamReader(EntropyCoder::decode(encodedData));
+        }
+    }
+
+    void encodeClusters(
+        std::vector<ClusterDescription>::const_iterator begin,
+        std::vector<ClusterDescription>::const_iterator end,
+        CompactEncodingSettings const& settings,
+        std::ostream& stream)
+    {
+        StreamWriter writers[NumStreamTypes];
+        auto& structure = writers[Structure];
+        auto& positions = writers[Positions];
+        auto& velocities = writers[Velocities];
+        auto& floats = writers[Floats];
+        auto& bytes = writers[Bytes];
+
+        structure.writeVarint(end - begin);
+        uint64_t prevClusterId = 0;
+        int64_t prevPosX = 0;
+        int64_t prevPosY = 0;
+        for (auto cluster = begin; cluster != end; ++cluster) {
+            structure.writeSignedVarint(static_cast<int64_t>(cluster->id - prevClusterId));
+            structure.writeVarint(cluster->cells.size());
+            prevClusterId = cluster->id;
+
+            std::unordered_map<uint64_t, int> cellIndexById;
+            for (int i = 0; i < toInt(cluster->cells.size()); ++i) {
+                cellIndexById.emplace(cluster->cells[i].id, i);
+            }
+
+            uint64_t prevCellId = cluster->id;
+            int64_t prevVelX = 0;
+            int64_t prevVelY = 0;
+            for (int i = 0; i < toInt(cluster->cells.size()); ++i) {
+                auto const& cell = cluster->cells[i];
+                structure.writeSignedVarint(static_cast<int64_t>(cell.id - prevCellId));
+                prevCellId = cell.id;
+
+                auto posX = quantize(cell.pos.x, settings.positionPrecision);
+                auto posY = quantize(cell.pos.y, settings.positionPrecision);
+                positions.writeSignedVarint(posX - prevPosX);
+                positions.writeSignedVarint(posY - prevPosY);
+                prevPosX = posX;
+                prevPosY = posY;
+
+                auto velX = quantize(cell.vel.x, settings.velocityPrecision);
+                auto velY = quantize(cell.vel.y, settings.velocityPrecision);
+                velocities.writeSignedVarint(velX - prevVelX);
+                velocities.writeSignedVarint(velY - prevVelY);
+                prevVelX = velX;
+                prevVelY = velY;
+
+                floats.writeFloat(static_cast<float>(cell.energy));
+
+                //connections refer to cells relative to the current cell, 0 marks cells outside of the cluster
+                structure.writeVarint(cell.maxConnections);
+                structure.writeVarint(cell.connections.size());
+                for (auto const& connection : cell.connections) {
+                    auto findResult = cellIndexById.find(connection.cellId);
+                    if (findResult != cellIndexById.end()) {
+                        structure.writeVarint(toZigZag(findResult->second - i) + 1);
+                    } else {
+                        structure.writeVarint(0);
+                        structure.writeVarint(connection.cellId);
+                    }
+                    floats.writeFloat(connection.distance);
+                    floats.writeFloat(connection.angleFromPrevious);
+                }
+
+                structure.writeByte(cell.tokenBlocked ? 1 : 0);
+                structure.writeSignedVarint(cell.tokenBranchNumber);
+                structure.writeSignedVarint(cell.tokenUsages);
+                structure.writeByte(cell.metadata.color);
+                structure.writeByte(static_cast<uint8_t>(cell.cellFeature.getType()));
+                bytes.writeString(cell.cellFeature.constData);
+                bytes.writeString(cell.cellFeature.volatileData);
+                bytes.writeString(cell.metadata.name);
+                bytes.writeString(cell.metadata.description);
+                bytes.writeString(cell.metadata.computerSourcecode);
+
+                structure.writeVarint(cell.tokens.size());
+                for (auto const& token : cell.tokens) {
+                    floats.writeFloat(static_cast<float>(token.energy));
+                    bytes.writeString(token.data);
+                }
+            }
+        }
+        writeChunk(stream, ChunkType::Clusters, writers);
+    }
+
+    void decodeClusters(std::istream& stream, CompactEncodingSettings const& settings, DataDescription& data)
+    {
+        StreamReader readers[NumStreamTypes];
+        readChunk(stream, readers);
+        auto& structure = readers[Structure];
+        auto& positions = readers[Positions];
+        auto& velocities = readers[Velocities];
+        auto& floats = readers[Floats];
+        auto& bytes = readers[Bytes];
+
+        auto numClusters = structure.readVarint();
+        uint64_t prevClusterId = 0;
+        int64_t posX = 0;
+        int64_t posY = 0;
+        for (uint64_t clusterIndex = 0; clusterIndex < numClusters; ++clusterIndex) {
+            ClusterDescription cluster;
+            cluster.id = prevClusterId + static_cast<uint64_t>(structure.readSignedVarint());
+            prevClusterId = cluster.id;
+            cluster.cells.resize(structure.readVarint());
+
+            //connections are resolved after all cell ids of the cluster are known
+            std::vector<std::vector<int64_t>> connectedCellIndices(cluster.cells.size());
+
+            uint64_t prevCellId = cluster.id;
+            int64_t velX = 0;
+            int64_t velY = 0;
+            for (int i = 0; i < toInt(cluster.cells.size()); ++i) {
+                auto& cell = cluster.cells[i];
+                cell.id = prevCellId + static_cast<uint64_t>(structure.readSignedVarint());
+                prevCellId = cell.id;
+
+                posX += positions.readSignedVarint();
+                posY += positions.readSignedVarint();
+                cell.pos = {dequantize(posX, settings.positionPrecision), dequantize(posY, settings.positionPrecision)};
+                velX += velocities.readSignedVarint();
+                velY += velocities.readSignedVarint();
+                cell.vel = {dequantize(velX, settings.velocityPrecision), dequantize(velY, settings.velocityPrecision)};
+
+                cell.energy = floats.readFloat();
+
+                cell.maxConnections = static_cast<int>(structure.readVarint());
+                cell.connections.resize(structure.readVarint());
+                for (auto& connection : cell.connections) {
+                    auto code = structure.readVarint();
+                    if (0 == code) {
+                        connection.cellId = structure.readVarint();
+                        connectedCellIndices[i].emplace_back(-1);
+                    } else {
+                        auto connectedCellIndex = i + fromZigZag(code - 1);
+                        if (connectedCellIndex < 0 || connectedCellIndex >= toInt(cluster.cells.size())) {
+                            throw std::runtime_error("Corrupt compact encoded data.");
+                        }
+                        connectedCellIndices[i].emplace_back(connectedCellIndex);
+                    }
+                    connection.distance = floats.readFloat();
+                    connection.angleFromPrevious = floats.readFloat();
+                }
+
+                cell.tokenBlocked = 0 != structure.readByte();
+                cell.tokenBranchNumber = static_cast<int>(structure.readSignedVarint());
+                cell.tokenUsages = static_cast<int>(structure.readSignedVarint());
+                cell.metadata.color = structure.readByte();
+                cell.cellFeature.setType(static_cast<Enums::CellFunction::Type>(structure.readByte()));
+                cell.cellFeature.constData = bytes.readString();
+                cell.cellFeature.volatileData = bytes.readString();
+                cell.metadata.name = bytes.readString();
+                cell.metadata.description = bytes.readString();
+                cell.metadata.computerSourcecode = bytes.readString();
+
+                cell.tokens.resize(structure.readVarint());
+                for (auto& token : cell.tokens) {
+                    token.energy = floats.readFloat();
+                    token.data = bytes.readString();
+                }
+            }
+            for (int i = 0; i < toInt(cluster.cells.size()); ++i) {
+                auto& connections = cluster.cells[i].connections;
+                for (int j = 0; j < toInt(connections.size()); ++j) {
+                    if (connectedCellIndices[i][j] != -1) {
+                        connections[j].cellId = cluster.cells[connectedCellIndices[i][j]].id;
+                    }
+                }
+            }
+            data.addCluster(cluster);
+        }
+    }
+
+    void encodeParticles(
+        std::vector<ParticleDescription>::const_iterator begin,
+        std::vector<ParticleDescription>::const_iterator end,
+        CompactEncodingSettings const& settings,
+        std::ostream& stream)
+    {
+        StreamWriter writers[NumStreamTypes];
+        auto& structure = writers[Structure];
+        auto& positions = writers[Positions];
+        auto& velocities = writers[Velocities];
+        auto& floats = writers[Floats];
+
+        structure.writeVarint(end - begin);
+        uint64_t prevId = 0;
+        int64_t prevPosX = 0;
+        int64_t prevPosY = 0;
+        int64_t prevVelX = 0;
+        int64_t prevVelY = 0;
+        for (auto particle = begin; particle != end; ++particle) {
+            structure.writeSignedVarint(static_cast<int64_t>(particle->id - prevId));
+            structure.writeByte(particle->metadata.color);
+            prevId = particle->id;
+
+            auto posX = quantize(particle->pos.x, settings.positionPrecision);
+            auto posY = quantize(particle->pos.y, settings.positionPrecision);
+            positions.writeSignedVarint(posX - prevPosX);
+            positions.writeSignedVarint(posY - prevPosY);
+            prevPosX = posX;
+            prevPosY = posY;
+
+            auto velX = quantize(particle->vel.x, settings.velocityPrecision);
+            auto velY = quantize(particle->vel.y, settings.velocityPrecision);
+            velocities.writeSignedVarint(velX - prevVelX);
+            velocities.writeSignedVarint(velY - prevVelY);
+            prevVelX = velX;
+            prevVelY = velY;
+
+            floats.writeFloat(static_cast<float>(particle->energy));
+        }
+        writeChunk(stream, ChunkType::Particles, writers);
+    }
+
+    void decodeParticles(std::istream& stream, CompactEncodingSettings const& settings, DataDescription& data)
+    {
+        StreamReader readers[NumStreamTypes];
+        readChunk(stream, readers);
+        auto& structure = readers[Structure];
+        auto& positions = readers[Positions];
+        auto& velocities = readers[Velocities];
+        auto& floats = readers[Floats];
+
+        auto numParticles = structure.readVarint();
+        uint64_t prevId = 0;
+        int64_t posX = 0;
+        int64_t posY = 0;
+        int64_t velX = 0;
+        int64_t velY = 0;
+        for (uint64_t i = 0; i < numParticles; ++i) {
+            ParticleDescription particle;
+            particle.id = prevId + static_cast<uint64_t>(structure.readSignedVarint());
+            particle.metadata.color = structure.readByte();
+            prevId = particle.id;
+
+            posX += positions.readSignedVarint();
+            posY += positions.readSignedVarint();
+            particle.pos = {dequantize(posX, settings.positionPrecision), dequantize(posY, settings.positionPrecision)};
+            velX += velocities.readSignedVarint();
+            velY += velocities.readSignedVarint();
+            particle.vel = {dequantize(velX, settings.velocityPrecision), dequantize(velY, settings.velocityPrecision)};
+
+            particle.energy = floats.readFloat();
+            data.addParticle(particle);
+        }
+    }
+}
+
+void CompactEncoding::encode(DataDescription const& data, CompactEncodingSettings const& settings, std::ostream& stream)
+{
+    if (settings.positionPrecision <= 0 || settings.velocityPrecision <= 0 || settings.maxEntitiesPerChunk < 1) {
+        throw std::runtime_error("Invalid compact encoding settings.");
+    }
+    stream.write(Signature, sizeof(Signature));
+    StreamWriter header;
+    header.writeVarint(Version);
+    header.writeFloat(settings.positionPrecision);
+    header.writeFloat(settings.velocityPrecision);
+    stream.write(header.getData().data(), header.getData().size());
+
+    auto chunkBegin = data.clusters.begin();
+    int numCells = 0;
+    for (auto cluster = data.clusters.begin(); cluster != data.clusters.end(); ++cluster) {
+        numCells += toInt(cluster->cells.size());
+        if (numCells >= settings.maxEntitiesPerChunk) {
+            encodeClusters(chunkBegin, cluster + 1, settings, stream);
+            chunkBegin = cluster + 1;
+            numCells = 0;
+        }
+    }
+    if (chunkBegin != data.clusters.end()) {
+        encodeClusters(chunkBegin, data.clusters.end(), settings, stream);
+    }
+
+    for (size_t index = 0; index < data.particles.size(); index += settings.maxEntitiesPerChunk) {
+        auto chunkEnd = std::min(data.particles.size(), index + settings.maxEntitiesPerChunk);
+        encodeParticles(data.particles.begin() + index, data.particles.begin() + chunkEnd, settings, stream);
+    }
+    writeVarint(stream, static_cast<uint64_t>(ChunkType::End));
+}
+
+void CompactEncoding::decode(std::istream& stream, DataDescription& data)
+{
+    char signature[sizeof(Signature)];
+    if (!stream.read(signature, sizeof(signature)) || 0 != std::memcmp(signature, Signature, sizeof(Signature))) {
+        throw std::runtime_error("Not a compact encoded file.");
+    }
+    char header[9];
+    if (!stream.read(header, sizeof(header))) {
+        throw std::runtime_error("Corrupt compact encoded data.");
+    }
+    StreamReader headerReader(std::string(header, sizeof(header)));
+    if (headerReader.readVarint() != Version) {
+        throw std::runtime_error("Unsupported version of compact encoded data.");
+    }
+    CompactEncodingSettings settings;
+    settings.positionPrecision = headerReader.readFloat();
+    settings.velocityPrecision = headerReader.readFloat();
+
+    data.clear();
+    while (true) {
+        auto chunkType = static_cast<ChunkType>(readVarint(stream));
+        if (ChunkType::Clusters == chunkType) {
+            decodeClusters(stream, settings, data);
+        } else if (ChunkType::Particles == chunkType) {
+            decodeParticles(stream, settings, data);
+        } else if (ChunkType::End == chunkType) {
+            break;
+        } else {
+            throw std::runtime_error("Corrupt compact encoded data.");
+        }
+    }
+}
+
+bool CompactEncoding::isCompactEncoded(std::istream& stream)
+{
+    auto position = stream.tellg();
+    char signature[sizeof(Signature)];
+    auto result = stream.read(signature, sizeof(signature)) && 0 == std::memcmp(signature, Signature, sizeof(Signature));
+    stream.clear();
+    stream.seekg(position);
+    return result;
+}
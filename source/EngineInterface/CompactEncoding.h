@@ -0,0 +1,24 @@
+#pragma once
+
+#include <iostream>
+
+#include "Base/Definitions.h"
+
+#include "CompactEncodingSettings.h"
+#include "Descriptions.h"
+
+/**
+ * Compact encoding of simulation content. Positions and velocities are quantized, ids are delta encoded, connections
+ * are stored as indices relative to the cells in the cluster and energies are stored with single precision as in the
+ * engine. The data is split into chunks whose streams are compressed by EntropyCoder.
+ */
+class CompactEncoding
+{
+public:
+    ENGINEINTERFACE_EXPORT static void
+    encode(DataDescription const& data, CompactEncodingSettings const& settings, std::ostream& stream);
+    ENGINEINTERFACE_EXPORT static void decode(std::istream& stream, DataDescription& data);
+
+    //checks the file signature without consuming it
+    ENGINEINTERFACE_EXPORT static bool isCompactEncoded(std::istream& stream);
+};
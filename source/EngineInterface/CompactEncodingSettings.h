@@ -0,0 +1,15 @@
+#pragma once
+
+struct CompactEncodingSettings
+{
+    float positionPrecision = 1.0f / 1024;
+    float velocityPrecision = 1.0f / 65536;
+    int maxEntitiesPerChunk = 65536;    //chunks are compressed independently
+
+    bool operator==(CompactEncodingSettings const& other) const
+    {
+        return positionPrecision == other.positionPrecision && velocityPrecision == other.velocityPrecision
+            && maxEntitiesPerChunk == other.maxEntitiesPerChunk;
+    }
+    bool operator!=(CompactEncodingSettings const& other) const { return !operator==(other); }
+};
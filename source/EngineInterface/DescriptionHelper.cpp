@@ -1,5 +1,7 @@
 #include "DescriptionHelper.h"
 
+#include <cmath>
+
 #include "Base/NumberGenerator.h"
 #include "Base/Math.h"
 #include "SpaceCalculator.h"
@@ -73,6 +75,95 @@ void DescriptionHelper::colorize(DataDescription& data, std::vector<int> const&
     }
 }
 
+int DescriptionHelper::getTileIndex(RealVector2D const& pos, IntVector2D const& worldSize, int tileSize)
+{
+    auto numTilesX = (worldSize.x + tileSize - 1) / tileSize;
+    auto numTilesY = (worldSize.y + tileSize - 1) / tileSize;
+    auto x = std::min(std::max(static_cast<int>(std::floor(pos.x)) / tileSize, 0), numTilesX - 1);
+    auto y = std::min(std::max(static_cast<int>(std::floor(pos.y)) / tileSize, 0), numTilesY - 1);
+    return x + y * numTilesX;
+}
+
+void DescriptionHelper::replaceTiles(
+    DataDescription& data,
+    IntVector2D const& worldSize,
+    int tileSize,
+    std::vector<int> const& tiles,
+    DataDescription const& tileContent)
+{
+    std::unordered_set<int> tileSet(tiles.begin(), tiles.end());
+    auto isReplaced = [&](RealVector2D const& pos) {
+        return tileSet.find(getTileIndex(pos, worldSize, tileSize)) != tileSet.end();
+    };
+
+    std::vector<CellDescription> cells;
+    for (auto const& cluster : data.clusters) {
+        for (auto const& cell : cluster.cells) {
+            if (!isReplaced(cell.pos)) {
+                cells.emplace_back(cell);
+            }
+        }
+    }
+    for (auto const& cluster : tileContent.clusters) {
+        cells.insert(cells.end(), cluster.cells.begin(), cluster.cells.end());
+    }
+
+    std::vector<ParticleDescription> particles;
+    for (auto const& particle : data.particles) {
+        if (!isReplaced(particle.pos)) {
+            particles.emplace_back(particle);
+        }
+    }
+    particles.insert(particles.end(), tileContent.particles.begin(), tileContent.particles.end());
+
+    //connections to cells which do not exist anymore are removed
+    std::unordered_map<uint64_t, int> cellIndexById;
+    for (int i = 0; i < toInt(cells.size()); ++i) {
+        cellIndexById.emplace(cells[i].id, i);
+    }
+    for (auto& cell : cells) {
+        std::vector<ConnectionDescription> newConnections;
+        float angleToAdd = 0;
+        for (auto connection : cell.connections) {
+            if (cellIndexById.find(connection.cellId) == cellIndexById.end()) {
+                angleToAdd += connection.angleFromPrevious;
+            } else {
+                connection.angleFromPrevious += angleToAdd;
+                angleToAdd = 0;
+                newConnections.emplace_back(connection);
+            }
+        }
+        cell.connections = newConnections;
+    }
+
+    //clusters are the connected components of the cells
+    std::vector<int> clusterIndexByCellIndex(cells.size(), -1);
+    data.clusters.clear();
+    for (int startIndex = 0; startIndex < toInt(cells.size()); ++startIndex) {
+        if (clusterIndexByCellIndex[startIndex] != -1) {
+            continue;
+        }
+        ClusterDescription cluster;
+        cluster.setId(NumberGenerator::getInstance().getId());
+        std::vector<int> cellIndices{startIndex};
+        clusterIndexByCellIndex[startIndex] = toInt(data.clusters.size());
+        while (!cellIndices.empty()) {
+            auto cellIndex = cellIndices.back();
+            cellIndices.pop_back();
+            for (auto const& connection : cells[cellIndex].connections) {
+                auto connectedCellIndex = cellIndexById.at(connection.cellId);
+                if (clusterIndexByCellIndex[connectedCellIndex] == -1) {
+                    clusterIndexByCellIndex[connectedCellIndex] = toInt(data.clusters.size());
+                    cellIndices.emplace_back(connectedCellIndex);
+                }
+            }
+            cluster.addCell(cells[cellIndex]);
+        }
+        data.addCluster(cluster);
+    }
+    data.particles = particles;
+}
+
 void DescriptionHelper::makeValid(ClusterDescription& cluster)
 {
     auto& numberGen = NumberGenerator::getInstance();
@@ -14,6 +14,17 @@ public:
 
     ENGINEINTERFACE_EXPORT static void colorize(DataDescription& data, std::vector<int> const& colorCodes);
 
+    //tiles are tileSize x tileSize areas in row-major order
+    ENGINEINTERFACE_EXPORT static int getTileIndex(RealVector2D const& pos, IntVector2D const& worldSize, int tileSize);
+
+    //replaces all entities located in the given tiles by tileContent and regroups the cells into clusters
+    ENGINEINTERFACE_EXPORT static void replaceTiles(
+        DataDescription& data,
+        IntVector2D const& worldSize,
+        int tileSize,
+        std::vector<int> const& tiles,
+        DataDescription const& tileContent);
+
 private:
     static void makeValid(ClusterDescription& cluster);
 };
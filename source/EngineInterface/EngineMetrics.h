@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+
+#include "OverallStatistics.h"
+
+namespace EngineArray
+{
+    enum Type
+    {
+        Cells,
+        CellPointers,
+        Particles,
+        ParticlePointers,
+        Tokens,
+        TokenPointers,
+        Count
+    };
+
+    constexpr char const* Names[Count] =
+        {"cells", "cell_pointers", "particles", "particle_pointers", "tokens", "token_pointers"};
+}
+
+//phases of a time step in calcSimulationTimestepKernel
+namespace EnginePhase
+{
+    enum Type
+    {
+        Preparation,
+        NeighborLists,
+        ProcessingStep2,
+        ProcessingStep3,
+        ProcessingStep4,
+        ProcessingStep5,
+        ProcessingStep6,
+        ProcessingStep7,
+        ProcessingStep8,
+        ProcessingStep9,
+        ProcessingStep10,
+        ProcessingStep11,
+        ProcessingStep12,
+        Cleanup,
+        Count
+    };
+
+    constexpr char const* Names[Count] = {
+        "preparation",
+        "neighbor_lists",
+        "processing_step_2",
+        "processing_step_3",
+        "processing_step_4",
+        "processing_step_5",
+        "processing_step_6",
+        "processing_step_7",
+        "processing_step_8",
+        "processing_step_9",
+        "processing_step_10",
+        "processing_step_11",
+        "processing_step_12",
+        "cleanup"};
+}
+
+struct EngineMetrics
+{
+    OverallStatistics statistics;   //process statistics refer to the last time step
+    float tps = 0;
+
+    //accumulated since the creation of the simulation
+    uint64_t totalCreatedCells = 0;
+    uint64_t totalSuccessfulAttacks = 0;
+    uint64_t totalFailedAttacks = 0;
+    uint64_t totalMuscleActivities = 0;
+    uint64_t numArrayResizes = 0;
+    uint64_t phaseNanoseconds[EnginePhase::Count] = {};
+
+    uint64_t gpuMemoryBytes = 0;
+    int arrayNumEntries[EngineArray::Count] = {};
+    int arraySizes[EngineArray::Count] = {};
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+
+#include <boost/optional.hpp>
+
+#include "Base/Definitions.h"
+
+namespace FrameExportFormat
+{
+    enum Type
+    {
+        Png,
+        Ppm
+    };
+}
+
+struct FrameExportSettings
+{
+    std::string directory = "frames";
+    int samplingRate = 100;  //a frame is written every samplingRate time steps
+    FrameExportFormat::Type format = FrameExportFormat::Png;
+    int imageWidth = 1920;
+    int imageHeight = 1080;
+    boost::optional<RealRect> worldRect;    //exported section, centered and scaled to fit; whole world if none
+    int numThreads = 0; //0 = number of hardware threads
+
+    bool operator==(FrameExportSettings const& other) const
+    {
+        auto isWorldRectEqual = !worldRect == !other.worldRect
+            && (!worldRect
+                || (worldRect->topLeft == other.worldRect->topLeft
+                    && worldRect->bottomRight == other.worldRect->bottomRight));
+        return directory == other.directory && samplingRate == other.samplingRate && format == other.format
+            && imageWidth == other.imageWidth && imageHeight == other.imageHeight && isWorldRectEqual
+            && numThreads == other.numThreads;
+    }
+    bool operator!=(FrameExportSettings const& other) const { return !operator==(other); }
+};
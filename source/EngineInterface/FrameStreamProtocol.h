@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Wire format of the frame stream which serves rendered images of the simulation to remote viewers over a TCP or
+ * Unix domain socket. All values are stored in the native byte order of the simulating host.
+ *
+ * A client sends a FrameStreamRequest to select the viewport and may send further requests at any time. The server
+ * answers with frames, each consisting of a FrameStreamFrameHeader followed by numTiles changed tiles. A tile
+ * consists of a FrameStreamTileHeader followed by its pixels row by row in aabbggrr format (4 bytes per pixel).
+ * Tiles at the right and bottom border are clipped to the image size. The first frame after a request is a key
+ * frame containing all tiles; later frames only contain tiles which differ from the previous frame.
+ *
+ * Frames are only rendered when the client has received the previous one, so a slow client receives fewer frames
+ * without slowing down the simulation.
+ */
+
+namespace FrameStream
+{
+    constexpr char RequestMagic[4] = {'A', 'L', 'V', 'R'};
+    constexpr char FrameMagic[4] = {'A', 'L', 'V', 'F'};
+    constexpr uint32_t Version = 1;
+
+    struct FrameFlag
+    {
+        enum Type : uint32_t
+        {
+            KeyFrame = 1 << 0
+        };
+    };
+}
+
+struct FrameStreamRequest
+{
+    char magic[4];
+    uint32_t version;
+    float centerX;  //in world coordinates
+    float centerY;
+    float zoom;  //pixels per world unit
+    int32_t imageWidth;
+    int32_t imageHeight;
+    uint32_t padding;
+};
+static_assert(sizeof(FrameStreamRequest) == 32, "unexpected layout");
+
+struct FrameStreamFrameHeader
+{
+    char magic[4];
+    uint32_t flags;
+    uint64_t frameNumber;
+    uint64_t timestep;
+    int32_t imageWidth;
+    int32_t imageHeight;
+    int32_t tileSize;
+    uint32_t numTiles;
+};
+static_assert(sizeof(FrameStreamFrameHeader) == 40, "unexpected layout");
+
+struct FrameStreamTileHeader
+{
+    uint16_t tileX;  //pixel position = tileX * tileSize
+    uint16_t tileY;
+};
+static_assert(sizeof(FrameStreamTileHeader) == 4, "unexpected layout");
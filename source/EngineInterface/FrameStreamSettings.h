@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+struct FrameStreamSettings
+{
+    bool useUnixSocket = false;
+    std::string host = "127.0.0.1";
+    int port = 8780;
+    std::string unixSocketPath = "/tmp/alien_frames.sock";
+
+    int maxClients = 4;
+    int maxFps = 20;    //per client
+    int tileSize = 32;
+    int maxImageWidth = 4096;
+    int maxImageHeight = 4096;
+
+    bool operator==(FrameStreamSettings const& other) const
+    {
+        return useUnixSocket == other.useUnixSocket && host == other.host && port == other.port
+            && unixSocketPath == other.unixSocketPath && maxClients == other.maxClients && maxFps == other.maxFps
+            && tileSize == other.tileSize && maxImageWidth == other.maxImageWidth
+            && maxImageHeight == other.maxImageHeight;
+    }
+    bool operator!=(FrameStreamSettings const& other) const { return !operator==(other); }
+};
@@ -18,5 +18,6 @@ struct GpuSettings
 namespace Const
 {
     int const MetadataMemorySize = 50000000; //~ 50 MB should sufficent
+    int const MaxOverlayElements = 500000;  //~ 8 MB, overlays are only shown for small visible regions
 }
 
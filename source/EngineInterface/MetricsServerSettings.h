@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+
+struct MetricsServerSettings
+{
+    std::string host = "127.0.0.1";
+    int port = 9464;
+
+    bool operator==(MetricsServerSettings const& other) const { return host == other.host && port == other.port; }
+    bool operator!=(MetricsServerSettings const& other) const { return !operator==(other); }
+};
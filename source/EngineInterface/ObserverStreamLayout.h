@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Memory layout of the observer stream which publishes world frames into a shared memory segment for external
+ * processes. The segment is opened by its name (POSIX: shm_open, Windows: OpenFileMapping) and consists of
+ *
+ *   ObserverStreamHeader | slot 0 | slot 1 | ... | slot numSlots - 1
+ *
+ * where slot i starts at byte headerSize + i * slotSize. Each slot begins with an ObserverFrameHeader followed by
+ * the flat arrays at the offsets given in the frame header (relative to the beginning of the slot, 0 = array not
+ * contained). All values are stored in the native byte order of the simulating host.
+ *
+ * Frames are written in a ring: frame n (counting from 1) is located in slot (n - 1) % numSlots and
+ * ObserverStreamHeader::numFrames holds the number of the last completed frame. Each slot is guarded by a sequence
+ * lock: the writer sets ObserverFrameHeader::sequence to an odd value before and to the next even value after
+ * writing. A reader copies a slot and accepts the copy if the sequence was even and unchanged before and after.
+ */
+
+namespace ObserverStream
+{
+    constexpr char Magic[8] = {'A', 'L', 'I', 'E', 'N', 'O', 'B', 'S'};
+    constexpr uint32_t Version = 1;
+    constexpr int MaxConnections = 6;
+
+    struct Field
+    {
+        enum Type : uint32_t
+        {
+            Cells = 1 << 0,
+            CellConnections = 1 << 1,  //requires Cells
+            Particles = 1 << 2,
+            Tokens = 1 << 3,
+            TokenMemory = 1 << 4,  //requires Tokens
+            All = Cells | CellConnections | Particles | Tokens | TokenMemory
+        };
+    };
+
+    struct FrameFlag
+    {
+        enum Type : uint32_t
+        {
+            Truncated = 1 << 0  //world contained more entities than the slot capacity
+        };
+    };
+}
+
+struct ObserverStreamHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t numSlots;
+    uint64_t headerSize;
+    uint64_t slotSize;
+    uint64_t numFrames;
+};
+static_assert(sizeof(ObserverStreamHeader) == 40, "unexpected layout");
+
+struct ObserverFrameHeader
+{
+    uint64_t sequence;
+    uint64_t frameNumber;
+    uint64_t timestep;
+    uint32_t fieldMask;
+    uint32_t flags;
+    int32_t worldSizeX;
+    int32_t worldSizeY;
+    uint32_t numCells;
+    uint32_t numParticles;
+    uint32_t numTokens;
+    uint32_t tokenMemorySize;   //bytes per token in the token memory array
+    uint64_t cellsOffset;       //ObserverCell[numCells]
+    uint64_t connectionsOffset; //ObserverCellConnections[numCells]
+    uint64_t particlesOffset;   //ObserverParticle[numParticles]
+    uint64_t tokensOffset;      //ObserverToken[numTokens]
+    uint64_t tokenMemoryOffset; //char[numTokens * tokenMemorySize]
+};
+static_assert(sizeof(ObserverFrameHeader) == 96, "unexpected layout");
+
+struct ObserverCell
+{
+    uint64_t id;
+    float posX;
+    float posY;
+    float velX;
+    float velY;
+    float energy;
+    int32_t cellFunctionType;
+    int32_t numConnections;
+    int32_t branchNumber;
+    int32_t tokenUsages;
+    uint8_t color;
+    uint8_t padding[3];
+};
+static_assert(sizeof(ObserverCell) == 48, "unexpected layout");
+
+struct ObserverCellConnections
+{
+    int32_t cellIndex[ObserverStream::MaxConnections];  //index in the cell array, -1 = no connection
+    float distance[ObserverStream::MaxConnections];
+};
+static_assert(sizeof(ObserverCellConnections) == 48, "unexpected layout");
+
+struct ObserverParticle
+{
+    uint64_t id;
+    float posX;
+    float posY;
+    float velX;
+    float velY;
+    float energy;
+    uint8_t color;
+    uint8_t padding[3];
+};
+static_assert(sizeof(ObserverParticle) == 32, "unexpected layout");
+
+struct ObserverToken
+{
+    float energy;
+    int32_t cellIndex;  //index in the cell array, -1 = cell not contained
+};
+static_assert(sizeof(ObserverToken) == 8, "unexpected layout");
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "ObserverStreamLayout.h"
+
+struct ObserverStreamSettings
+{
+    std::string name = "/alien_observer";   //name of the shared memory segment
+    int samplingRate = 10;  //a frame is published every samplingRate time steps
+    uint32_t fieldMask = ObserverStream::Field::All;
+    int numSlots = 3;
+
+    //capacity of a slot
+    int maxCells = 500000;
+    int maxParticles = 500000;
+    int maxTokens = 100000;
+    int maxTokenMemorySize = 256;
+
+    bool operator==(ObserverStreamSettings const& other) const
+    {
+        return name == other.name && samplingRate == other.samplingRate && fieldMask == other.fieldMask
+            && numSlots == other.numSlots && maxCells == other.maxCells && maxParticles == other.maxParticles
+            && maxTokens == other.maxTokens && maxTokenMemorySize == other.maxTokenMemorySize;
+    }
+    bool operator!=(ObserverStreamSettings const& other) const { return !operator==(other); }
+};
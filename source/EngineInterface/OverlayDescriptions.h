@@ -5,12 +5,13 @@
 #include "Base/Definitions.h"
 #include "EngineInterface/ElementaryTypes.h"
 
+//the layout matches OverlayElementAccessTO such that the engine can write the elements without conversion
 struct OverlayElementDescription
 {
-    bool cell;  //false = energy particle
-    Enums::CellFunction::Type cellType;
     RealVector2D pos;
-    int selected;
+    Enums::CellFunction::Type cellType;
+    unsigned char selected;
+    bool cell;  //false = energy particle
 };
 
 struct OverlayDescription 
@@ -10,6 +10,15 @@ boost::property_tree::ptree Parser::encode(uint64_t timestep, Settings settings)
     return tree;
 }
 
+boost::property_tree::ptree Parser::encodeTypes()
+{
+    boost::property_tree::ptree tree;
+    uint64_t timestep = 0;
+    Settings settings;
+    encodeDecode(tree, timestep, settings, ParserTask::EncodeTypes);
+    return tree;
+}
+
 std::pair<uint64_t, Settings> Parser::decodeTimestepAndSettings(
     boost::property_tree::ptree tree)
 {
@@ -122,6 +131,24 @@ void Parser::encodeDecode(boost::property_tree::ptree& tree, uint64_t& timestep,
         defaultPar.cellTransformationProb,
         "simulation parameters.cell.transformation probability",
         ParserTask);
+    JsonParser::encodeDecode(
+        tree,
+        simPar.cellSleepingSteps,
+        defaultPar.cellSleepingSteps,
+        "simulation parameters.cell.sleeping steps",
+        ParserTask);
+    JsonParser::encodeDecode(
+        tree,
+        simPar.cellSleepingMaxVel,
+        defaultPar.cellSleepingMaxVel,
+        "simulation parameters.cell.sleeping max velocity",
+        ParserTask);
+    JsonParser::encodeDecode(
+        tree,
+        simPar.cellSleepingMaxForce,
+        defaultPar.cellSleepingMaxForce,
+        "simulation parameters.cell.sleeping max force",
+        ParserTask);
     JsonParser::encodeDecode(
         tree,
         simPar.spotValues.cellFusionVelocity,
@@ -11,6 +11,9 @@ class Parser
 {
 public:
     ENGINEINTERFACE_EXPORT static boost::property_tree::ptree encode(uint64_t timestep, Settings parameters);
+
+    //contains the type name of each parameter instead of its value, see ParserTask::EncodeTypes
+    ENGINEINTERFACE_EXPORT static boost::property_tree::ptree encodeTypes();
     ENGINEINTERFACE_EXPORT static std::pair<uint64_t, Settings> decodeTimestepAndSettings(
         boost::property_tree::ptree tree);
 
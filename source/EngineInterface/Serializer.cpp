@@ -1,5 +1,6 @@
 #include "Serializer.h"
 
+#include <fstream>
 #include <sstream>
 #include <regex>
 #include <stdexcept>
@@ -17,7 +18,9 @@
 
 #include "Base/ServiceLocator.h"
 
+#include "CompactEncoding.h"
 #include "Descriptions.h"
+#include "DescriptionHelper.h"
 #include "ChangeDescriptions.h"
 #include "SimulationParameters.h"
 #include "Parser.h"
@@ -116,9 +119,17 @@ namespace cereal
     {
         ar(data.clusters, data.particles);
     }
+    template <class Archive>
+    inline void serialize(Archive& ar, CheckpointJournalEntry& data)
+    {
+        ar(data.timestep, data.tileSize, data.tiles, data.content);
+    }
 }
 
-bool _Serializer::serializeSimulationToFile(string const& filename, DeserializedSimulation const& data)
+bool _Serializer::serializeSimulationToFile(
+    string const& filename,
+    DeserializedSimulation const& data,
+    boost::optional<CompactEncodingSettings> const& compactEncodingSettings)
 {
     try {
         std::regex fileEndingExpr("\\.\\w+$");
@@ -133,7 +144,7 @@ bool _Serializer::serializeSimulationToFile(string const& filename, Deserialized
             if (!stream) {
                 return false;
             }
-            serializeDataDescription(data.content, stream);
+            serializeDataDescription(data.content, compactEncodingSettings, stream);
             stream.close();
         }
         {
@@ -199,8 +210,89 @@ bool _Serializer::deserializeSimulationFromFile(string const& filename, Deserial
     }
 }
 
-void _Serializer::serializeDataDescription(DataDescription const& data, std::ostream& stream) const
+bool _Serializer::appendToCheckpointJournal(string const& journalFilename, CheckpointJournalEntry const& entry)
+{
+    try {
+        std::ostringstream entryStream;
+        {
+            cereal::PortableBinaryOutputArchive archive(entryStream);
+            archive(entry);
+        }
+        auto entryData = entryStream.str();
+
+        //each entry is preceded by its size (little endian) in order to detect incompletely written entries
+        std::string sizeData(sizeof(uint64_t), 0);
+        for (int i = 0; i < toInt(sizeData.size()); ++i) {
+            sizeData[i] = static_cast<char>((static_cast<uint64_t>(entryData.size()) >> (i * 8)) & 0xff);
+        }
+
+        std::ofstream stream(journalFilename, std::ios::binary | std::ios::app);
+        if (!stream) {
+            return false;
+        }
+        stream.write(sizeData.data(), sizeData.size());
+        stream.write(entryData.data(), entryData.size());
+        stream.flush();
+        return static_cast<bool>(stream);
+    } catch (std::exception const& e) {
+        throw std::runtime_error(std::string("An error occurred while serializing checkpoint data: ") + e.what());
+    }
+}
+
+bool _Serializer::deserializeCheckpointFromFiles(
+    string const& baseFilename,
+    string const& journalFilename,
+    DeserializedSimulation& data)
+{
+    if (!deserializeSimulationFromFile(baseFilename, data)) {
+        return false;
+    }
+    std::ifstream stream(journalFilename, std::ios::binary);
+    if (!stream) {
+        return true;
+    }
+    try {
+        IntVector2D worldSize{data.settings.generalSettings.worldSizeX, data.settings.generalSettings.worldSizeY};
+        std::string sizeData(sizeof(uint64_t), 0);
+        while (stream.read(sizeData.data(), sizeData.size())) {
+            uint64_t entrySize = 0;
+            for (int i = 0; i < toInt(sizeData.size()); ++i) {
+                entrySize |= static_cast<uint64_t>(static_cast<unsigned char>(sizeData[i])) << (i * 8);
+            }
+            std::string entryData(entrySize, 0);
+            if (!stream.read(entryData.data(), entrySize)) {
+                break;
+            }
+
+            CheckpointJournalEntry entry;
+            {
+                std::istringstream entryStream(entryData);
+                cereal::PortableBinaryInputArchive archive(entryStream);
+                archive(entry);
+            }
+
+            //a journal which has not been truncated after writing a new base contains entries older than the base
+            if (entry.timestep < data.timestep) {
+                continue;
+            }
+            DescriptionHelper::replaceTiles(data.content, worldSize, entry.tileSize, entry.tiles, entry.content);
+            data.timestep = entry.timestep;
+        }
+        return true;
+    } catch (std::exception const& e) {
+        throw std::runtime_error("An error occurred while loading the file " + journalFilename + ": " + e.what());
+    }
+}
+
+void _Serializer::serializeDataDescription(
+    DataDescription const& data,
+    boost::optional<CompactEncodingSettings> const& compactEncodingSettings,
+    std::ostream& stream) const
 {
+    if (compactEncodingSettings) {
+        CompactEncoding::encode(data, *compactEncodingSettings, stream);
+        return;
+    }
     cereal::PortableBinaryOutputArchive archive(stream);
     archive(data);
 }
@@ -223,8 +315,12 @@ void _Serializer::serializeSymbolMap(SymbolMap const symbols, std::ostream& stre
 
 void _Serializer::deserializeDataDescription(DataDescription& data, std::istream& stream) const
 {
-    cereal::PortableBinaryInputArchive archive(stream);
-    archive(data);
+    if (CompactEncoding::isCompactEncoded(stream)) {
+        CompactEncoding::decode(stream, data);
+    } else {
+        cereal::PortableBinaryInputArchive archive(stream);
+        archive(data);
+    }
 
     if (data.clusters.empty() && data.particles.empty()) {
         throw std::runtime_error("no data found");
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "Base/Definitions.h"
 
 #include "Definitions.h"
@@ -8,6 +10,7 @@
 #include "SimulationParameters.h"
 #include "GeneralSettings.h"
 #include "Descriptions.h"
+#include "CompactEncodingSettings.h"
 
 struct DeserializedSimulation
 {
@@ -17,14 +20,42 @@ struct DeserializedSimulation
     DataDescription content;
 };
 
+struct CheckpointJournalEntry
+{
+    uint64_t timestep = 0;
+    int tileSize = 0;
+    std::vector<int> tiles;     //entities in these tiles are replaced (see DescriptionHelper::getTileIndex)
+    DataDescription content;    //all entities located in the tiles
+};
+
 class _Serializer
 {
 public:
-    ENGINEINTERFACE_EXPORT bool serializeSimulationToFile(string const& filename, DeserializedSimulation const& data);
+    //the content is written in the compact encoding (see CompactEncoding) if settings for it are given
+    ENGINEINTERFACE_EXPORT bool serializeSimulationToFile(
+        string const& filename,
+        DeserializedSimulation const& data,
+        boost::optional<CompactEncodingSettings> const& compactEncodingSettings = boost::none);
     ENGINEINTERFACE_EXPORT bool deserializeSimulationFromFile(string const& filename, DeserializedSimulation& data);
 
+    /**
+     * A checkpoint consists of a simulation file as base and a journal of entries which are applied on top of it.
+     * An incompletely written entry at the end of the journal and entries older than the base are ignored on
+     * loading.
+     */
+    ENGINEINTERFACE_EXPORT bool appendToCheckpointJournal(
+        string const& journalFilename,
+        CheckpointJournalEntry const& entry);
+    ENGINEINTERFACE_EXPORT bool deserializeCheckpointFromFiles(
+        string const& baseFilename,
+        string const& journalFilename,
+        DeserializedSimulation& data);
+
 private:
-    void serializeDataDescription(DataDescription const& data, std::ostream& stream) const;
+    void serializeDataDescription(
+        DataDescription const& data,
+        boost::optional<CompactEncodingSettings> const& compactEncodingSettings,
+        std::ostream& stream) const;
     void serializeTimestepAndSettings(uint64_t timestep, Settings const& generalSettings, std::ostream& stream) const;
     void serializeSymbolMap(SymbolMap const symbols, std::ostream& stream) const;
 
@@ -0,0 +1,103 @@
+#include "SimulationFiles.h"
+
+#include <filesystem>
+#include <regex>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+std::vector<std::string> SimulationFiles::getFilenames(std::string const& filename)
+{
+    std::regex fileEndingExpr("\\.\\w+$");
+    return {
+        filename,
+        std::regex_replace(filename, fileEndingExpr, ".settings.json"),
+        std::regex_replace(filename, fileEndingExpr, ".symbols.json")};
+}
+
+std::string SimulationFiles::getTemporaryFilename(std::string const& filename)
+{
+    return std::regex_replace(filename, std::regex("\\.\\w+$"), ".tmp$&");
+}
+
+void SimulationFiles::flushToDisk(std::string const& filename)
+{
+    for (auto const& file : getFilenames(filename)) {
+        std::error_code error;
+        if (!std::filesystem::exists(file, error)) {
+            continue;
+        }
+#if defined(_WIN32)
+        auto fileDescriptor = _open(file.c_str(), _O_RDWR | _O_BINARY);
+        auto success = fileDescriptor >= 0 && 0 == _commit(fileDescriptor);
+        if (fileDescriptor >= 0) {
+            _close(fileDescriptor);
+        }
+#else
+        auto fileDescriptor = open(file.c_str(), O_RDONLY);
+        auto success = fileDescriptor >= 0 && 0 == fsync(fileDescriptor);
+        if (fileDescriptor >= 0) {
+            close(fileDescriptor);
+        }
+#endif
+        if (!success) {
+            throw std::runtime_error("Could not flush " + file + ".");
+        }
+    }
+}
+
+void SimulationFiles::flushDirectoryToDisk(std::string const& filename)
+{
+#if !defined(_WIN32)
+    auto directory = std::filesystem::path(filename).parent_path();
+    auto fileDescriptor = open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (fileDescriptor >= 0) {
+        fsync(fileDescriptor);
+        close(fileDescriptor);
+    }
+#endif
+}
+
+void SimulationFiles::rename(std::string const& sourceFilename, std::string const& targetFilename)
+{
+    auto sourceFilenames = getFilenames(sourceFilename);
+    auto targetFilenames = getFilenames(targetFilename);
+    for (size_t i = 0; i < sourceFilenames.size(); ++i) {
+        std::error_code error;
+        if (!std::filesystem::exists(sourceFilenames[i], error)) {
+            continue;
+        }
+        std::filesystem::rename(sourceFilenames[i], targetFilenames[i], error);
+        if (error) {
+            throw std::runtime_error("Could not rename " + sourceFilenames[i] + " to " + targetFilenames[i] + ".");
+        }
+    }
+}
+
+void SimulationFiles::link(std::string const& sourceFilename, std::string const& targetFilename)
+{
+    auto sourceFilenames = getFilenames(sourceFilename);
+    auto targetFilenames = getFilenames(targetFilename);
+    for (size_t i = 0; i < sourceFilenames.size(); ++i) {
+        std::error_code error;
+        if (!std::filesystem::exists(sourceFilenames[i], error)) {
+            continue;
+        }
+        std::filesystem::remove(targetFilenames[i], error);
+        std::filesystem::create_hard_link(sourceFilenames[i], targetFilenames[i], error);
+        if (error) {
+            error.clear();
+            std::filesystem::copy_file(
+                sourceFilenames[i], targetFilenames[i], std::filesystem::copy_options::overwrite_existing, error);
+        }
+        if (error) {
+            throw std::runtime_error("Could not copy " + sourceFilenames[i] + " to " + targetFilenames[i] + ".");
+        }
+    }
+}
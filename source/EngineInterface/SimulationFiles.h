@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "DllExport.h"
+
+/**
+ * File operations for replacing saved simulations atomically. A simulation consists of the data file and the
+ * accompanying settings and symbol files (see _Serializer). Missing files of a simulation are skipped. All operations
+ * throw std::runtime_error on failure.
+ */
+class SimulationFiles
+{
+public:
+    ENGINEINTERFACE_EXPORT static std::vector<std::string> getFilenames(std::string const& filename);
+
+    //name for writing a simulation before it is renamed to filename
+    ENGINEINTERFACE_EXPORT static std::string getTemporaryFilename(std::string const& filename);
+
+    ENGINEINTERFACE_EXPORT static void flushToDisk(std::string const& filename);
+
+    //makes the renamings in the directory of filename durable (no-op on Windows)
+    ENGINEINTERFACE_EXPORT static void flushDirectoryToDisk(std::string const& filename);
+
+    //replaces the target files atomically
+    ENGINEINTERFACE_EXPORT static void rename(std::string const& sourceFilename, std::string const& targetFilename);
+
+    //keeps the source files in place so that they can be replaced atomically afterwards
+    ENGINEINTERFACE_EXPORT static void link(std::string const& sourceFilename, std::string const& targetFilename);
+};
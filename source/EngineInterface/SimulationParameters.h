@@ -22,6 +22,9 @@ struct SimulationParameters
     int cellCreationMaxConnection = 4;
     int cellCreationTokenAccessNumber = 0;
     float cellTransformationProb = 0.2f;
+    int cellSleepingSteps = 0;    //0 = cells never fall asleep
+    float cellSleepingMaxVel = 0.01f;
+    float cellSleepingMaxForce = 0.01f;  //larger forces wake sleeping cells up
 
     float cellFunctionWeaponStrength = 0.1f;
     int cellFunctionComputerMaxInstructions = 15;
@@ -55,7 +58,8 @@ struct SimulationParameters
             && cellMaxToken == other.cellMaxToken && cellMaxTokenBranchNumber == other.cellMaxTokenBranchNumber
             && cellCreationMaxConnection == other.cellCreationMaxConnection
             && cellCreationTokenAccessNumber == other.cellCreationTokenAccessNumber
-            && cellTransformationProb == other.cellTransformationProb
+            && cellTransformationProb == other.cellTransformationProb && cellSleepingSteps == other.cellSleepingSteps
+            && cellSleepingMaxVel == other.cellSleepingMaxVel && cellSleepingMaxForce == other.cellSleepingMaxForce
             && cellFunctionWeaponStrength == other.cellFunctionWeaponStrength
             && cellFunctionComputerMaxInstructions == other.cellFunctionComputerMaxInstructions
             && cellFunctionComputerCellMemorySize == other.cellFunctionComputerCellMemorySize
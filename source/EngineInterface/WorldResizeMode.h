@@ -0,0 +1,10 @@
+#pragma once
+
+namespace WorldResizeMode
+{
+    enum Type
+    {
+        Remap,  //entities keep their positions modulo the new world size
+        Tile    //the new world is filled with copies of the original world
+    };
+}
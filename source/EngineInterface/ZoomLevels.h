@@ -5,4 +5,5 @@ namespace Const
     int const ZoomLevelForAutomaticEditorSwitch = 32;
     int const ZoomLevelForAutomaticVectorViewSwitch = 2;
     int const MinZoomLevelForEditor = 4;
-}
\ No newline at end of file
+    float const MaxZoomLevelForDensityRendering = 0.5f;  //below, entities are accumulated per pixel instead of drawn
+}
@@ -1,29 +1,55 @@
 #include "AutosaveController.h"
 
+#include <regex>
+
 #include <imgui.h>
 
+#include "Base/LoggingService.h"
+#include "Base/ServiceLocator.h"
 #include "EngineInterface/Serializer.h"
+#include "EngineInterface/SimulationFiles.h"
+#include "EngineImpl/AccessDataTOCache.h"
+#include "EngineImpl/DataConverter.h"
 #include "Resources.h"
 #include "GlobalSettings.h"
 
+namespace
+{
+    //generation 0 is the most recent autosave
+    std::string getAutosaveFilename(int generation)
+    {
+        if (0 == generation) {
+            return Const::AutosaveFile;
+        }
+        return std::regex_replace(Const::AutosaveFile, std::regex("\\.\\w+$"), "." + std::to_string(generation) + "$&");
+    }
+}
+
 _AutosaveController::_AutosaveController(SimulationController const& simController)
     : _simController(simController)
 {
-    _startTimePoint = std::chrono::steady_clock::now();
+    _lastSaveTimePoint = std::chrono::steady_clock::now();
     _on = GlobalSettings::getInstance().getBoolState("controllers.auto save.active", true);
+    _interval = std::max(1, GlobalSettings::getInstance().getIntState("controllers.auto save.interval", 20));
+    _numGenerations = std::max(1, GlobalSettings::getInstance().getIntState("controllers.auto save.generations", 3));
 }
 
 _AutosaveController::~_AutosaveController()
 {
+    joinSaveThread();
     GlobalSettings::getInstance().setBoolState("controllers.auto save.active", _on);
+    GlobalSettings::getInstance().setIntState("controllers.auto save.interval", _interval);
+    GlobalSettings::getInstance().setIntState("controllers.auto save.generations", _numGenerations);
 }
 
 void _AutosaveController::shutdown()
 {
-    if (!_on) {
-        return;
+    joinSaveThread();
+    if (_on) {
+        onSave();
+        joinSaveThread();
     }
-    onSave();
+    logSaveResult();
 }
 
 bool _AutosaveController::isOn() const
@@ -36,27 +62,113 @@ void _AutosaveController::setOn(bool value)
     _on = value;
 }
 
+int _AutosaveController::getInterval() const
+{
+    return _interval;
+}
+
+void _AutosaveController::setInterval(int value)
+{
+    _interval = std::max(1, value);
+}
+
 void _AutosaveController::process()
 {
+    logSaveResult();
     if (!_on) {
         return;
     }
 
-    auto durationSinceStart =
-        std::chrono::duration_cast<std::chrono::minutes>(std::chrono::steady_clock::now() - *_startTimePoint).count();
-    if (durationSinceStart > 0 && durationSinceStart % 20 == 0) {
+    auto now = std::chrono::steady_clock::now();
+    if (now - _lastSaveTimePoint >= std::chrono::minutes(_interval)) {
+        _lastSaveTimePoint = now;
         onSave();
     }
 }
 
 void _AutosaveController::onSave()
 {
-    DeserializedSimulation sim;
-    sim.timestep = static_cast<uint32_t>(_simController->getCurrentTimestep());
-    sim.settings = _simController->getSettings();
-    sim.symbolMap = _simController->getSymbolMap();
-    sim.content = _simController->getSimulationData(
-        {-1000, -1000}, {_simController->getWorldSize().x + 1000, _simController->getWorldSize().y + 1000});
-    Serializer serializer = boost::make_shared<_Serializer>();
-    serializer->serializeSimulationToFile(Const::AutosaveFile, sim);
+    auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
+    if (_isSaving.load()) {
+        loggingService->logMessage(Priority::Important, "autosave skipped since the previous autosave is in progress");
+        return;
+    }
+    joinSaveThread();
+
+    //only the copy of the simulation data happens on this thread
+    SaveJob job;
+    job.timestep = _simController->getCurrentTimestep();
+    job.settings = _simController->getSettings();
+    job.symbolMap = _simController->getSymbolMap();
+    job.gpuSettings = _simController->getGpuSettings();
+    job.dataTOCache = boost::make_shared<_AccessDataTOCache>(job.gpuSettings);
+    job.dataTO = _simController->getSimulationDataTO(
+        {-1000, -1000},
+        {_simController->getWorldSize().x + 1000, _simController->getWorldSize().y + 1000},
+        job.dataTOCache);
+
+    loggingService->logMessage(Priority::Unimportant, "autosave started");
+    _isSaving.store(true);
+    _saveThread = std::thread(&_AutosaveController::save, this, std::move(job));
+}
+
+void _AutosaveController::save(SaveJob const& job)
+{
+    std::string result;
+    try {
+        DeserializedSimulation sim;
+        sim.timestep = static_cast<uint32_t>(job.timestep);
+        sim.settings = job.settings;
+        sim.symbolMap = job.symbolMap;
+        DataConverter converter(job.settings.simulationParameters, job.gpuSettings);
+        sim.content = converter.convertAccessTOtoDataDescription(job.dataTO);
+        job.dataTOCache->releaseDataTO(job.dataTO);
+
+        auto temporaryFilename = SimulationFiles::getTemporaryFilename(Const::AutosaveFile);
+        Serializer serializer = boost::make_shared<_Serializer>();
+        if (!serializer->serializeSimulationToFile(temporaryFilename, sim)) {
+            throw std::runtime_error("Could not write " + temporaryFilename + ".");
+        }
+        SimulationFiles::flushToDisk(temporaryFilename);
+
+        //the most recent autosave remains valid at any time
+        for (int generation = _numGenerations - 2; generation >= 1; --generation) {
+            SimulationFiles::rename(getAutosaveFilename(generation), getAutosaveFilename(generation + 1));
+        }
+        if (_numGenerations > 1) {
+            SimulationFiles::link(getAutosaveFilename(0), getAutosaveFilename(1));
+        }
+        SimulationFiles::rename(temporaryFilename, getAutosaveFilename(0));
+        SimulationFiles::flushDirectoryToDisk(Const::AutosaveFile);
+
+        result = "autosave of time step " + std::to_string(job.timestep) + " completed";
+    } catch (std::exception const& exception) {
+        result = std::string("autosave failed: ") + exception.what();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutexForSaveResult);
+        _saveResult = result;
+    }
+    _isSaving.store(false);
+}
+
+void _AutosaveController::logSaveResult()
+{
+    boost::optional<std::string> saveResult;
+    {
+        std::lock_guard<std::mutex> lock(_mutexForSaveResult);
+        std::swap(saveResult, _saveResult);
+    }
+    if (saveResult) {
+        auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
+        loggingService->logMessage(Priority::Important, *saveResult);
+    }
+}
+
+void _AutosaveController::joinSaveThread()
+{
+    if (_saveThread.joinable()) {
+        _saveThread.join();
+    }
 }
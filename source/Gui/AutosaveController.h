@@ -1,10 +1,21 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <mutex>
+#include <thread>
 
+#include "EngineInterface/Settings.h"
+#include "EngineInterface/SymbolMap.h"
+#include "EngineGpuKernels/AccessTOs.cuh"
 #include "EngineImpl/SimulationController.h"
 #include "Definitions.h"
 
+/**
+ * Saves the simulation periodically. The simulation data is copied quickly from the engine and then converted,
+ * serialized and written on a background thread. The files are written under a temporary name and renamed after
+ * they have been flushed to disk, while the previous autosaves are kept as numbered generations.
+ */
 class _AutosaveController
 {
 public:
@@ -16,13 +27,36 @@ public:
     bool isOn() const;
     void setOn(bool value);
 
+    int getInterval() const;    //in minutes
+    void setInterval(int value);
+
     void process();
 
 private:
+    struct SaveJob
+    {
+        uint64_t timestep;
+        Settings settings;
+        SymbolMap symbolMap;
+        GpuSettings gpuSettings;
+        AccessDataTOCache dataTOCache;
+        DataAccessTO dataTO;
+    };
+
     void onSave();
+    void save(SaveJob const& job);
+    void logSaveResult();
+    void joinSaveThread();
 
     SimulationController _simController;
 
     bool _on = true;
-    boost::optional<std::chrono::steady_clock::time_point> _startTimePoint;
-};
\ No newline at end of file
+    int _interval = 20;
+    int _numGenerations = 3;
+    std::chrono::steady_clock::time_point _lastSaveTimePoint;
+
+    std::thread _saveThread;
+    std::atomic<bool> _isSaving{false};
+    std::mutex _mutexForSaveResult;
+    boost::optional<std::string> _saveResult;
+};
@@ -3,10 +3,9 @@
 #include <imgui.h>
 
 #include "Base/Definitions.h"
+#include "Base/NumberGenerator.h"
+#include "EngineInterface/BulkTransform.h"
 #include "EngineInterface/Colors.h"
-#include "EngineInterface/ChangeDescriptions.h"
-#include "EngineInterface/Descriptions.h"
-#include "EngineInterface/DescriptionHelper.h"
 #include "EngineImpl/SimulationController.h"
 
 #include "AlienImGui.h"
@@ -89,20 +88,13 @@ void _ColorizeDialog::colorCheckbox(std::string id, uint32_t cellColor, bool& ch
 
 void _ColorizeDialog::onColorize()
 {
-    auto timestep = static_cast<uint32_t>(_simController->getCurrentTimestep());
-    auto settings = _simController->getSettings();
-    auto symbolMap = _simController->getSymbolMap();
-    auto content = _simController->getSimulationData({0, 0}, _simController->getWorldSize());
-
-    std::vector<int> colorCodes;
+    BulkTransform transform;
+    transform.operation = BulkTransformOperation::SetColorByCluster;
     for (int i = 0; i < 7; ++i) {
         if(_checkColors[i]) {
-            colorCodes.emplace_back(i);
+            transform.colorCodes[transform.numColorCodes++] = i;
         }
     }
-    DescriptionHelper::colorize(content, colorCodes);
-
-    _simController->closeSimulation();
-    _simController->newSimulation(timestep, settings, symbolMap);
-    _simController->setSimulationData(content);
+    transform.seed = NumberGenerator::getInstance().getRandomInt();
+    _simController->applyBulkTransform(transform);
 }
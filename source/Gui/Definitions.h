@@ -95,6 +95,9 @@ using ManipulatorWindow = boost::shared_ptr<_ManipulatorWindow>;
 class _WindowController;
 using WindowController = boost::shared_ptr<_WindowController>;
 
+class _ProgressDialog;
+using ProgressDialog = boost::shared_ptr<_ProgressDialog>;
+
 
 struct GLFWvidmode;
 struct GLFWwindow;
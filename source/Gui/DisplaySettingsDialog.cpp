@@ -1,5 +1,6 @@
 #include "DisplaySettingsDialog.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include <GLFW/glfw3.h>
@@ -11,6 +12,7 @@
 #include "AlienImGui.h"
 #include "GlobalSettings.h"
 #include "WindowController.h"
+#include "SimulationView.h"
 #include "StyleRepository.h"
 
 namespace
@@ -18,8 +20,11 @@ namespace
     auto const MaxContentTextWidth = 130.0f;
 }
 
-_DisplaySettingsDialog::_DisplaySettingsDialog(WindowController const& windowController)
+_DisplaySettingsDialog::_DisplaySettingsDialog(
+    WindowController const& windowController,
+    SimulationView const& simulationView)
     : _windowController(windowController)
+    , _simulationView(simulationView)
 {
     auto primaryMonitor = glfwGetPrimaryMonitor();
     _videoModes = glfwGetVideoModes(primaryMonitor, &_videoModesCount);
@@ -65,6 +70,17 @@ void _DisplaySettingsDialog::process()
         }
         ImGui::EndDisabled();
 
+        AlienImGui::InputInt(
+            AlienImGui::InputIntParameters()
+                .name("Render rate limit")
+                .textWidth(maxContentTextWidthScaled)
+                .defaultValue(_origRenderRateLimit)
+                .tooltip(std::string("Maximum number of image updates per second caused by the running simulation. "
+                                     "Changes of the view are always shown immediately. 0 = no limit.")),
+            _renderRateLimit);
+        _renderRateLimit = std::max(0, _renderRateLimit);
+        _simulationView->setRenderRateLimit(_renderRateLimit);
+
         AlienImGui::Separator();
 
         if (ImGui::Button("OK")) {
@@ -79,6 +95,7 @@ void _DisplaySettingsDialog::process()
             _show = false;
             _windowController->setMode(_origMode);
             _selectionIndex = _origSelectionIndex;
+            _simulationView->setRenderRateLimit(_origRenderRateLimit);
         }
 
         ImGui::EndPopup();
@@ -91,6 +108,8 @@ void _DisplaySettingsDialog::show()
     _selectionIndex = getSelectionIndex();
     _origSelectionIndex = _selectionIndex;
     _origMode = _windowController->getMode();
+    _origRenderRateLimit = _simulationView->getRenderRateLimit();
+    _renderRateLimit = _origRenderRateLimit;
 }
 
 void _DisplaySettingsDialog::setFullscreen(int selectionIndex)
@@ -6,7 +6,7 @@
 class _DisplaySettingsDialog
 {
 public:
-    _DisplaySettingsDialog(WindowController const& windowController);
+    _DisplaySettingsDialog(WindowController const& windowController, SimulationView const& simulationView);
     ~_DisplaySettingsDialog();
 
     void process();
@@ -19,11 +19,14 @@ private:
     std::vector<std::string> createVideoModeStrings() const;
 
     WindowController _windowController;
+    SimulationView _simulationView;
 
     bool _show = false;
     std::string _origMode;
     int _origSelectionIndex;
     int _selectionIndex;
+    int _origRenderRateLimit;
+    int _renderRateLimit;
 
     int _videoModesCount = 0;
     GLFWvidmode const* _videoModes;
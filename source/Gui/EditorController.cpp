@@ -34,6 +34,7 @@ void _EditorController::process()
         return;
     }
 
+    _editorModel->update();
     if (!_simController->isSimulationRunning()) {
         _selectionWindow->process();
         _manipulatorWindow->process();
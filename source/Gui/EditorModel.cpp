@@ -15,7 +15,11 @@ SelectionShallowData const& _EditorModel::getSelectionShallowData() const
 
 void _EditorModel::update()
 {
-    _selectionShallowData = _simController->getSelectionShallowData();
+    auto selectionVersion = _simController->getSelectionVersion();
+    if (!_selectionVersion || *_selectionVersion != selectionVersion) {
+        _selectionShallowData = _simController->getSelectionShallowData();
+        _selectionVersion = selectionVersion;
+    }
 }
 
 bool _EditorModel::isSelectionEmpty() const
@@ -27,4 +31,5 @@ bool _EditorModel::isSelectionEmpty() const
 void _EditorModel::clear()
 {
     _selectionShallowData = SelectionShallowData();
+    _selectionVersion = boost::none;
 }
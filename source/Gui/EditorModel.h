@@ -1,5 +1,7 @@
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "Base/Definitions.h"
 #include "EngineInterface/SelectionShallowData.h"
 #include "EngineImpl/Definitions.h"
@@ -11,11 +13,12 @@ public:
     _EditorModel(SimulationController const& simController);
 
     SelectionShallowData const& getSelectionShallowData() const;
-    void update();
+    void update();  //cheap, reads the selection data published by the engine
 
     bool isSelectionEmpty() const;
     void clear();
 private:
     SimulationController _simController;
     SelectionShallowData _selectionShallowData;
+    boost::optional<uint64_t> _selectionVersion;
 };
\ No newline at end of file
@@ -49,6 +49,7 @@
 #include "OpenSimulationDialog.h"
 #include "SaveSimulationDialog.h"
 #include "DisplaySettingsDialog.h"
+#include "ProgressDialog.h"
 #include "EditorController.h"
 #include "SelectionWindow.h"
 #include "ManipulatorWindow.h"
@@ -106,6 +107,7 @@ _MainWindow::_MainWindow(SimulationController const& simController, SimpleLogger
     auto worldSize = _simController->getWorldSize();
     _viewport = boost::make_shared<_Viewport>(_windowController);
     _uiController = boost::make_shared<_UiController>();
+    _progressDialog = boost::make_shared<_ProgressDialog>();
     _autosaveController = boost::make_shared<_AutosaveController>(_simController);
 
     _editorController =
@@ -114,8 +116,8 @@ _MainWindow::_MainWindow(SimulationController const& simController, SimpleLogger
     _simulationView = boost::make_shared<_SimulationView>(_simController, _modeWindow, _viewport);
     simulationViewPtr = _simulationView.get();
     _statisticsWindow = boost::make_shared<_StatisticsWindow>(_simController);
-    _temporalControlWindow = boost::make_shared<_TemporalControlWindow>(_simController, _statisticsWindow);
-    _spatialControlWindow = boost::make_shared<_SpatialControlWindow>(_simController, _viewport);
+    _temporalControlWindow = boost::make_shared<_TemporalControlWindow>(_simController, _statisticsWindow, _progressDialog);
+    _spatialControlWindow = boost::make_shared<_SpatialControlWindow>(_simController, _viewport, _progressDialog);
     _simulationParametersWindow = boost::make_shared<_SimulationParametersWindow>(_simController);
     _gpuSettingsDialog = boost::make_shared<_GpuSettingsDialog>(_simController);
     _newSimulationDialog = boost::make_shared<_NewSimulationDialog>(_simController, _viewport, _statisticsWindow);
@@ -125,9 +127,10 @@ _MainWindow::_MainWindow(SimulationController const& simController, SimpleLogger
     _colorizeDialog = boost::make_shared<_ColorizeDialog>(_simController);
     _logWindow = boost::make_shared<_LogWindow>(_logger);
     _gettingStartedWindow = boost::make_shared<_GettingStartedWindow>();
-    _openSimulationDialog = boost::make_shared<_OpenSimulationDialog>(_simController, _statisticsWindow, _viewport);
-    _saveSimulationDialog = boost::make_shared<_SaveSimulationDialog>(_simController);
-    _displaySettingsDialog = boost::make_shared<_DisplaySettingsDialog>(_windowController);
+    _openSimulationDialog =
+        boost::make_shared<_OpenSimulationDialog>(_simController, _statisticsWindow, _viewport, _progressDialog);
+    _saveSimulationDialog = boost::make_shared<_SaveSimulationDialog>(_simController, _progressDialog);
+    _displaySettingsDialog = boost::make_shared<_DisplaySettingsDialog>(_windowController, _simulationView);
 
     ifd::FileDialog::Instance().CreateTexture = [](uint8_t* data, int w, int h, char fmt) -> void* {
         GLuint tex;
@@ -169,6 +172,12 @@ void _MainWindow::mainLoop()
         {}
 */
 
+        //the simulation must not be accessed while an operation is running
+        if (_progressDialog->isBusy()) {
+            processRunningOperation();
+            continue;
+        }
+
         switch (_startupWindow->getState()) {
         case _StartupWindow::State::Unintialized:
             processUninitialized();
@@ -193,6 +202,7 @@ void _MainWindow::mainLoop()
 
 void _MainWindow::shutdown()
 {
+    _progressDialog->shutdown();
     _windowController->shutdown();
     _autosaveController->shutdown();
 
@@ -316,12 +326,18 @@ void _MainWindow::processFinishedLoading()
     renderSimulation();
 }
 
+void _MainWindow::processRunningOperation()
+{
+    _progressDialog->process();
+    renderSimulation();
+}
+
 void _MainWindow::renderSimulation()
 {
     int display_w, display_h;
     glfwGetFramebufferSize(_window, &display_w, &display_h);
     glViewport(0, 0, display_w, display_h);
-    if (_renderSimulation) {
+    if (_renderSimulation && !_progressDialog->isBusy()) {
         _simulationView->processContent();
     } else {
         glClearColor(0, 0, 0.1f, 1.0f);
@@ -415,6 +431,15 @@ void _MainWindow::processMenubar()
             if (ImGui::MenuItem("Auto save", "", _autosaveController->isOn())) {
                 _autosaveController->setOn(!_autosaveController->isOn());
             }
+            ImGui::BeginDisabled(!_autosaveController->isOn());
+            auto autosaveInterval = _autosaveController->getInterval();
+            if (ImGui::SliderInt("##autosaveInterval", &autosaveInterval, 1, 240, "every %d min")) {
+                _autosaveController->setInterval(autosaveInterval);
+            }
+            ImGui::EndDisabled();
+            if (ImGui::MenuItem("Compact save files", "", _saveSimulationDialog->isCompactEncodingOn())) {
+                _saveSimulationDialog->setCompactEncodingOn(!_saveSimulationDialog->isCompactEncodingOn());
+            }
             if (ImGui::MenuItem("GPU settings", "ALT+C")) {
                 _gpuSettingsDialog->show();
             }
@@ -19,6 +19,7 @@ private:
     void processLoadingControls();
     void processFinishedLoading();
 
+    void processRunningOperation();
     void renderSimulation();
 
     void processMenubar();
@@ -58,6 +59,7 @@ private:
     SaveSimulationDialog _saveSimulationDialog; 
     DisplaySettingsDialog _displaySettingsDialog;
     EditorController _editorController; 
+    ProgressDialog _progressDialog;
 
     bool _onClose = false;
     bool _simulationMenuToggled = false;
@@ -8,14 +8,17 @@
 #include "EngineImpl/SimulationController.h"
 #include "StatisticsWindow.h"
 #include "Viewport.h"
+#include "ProgressDialog.h"
 
 _OpenSimulationDialog::_OpenSimulationDialog(
     SimulationController const& simController,
     StatisticsWindow const& statisticsWindow,
-    Viewport const& viewport)
+    Viewport const& viewport,
+    ProgressDialog const& progressDialog)
     : _simController(simController)
     , _statisticsWindow(statisticsWindow)
     , _viewport(viewport)
+    , _progressDialog(progressDialog)
 {}
 
 void _OpenSimulationDialog::process()
@@ -26,21 +29,30 @@ void _OpenSimulationDialog::process()
     if (ifd::FileDialog::Instance().HasResult()) {
         const std::vector<std::filesystem::path>& res = ifd::FileDialog::Instance().GetResults();
         auto firstFilename = res.front();
-        _simController->closeSimulation();
 
-        _statisticsWindow->reset();
+        auto simController = _simController;
+        auto deserializedData = boost::make_shared<DeserializedSimulation>();
+        _progressDialog->run(
+            "Loading simulation",
+            [simController, firstFilename, deserializedData](_Operation& operation) {
+                Serializer serializer = boost::make_shared<_Serializer>();
+                serializer->deserializeSimulationFromFile(firstFilename.string(), *deserializedData);
+                operation.setProgress(0.5f);
+                operation.checkCancellation();
 
-        Serializer serializer = boost::make_shared<_Serializer>();
-
-        DeserializedSimulation deserializedData;
-        serializer->deserializeSimulationFromFile(firstFilename.string(), deserializedData);
-
-        _simController->newSimulation(deserializedData.timestep, deserializedData.settings, deserializedData.symbolMap);
-        _simController->setSimulationData(deserializedData.content);
-        _viewport->setCenterInWorldPos(
-            {toFloat(deserializedData.settings.generalSettings.worldSizeX) / 2,
-             toFloat(deserializedData.settings.generalSettings.worldSizeY) / 2});
-        _viewport->setZoomFactor(2.0f);
+                //the simulation is replaced from here on and cannot be cancelled anymore
+                simController->replaceSimulation(
+                    deserializedData->timestep, deserializedData->settings, deserializedData->symbolMap);
+                operation.setProgress(0.7f);
+                simController->setSimulationData(deserializedData->content);
+            },
+            [this, deserializedData] {
+                _statisticsWindow->reset();
+                _viewport->setCenterInWorldPos(
+                    {toFloat(deserializedData->settings.generalSettings.worldSizeX) / 2,
+                     toFloat(deserializedData->settings.generalSettings.worldSizeY) / 2});
+                _viewport->setZoomFactor(2.0f);
+            });
 
 /*
         Serializer serializer = boost::make_shared<_Serializer>();
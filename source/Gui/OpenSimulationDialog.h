@@ -9,7 +9,8 @@ public:
     _OpenSimulationDialog(
         SimulationController const& simController,
         StatisticsWindow const& statisticsWindow,
-        Viewport const& viewport);
+        Viewport const& viewport,
+        ProgressDialog const& progressDialog);
 
     void process();
 
@@ -19,5 +20,6 @@ private:
     SimulationController _simController;
     StatisticsWindow _statisticsWindow;
     Viewport _viewport;
+    ProgressDialog _progressDialog;
 };
 
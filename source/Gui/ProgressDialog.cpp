@@ -0,0 +1,101 @@
+#include "ProgressDialog.h"
+
+#include <imgui.h>
+
+#include <boost/make_shared.hpp>
+
+#include "Base/LoggingService.h"
+#include "Base/ServiceLocator.h"
+#include "StyleRepository.h"
+
+_ProgressDialog::_ProgressDialog()
+{
+    _runner = boost::make_shared<_OperationRunner>();
+}
+
+void _ProgressDialog::shutdown()
+{
+    _pendingOperation = boost::none;
+    if (_operation) {
+        _operation->cancel();
+        finish();
+    }
+    _runner.reset();
+}
+
+void _ProgressDialog::run(
+    std::string const& name,
+    std::function<void(_Operation&)> const& body,
+    std::function<void()> const& onFinished,
+    bool cancellable)
+{
+    if (isBusy()) {
+        auto runningName = _pendingOperation ? _pendingOperation->name : _operation->getName();
+        auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
+        loggingService->logMessage(Priority::Important, name + " skipped since " + runningName + " is in progress");
+        return;
+    }
+
+    //the operation is started in the next frame such that the current frame can still access the simulation
+    _pendingOperation = PendingOperation{name, body, cancellable};
+    _onFinished = onFinished;
+}
+
+bool _ProgressDialog::isBusy() const
+{
+    return _pendingOperation || _operation;
+}
+
+void _ProgressDialog::process()
+{
+    if (_pendingOperation) {
+        _operation = _runner->run(_pendingOperation->name, _pendingOperation->body, _pendingOperation->cancellable);
+        _pendingOperation = boost::none;
+    }
+    if (!_operation) {
+        return;
+    }
+    if (_operation->isFinished()) {
+        finish();
+        return;
+    }
+
+    auto name = _operation->getName().c_str();
+    ImGui::OpenPopup(name);
+    ImGui::SetNextWindowPos(ImGui::GetMainViewport()->GetCenter(), ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
+    if (ImGui::BeginPopupModal(name, NULL, ImGuiWindowFlags_AlwaysAutoResize)) {
+        ImGui::ProgressBar(_operation->getProgress(), ImVec2(StyleRepository::getInstance().scaleContent(300), 0));
+
+        if (_operation->isCancellable()) {
+            ImGui::Spacing();
+            ImGui::Spacing();
+            ImGui::Separator();
+            ImGui::Spacing();
+            ImGui::Spacing();
+
+            ImGui::BeginDisabled(_operation->isCancelled());
+            if (ImGui::Button("Cancel")) {
+                _operation->cancel();
+            }
+            ImGui::EndDisabled();
+        }
+        ImGui::EndPopup();
+    }
+}
+
+void _ProgressDialog::finish()
+{
+    auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
+    try {
+        _operation->get();
+        if (_onFinished) {
+            _onFinished();
+        }
+    } catch (OperationCancelledException const& exception) {
+        loggingService->logMessage(Priority::Important, exception.what());
+    } catch (std::exception const& exception) {
+        loggingService->logMessage(Priority::Important, _operation->getName() + " failed: " + exception.what());
+    }
+    _operation.reset();
+    _onFinished = nullptr;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include <boost/optional.hpp>
+
+#include "EngineImpl/Definitions.h"
+#include "EngineImpl/OperationRunner.h"
+#include "Definitions.h"
+
+/**
+ * Runs long-running operations in the background and shows their progress in a modal dialog. The main window
+ * neither renders the simulation nor processes other windows while an operation is running.
+ */
+class _ProgressDialog
+{
+public:
+    _ProgressDialog();
+
+    void shutdown();    //cancels the running operation and waits for it
+
+    //onFinished is called on the UI thread after the operation has been completed successfully
+    void run(
+        std::string const& name,
+        std::function<void(_Operation&)> const& body,
+        std::function<void()> const& onFinished = {},
+        bool cancellable = true);
+    bool isBusy() const;
+
+    void process();
+
+private:
+    void finish();
+
+    struct PendingOperation
+    {
+        std::string name;
+        std::function<void(_Operation&)> body;
+        bool cancellable;
+    };
+
+    OperationRunner _runner;
+    boost::optional<PendingOperation> _pendingOperation;  //is started in the next frame
+    Operation _operation;
+    std::function<void()> _onFinished;
+};
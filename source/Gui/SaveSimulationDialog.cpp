@@ -6,10 +6,22 @@
 #include "EngineInterface/ChangeDescriptions.h"
 #include "EngineInterface/Serializer.h"
 #include "ImFileDialog.h"
+#include "GlobalSettings.h"
+#include "ProgressDialog.h"
 
-_SaveSimulationDialog::_SaveSimulationDialog(SimulationController const& simController)
+_SaveSimulationDialog::_SaveSimulationDialog(
+    SimulationController const& simController,
+    ProgressDialog const& progressDialog)
     : _simController(simController)
-{}
+    , _progressDialog(progressDialog)
+{
+    _compactEncodingOn = GlobalSettings::getInstance().getBoolState("dialogs.save simulation.compact encoding", false);
+}
+
+_SaveSimulationDialog::~_SaveSimulationDialog()
+{
+    GlobalSettings::getInstance().setBoolState("dialogs.save simulation.compact encoding", _compactEncodingOn);
+}
 
 void _SaveSimulationDialog::process()
 {
@@ -20,14 +32,26 @@ void _SaveSimulationDialog::process()
         const std::vector<std::filesystem::path>& res = ifd::FileDialog::Instance().GetResults();
         auto firstFilename = res.front();
 
-        DeserializedSimulation sim;
-        sim.timestep = static_cast<uint32_t>(_simController->getCurrentTimestep());
-        sim.settings = _simController->getSettings();
-        sim.symbolMap = _simController->getSymbolMap();
-        sim.content = _simController->getSimulationData({0, 0}, _simController->getWorldSize());
+        auto simController = _simController;
+        auto compactEncodingOn = _compactEncodingOn;
+        _progressDialog->run(
+            "Saving simulation", [simController, firstFilename, compactEncodingOn](_Operation& operation) {
+                DeserializedSimulation sim;
+                sim.timestep = static_cast<uint32_t>(simController->getCurrentTimestep());
+                sim.settings = simController->getSettings();
+                sim.symbolMap = simController->getSymbolMap();
+                sim.content = simController->getSimulationData({0, 0}, simController->getWorldSize());
+                operation.setProgress(0.3f);
+                operation.checkCancellation();
 
-        Serializer serializer = boost::make_shared<_Serializer>();
-        serializer->serializeSimulationToFile(firstFilename.string(), sim);
+                Serializer serializer = boost::make_shared<_Serializer>();
+                if (!serializer->serializeSimulationToFile(
+                        firstFilename.string(),
+                        sim,
+                        compactEncodingOn ? boost::make_optional(CompactEncodingSettings()) : boost::none)) {
+                    throw std::runtime_error("Could not write " + firstFilename.string() + ".");
+                }
+            });
     }
     ifd::FileDialog::Instance().Close();
 }
@@ -36,3 +60,13 @@ void _SaveSimulationDialog::show()
 {
     ifd::FileDialog::Instance().Save("SimulationSaveDialog", "Save simulation", "Simulation file (*.sim){.sim},.*");
 }
+
+bool _SaveSimulationDialog::isCompactEncodingOn() const
+{
+    return _compactEncodingOn;
+}
+
+void _SaveSimulationDialog::setCompactEncodingOn(bool value)
+{
+    _compactEncodingOn = value;
+}
@@ -6,12 +6,20 @@
 class _SaveSimulationDialog
 {
 public:
-    _SaveSimulationDialog(SimulationController const& simController);
+    _SaveSimulationDialog(SimulationController const& simController, ProgressDialog const& progressDialog);
+    ~_SaveSimulationDialog();
 
     void process();
 
     void show();
 
+    //saves the content quantized and entropy coded (see CompactEncoding)
+    bool isCompactEncodingOn() const;
+    void setCompactEncodingOn(bool value);
+
 private:
     SimulationController _simController;
+    ProgressDialog _progressDialog;
+
+    bool _compactEncodingOn = false;
 };
@@ -276,6 +276,34 @@ void _SimulationParametersWindow::processBase(
                 .max(6)
                 .tooltip(std::string("Maximum number of connections a cell can establish with others.")),
             simParameters.cellMaxBonds);
+        AlienImGui::SliderInt(
+            AlienImGui::SliderIntParameters()
+                .name("Sleeping steps")
+                .textWidth(maxContentTextWidthScaled)
+                .defaultValue(origSimParameters.cellSleepingSteps)
+                .min(0)
+                .max(1000)
+                .tooltip(std::string("Number of time steps after which resting cells without tokens are no longer "
+                                     "moved until they are touched. The value 0 disables sleeping.")),
+            simParameters.cellSleepingSteps);
+        AlienImGui::SliderFloat(
+            AlienImGui::SliderFloatParameters()
+                .name("Sleeping max velocity")
+                .textWidth(maxContentTextWidthScaled)
+                .min(0)
+                .max(0.1f)
+                .defaultValue(origSimParameters.cellSleepingMaxVel)
+                .tooltip(std::string("Maximum velocity at which a cell is considered as resting.")),
+            simParameters.cellSleepingMaxVel);
+        AlienImGui::SliderFloat(
+            AlienImGui::SliderFloatParameters()
+                .name("Sleeping max force")
+                .textWidth(maxContentTextWidthScaled)
+                .min(0)
+                .max(0.1f)
+                .defaultValue(origSimParameters.cellSleepingMaxForce)
+                .tooltip(std::string("Maximum force which does not wake up a sleeping cell.")),
+            simParameters.cellSleepingMaxForce);
 
         AlienImGui::Group("Cell functions");
         AlienImGui::SliderFloat(
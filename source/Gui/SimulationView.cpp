@@ -11,6 +11,7 @@
 #include "Resources.h"
 #include "ModeWindow.h"
 #include "StyleRepository.h"
+#include "GlobalSettings.h"
 
 namespace
 {
@@ -90,6 +91,14 @@ _SimulationView::_SimulationView(
     _shader->setBool("glowEffect", true);
     _shader->setBool("motionEffect", true);
     _shader->setFloat("motionBlurFactor", MotionBlurStandard);
+
+    _renderRateLimit =
+        std::max(0, GlobalSettings::getInstance().getIntState("settings.simulation view.render rate limit", 0));
+}
+
+_SimulationView::~_SimulationView()
+{
+    GlobalSettings::getInstance().setIntState("settings.simulation view.render rate limit", _renderRateLimit);
 }
 
 void _SimulationView::resize(IntVector2D const& size)
@@ -123,6 +132,7 @@ void _SimulationView::resize(IntVector2D const& size)
     glBindFramebuffer(GL_FRAMEBUFFER, 0);  
 
     _viewport->setViewSize(size);
+    _lastImageState = boost::none;
 }
 
 void _SimulationView::leftMouseButtonPressed(IntVector2D const& viewPos)
@@ -261,23 +271,41 @@ void _SimulationView::processControls()
          {1, viewport->Size.y - 1 - scrollbarThickness}});
 }
 
+int _SimulationView::getRenderRateLimit() const
+{
+    return _renderRateLimit;
+}
+
+void _SimulationView::setRenderRateLimit(int value)
+{
+    _renderRateLimit = std::max(0, value);
+}
+
 void _SimulationView::updateImageFromSimulation()
 {
+    if (isImageUpdateRequired()) {
+        auto imageState = getCurrentImageState();
+        auto zoomFactor = _viewport->getZoomFactor();
+
+        auto success = false;
+        if (zoomFactor < ZoomFactorForOverlay) {
+            success = _simController->tryDrawVectorGraphics(
+                imageState.worldRectTopLeft, imageState.worldRectBottomRight, imageState.viewSize, zoomFactor);
+            _overlay = boost::none;
+
+        } else {
+            auto overlay = _simController->tryDrawVectorGraphicsAndReturnOverlay(
+                imageState.worldRectTopLeft, imageState.worldRectBottomRight, imageState.viewSize, zoomFactor);
+            if (overlay) {
+                _overlay = overlay;
+                success = true;
+            }
+        }
 
-    auto worldRect = _viewport->getVisibleWorldRect();
-    auto viewSize = _viewport->getViewSize();
-    auto zoomFactor = _viewport->getZoomFactor();
-
-    if (zoomFactor < ZoomFactorForOverlay) {
-        _simController->tryDrawVectorGraphics(
-            worldRect.topLeft, worldRect.bottomRight, {viewSize.x, viewSize.y}, zoomFactor);
-        _overlay = boost::none;
-
-    } else {
-        auto overlay = _simController->tryDrawVectorGraphicsAndReturnOverlay(
-            worldRect.topLeft, worldRect.bottomRight, {viewSize.x, viewSize.y}, zoomFactor);
-        if (overlay) {
-            _overlay = overlay;
+        //in case of a timeout the image is updated in the next frame
+        if (success) {
+            _lastImageState = imageState;
+            _lastImageUpdate = std::chrono::steady_clock::now();
         }
     }
 
@@ -311,3 +339,33 @@ void _SimulationView::updateImageFromSimulation()
     }
 }
 
+bool _SimulationView::isImageUpdateRequired() const
+{
+    if (!_lastImageState) {
+        return true;
+    }
+    auto imageState = getCurrentImageState();
+
+    //changes of the view are shown immediately
+    if (imageState.worldRectTopLeft != _lastImageState->worldRectTopLeft
+        || imageState.worldRectBottomRight != _lastImageState->worldRectBottomRight
+        || !(imageState.viewSize == _lastImageState->viewSize)) {
+        return true;
+    }
+
+    //changes of the simulation are shown at most at the render rate limit
+    if (imageState.dataVersion == _lastImageState->dataVersion) {
+        return false;
+    }
+    if (_renderRateLimit > 0) {
+        auto minDuration = std::chrono::microseconds(1000000 / _renderRateLimit);
+        return std::chrono::steady_clock::now() - _lastImageUpdate >= minDuration;
+    }
+    return true;
+}
+
+_SimulationView::ImageState _SimulationView::getCurrentImageState() const
+{
+    auto worldRect = _viewport->getVisibleWorldRect();
+    return {_simController->getDataVersion(), worldRect.topLeft, worldRect.bottomRight, _viewport->getViewSize()};
+}
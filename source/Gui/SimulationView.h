@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+
 #include "Base/Definitions.h"
 #include "EngineInterface/OverlayDescriptions.h"
 #include "EngineImpl/Definitions.h"
@@ -12,11 +14,17 @@ public:
         SimulationController const& simController,
         ModeWindow const& modeWindow,
         Viewport const& viewport);
+    ~_SimulationView();
+
     void resize(IntVector2D const& viewportSize);
 
     void processContent();
     void processControls();
 
+    //limits the image updates caused by simulation changes, 0 = no limit
+    int getRenderRateLimit() const;
+    void setRenderRateLimit(int value);
+
 private:
     void processEvents();
 
@@ -33,6 +41,7 @@ private:
     void middleMouseButtonReleased();
 
     void updateImageFromSimulation();
+    bool isImageUpdateRequired() const;
 
     //widgets
     SimulationScrollbar _scrollbarX;
@@ -40,6 +49,20 @@ private:
 
     //overlay
     boost::optional<OverlayDescription> _overlay;
+
+    //image updates
+    struct ImageState
+    {
+        uint64_t dataVersion;
+        RealVector2D worldRectTopLeft;
+        RealVector2D worldRectBottomRight;
+        IntVector2D viewSize;
+    };
+    ImageState getCurrentImageState() const;
+
+    boost::optional<ImageState> _lastImageState;
+    std::chrono::steady_clock::time_point _lastImageUpdate;
+    int _renderRateLimit = 0;
     
     //shader data
     unsigned int _vao, _vbo, _ebo;
@@ -5,18 +5,21 @@
 #include "IconFontCppHeaders/IconsFontAwesome5.h"
 
 #include "Base/StringFormatter.h"
-#include "EngineInterface/ChangeDescriptions.h"
-#include "EngineInterface/DescriptionHelper.h"
 #include "EngineImpl/SimulationController.h"
 #include "StyleRepository.h"
 #include "Viewport.h"
 #include "Resources.h"
 #include "GlobalSettings.h"
 #include "AlienImGui.h"
+#include "ProgressDialog.h"
 
-_SpatialControlWindow::_SpatialControlWindow(SimulationController const& simController, Viewport const& viewport)
+_SpatialControlWindow::_SpatialControlWindow(
+    SimulationController const& simController,
+    Viewport const& viewport,
+    ProgressDialog const& progressDialog)
     : _simController(simController)
     , _viewport(viewport)
+    , _progressDialog(progressDialog)
 {
     _on = GlobalSettings::getInstance().getBoolState("windows.spatial control.active", true);
 }
@@ -191,22 +194,13 @@ void _SpatialControlWindow::processResizeDialog()
 
 void _SpatialControlWindow::onResizing()
 {
-    auto timestep = static_cast<uint32_t>(_simController->getCurrentTimestep());
-    auto settings = _simController->getSettings();
-    auto symbolMap = _simController->getSymbolMap();
-    auto content = _simController->getSimulationData({0, 0}, _simController->getWorldSize());
-
-    _simController->closeSimulation();
-
-    IntVector2D origWorldSize{settings.generalSettings.worldSizeX, settings.generalSettings.worldSizeY};
-    settings.generalSettings.worldSizeX = _width;
-    settings.generalSettings.worldSizeY = _height;
-    
-    _simController->newSimulation(timestep, settings, symbolMap);
-
-    DescriptionHelper::correctConnections(content, {_width, _height});
-    if (_scaleContent) {
-        DescriptionHelper::duplicate(content, origWorldSize, {_width, _height});
-    }
-    _simController->setSimulationData(content);
+    //the resizing is a single engine call which cannot be interrupted
+    auto simController = _simController;
+    IntVector2D worldSize{_width, _height};
+    auto mode = _scaleContent ? WorldResizeMode::Tile : WorldResizeMode::Remap;
+    _progressDialog->run(
+        "Resizing",
+        [simController, worldSize, mode](_Operation&) { simController->resizeWorld(worldSize, mode); },
+        {},
+        false);
 }
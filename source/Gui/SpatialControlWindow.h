@@ -8,7 +8,10 @@
 class _SpatialControlWindow
 {
 public:
-    _SpatialControlWindow(SimulationController const& simController, Viewport const& viewport);
+    _SpatialControlWindow(
+        SimulationController const& simController,
+        Viewport const& viewport,
+        ProgressDialog const& progressDialog);
     ~_SpatialControlWindow();
 
     void process();
@@ -28,6 +31,7 @@ private:
 
     SimulationController _simController;
     Viewport _viewport;
+    ProgressDialog _progressDialog;
 
     bool _on = false;
     bool _showResizeDialog = false;
@@ -8,25 +8,33 @@
 #include "Base/StringFormatter.h"
 #include "EngineInterface/ChangeDescriptions.h"
 #include "EngineImpl/SimulationController.h"
+#include "EngineImpl/StepHistory.h"
 
 #include "StyleRepository.h"
 #include "Resources.h"
 #include "StatisticsWindow.h"
 #include "GlobalSettings.h"
 #include "AlienImGui.h"
+#include "ProgressDialog.h"
 
 _TemporalControlWindow::_TemporalControlWindow(
     SimulationController const& simController,
-    StatisticsWindow const& statisticsWindow)
+    StatisticsWindow const& statisticsWindow,
+    ProgressDialog const& progressDialog)
     : _simController(simController)
     , _statisticsWindow(statisticsWindow)
+    , _progressDialog(progressDialog)
 {
+    _history = boost::make_shared<_StepHistory>(simController);
     _on = GlobalSettings::getInstance().getBoolState("windows.temporal control.active", true);
+    _historyMemoryBudget = GlobalSettings::getInstance().getIntState("windows.temporal control.history memory", 1024);
+    _history->setMemoryBudget(static_cast<uint64_t>(_historyMemoryBudget) * 1024 * 1024);
 }
 
 _TemporalControlWindow::~_TemporalControlWindow()
 {
     GlobalSettings::getInstance().setBoolState("windows.temporal control.active", _on);
+    GlobalSettings::getInstance().setIntState("windows.temporal control.history memory", _historyMemoryBudget);
 }
 
 void _TemporalControlWindow::process()
@@ -63,6 +71,7 @@ void _TemporalControlWindow::process()
         ImGui::Spacing();
         ImGui::Spacing();
         processTpsRestriction();
+        processHistoryMemory();
     }
     ImGui::EndChild();
 
@@ -117,11 +126,25 @@ void _TemporalControlWindow::processTpsRestriction()
     ImGui::EndDisabled();
 }
 
+void _TemporalControlWindow::processHistoryMemory()
+{
+    ImGui::Text(
+        "Step history: %d steps, %s MB",
+        _history->getNumEntries(),
+        StringFormatter::format(toFloat(_history->getMemorySize()) / (1024 * 1024), 1).c_str());
+    ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x);
+    if (ImGui::SliderInt(
+            "##historyMemory", &_historyMemoryBudget, 16, 16384, "%d MB budget", ImGuiSliderFlags_Logarithmic)) {
+        _history->setMemoryBudget(static_cast<uint64_t>(_historyMemoryBudget) * 1024 * 1024);
+    }
+    ImGui::PopItemWidth();
+}
+
 void _TemporalControlWindow::processRunButton()
 {
     ImGui::BeginDisabled(_simController->isSimulationRunning());
     if(AlienImGui::BeginToolbarButton(ICON_FA_PLAY)) {
-        _history.clear();
+        _history->clear();
         _simController->runSimulation();
     }
     AlienImGui::EndToolbarButton();
@@ -140,12 +163,9 @@ void _TemporalControlWindow::processPauseButton()
 
 void _TemporalControlWindow::processStepBackwardButton()
 {
-    ImGui::BeginDisabled(_history.empty() || _simController->isSimulationRunning());
+    ImGui::BeginDisabled(_history->isEmpty() || _simController->isSimulationRunning());
     if (AlienImGui::BeginToolbarButton(ICON_FA_CHEVRON_LEFT)) {
-        auto const& snapshot = _history.back();
-        _simController->setCurrentTimestep(snapshot.timestep);
-        _simController->setSimulationData(snapshot.data);
-        _history.pop_back();
+        _history->restore();
     }
     AlienImGui::EndToolbarButton();
     ImGui::EndDisabled();
@@ -155,12 +175,7 @@ void _TemporalControlWindow::processStepForwardButton()
 {
     ImGui::BeginDisabled(_simController->isSimulationRunning());
     if (AlienImGui::BeginToolbarButton(ICON_FA_CHEVRON_RIGHT)) {
-        Snapshot newSnapshot;
-        newSnapshot.timestep = _simController->getCurrentTimestep();
-        auto size = _simController->getWorldSize();
-        newSnapshot.data = _simController->getSimulationData({0, 0}, size);
-        _history.emplace_back(newSnapshot);
-
+        _history->push();
         _simController->calcSingleTimestep();
     }
     AlienImGui::EndToolbarButton();
@@ -184,8 +199,18 @@ void _TemporalControlWindow::processRestoreButton()
     ImGui::BeginDisabled(!_snapshot);
     if (AlienImGui::BeginToolbarButton(ICON_FA_UNDO)) {
         _statisticsWindow->reset();
-        _simController->setCurrentTimestep(_snapshot->timestep);
-        _simController->setSimulationData(_snapshot->data);
+
+        //the operation works on its own copy such that a new snapshot cannot interfere
+        auto simController = _simController;
+        auto snapshot = boost::make_shared<Snapshot>(*_snapshot);
+        _progressDialog->run(
+            "Restoring snapshot",
+            [simController, snapshot](_Operation&) {
+                simController->setCurrentTimestep(snapshot->timestep);
+                simController->setSimulationData(snapshot->data);
+            },
+            {},
+            false);
     }
     AlienImGui::EndToolbarButton();
     ImGui::EndDisabled();
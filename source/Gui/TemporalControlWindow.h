@@ -8,7 +8,10 @@
 class _TemporalControlWindow
 {
 public:
-    _TemporalControlWindow(SimulationController const& simController, StatisticsWindow const& statisticsWindow);
+    _TemporalControlWindow(
+        SimulationController const& simController,
+        StatisticsWindow const& statisticsWindow,
+        ProgressDialog const& progressDialog);
     ~_TemporalControlWindow();
 
     void process();
@@ -20,6 +23,7 @@ private:
     void processTpsInfo();
     void processTotalTimestepsInfo();
     void processTpsRestriction();
+    void processHistoryMemory();
 
     void processRunButton();
     void processPauseButton();
@@ -30,6 +34,7 @@ private:
 
     SimulationController _simController; 
     StatisticsWindow _statisticsWindow;
+    ProgressDialog _progressDialog;
 
     struct Snapshot
     {
@@ -38,7 +43,8 @@ private:
     };
     boost::optional<Snapshot> _snapshot;
 
-    std::vector<Snapshot> _history;
+    StepHistory _history;
+    int _historyMemoryBudget = 0;  //in MB
     bool _on = false;
 
     bool _slowDown = false;
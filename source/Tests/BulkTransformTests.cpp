@@ -0,0 +1,174 @@
+#include <cmath>
+#include <map>
+#include <set>
+
+#include "EngineTesting.h"
+#include "Testing.h"
+
+namespace
+{
+    IntVector2D const WorldSize{100, 100};
+
+    struct CellIds
+    {
+        uint64_t atLeftBorder;
+        uint64_t atRightBorder;
+        uint64_t atCenter;
+        uint64_t atTopBorder;
+    };
+
+    //single resting cells near the world boundaries and in the center
+    SimulationController createSimulation(CellIds& cellIds)
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+        auto cellAtLeftBorder = EngineTesting::createCell({2, 50});
+        auto cellAtRightBorder = EngineTesting::createCell({97, 50});
+        auto cellAtCenter = EngineTesting::createCell({50, 50});
+        auto cellAtTopBorder = EngineTesting::createCell({2, 1});
+        cellIds = {cellAtLeftBorder.id, cellAtRightBorder.id, cellAtCenter.id, cellAtTopBorder.id};
+        simController->setSimulationData(DataDescription()
+                                             .addCluster(EngineTesting::createCluster({cellAtLeftBorder}))
+                                             .addCluster(EngineTesting::createCluster({cellAtRightBorder}))
+                                             .addCluster(EngineTesting::createCluster({cellAtCenter}))
+                                             .addCluster(EngineTesting::createCluster({cellAtTopBorder})));
+        return simController;
+    }
+
+    float getEnergy(SimulationController const& simController, uint64_t cellId)
+    {
+        auto cell = EngineTesting::findCell(EngineTesting::getAllData(simController, WorldSize), cellId);
+        EXPECT(cell.has_value());
+        return cell ? cell->energy : 0.0f;
+    }
+
+    bool isScaled(SimulationController const& simController, uint64_t cellId)
+    {
+        return std::abs(getEnergy(simController, cellId) - 50.0f) < 0.01f;
+    }
+
+    bool isUnchanged(SimulationController const& simController, uint64_t cellId)
+    {
+        return std::abs(getEnergy(simController, cellId) - 100.0f) < 0.01f;
+    }
+
+    BulkTransform createEnergyScaling(BulkTransformScope::Type scope)
+    {
+        BulkTransform result;
+        result.operation = BulkTransformOperation::ScaleEnergy;
+        result.scope = scope;
+        result.energyFactor = 0.5f;
+        return result;
+    }
+
+    //regions exceeding the world on either side are continued on the opposite side
+    void testRegionAcrossWorldBoundary()
+    {
+        for (auto regionTopLeftX : {-5.0f, 95.0f}) {
+            CellIds cellIds;
+            auto simController = createSimulation(cellIds);
+            auto transform = createEnergyScaling(BulkTransformScope::Region);
+            transform.regionTopLeftX = regionTopLeftX;
+            transform.regionTopLeftY = 40;
+            transform.regionBottomRightX = regionTopLeftX + 10;
+            transform.regionBottomRightY = 60;
+            simController->applyBulkTransform(transform);
+
+            EXPECT(isScaled(simController, cellIds.atLeftBorder));
+            EXPECT(isScaled(simController, cellIds.atRightBorder));
+            EXPECT(isUnchanged(simController, cellIds.atCenter));
+            EXPECT(isUnchanged(simController, cellIds.atTopBorder));
+        }
+
+        CellIds cellIds;
+        auto simController = createSimulation(cellIds);
+        auto transform = createEnergyScaling(BulkTransformScope::Region);
+        transform.regionTopLeftX = -5;
+        transform.regionTopLeftY = -5;
+        transform.regionBottomRightX = 5;
+        transform.regionBottomRightY = 5;
+        simController->applyBulkTransform(transform);
+
+        EXPECT(isUnchanged(simController, cellIds.atLeftBorder));
+        EXPECT(isUnchanged(simController, cellIds.atRightBorder));
+        EXPECT(isUnchanged(simController, cellIds.atCenter));
+        EXPECT(isScaled(simController, cellIds.atTopBorder));
+    }
+
+    void testSelection()
+    {
+        CellIds cellIds;
+        auto simController = createSimulation(cellIds);
+        simController->setSelection({40, 40}, {60, 60});
+        simController->applyBulkTransform(createEnergyScaling(BulkTransformScope::Selection));
+
+        EXPECT(isUnchanged(simController, cellIds.atLeftBorder));
+        EXPECT(isUnchanged(simController, cellIds.atRightBorder));
+        EXPECT(isScaled(simController, cellIds.atCenter));
+        EXPECT(isUnchanged(simController, cellIds.atTopBorder));
+    }
+
+    std::map<uint64_t, int> getCellColors(SimulationController const& simController)
+    {
+        std::map<uint64_t, int> result;
+        for (auto const& cluster : EngineTesting::getAllData(simController, WorldSize).clusters) {
+            for (auto const& cell : cluster.cells) {
+                result.emplace(cell.id, cell.metadata.color);
+            }
+        }
+        return result;
+    }
+
+    //each cluster gets one of the color codes, which depends only on the seed and the cluster
+    void testColorByCluster()
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+        DataDescription data;
+        for (int i = 0; i < 20; ++i) {
+            RealVector2D pos{10.0f + toFloat(i % 5) * 15, 10.0f + toFloat(i / 5) * 15};
+            auto cell1 = EngineTesting::createCell(pos);
+            auto cell2 = EngineTesting::createCell(pos + RealVector2D{1, 0});
+            auto cluster = EngineTesting::createCluster({cell1, cell2});
+            std::unordered_map<uint64_t, int> cache;
+            cluster.addConnection(cell1.id, cell2.id, cache);
+            data.addCluster(cluster);
+        }
+        simController->setSimulationData(data);
+
+        BulkTransform transform;
+        transform.operation = BulkTransformOperation::SetColorByCluster;
+        transform.numColorCodes = 2;
+        transform.colorCodes[0] = 2;
+        transform.colorCodes[1] = 5;
+        transform.seed = 7;
+        simController->applyBulkTransform(transform);
+
+        auto colors = getCellColors(simController);
+        EXPECT(40 == colors.size());
+        std::set<int> usedColors;
+        for (auto const& cluster : EngineTesting::getAllData(simController, WorldSize).clusters) {
+            EXPECT(2 == cluster.cells.size());
+            for (auto const& cell : cluster.cells) {
+                EXPECT(colors.at(cell.id) == colors.at(cluster.cells.front().id));
+                usedColors.insert(colors.at(cell.id));
+            }
+        }
+        EXPECT((std::set<int>{2, 5}) == usedColors);
+
+        simController->applyBulkTransform(transform);
+        EXPECT(getCellColors(simController) == colors);
+
+        auto otherSimController =
+            EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+        otherSimController->setSimulationData(data);
+        otherSimController->applyBulkTransform(transform);
+        EXPECT(getCellColors(otherSimController) == colors);
+    }
+}
+
+int main()
+{
+    Testing::run("region across world boundary", testRegionAcrossWorldBoundary);
+    Testing::run("selection", testSelection);
+    Testing::run("color by cluster", testColorByCluster);
+    return Testing::getExitCode();
+}
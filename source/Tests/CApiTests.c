@@ -0,0 +1,157 @@
+/* Tests the C API from C code such that the header is checked to be valid C */
+
+#include <math.h>
+#include <stdio.h>
+
+#include "EngineCApi/AlienCApi.h"
+
+static int numFailures = 0;
+
+#define EXPECT(condition) \
+    do { \
+        if (!(condition)) { \
+            ++numFailures; \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        } \
+    } while (0)
+
+static char const* const MaxVelocityKey = "simulation parameters.cell.max velocity";
+static char const* const RadiationFactorKey = "simulation parameters.radiation.factor";
+static char const* const MaxBondsKey = "simulation parameters.cell.max bonds";
+static char const* const SuppressMemoryCopyKey =
+    "simulation parameters.cell.function.constructor.offspring.token suppress memory copy";
+static char const* const NumSpotsKey = "simulation parameters.spots.num spots";
+
+static double getParameter(AlienSimulation* simulation, char const* key)
+{
+    double result = -1.0;
+    EXPECT(alien_get_parameter(simulation, key, &result) == ALIEN_OK);
+    return result;
+}
+
+/* values are stored with the precision of the parameter type */
+static void testFloatParameters(AlienSimulation* simulation)
+{
+    EXPECT(alien_set_parameter(simulation, MaxVelocityKey, 1.2345678) == ALIEN_OK);
+    EXPECT(getParameter(simulation, MaxVelocityKey) == (double)(float)1.2345678);
+
+    EXPECT(alien_set_parameter(simulation, RadiationFactorKey, 1.5e-7) == ALIEN_OK);
+    EXPECT(getParameter(simulation, RadiationFactorKey) == (double)(float)1.5e-7);
+
+    /* an integral value does not turn the parameter into an integer */
+    EXPECT(alien_set_parameter(simulation, MaxVelocityKey, 2.0) == ALIEN_OK);
+    EXPECT(alien_set_parameter(simulation, MaxVelocityKey, 2.5) == ALIEN_OK);
+    EXPECT(getParameter(simulation, MaxVelocityKey) == 2.5);
+
+    EXPECT(alien_set_parameter(simulation, MaxVelocityKey, HUGE_VAL) == ALIEN_ERROR_INVALID_ARGUMENT);
+    EXPECT(alien_set_parameter(simulation, MaxVelocityKey, 1e300) == ALIEN_ERROR_INVALID_ARGUMENT);
+    EXPECT(getParameter(simulation, MaxVelocityKey) == 2.5);
+}
+
+static void testIntegerParameters(AlienSimulation* simulation)
+{
+    EXPECT(alien_set_parameter(simulation, MaxBondsKey, 4.0) == ALIEN_OK);
+    EXPECT(getParameter(simulation, MaxBondsKey) == 4.0);
+
+    EXPECT(alien_set_parameter(simulation, MaxBondsKey, 4.5) == ALIEN_ERROR_INVALID_ARGUMENT);
+    EXPECT(alien_set_parameter(simulation, MaxBondsKey, 1e10) == ALIEN_ERROR_INVALID_ARGUMENT);
+    EXPECT(getParameter(simulation, MaxBondsKey) == 4.0);
+
+    EXPECT(alien_set_parameter(simulation, NumSpotsKey, 1.0) == ALIEN_OK);
+    EXPECT(getParameter(simulation, NumSpotsKey) == 1.0);
+}
+
+static void testBoolParameters(AlienSimulation* simulation)
+{
+    EXPECT(alien_set_parameter(simulation, SuppressMemoryCopyKey, 1.0) == ALIEN_OK);
+    EXPECT(getParameter(simulation, SuppressMemoryCopyKey) == 1.0);
+    EXPECT(alien_set_parameter(simulation, SuppressMemoryCopyKey, 0.0) == ALIEN_OK);
+    EXPECT(getParameter(simulation, SuppressMemoryCopyKey) == 0.0);
+}
+
+static void testUnknownParameters(AlienSimulation* simulation)
+{
+    double value;
+    EXPECT(alien_get_parameter(simulation, "simulation parameters.unknown", &value) == ALIEN_ERROR_UNKNOWN_PARAMETER);
+    EXPECT(alien_set_parameter(simulation, "simulation parameters.unknown", 1.0) == ALIEN_ERROR_UNKNOWN_PARAMETER);
+    EXPECT(alien_set_parameter(simulation, "general.world size.x", 10.0) == ALIEN_ERROR_UNKNOWN_PARAMETER);
+    EXPECT(alien_set_parameter(simulation, NULL, 1.0) == ALIEN_ERROR_INVALID_ARGUMENT);
+}
+
+/* the parameters are applied before the next time step is calculated */
+static void testTimestepsAfterChange(AlienSimulation* simulation)
+{
+    uint64_t timestep = 0;
+    EXPECT(alien_set_parameter(simulation, MaxVelocityKey, 3.0) == ALIEN_OK);
+    EXPECT(alien_calc_timesteps(simulation, 2) == ALIEN_OK);
+    EXPECT(alien_get_timestep(simulation, &timestep) == ALIEN_OK);
+    EXPECT(timestep == 2);
+    EXPECT(getParameter(simulation, MaxVelocityKey) == 3.0);
+}
+
+static void testCheckpoints(AlienSimulation* simulation)
+{
+    char const* const filename = "alien_c_api_tests_checkpoint.sim";
+    AlienSimulation* loadedSimulation = NULL;
+    uint64_t timestep = 0;
+
+    EXPECT(alien_calc_timesteps(simulation, 5) == ALIEN_OK);
+    EXPECT(alien_write_checkpoint(simulation, filename) == ALIEN_OK);
+    EXPECT(alien_calc_timesteps(simulation, 5) == ALIEN_OK);
+    EXPECT(alien_write_checkpoint(simulation, filename) == ALIEN_OK);
+
+    /* the empty world has not changed since the base has been written */
+    EXPECT(alien_load_checkpoint(filename, &loadedSimulation) == ALIEN_OK);
+    if (loadedSimulation) {
+        EXPECT(alien_get_timestep(loadedSimulation, &timestep) == ALIEN_OK);
+        EXPECT(timestep == 5);
+        alien_destroy_simulation(loadedSimulation);
+    }
+    EXPECT(alien_load_checkpoint("missing.sim", &loadedSimulation) == ALIEN_ERROR_INVALID_ARGUMENT);
+}
+
+/* an empty set of color codes is rejected, other operations ignore the color codes */
+static void testBulkTransformArguments(AlienSimulation* simulation)
+{
+    AlienBulkTransform transform = {0};
+    transform.operation = ALIEN_TRANSFORM_SET_COLOR_BY_CLUSTER;
+    transform.scope = ALIEN_SCOPE_ALL;
+    EXPECT(alien_apply_bulk_transform(simulation, &transform) == ALIEN_ERROR_INVALID_ARGUMENT);
+    transform.numColorCodes = 8;
+    EXPECT(alien_apply_bulk_transform(simulation, &transform) == ALIEN_ERROR_INVALID_ARGUMENT);
+    transform.numColorCodes = 2;
+    transform.colorCodes[0] = 1;
+    transform.colorCodes[1] = 4;
+    EXPECT(alien_apply_bulk_transform(simulation, &transform) == ALIEN_OK);
+
+    transform.operation = ALIEN_TRANSFORM_SCALE_ENERGY;
+    transform.numColorCodes = 0;
+    transform.energyFactor = 0.5f;
+    EXPECT(alien_apply_bulk_transform(simulation, &transform) == ALIEN_OK);
+}
+
+static void run(char const* name, void (*test)(AlienSimulation*))
+{
+    int numFailuresBefore = numFailures;
+    AlienSimulation* simulation = NULL;
+    if (alien_create_simulation(100, 100, &simulation) != ALIEN_OK) {
+        ++numFailures;
+        fprintf(stderr, "%s: could not create simulation: %s\n", name, alien_get_last_error());
+    } else {
+        test(simulation);
+        alien_destroy_simulation(simulation);
+    }
+    printf("%s %s\n", numFailuresBefore == numFailures ? "[  OK  ]" : "[FAILED]", name);
+}
+
+int main(void)
+{
+    run("float parameters", testFloatParameters);
+    run("integer parameters", testIntegerParameters);
+    run("bool parameters", testBoolParameters);
+    run("unknown parameters", testUnknownParameters);
+    run("time steps after change", testTimestepsAfterChange);
+    run("checkpoints", testCheckpoints);
+    run("bulk transform arguments", testBulkTransformArguments);
+    return numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+#include <random>
+#include <vector>
+
+#include "EngineGpuKernels/CellComputerFunction.cuh"
+
+#include "CellComputerTesting.h"
+#include "Testing.h"
+
+using namespace CellComputerTesting;
+
+namespace
+{
+    int const NumBlocks = 64;
+    int const NumThreadsPerBlock = 32;
+
+    __global__ void processTokens(Array<Token*> tokens, SimulationData data)
+    {
+        auto const partition = calcAllThreadsPartition(tokens.getNumEntries());
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            CellComputerFunction::processing(tokens.at(index), data);
+        }
+    }
+
+    /**
+     * Executes each computation with CellComputerFunction by a token on a separate computer cell on the device.
+     * The cells keep their decoded programs between the executions as in the engine.
+     */
+    class DeviceCellComputer
+    {
+    public:
+        DeviceCellComputer(std::vector<CellComputerComputation> const& computations, int programPoolSize)
+            : _numComputations(static_cast<int>(computations.size()))
+        {
+            GpuSettings gpuSettings;
+            gpuSettings.NUM_BLOCKS = NumBlocks;
+            gpuSettings.NUM_THREADS_PER_BLOCK = NumThreadsPerBlock;
+            CHECK_FOR_CUDA_ERROR(cudaMemcpyToSymbol(gpuConstants, &gpuSettings, sizeof(GpuSettings)));
+
+            _cells.init();
+            _cells.resize(_numComputations);
+            _cells.setNumEntries_host(_numComputations);
+            _tokens.init();
+            _tokens.resize(_numComputations);
+            _tokens.setNumEntries_host(_numComputations);
+            _tokenPointers.init();
+            _tokenPointers.resize(_numComputations);
+            _tokenPointers.setNumEntries_host(_numComputations);
+            _tokenMemory.init();
+            _tokenMemory.resize(_numComputations * MAX_TOKEN_MEM_SIZE);
+            _data.entities.computerPrograms.init();
+            _data.entities.computerPrograms.resize(programPoolSize);
+
+            std::vector<Cell> cells(_numComputations);
+            std::vector<Token> tokens(_numComputations);
+            std::vector<Token*> tokenPointers;
+            for (int i = 0; i < _numComputations; ++i) {
+                auto const& staticData = computations[i].staticData;
+                auto& cell = cells[i];
+                cell.cellFunctionType = Enums::CellFunction::COMPUTER;
+                cell.numStaticBytes = std::min(static_cast<int>(staticData.size()), MAX_CELL_STATIC_BYTES);
+                std::fill(std::begin(cell.staticData), std::end(cell.staticData), 0);
+                std::copy(staticData.begin(), staticData.begin() + cell.numStaticBytes, cell.staticData);
+                cell.computerProgram = nullptr;
+
+                auto& token = tokens[i];
+                token.memory = _tokenMemory.getArray_host() + i * MAX_TOKEN_MEM_SIZE;
+                token.cell = _cells.getArray_host() + i;
+                token.sourceCell = token.cell;
+                tokenPointers.emplace_back(_tokens.getArray_host() + i);
+            }
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                _cells.getArray_host(), cells.data(), sizeof(Cell) * _numComputations, cudaMemcpyHostToDevice));
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                _tokens.getArray_host(), tokens.data(), sizeof(Token) * _numComputations, cudaMemcpyHostToDevice));
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                _tokenPointers.getArray_host(),
+                tokenPointers.data(),
+                sizeof(Token*) * _numComputations,
+                cudaMemcpyHostToDevice));
+        }
+
+        ~DeviceCellComputer()
+        {
+            _cells.free();
+            _tokens.free();
+            _tokenPointers.free();
+            _tokenMemory.free();
+            _data.entities.computerPrograms.free();
+        }
+
+        //the memories of the computations are resized as in CellComputerBatchInterpreter
+        void process(SimulationParameters const& parameters, std::vector<CellComputerComputation>& computations)
+        {
+            CHECK_FOR_CUDA_ERROR(
+                cudaMemcpyToSymbol(cudaSimulationParameters, &parameters, sizeof(SimulationParameters)));
+
+            std::vector<char> tokenMemory(_numComputations * MAX_TOKEN_MEM_SIZE, 0);
+            std::vector<Cell> cells(_numComputations);
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                cells.data(), _cells.getArray_host(), sizeof(Cell) * _numComputations, cudaMemcpyDeviceToHost));
+            for (int i = 0; i < _numComputations; ++i) {
+                auto& computation = computations[i];
+                computation.tokenMemory.resize(parameters.tokenMemorySize, 0);
+                computation.cellMemory.resize(parameters.cellFunctionComputerCellMemorySize, 0);
+                std::copy(
+                    computation.tokenMemory.begin(),
+                    computation.tokenMemory.end(),
+                    tokenMemory.begin() + i * MAX_TOKEN_MEM_SIZE);
+                std::fill(std::begin(cells[i].mutableData), std::end(cells[i].mutableData), 0);
+                std::copy(computation.cellMemory.begin(), computation.cellMemory.end(), cells[i].mutableData);
+            }
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                _tokenMemory.getArray_host(), tokenMemory.data(), tokenMemory.size(), cudaMemcpyHostToDevice));
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                _cells.getArray_host(), cells.data(), sizeof(Cell) * _numComputations, cudaMemcpyHostToDevice));
+
+            processTokens<<<NumBlocks, NumThreadsPerBlock>>>(_tokenPointers, _data);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                tokenMemory.data(), _tokenMemory.getArray_host(), tokenMemory.size(), cudaMemcpyDeviceToHost));
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                cells.data(), _cells.getArray_host(), sizeof(Cell) * _numComputations, cudaMemcpyDeviceToHost));
+            for (int i = 0; i < _numComputations; ++i) {
+                auto& computation = computations[i];
+                auto tokenMemoryOfComputation = tokenMemory.begin() + i * MAX_TOKEN_MEM_SIZE;
+                std::copy(
+                    tokenMemoryOfComputation,
+                    tokenMemoryOfComputation + parameters.tokenMemorySize,
+                    computation.tokenMemory.begin());
+                std::copy(
+                    cells[i].mutableData,
+                    cells[i].mutableData + parameters.cellFunctionComputerCellMemorySize,
+                    computation.cellMemory.begin());
+            }
+        }
+
+        int getNumDecodedPrograms() const { return _data.entities.computerPrograms.getNumEntries_host(); }
+
+    private:
+        int _numComputations;
+        Array<Cell> _cells;
+        Array<Token> _tokens;
+        Array<Token*> _tokenPointers;
+        Array<char> _tokenMemory;
+        SimulationData _data;
+    };
+
+    SimulationParameters createParameters(int tokenMemorySize, int maxInstructions)
+    {
+        SimulationParameters result;
+        result.tokenMemorySize = tokenMemorySize;
+        result.cellFunctionComputerMaxInstructions = maxInstructions;
+        return result;
+    }
+
+    std::vector<CellComputerComputation>
+    createRandomComputations(std::mt19937& generator, int numComputations, SimulationParameters const& parameters)
+    {
+        std::vector<CellComputerComputation> result;
+        for (int i = 0; i < numComputations; ++i) {
+            result.emplace_back(CellComputerComputation{
+                createRandomCode(generator, 16),
+                createRandomMemory(generator, parameters.tokenMemorySize),
+                createRandomMemory(generator, parameters.cellFunctionComputerCellMemorySize)});
+        }
+        return result;
+    }
+
+    void processByLegacy(SimulationParameters const& parameters, std::vector<CellComputerComputation>& computations)
+    {
+        LegacyCellComputer legacy(
+            parameters.tokenMemorySize,
+            parameters.cellFunctionComputerCellMemorySize,
+            parameters.cellFunctionComputerMaxInstructions);
+        for (auto& computation : computations) {
+            computation.tokenMemory.resize(parameters.tokenMemorySize, 0);
+            computation.cellMemory.resize(parameters.cellFunctionComputerCellMemorySize, 0);
+            legacy.process(computation);
+        }
+    }
+
+    bool isEqual(
+        std::vector<CellComputerComputation> const& computations,
+        std::vector<CellComputerComputation> const& expected)
+    {
+        for (int i = 0; i < static_cast<int>(computations.size()); ++i) {
+            if (computations[i].tokenMemory != expected[i].tokenMemory
+                || computations[i].cellMemory != expected[i].cellMemory) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //the second execution uses the programs which have been decoded in the first one
+    void testRandomPrograms()
+    {
+        std::mt19937 generator(1234);
+        for (int tokenMemorySize : {64, 100, 256}) {
+            for (int maxInstructions : {5, 15, 16}) {
+                auto parameters = createParameters(tokenMemorySize, maxInstructions);
+                auto computations = createRandomComputations(generator, 500, parameters);
+                DeviceCellComputer device(computations, 500);
+                for (int execution = 0; execution < 2; ++execution) {
+                    auto expected = computations;
+                    processByLegacy(parameters, expected);
+                    device.process(parameters, computations);
+                    EXPECT(isEqual(computations, expected));
+                    EXPECT(500 == device.getNumDecodedPrograms());
+                }
+            }
+        }
+    }
+
+    //the decoded programs depend on the parameters and are decoded again in place
+    void testChangedParameters()
+    {
+        std::mt19937 generator(42);
+        auto parameters = createParameters(64, 15);
+        auto computations = createRandomComputations(generator, 200, parameters);
+        DeviceCellComputer device(computations, 200);
+        device.process(parameters, computations);
+
+        for (auto const& changedParameters : {createParameters(100, 15), createParameters(100, 5)}) {
+            auto expected = computations;
+            processByLegacy(changedParameters, expected);
+            device.process(changedParameters, computations);
+            EXPECT(isEqual(computations, expected));
+            EXPECT(200 == device.getNumDecodedPrograms());
+        }
+
+        auto cellMemoryParameters = createParameters(100, 5);
+        cellMemoryParameters.cellFunctionComputerCellMemorySize /= 2;
+        auto expected = computations;
+        processByLegacy(cellMemoryParameters, expected);
+        device.process(cellMemoryParameters, computations);
+        EXPECT(isEqual(computations, expected));
+    }
+
+    //computer cells without a pool entry decode their programs on every execution
+    void testExhaustedProgramPool()
+    {
+        std::mt19937 generator(7);
+        auto parameters = createParameters(64, 15);
+        auto computations = createRandomComputations(generator, 300, parameters);
+        DeviceCellComputer device(computations, 100);
+        for (int execution = 0; execution < 2; ++execution) {
+            auto expected = computations;
+            processByLegacy(parameters, expected);
+            device.process(parameters, computations);
+            EXPECT(isEqual(computations, expected));
+            EXPECT(100 == device.getNumDecodedPrograms());
+        }
+    }
+}
+
+int main()
+{
+    Testing::run("random programs against legacy interpreter", testRandomPrograms);
+    Testing::run("changed parameters", testChangedParameters);
+    Testing::run("exhausted program pool", testExhaustedProgramPool);
+    return Testing::getExitCode();
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "EngineInterface/ElementaryTypes.h"
+#include "EngineImpl/CellComputerBatchInterpreter.h"
+#include "EngineGpuKernels/AccessTOs.cuh"
+
+/**
+ * Reference interpreter and random programs for the tests of the host and device cell computers.
+ */
+namespace CellComputerTesting
+{
+    /**
+     * Interpreter which decodes the machine code on every execution and evaluates conditions via a condition table.
+     * It is a host port of CellComputerFunction before programs were pre-decoded and serves as reference.
+     */
+    class LegacyCellComputer
+    {
+    public:
+        LegacyCellComputer(int tokenMemorySize, int cellMemorySize, int maxInstructions)
+            : _tokenMemorySize(tokenMemorySize)
+            , _cellMemorySize(cellMemorySize)
+            , _maxInstructions(maxInstructions)
+        {}
+
+        void process(CellComputerComputation& computation) const
+        {
+            std::string staticData = computation.staticData;
+            staticData.resize(MAX_CELL_STATIC_BYTES, 0);
+            auto tokenMemory = computation.tokenMemory.data();
+            auto cellMemory = computation.cellMemory.data();
+
+            bool condTable[MAX_CELL_STATIC_BYTES / 3 + 1];
+            int condPointer(0);
+            int numStaticBytes = std::min(static_cast<int>(computation.staticData.size()), _maxInstructions * 3);
+            for (int instructionPointer = 0; instructionPointer < numStaticBytes;) {
+
+                //decode instruction
+                InstructionCoded instruction;
+                readInstruction(staticData.data(), instructionPointer, instruction);
+
+                //operand 1: pointer to mem
+                uint8_t opPointer1 = 0;
+                bool isCellMemory = false;
+                if (instruction.opType1 == Enums::ComputerOptype::MEM) {
+                    opPointer1 = convertToAddress(instruction.operand1, _tokenMemorySize);
+                }
+                if (instruction.opType1 == Enums::ComputerOptype::MEMMEM) {
+                    instruction.operand1 = tokenMemory[convertToAddress(instruction.operand1, _tokenMemorySize)];
+                    opPointer1 = convertToAddress(instruction.operand1, _tokenMemorySize);
+                }
+                if (instruction.opType1 == Enums::ComputerOptype::CMEM) {
+                    opPointer1 = convertToAddress(instruction.operand1, _cellMemorySize);
+                    isCellMemory = true;
+                }
+                auto& target = isCellMemory ? cellMemory[opPointer1] : tokenMemory[opPointer1];
+
+                //operand 2: loading value
+                if (instruction.opType2 == Enums::ComputerOptype::MEM) {
+                    instruction.operand2 = tokenMemory[convertToAddress(instruction.operand2, _tokenMemorySize)];
+                }
+                if (instruction.opType2 == Enums::ComputerOptype::MEMMEM) {
+                    instruction.operand2 = tokenMemory[convertToAddress(instruction.operand2, _tokenMemorySize)];
+                    instruction.operand2 = tokenMemory[convertToAddress(instruction.operand2, _tokenMemorySize)];
+                }
+                if (instruction.opType2 == Enums::ComputerOptype::CMEM) {
+                    instruction.operand2 = cellMemory[convertToAddress(instruction.operand2, _cellMemorySize)];
+                }
+
+                //execute instruction
+                bool execute = true;
+                for (int k = 0; k < condPointer; ++k) {
+                    if (!condTable[k]) {
+                        execute = false;
+                    }
+                }
+                if (execute) {
+                    auto operand1 = static_cast<int8_t>(target);
+                    switch (instruction.operation) {
+                    case Enums::ComputerOperation::MOV:
+                        target = instruction.operand2;
+                        break;
+                    case Enums::ComputerOperation::ADD:
+                        target = operand1 + instruction.operand2;
+                        break;
+                    case Enums::ComputerOperation::SUB:
+                        target = operand1 - instruction.operand2;
+                        break;
+                    case Enums::ComputerOperation::MUL:
+                        target = operand1 * instruction.operand2;
+                        break;
+                    case Enums::ComputerOperation::DIV:
+                        target = instruction.operand2 > 0 ? operand1 / instruction.operand2 : 0;
+                        break;
+                    case Enums::ComputerOperation::XOR:
+                        target = operand1 ^ instruction.operand2;
+                        break;
+                    case Enums::ComputerOperation::OR:
+                        target = operand1 | instruction.operand2;
+                        break;
+                    case Enums::ComputerOperation::AND:
+                        target = operand1 & instruction.operand2;
+                        break;
+                    default:
+                        break;
+                    }
+                }
+
+                //if instructions
+                instruction.operand1 = static_cast<uint8_t>(target);
+                switch (instruction.operation) {
+                case Enums::ComputerOperation::IFG:
+                    condTable[condPointer++] = instruction.operand1 > instruction.operand2;
+                    break;
+                case Enums::ComputerOperation::IFGE:
+                    condTable[condPointer++] = instruction.operand1 >= instruction.operand2;
+                    break;
+                case Enums::ComputerOperation::IFE:
+                    condTable[condPointer++] = instruction.operand1 == instruction.operand2;
+                    break;
+                case Enums::ComputerOperation::IFNE:
+                    condTable[condPointer++] = instruction.operand1 != instruction.operand2;
+                    break;
+                case Enums::ComputerOperation::IFLE:
+                    condTable[condPointer++] = instruction.operand1 <= instruction.operand2;
+                    break;
+                case Enums::ComputerOperation::IFL:
+                    condTable[condPointer++] = instruction.operand1 < instruction.operand2;
+                    break;
+                case Enums::ComputerOperation::ELSE:
+                    if (condPointer > 0) {
+                        condTable[condPointer - 1] = !condTable[condPointer - 1];
+                    }
+                    break;
+                case Enums::ComputerOperation::ENDIF:
+                    if (condPointer > 0) {
+                        condPointer--;
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+    private:
+        static void readInstruction(char const* data, int& instructionPointer, InstructionCoded& instructionCoded)
+        {
+            //machine code: [INSTR - 4 Bits][MEM/ADDR/CMEM - 2 Bit][MEM/ADDR/CMEM/CONST - 2 Bit]
+            instructionCoded.operation =
+                static_cast<Enums::ComputerOperation::Type>((data[instructionPointer] >> 4) & 0xF);
+            instructionCoded.opType1 =
+                static_cast<Enums::ComputerOptype::Type>(((data[instructionPointer] >> 2) & 0x3) % 3);
+            instructionCoded.opType2 = static_cast<Enums::ComputerOptype::Type>(data[instructionPointer] & 0x3);
+            instructionCoded.operand1 = data[instructionPointer + 1];
+            instructionCoded.operand2 = data[instructionPointer + 2];
+            instructionPointer += 3;
+        }
+
+        static uint8_t convertToAddress(int8_t addr, uint32_t size)
+        {
+            auto t = static_cast<uint32_t>(static_cast<uint8_t>(addr));
+            return ((t % size) + size) % size;
+        }
+
+        int _tokenMemorySize;
+        int _cellMemorySize;
+        int _maxInstructions;
+    };
+
+    inline char encodeInstruction(int operation, int opType1, int opType2)
+    {
+        return static_cast<char>((operation << 4) | (opType1 << 2) | opType2);
+    }
+
+    //conditional instructions are overrepresented to obtain deeply nested blocks
+    inline std::string createRandomCode(std::mt19937& generator, int numInstructions, bool indirectAddressing = true)
+    {
+        std::uniform_int_distribution<int> operationDistribution(0, 23);
+        std::uniform_int_distribution<int> opTypeDistribution(0, 3);
+        std::uniform_int_distribution<int> byteDistribution(0, 255);
+        std::string result;
+        for (int i = 0; i < numInstructions; ++i) {
+            auto operation = operationDistribution(generator);
+            if (operation > Enums::ComputerOperation::ENDIF) {
+                operation = Enums::ComputerOperation::IFG + (operation - Enums::ComputerOperation::ENDIF - 1) % 8;
+            }
+            auto opType1 = opTypeDistribution(generator);
+            auto opType2 = opTypeDistribution(generator);
+            if (!indirectAddressing) {
+                opType1 = opType1 == Enums::ComputerOptype::MEMMEM ? Enums::ComputerOptype::MEM : opType1;
+                opType2 = opType2 == Enums::ComputerOptype::MEMMEM ? Enums::ComputerOptype::CMEM : opType2;
+            }
+            result.push_back(encodeInstruction(operation, opType1, opType2));
+            result.push_back(static_cast<char>(byteDistribution(generator)));
+            result.push_back(static_cast<char>(byteDistribution(generator)));
+        }
+        return result;
+    }
+
+    //small values make equal operands and thus both branches of conditions likely
+    inline std::string createRandomMemory(std::mt19937& generator, int size)
+    {
+        std::uniform_int_distribution<int> byteDistribution(0, 3);
+        std::uniform_int_distribution<int> largeByteDistribution(0, 255);
+        std::string result;
+        for (int i = 0; i < size; ++i) {
+            auto value = i % 5 == 0 ? largeByteDistribution(generator) : byteDistribution(generator);
+            result.push_back(static_cast<char>(value));
+        }
+        return result;
+    }
+}
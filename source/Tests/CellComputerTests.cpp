@@ -0,0 +1,195 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Base/Definitions.h"
+#include "EngineImpl/CellComputerBatchInterpreter.h"
+#include "EngineGpuKernels/CellComputerProgram.cuh"
+
+#include "CellComputerTesting.h"
+#include "Testing.h"
+
+using namespace CellComputerTesting;
+
+namespace
+{
+    CellComputerInstructionSet::Type const AllInstructionSets[] = {
+        CellComputerInstructionSet::Scalar, CellComputerInstructionSet::Avx2, CellComputerInstructionSet::Avx512};
+
+    SimulationParameters createParameters(int tokenMemorySize, int maxInstructions)
+    {
+        SimulationParameters result;
+        result.tokenMemorySize = tokenMemorySize;
+        result.cellFunctionComputerMaxInstructions = maxInstructions;
+        return result;
+    }
+
+    void checkAgainstLegacy(SimulationParameters const& parameters, std::vector<CellComputerComputation> computations)
+    {
+        LegacyCellComputer legacy(
+            parameters.tokenMemorySize,
+            parameters.cellFunctionComputerCellMemorySize,
+            parameters.cellFunctionComputerMaxInstructions);
+        auto expected = computations;
+        for (auto& computation : expected) {
+            computation.tokenMemory.resize(parameters.tokenMemorySize, 0);
+            computation.cellMemory.resize(parameters.cellFunctionComputerCellMemorySize, 0);
+            legacy.process(computation);
+        }
+        auto sequential = computations;
+        CellComputerBatchInterpreter(parameters).processSequentially(sequential);
+        for (int i = 0; i < toInt(computations.size()); ++i) {
+            EXPECT(expected[i].tokenMemory == sequential[i].tokenMemory);
+            EXPECT(expected[i].cellMemory == sequential[i].cellMemory);
+        }
+
+        for (auto instructionSet : AllInstructionSets) {
+            if (!CellComputerBatchInterpreter::isSupported(instructionSet)) {
+                continue;
+            }
+            auto batched = computations;
+            CellComputerBatchInterpreter(parameters, instructionSet).process(batched);
+            for (int i = 0; i < toInt(computations.size()); ++i) {
+                EXPECT(expected[i].tokenMemory == batched[i].tokenMemory);
+                EXPECT(expected[i].cellMemory == batched[i].cellMemory);
+            }
+        }
+    }
+
+    void testNestedConditions()
+    {
+        using Op = Enums::ComputerOperation;
+        using Type = Enums::ComputerOptype;
+
+        //if ([0] > 1) { if ([1] == 2) {[2] = 7} else {[2] = 8} } else {[3] = 9} [4] += 1
+        std::string code = {
+            encodeInstruction(Op::IFG, Type::MEM, Type::CONSTANT), 0, 1,
+            encodeInstruction(Op::IFE, Type::MEM, Type::CONSTANT), 1, 2,
+            encodeInstruction(Op::MOV, Type::MEM, Type::CONSTANT), 2, 7,
+            encodeInstruction(Op::ELSE, 0, 0), 0, 0,
+            encodeInstruction(Op::MOV, Type::MEM, Type::CONSTANT), 2, 8,
+            encodeInstruction(Op::ENDIF, 0, 0), 0, 0,
+            encodeInstruction(Op::ELSE, 0, 0), 0, 0,
+            encodeInstruction(Op::MOV, Type::MEM, Type::CONSTANT), 3, 9,
+            encodeInstruction(Op::ENDIF, 0, 0), 0, 0,
+            encodeInstruction(Op::ADD, Type::MEM, Type::CONSTANT), 4, 1};
+
+        std::vector<CellComputerComputation> computations;
+        for (char first : {0, 2}) {
+            for (char second : {0, 2}) {
+                computations.emplace_back(CellComputerComputation{code, std::string{first, second}, ""});
+            }
+        }
+        checkAgainstLegacy(createParameters(64, 15), computations);
+
+        CellComputerBatchInterpreter interpreter(createParameters(64, 15));
+        interpreter.processSequentially(computations);
+        EXPECT(computations[0].tokenMemory[3] == 9);
+        EXPECT(computations[2].tokenMemory[2] == 8);
+        EXPECT(computations[3].tokenMemory[2] == 7);
+        EXPECT(computations[3].tokenMemory[3] == 0);
+        EXPECT(computations[3].tokenMemory[4] == 1);
+    }
+
+    void testUnmatchedBlocks()
+    {
+        using Op = Enums::ComputerOperation;
+        using Type = Enums::ComputerOptype;
+
+        //ENDIF and ELSE without a condition are ignored, an unclosed condition covers the rest of the program
+        std::string code = {
+            encodeInstruction(Op::ENDIF, 0, 0), 0, 0,
+            encodeInstruction(Op::ELSE, 0, 0), 0, 0,
+            encodeInstruction(Op::MOV, Type::MEM, Type::CONSTANT), 1, 5,
+            encodeInstruction(Op::IFE, Type::MEM, Type::CONSTANT), 0, 1,
+            encodeInstruction(Op::MOV, Type::MEM, Type::CONSTANT), 2, 6,
+            encodeInstruction(Op::ELSE, 0, 0), 0, 0,
+            encodeInstruction(Op::ELSE, 0, 0), 0, 0,
+            encodeInstruction(Op::MOV, Type::MEM, Type::CONSTANT), 3, 7};
+        checkAgainstLegacy(
+            createParameters(64, 15),
+            {CellComputerComputation{code, std::string{0}, ""}, CellComputerComputation{code, std::string{1}, ""}});
+    }
+
+    //indirect accesses in lockstep go to the transposed bytes if their addresses are also accessed directly
+    void testIndirectAddressing()
+    {
+        using Op = Enums::ComputerOperation;
+        using Type = Enums::ComputerOptype;
+
+        //[[0]] += [1], [2] = [[3]], [1] += 1, [[2]] = [1]
+        std::string code = {
+            encodeInstruction(Op::ADD, Type::MEMMEM, Type::MEM), 0, 1,
+            encodeInstruction(Op::MOV, Type::MEM, Type::MEMMEM), 2, 3,
+            encodeInstruction(Op::ADD, Type::MEM, Type::CONSTANT), 1, 1,
+            encodeInstruction(Op::MOV, Type::MEMMEM, Type::MEM), 2, 1};
+
+        std::vector<CellComputerComputation> computations;
+        for (int i = 0; i < 45; ++i) {
+            std::string tokenMemory(64, 0);
+            tokenMemory[0] = static_cast<char>(i % 5);
+            tokenMemory[1] = static_cast<char>(i);
+            tokenMemory[3] = static_cast<char>(i % 3 == 0 ? 1 : 10 + i);
+            tokenMemory[10 + i] = static_cast<char>(i % 4);
+            computations.emplace_back(CellComputerComputation{code, tokenMemory, ""});
+        }
+        checkAgainstLegacy(createParameters(64, 15), computations);
+    }
+
+    void testRandomPrograms()
+    {
+        std::mt19937 generator(1234);
+        for (int tokenMemorySize : {64, 100, 256}) {
+            for (int maxInstructions : {5, 15, 16}) {
+                auto parameters = createParameters(tokenMemorySize, maxInstructions);
+                for (int program = 0; program < 200; ++program) {
+                    //programs with and without indirect addressing
+                    auto code = createRandomCode(generator, 16, program % 2 == 0);
+
+                    //identical code in several computations exercises the lockstep execution
+                    std::vector<CellComputerComputation> computations;
+                    for (int i = 0; i < 40; ++i) {
+                        computations.emplace_back(CellComputerComputation{
+                            code,
+                            createRandomMemory(generator, tokenMemorySize),
+                            createRandomMemory(generator, parameters.cellFunctionComputerCellMemorySize)});
+                    }
+                    checkAgainstLegacy(parameters, computations);
+                }
+            }
+        }
+    }
+
+    void testDecodingCache()
+    {
+        std::mt19937 generator(42);
+        auto code = createRandomCode(generator, 16);
+        char staticData[MAX_CELL_STATIC_BYTES] = {};
+        std::copy(code.begin(), code.end(), staticData);
+
+        CellComputerProgram program;
+        program.decode(staticData, toInt(code.size()), 64, 8, 15);
+        EXPECT(program.isValid(64, 8, 15));
+        EXPECT(!program.isValid(128, 8, 15));
+        EXPECT(!program.isValid(64, 4, 15));
+        EXPECT(!program.isValid(64, 8, 10));
+        EXPECT(program.numInstructions <= 15);
+    }
+}
+
+int main()
+{
+    for (auto instructionSet : {CellComputerInstructionSet::Avx2, CellComputerInstructionSet::Avx512}) {
+        if (!CellComputerBatchInterpreter::isSupported(instructionSet)) {
+            std::cout << "instruction set " << instructionSet << " not supported, skipping its checks" << std::endl;
+        }
+    }
+    Testing::run("nested conditions", testNestedConditions);
+    Testing::run("unmatched blocks", testUnmatchedBlocks);
+    Testing::run("indirect addressing", testIndirectAddressing);
+    Testing::run("random programs against legacy interpreter", testRandomPrograms);
+    Testing::run("decoding cache", testDecodingCache);
+    return Testing::getExitCode();
+}
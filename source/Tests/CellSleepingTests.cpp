@@ -0,0 +1,106 @@
+#include "Base/Math.h"
+
+#include "EngineTesting.h"
+#include "Testing.h"
+
+namespace
+{
+    IntVector2D const WorldSize{100, 100};
+
+    float getDistance(RealVector2D const& pos1, RealVector2D const& pos2)
+    {
+        auto delta = pos1 - pos2;
+        return static_cast<float>(Math::length(delta));
+    }
+
+    //moves a slow cell for numTimesteps and returns its distance to the start position
+    float calcDistanceOfSlowCell(SimulationParameters const& parameters, int numTimesteps)
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, parameters);
+        auto cell = EngineTesting::createCell({50, 50}, {0.005f, 0});
+        simController->setSimulationData(DataDescription().addCluster(EngineTesting::createCluster({cell})));
+
+        EngineTesting::calcTimesteps(simController, numTimesteps);
+
+        auto movedCell = EngineTesting::findCell(EngineTesting::getAllData(simController, WorldSize), cell.id);
+        simController->closeSimulation();
+        EXPECT(movedCell.has_value());
+        return movedCell ? getDistance(movedCell->pos, cell.pos) : 0.0f;
+    }
+
+    void testNoSleepingByDefault()
+    {
+        EXPECT(0 == SimulationParameters().cellSleepingSteps);
+        EXPECT(calcDistanceOfSlowCell(EngineTesting::createDeterministicParameters(), 200) > 0.3f);
+    }
+
+    void testRestingCellFallsAsleep()
+    {
+        auto parameters = EngineTesting::createDeterministicParameters();
+        parameters.cellSleepingSteps = 10;
+        EXPECT(calcDistanceOfSlowCell(parameters, 200) < 0.1f);
+    }
+
+    //a fast cell approaching a sleeping cell wakes it up and pushes it away
+    void testCollisionWakesUp()
+    {
+        auto parameters = EngineTesting::createDeterministicParameters();
+        parameters.cellSleepingSteps = 10;
+        auto simController = EngineTesting::createSimulation(WorldSize, parameters);
+        auto sleepingCell = EngineTesting::createCell({50, 50});
+        auto movingCell = EngineTesting::createCell({30, 50}, {0.5f, 0});
+        simController->setSimulationData(DataDescription()
+                                             .addCluster(EngineTesting::createCluster({sleepingCell}))
+                                             .addCluster(EngineTesting::createCluster({movingCell})));
+
+        EngineTesting::calcTimesteps(simController, 200);
+
+        auto cell = EngineTesting::findCell(EngineTesting::getAllData(simController, WorldSize), sleepingCell.id);
+        simController->closeSimulation();
+        EXPECT(cell.has_value());
+        if (cell) {
+            EXPECT(getDistance(cell->pos, sleepingCell.pos) > 0.2f);
+        }
+    }
+
+    //a new neighbor exerts a repulsive force on a sleeping cell, the velocity threshold is chosen such that the
+    //velocity of the neighbor does not wake up the cell
+    float calcDistanceOfPushedSleepingCell(float sleepingMaxForce)
+    {
+        auto parameters = EngineTesting::createDeterministicParameters();
+        parameters.cellSleepingSteps = 10;
+        parameters.cellSleepingMaxVel = 0.5f;
+        parameters.cellSleepingMaxForce = sleepingMaxForce;
+        auto simController = EngineTesting::createSimulation(WorldSize, parameters);
+        auto sleepingCell = EngineTesting::createCell({50, 50});
+        simController->setSimulationData(DataDescription().addCluster(EngineTesting::createCluster({sleepingCell})));
+        EngineTesting::calcTimesteps(simController, 20);
+
+        auto neighborCell = EngineTesting::createCell({51, 50});
+        simController->addAndSelectSimulationData(
+            DataDescription().addCluster(EngineTesting::createCluster({neighborCell})));
+        EngineTesting::calcTimesteps(simController, 5);
+
+        auto cell = EngineTesting::findCell(EngineTesting::getAllData(simController, WorldSize), sleepingCell.id);
+        simController->closeSimulation();
+        EXPECT(cell.has_value());
+        return cell ? getDistance(cell->pos, sleepingCell.pos) : 0.0f;
+    }
+
+    void testForceThreshold()
+    {
+        auto repulsiveForce = (SimulationParameters().cellMaxCollisionDistance - 1.0f)
+            * SimulationParameters().cellRepulsionStrength;
+        EXPECT(calcDistanceOfPushedSleepingCell(repulsiveForce * 10) < 0.001f);
+        EXPECT(calcDistanceOfPushedSleepingCell(repulsiveForce / 10) > 0.001f);
+    }
+}
+
+int main()
+{
+    Testing::run("no sleeping by default", testNoSleepingByDefault);
+    Testing::run("resting cell falls asleep", testRestingCellFallsAsleep);
+    Testing::run("collision wakes up", testCollisionWakesUp);
+    Testing::run("force threshold", testForceThreshold);
+    return Testing::getExitCode();
+}
@@ -0,0 +1,203 @@
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <stdexcept>
+
+#include "EngineImpl/CheckpointWriter.h"
+#include "EngineInterface/Serializer.h"
+#include "EngineInterface/SimulationFiles.h"
+
+#include "EngineTesting.h"
+#include "Testing.h"
+
+namespace
+{
+    IntVector2D const WorldSize{100, 100};
+
+    std::string getFilename()
+    {
+        return (std::filesystem::temp_directory_path() / "alien_checkpoint_tests.sim").string();
+    }
+
+    void removeFiles()
+    {
+        for (auto const& filename : SimulationFiles::getFilenames(getFilename())) {
+            std::filesystem::remove(filename);
+        }
+        std::filesystem::remove(_CheckpointWriter::getJournalFilename(getFilename()));
+    }
+
+    CheckpointSettings createSettings()
+    {
+        CheckpointSettings result;
+        result.filename = getFilename();
+        result.tileSize = 25;
+        result.positionTolerance = 0.01f;
+        return result;
+    }
+
+    //one cell moving through the tiles and one resting cell
+    SimulationController createSimulation()
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+        simController->setSimulationData(
+            DataDescription()
+                .addCluster(EngineTesting::createCluster({EngineTesting::createCell({10, 10}, {0.5f, 0})}))
+                .addCluster(EngineTesting::createCluster({EngineTesting::createCell({80, 80})})));
+        return simController;
+    }
+
+    std::map<uint64_t, RealVector2D> getCellPositions(DataDescription const& data)
+    {
+        std::map<uint64_t, RealVector2D> result;
+        for (auto const& cluster : data.clusters) {
+            for (auto const& cell : cluster.cells) {
+                result.emplace(cell.id, cell.pos);
+            }
+        }
+        return result;
+    }
+
+    CellDescription& getRestingCell(DataDescription& data)
+    {
+        for (auto& cluster : data.clusters) {
+            for (auto& cell : cluster.cells) {
+                if (cell.pos.x > 50) {
+                    return cell;
+                }
+            }
+        }
+        throw std::runtime_error("Resting cell not found.");
+    }
+
+    DeserializedSimulation loadCheckpoint()
+    {
+        DeserializedSimulation result;
+        Serializer serializer = boost::make_shared<_Serializer>();
+        EXPECT(serializer->deserializeCheckpointFromFiles(
+            getFilename(), _CheckpointWriter::getJournalFilename(getFilename()), result));
+        return result;
+    }
+
+    void testJournal()
+    {
+        removeFiles();
+        auto simController = createSimulation();
+        auto writer = boost::make_shared<_CheckpointWriter>(simController, createSettings());
+
+        writer->writeCheckpoint();
+        EXPECT(0 == writer->getNumJournalEntries());
+        for (int i = 1; i <= 3; ++i) {
+            EngineTesting::calcTimesteps(simController, 10);
+            writer->writeCheckpoint();
+            EXPECT(i == writer->getNumJournalEntries());
+        }
+
+        auto checkpoint = loadCheckpoint();
+        EXPECT(simController->getCurrentTimestep() == checkpoint.timestep);
+        EXPECT(getCellPositions(EngineTesting::getAllData(simController, WorldSize))
+               == getCellPositions(checkpoint.content));
+
+        simController->closeSimulation();
+        removeFiles();
+    }
+
+    //the base is written under a temporary name and renamed afterwards
+    void testBaseReplacement()
+    {
+        removeFiles();
+        auto simController = createSimulation();
+        auto writer = boost::make_shared<_CheckpointWriter>(simController, createSettings());
+        writer->writeCheckpoint();
+        EngineTesting::calcTimesteps(simController, 10);
+        writer->writeCheckpoint();
+        EXPECT(1 == writer->getNumJournalEntries());
+
+        EngineTesting::calcTimesteps(simController, 10);
+        writer->writeBase();
+        EXPECT(0 == writer->getNumJournalEntries());
+        EXPECT(!std::filesystem::exists(_CheckpointWriter::getJournalFilename(getFilename())));
+        auto temporaryFilename = SimulationFiles::getTemporaryFilename(getFilename());
+        for (auto const& filename : SimulationFiles::getFilenames(temporaryFilename)) {
+            EXPECT(!std::filesystem::exists(filename));
+        }
+
+        auto checkpoint = loadCheckpoint();
+        EXPECT(simController->getCurrentTimestep() == checkpoint.timestep);
+        EXPECT(getCellPositions(EngineTesting::getAllData(simController, WorldSize))
+               == getCellPositions(checkpoint.content));
+
+        simController->closeSimulation();
+        removeFiles();
+    }
+
+    //a journal which has not been truncated after the base has been replaced is not applied
+    void testOutdatedJournal()
+    {
+        removeFiles();
+        auto simController = createSimulation();
+        auto writer = boost::make_shared<_CheckpointWriter>(simController, createSettings());
+        writer->writeCheckpoint();
+        EngineTesting::calcTimesteps(simController, 10);
+        writer->writeCheckpoint();
+        auto journalFilename = _CheckpointWriter::getJournalFilename(getFilename());
+        auto outdatedJournalFilename = journalFilename + ".outdated";
+        std::filesystem::copy_file(journalFilename, outdatedJournalFilename);
+
+        EngineTesting::calcTimesteps(simController, 10);
+        writer->writeBase();
+        std::filesystem::rename(outdatedJournalFilename, journalFilename);
+
+        auto checkpoint = loadCheckpoint();
+        EXPECT(simController->getCurrentTimestep() == checkpoint.timestep);
+        EXPECT(getCellPositions(EngineTesting::getAllData(simController, WorldSize))
+               == getCellPositions(checkpoint.content));
+
+        simController->closeSimulation();
+        removeFiles();
+    }
+
+    //a change of the resting cell without time steps keeps its position, nevertheless the journal contains its tile
+    void checkChangedRestingCell(std::function<void(CellDescription&)> const& change)
+    {
+        removeFiles();
+        auto simController = createSimulation();
+        auto writer = boost::make_shared<_CheckpointWriter>(simController, createSettings());
+        writer->writeCheckpoint();
+
+        auto data = EngineTesting::getAllData(simController, WorldSize);
+        change(getRestingCell(data));
+        simController->setSimulationData(data);
+        writer->writeCheckpoint();
+        EXPECT(1 == writer->getNumJournalEntries());
+
+        auto checkpoint = loadCheckpoint();
+        auto expectedCell = getRestingCell(data);
+        auto cell = getRestingCell(checkpoint.content);
+        EXPECT(expectedCell.metadata.color == cell.metadata.color);
+        EXPECT(expectedCell.vel == cell.vel);
+
+        simController->closeSimulation();
+        removeFiles();
+    }
+
+    void testChangedColor()
+    {
+        checkChangedRestingCell([](CellDescription& cell) { cell.metadata.color = 3; });
+    }
+
+    void testChangedVelocity()
+    {
+        checkChangedRestingCell([](CellDescription& cell) { cell.vel = {0.25f, -0.125f}; });
+    }
+}
+
+int main()
+{
+    Testing::run("journal", testJournal);
+    Testing::run("base replacement", testBaseReplacement);
+    Testing::run("outdated journal", testOutdatedJournal);
+    Testing::run("changed color", testChangedColor);
+    Testing::run("changed velocity", testChangedVelocity);
+    return Testing::getExitCode();
+}
@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "EngineGpuKernels/CellConnectionProcessor.cuh"
+#include "EngineGpuKernels/ClusterLabelKernels.cuh"
+
+#include "Testing.h"
+
+namespace
+{
+    int const NumBlocks = 64;
+    int const NumThreadsPerBlock = 32;
+    int const NumClusters = 100;
+    int const ClusterSize = 10;
+
+    __global__ void initLabels(Array<Cell*> cells, bool needsUpdate)
+    {
+        auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            ClusterLabelProcessor::init(cells.at(index), needsUpdate);
+        }
+    }
+
+    //corresponds to the label update in CellConnectionProcessor::addConnections
+    __global__ void uniteCells(Cell* cells, int2* cellIndexPairs, int numPairs)
+    {
+        auto const partition = calcAllThreadsPartition(numPairs);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& pair = cellIndexPairs[index];
+            ClusterLabelProcessor::unite(&cells[pair.x], &cells[pair.y]);
+        }
+    }
+
+    __global__ void delConnections(Cell* cells, int2* cellIndexPairs, int numPairs)
+    {
+        auto const partition = calcAllThreadsPartition(numPairs);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& pair = cellIndexPairs[index];
+            CellConnectionProcessor::delConnections(&cells[pair.x], &cells[pair.y]);
+        }
+    }
+
+    class ClusterLabelFixture
+    {
+    public:
+        ClusterLabelFixture()
+        {
+            GpuSettings gpuSettings;
+            gpuSettings.NUM_BLOCKS = NumBlocks;
+            gpuSettings.NUM_THREADS_PER_BLOCK = NumThreadsPerBlock;
+            CHECK_FOR_CUDA_ERROR(cudaMemcpyToSymbol(gpuConstants, &gpuSettings, sizeof(GpuSettings)));
+
+            auto numCells = NumClusters * ClusterSize;
+            _cells.resize(numCells);
+            for (auto& cell : _cells) {
+                cell.maxConnections = MAX_CELL_BONDS;
+                cell.numConnections = 0;
+                cell.locked = 0;
+            }
+            _cellArray.init(numCells);
+            _cellArray.setNumEntries_host(numCells);
+            _cellPointers.init(numCells);
+
+            std::vector<Cell*> cellPointers;
+            for (int i = 0; i < numCells; ++i) {
+                cellPointers.emplace_back(getCellOnDevice(i));
+            }
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                _cellPointers.getArray_host(),
+                cellPointers.data(),
+                sizeof(Cell*) * cellPointers.size(),
+                cudaMemcpyHostToDevice));
+            _cellPointers.setNumEntries_host(numCells);
+            CHECK_FOR_CUDA_ERROR(cudaMalloc(&_cellIndexPairs, sizeof(int2) * numCells * MAX_CELL_BONDS));
+            upload();
+        }
+
+        ~ClusterLabelFixture()
+        {
+            _cellArray.free();
+            _cellPointers.free();
+            CHECK_FOR_CUDA_ERROR(cudaFree(_cellIndexPairs));
+        }
+
+        Cell* getCellOnDevice(int index) const { return _cellArray.getArray_host() + index; }
+
+        //the connections refer to the cells on the device, the labels are not touched
+        void connect(int index1, int index2)
+        {
+            for (auto [index, otherIndex] : {std::make_pair(index1, index2), std::make_pair(index2, index1)}) {
+                auto& cell = _cells[index];
+                auto& connection = cell.connections[cell.numConnections++];
+                connection.cell = getCellOnDevice(otherIndex);
+                connection.distance = 1.0f;
+                connection.angleFromPrevious = 0;
+            }
+        }
+
+        void upload()
+        {
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                _cellArray.getArray_host(), _cells.data(), sizeof(Cell) * _cells.size(), cudaMemcpyHostToDevice));
+        }
+
+        void download()
+        {
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                _cells.data(), _cellArray.getArray_host(), sizeof(Cell) * _cells.size(), cudaMemcpyDeviceToHost));
+        }
+
+        void initLabels(bool needsUpdate)
+        {
+            ::initLabels<<<NumBlocks, NumThreadsPerBlock>>>(_cellPointers, needsUpdate);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+        }
+
+        void unite(std::vector<int2> const& cellIndexPairs)
+        {
+            uploadCellIndexPairs(cellIndexPairs);
+            ::uniteCells<<<NumBlocks, NumThreadsPerBlock>>>(
+                _cellArray.getArray_host(), _cellIndexPairs, toInt(cellIndexPairs.size()));
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+        }
+
+        void delConnections(std::vector<int2> const& cellIndexPairs)
+        {
+            uploadCellIndexPairs(cellIndexPairs);
+            ::delConnections<<<NumBlocks, NumThreadsPerBlock>>>(
+                _cellArray.getArray_host(), _cellIndexPairs, toInt(cellIndexPairs.size()));
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+        }
+
+        void updateClusterLabels()
+        {
+            ::updateClusterLabels<<<1, 1>>>(_cellPointers);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+            download();
+        }
+
+        //afterwards each cell has to point directly to the cell with the lowest address in its cluster
+        bool hasLabel(int index, int rootIndex) const
+        {
+            return _cells[index].clusterParent == getCellOnDevice(rootIndex);
+        }
+
+        std::vector<Cell>& getCells() { return _cells; }
+
+    private:
+        void uploadCellIndexPairs(std::vector<int2> const& cellIndexPairs)
+        {
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                _cellIndexPairs,
+                cellIndexPairs.data(),
+                sizeof(int2) * cellIndexPairs.size(),
+                cudaMemcpyHostToDevice));
+        }
+
+        std::vector<Cell> _cells;
+        Array<Cell> _cellArray;
+        Array<Cell*> _cellPointers;
+        int2* _cellIndexPairs;
+    };
+
+    //chains of ClusterSize cells, the bonds are created in random order
+    std::vector<int2> getChainBonds()
+    {
+        std::vector<int> indices;
+        for (int cluster = 0; cluster < NumClusters; ++cluster) {
+            for (int i = 0; i < ClusterSize - 1; ++i) {
+                indices.emplace_back(cluster * ClusterSize + i);
+            }
+        }
+        std::mt19937 generator(1);
+        std::shuffle(indices.begin(), indices.end(), generator);
+
+        std::vector<int2> result;
+        for (auto const& index : indices) {
+            result.emplace_back(int2{index, index + 1});
+        }
+        return result;
+    }
+
+    bool hasChainLabels(ClusterLabelFixture const& fixture)
+    {
+        for (int cluster = 0; cluster < NumClusters; ++cluster) {
+            for (int i = 0; i < ClusterSize; ++i) {
+                if (!fixture.hasLabel(cluster * ClusterSize + i, cluster * ClusterSize)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void testMerges()
+    {
+        ClusterLabelFixture fixture;
+        fixture.initLabels(false);
+        fixture.unite(getChainBonds());
+        fixture.updateClusterLabels();
+        EXPECT(hasChainLabels(fixture));
+
+        //bonds between neighboring chains merge them pairwise
+        std::vector<int2> bonds;
+        for (int cluster = 0; cluster < NumClusters; cluster += 2) {
+            bonds.emplace_back(int2{(cluster + 1) * ClusterSize + 3, cluster * ClusterSize + 5});
+        }
+        fixture.unite(bonds);
+        fixture.updateClusterLabels();
+        auto merged = true;
+        for (int i = 0; i < NumClusters * ClusterSize; ++i) {
+            merged &= fixture.hasLabel(i, (i / (2 * ClusterSize)) * 2 * ClusterSize);
+        }
+        EXPECT(merged);
+    }
+
+    //removed bonds split the chains, a removed bond in a ring keeps the cluster
+    void testSplits()
+    {
+        ClusterLabelFixture fixture;
+        for (auto const& bond : getChainBonds()) {
+            fixture.connect(bond.x, bond.y);
+        }
+        for (int cluster = 1; cluster < NumClusters; cluster += 4) {
+            fixture.connect(cluster * ClusterSize, cluster * ClusterSize + ClusterSize - 1);
+        }
+        fixture.upload();
+        fixture.initLabels(false);
+        fixture.unite(getChainBonds());
+        fixture.updateClusterLabels();
+
+        std::vector<int2> removedBonds;
+        for (int cluster = 0; cluster < NumClusters; ++cluster) {
+            if (cluster % 4 != 3) {
+                removedBonds.emplace_back(int2{cluster * ClusterSize + 5, cluster * ClusterSize + 6});
+            }
+        }
+        fixture.delConnections(removedBonds);
+        fixture.updateClusterLabels();
+
+        auto const& cells = fixture.getCells();
+        auto split = true;
+        auto unchanged = true;
+        for (int cluster = 0; cluster < NumClusters; ++cluster) {
+            for (int i = 0; i < ClusterSize; ++i) {
+                auto index = cluster * ClusterSize + i;
+                if (cluster % 4 == 1 || cluster % 4 == 3) {
+                    split &= fixture.hasLabel(index, cluster * ClusterSize);
+                } else {
+                    split &= fixture.hasLabel(index, cluster * ClusterSize + (i <= 5 ? 0 : 6));
+                }
+
+                //labels of clusters without removed bonds are not rebuilt
+                if (cluster % 4 == 3) {
+                    unchanged &= 0 == cells[index].tag;
+                }
+            }
+        }
+        EXPECT(split);
+        EXPECT(unchanged);
+        EXPECT(1 == cells[5].numConnections && 1 == cells[6].numConnections);
+        EXPECT(0 == cells[5].clusterNeedsUpdate && 0 == cells[0].clusterNeedsUpdate);
+    }
+
+    //cells created from transfer data are bonded without uniting their labels (see EntityFactory)
+    void testCellCreation()
+    {
+        ClusterLabelFixture fixture;
+        for (auto const& bond : getChainBonds()) {
+            fixture.connect(bond.x, bond.y);
+        }
+        fixture.upload();
+        fixture.initLabels(true);
+        fixture.updateClusterLabels();
+        EXPECT(hasChainLabels(fixture));
+
+        auto marksRemoved = true;
+        for (auto const& cell : fixture.getCells()) {
+            marksRemoved &= 0 == cell.clusterNeedsUpdate;
+        }
+        EXPECT(marksRemoved);
+    }
+}
+
+int main()
+{
+    Testing::run("merges", testMerges);
+    Testing::run("splits", testSplits);
+    Testing::run("cell creation", testCellCreation);
+    return Testing::getExitCode();
+}
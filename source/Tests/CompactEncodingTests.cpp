@@ -0,0 +1,279 @@
+#include <cmath>
+#include <random>
+#include <sstream>
+
+#include "Base/EntropyCoder.h"
+#include "EngineInterface/CompactEncoding.h"
+
+#include "Testing.h"
+
+namespace
+{
+    std::mt19937 randomGenerator(42);
+
+    int getRandomInt(int min, int max)
+    {
+        return std::uniform_int_distribution<int>(min, max)(randomGenerator);
+    }
+
+    float getRandomFloat(float min, float max)
+    {
+        return std::uniform_real_distribution<float>(min, max)(randomGenerator);
+    }
+
+    std::string getRandomBytes(int size, int numSymbols)
+    {
+        std::string result(size, 0);
+        for (auto& byte : result) {
+            byte = static_cast<char>(getRandomInt(0, numSymbols - 1));
+        }
+        return result;
+    }
+
+    bool isRoundTrip(std::string const& data)
+    {
+        return EntropyCoder::decode(EntropyCoder::encode(data)) == data;
+    }
+
+    void testEntropyCoderRoundTrip()
+    {
+        EXPECT(isRoundTrip(""));
+        EXPECT(isRoundTrip("a"));
+        EXPECT(isRoundTrip(std::string(100000, 'x')));
+        EXPECT(isRoundTrip(getRandomBytes(100000, 256)));
+        EXPECT(isRoundTrip(getRandomBytes(100000, 3)));
+
+        std::string allSymbols;
+        for (int i = 0; i < 256; ++i) {
+            allSymbols.push_back(static_cast<char>(i));
+        }
+        EXPECT(isRoundTrip(allSymbols));
+
+        //one frequent symbol and rare others
+        auto skewedData = getRandomBytes(100000, 256);
+        for (auto& byte : skewedData) {
+            if (getRandomInt(0, 99) < 95) {
+                byte = 0;
+            }
+        }
+        EXPECT(isRoundTrip(skewedData));
+        EXPECT(EntropyCoder::encode(skewedData).size() < skewedData.size() / 3);
+    }
+
+    void testEntropyCoderCorruptData()
+    {
+        auto encodedData = EntropyCoder::encode(getRandomBytes(10000, 16));
+        auto isThrown = false;
+        try {
+            EntropyCoder::decode(encodedData.substr(0, encodedData.size() / 2));
+        } catch (std::exception const&) {
+            isThrown = true;
+        }
+        EXPECT(isThrown);
+    }
+
+    DataDescription createRandomData(int numClusters, int numParticles)
+    {
+        DataDescription result;
+        uint64_t id = 1000;
+        for (int i = 0; i < numClusters; ++i) {
+            ClusterDescription cluster;
+            cluster.setId(id++);
+            auto numCells = getRandomInt(1, 8);
+            for (int j = 0; j < numCells; ++j) {
+                CellDescription cell;
+                cell.id = id + getRandomInt(0, 3);
+                id = cell.id + 1;
+                cell.pos = {getRandomFloat(0, 1000), getRandomFloat(0, 1000)};
+                cell.vel = {getRandomFloat(-1, 1), getRandomFloat(-1, 1)};
+                cell.energy = getRandomFloat(0, 200);
+                cell.maxConnections = getRandomInt(0, 6);
+                cell.tokenBlocked = getRandomInt(0, 1) == 1;
+                cell.tokenBranchNumber = getRandomInt(0, 5);
+                cell.tokenUsages = getRandomInt(0, 100);
+                cell.metadata.setColor(static_cast<uint8_t>(getRandomInt(0, 6)))
+                    .setName("cell " + std::to_string(j))
+                    .setDescription(j % 2 == 0 ? "" : "description")
+                    .setSourceCode(j % 3 == 0 ? "mov [1], 3" : "");
+                auto cellFunction = getRandomInt(0, Enums::CellFunction::_COUNTER - 1);
+                cell.cellFeature.setType(static_cast<Enums::CellFunction::Type>(cellFunction))
+                    .setConstData(getRandomBytes(getRandomInt(0, 48), 256))
+                    .setVolatileData(getRandomBytes(getRandomInt(0, 16), 256));
+                for (int k = 0; k < getRandomInt(0, 2); ++k) {
+                    cell.tokens.emplace_back(
+                        TokenDescription().setEnergy(getRandomFloat(0, 100)).setData(getRandomBytes(256, 256)));
+                }
+                cluster.addCell(cell);
+            }
+
+            //connections within the cluster and to a cell outside of it
+            for (int j = 0; j < numCells; ++j) {
+                auto& cell = cluster.cells[j];
+                for (int k = 0; k < getRandomInt(0, 3); ++k) {
+                    ConnectionDescription connection;
+                    connection.cellId = getRandomInt(0, 4) == 0 ? 1 : cluster.cells[getRandomInt(0, numCells - 1)].id;
+                    connection.distance = getRandomFloat(0.5f, 2);
+                    connection.angleFromPrevious = getRandomFloat(0, 360);
+                    cell.connections.emplace_back(connection);
+                }
+            }
+            result.addCluster(cluster);
+        }
+        for (int i = 0; i < numParticles; ++i) {
+            result.addParticle(ParticleDescription()
+                                   .setId(id++)
+                                   .setPos({getRandomFloat(0, 1000), getRandomFloat(0, 1000)})
+                                   .setVel({getRandomFloat(-1, 1), getRandomFloat(-1, 1)})
+                                   .setEnergy(getRandomFloat(0, 10))
+                                   .setMetadata(ParticleMetadata().setColor(static_cast<uint8_t>(i % 7))));
+        }
+        return result;
+    }
+
+    //the quantization error is at most half of the precision apart from float rounding
+    bool isQuantized(RealVector2D const& value, RealVector2D const& decodedValue, float precision)
+    {
+        auto tolerance = precision / 2 + 1e-4f;
+        return std::abs(value.x - decodedValue.x) <= tolerance && std::abs(value.y - decodedValue.y) <= tolerance;
+    }
+
+    bool isEqual(
+        CellDescription const& cell,
+        CellDescription const& decodedCell,
+        CompactEncodingSettings const& settings)
+    {
+        if (cell.id != decodedCell.id || !isQuantized(cell.pos, decodedCell.pos, settings.positionPrecision)
+            || !isQuantized(cell.vel, decodedCell.vel, settings.velocityPrecision)
+            || static_cast<float>(cell.energy) != decodedCell.energy
+            || cell.maxConnections != decodedCell.maxConnections || cell.tokenBlocked != decodedCell.tokenBlocked
+            || cell.tokenBranchNumber != decodedCell.tokenBranchNumber || cell.tokenUsages != decodedCell.tokenUsages
+            || cell.metadata != decodedCell.metadata || cell.cellFeature != decodedCell.cellFeature
+            || cell.connections.size() != decodedCell.connections.size()
+            || cell.tokens.size() != decodedCell.tokens.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < cell.connections.size(); ++i) {
+            auto const& connection = cell.connections[i];
+            auto const& decodedConnection = decodedCell.connections[i];
+            if (connection.cellId != decodedConnection.cellId || connection.distance != decodedConnection.distance
+                || connection.angleFromPrevious != decodedConnection.angleFromPrevious) {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < cell.tokens.size(); ++i) {
+            if (static_cast<float>(cell.tokens[i].energy) != decodedCell.tokens[i].energy
+                || cell.tokens[i].data != decodedCell.tokens[i].data) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isEqual(
+        DataDescription const& data,
+        DataDescription const& decodedData,
+        CompactEncodingSettings const& settings)
+    {
+        if (data.clusters.size() != decodedData.clusters.size()
+            || data.particles.size() != decodedData.particles.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < data.clusters.size(); ++i) {
+            auto const& cluster = data.clusters[i];
+            auto const& decodedCluster = decodedData.clusters[i];
+            if (cluster.id != decodedCluster.id || cluster.cells.size() != decodedCluster.cells.size()) {
+                return false;
+            }
+            for (size_t j = 0; j < cluster.cells.size(); ++j) {
+                if (!isEqual(cluster.cells[j], decodedCluster.cells[j], settings)) {
+                    return false;
+                }
+            }
+        }
+        for (size_t i = 0; i < data.particles.size(); ++i) {
+            auto const& particle = data.particles[i];
+            auto const& decodedParticle = decodedData.particles[i];
+            if (particle.id != decodedParticle.id
+                || !isQuantized(particle.pos, decodedParticle.pos, settings.positionPrecision)
+                || !isQuantized(particle.vel, decodedParticle.vel, settings.velocityPrecision)
+                || static_cast<float>(particle.energy) != decodedParticle.energy
+                || particle.metadata != decodedParticle.metadata) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    DataDescription encodeDecode(DataDescription const& data, CompactEncodingSettings const& settings)
+    {
+        std::stringstream stream;
+        CompactEncoding::encode(data, settings, stream);
+        DataDescription result;
+        CompactEncoding::decode(stream, result);
+        return result;
+    }
+
+    void testCompactEncodingRoundTrip()
+    {
+        CompactEncodingSettings settings;
+        auto data = createRandomData(500, 2000);
+        EXPECT(isEqual(data, encodeDecode(data, settings), settings));
+
+        //coarser precisions and many chunks
+        settings.positionPrecision = 1.0f / 8;
+        settings.velocityPrecision = 1.0f / 256;
+        settings.maxEntitiesPerChunk = 7;
+        EXPECT(isEqual(data, encodeDecode(data, settings), settings));
+
+        DataDescription emptyData;
+        auto decodedData = encodeDecode(emptyData, settings);
+        EXPECT(decodedData.clusters.empty() && decodedData.particles.empty());
+    }
+
+    void testIsCompactEncoded()
+    {
+        std::stringstream stream;
+        CompactEncoding::encode(createRandomData(10, 10), CompactEncodingSettings(), stream);
+        EXPECT(CompactEncoding::isCompactEncoded(stream));
+        EXPECT(0 == stream.tellg());
+
+        std::stringstream otherStream("ALC");
+        EXPECT(!CompactEncoding::isCompactEncoded(otherStream));
+    }
+
+    void testInvalidInput()
+    {
+        CompactEncodingSettings settings;
+        settings.positionPrecision = 0;
+        std::stringstream stream;
+        auto isThrown = false;
+        try {
+            CompactEncoding::encode(createRandomData(1, 1), settings, stream);
+        } catch (std::exception const&) {
+            isThrown = true;
+        }
+        EXPECT(isThrown);
+
+        std::stringstream truncatedStream;
+        CompactEncoding::encode(createRandomData(100, 100), CompactEncodingSettings(), truncatedStream);
+        truncatedStream.str(truncatedStream.str().substr(0, truncatedStream.str().size() / 2));
+        isThrown = false;
+        try {
+            DataDescription data;
+            CompactEncoding::decode(truncatedStream, data);
+        } catch (std::exception const&) {
+            isThrown = true;
+        }
+        EXPECT(isThrown);
+    }
+}
+
+int main()
+{
+    Testing::run("entropy coder round trip", testEntropyCoderRoundTrip);
+    Testing::run("entropy coder corrupt data", testEntropyCoderCorruptData);
+    Testing::run("compact encoding round trip", testCompactEncodingRoundTrip);
+    Testing::run("compact encoding signature", testIsCompactEncoded);
+    Testing::run("invalid input", testInvalidInput);
+    return Testing::getExitCode();
+}
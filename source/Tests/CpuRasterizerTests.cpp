@@ -0,0 +1,160 @@
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "EngineImpl/AccessDataTOCache.h"
+#include "EngineImpl/CpuRasterizer.h"
+#include "EngineInterface/ZoomLevels.h"
+
+#include "EngineTesting.h"
+#include "Testing.h"
+
+namespace
+{
+    IntVector2D const WorldSize{200, 150};
+
+    //bonded cell pairs with tokens, particles and a selected region
+    SimulationController createSimulation()
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<float> xDistribution(0, toFloat(WorldSize.x) - 2);
+        std::uniform_real_distribution<float> yDistribution(0, toFloat(WorldSize.y));
+        std::uniform_real_distribution<float> energyDistribution(10.0f, 400.0f);
+        std::uniform_int_distribution<int> intDistribution(0, 6);
+
+        DataDescription data;
+        for (int i = 0; i < 500; ++i) {
+            RealVector2D pos{xDistribution(generator), yDistribution(generator)};
+            auto cell1 = EngineTesting::createCell(pos).setEnergy(energyDistribution(generator));
+            auto cell2 = EngineTesting::createCell(pos + RealVector2D{1, 0}).setEnergy(energyDistribution(generator));
+            cell1.metadata.color = static_cast<unsigned char>(intDistribution(generator));
+            cell2.metadata.color = static_cast<unsigned char>(intDistribution(generator));
+            if (0 == i % 3) {
+                std::string tokenData(SimulationParameters().tokenMemorySize, 0);
+                cell1.addToken(TokenDescription().setEnergy(30).setData(tokenData));
+            }
+            auto cluster = EngineTesting::createCluster({cell1, cell2});
+            std::unordered_map<uint64_t, int> cache;
+            cluster.addConnection(cell1.id, cell2.id, cache);
+            data.addCluster(cluster);
+        }
+        for (int i = 0; i < 2000; ++i) {
+            data.addParticle(ParticleDescription()
+                                 .setId(NumberGenerator::getInstance().getId())
+                                 .setPos({xDistribution(generator), yDistribution(generator)})
+                                 .setVel({0, 0})
+                                 .setEnergy(energyDistribution(generator) / 10));
+        }
+        simController->setSimulationData(data);
+        simController->setSelection({20, 20}, {80, 60});
+        return simController;
+    }
+
+    std::vector<uint32_t> drawOnDevice(
+        SimulationController const& simController,
+        RealVector2D const& rectUpperLeft,
+        IntVector2D const& imageSize,
+        float zoom)
+    {
+        RealVector2D rectLowerRight{
+            rectUpperLeft.x + toFloat(imageSize.x) / zoom, rectUpperLeft.y + toFloat(imageSize.y) / zoom};
+        std::vector<uint32_t> result;
+        while (!simController->tryDrawVectorGraphicsToHost(rectUpperLeft, rectLowerRight, imageSize, zoom, result)) {
+        }
+        return result;
+    }
+
+    //single values may differ slightly since the GPU reorders and contracts float operations
+    bool isSimilar(std::vector<uint32_t> const& image, std::vector<uint32_t> const& otherImage)
+    {
+        if (image.size() != otherImage.size()) {
+            return false;
+        }
+        size_t numDifferentPixels = 0;
+        for (size_t i = 0; i < image.size(); ++i) {
+            for (int channel = 0; channel < 3; ++channel) {
+                auto value = toInt((image[i] >> (channel * 8)) & 0xff);
+                auto otherValue = toInt((otherImage[i] >> (channel * 8)) & 0xff);
+                if (std::abs(value - otherValue) > 2) {
+                    ++numDifferentPixels;
+                    break;
+                }
+            }
+        }
+        return numDifferentPixels <= image.size() / 1000;
+    }
+
+    void expectSameImage(
+        SimulationController const& simController,
+        DataAccessTO const& dataTO,
+        CpuRasterizer& rasterizer,
+        RealVector2D const& rectUpperLeft,
+        IntVector2D const& imageSize,
+        float zoom)
+    {
+        std::vector<uint32_t> image;
+        rasterizer.rasterize(
+            dataTO,
+            WorldSize,
+            simController->getSimulationParametersSpots(),
+            rectUpperLeft,
+            imageSize,
+            zoom,
+            image);
+        EXPECT(isSimilar(image, drawOnDevice(simController, rectUpperLeft, imageSize, zoom)));
+
+        //the comparison is not trivial
+        int noEntities = 0;
+        auto emptyDataTO = dataTO;
+        emptyDataTO.numCells = &noEntities;
+        emptyDataTO.numParticles = &noEntities;
+        emptyDataTO.numTokens = &noEntities;
+        std::vector<uint32_t> emptyImage;
+        rasterizer.rasterize(
+            emptyDataTO,
+            WorldSize,
+            simController->getSimulationParametersSpots(),
+            rectUpperLeft,
+            imageSize,
+            zoom,
+            emptyImage);
+        EXPECT(!isSimilar(image, emptyImage));
+    }
+
+    void testDensityRendering()
+    {
+        auto simController = createSimulation();
+        auto cache = boost::make_shared<_AccessDataTOCache>(simController->getGpuSettings());
+        auto dataTO = simController->getSimulationDataTO({0, 0}, WorldSize, cache);
+        CpuRasterizer rasterizer(4);
+
+        EXPECT(0.4f < Const::MaxZoomLevelForDensityRendering);
+        expectSameImage(simController, dataTO, rasterizer, {0, 0}, {80, 60}, 0.4f);
+        expectSameImage(simController, dataTO, rasterizer, {-100.5f, -40.25f}, {120, 100}, 0.3f);
+
+        cache->releaseDataTO(dataTO);
+    }
+
+    void testCircleRendering()
+    {
+        auto simController = createSimulation();
+        auto cache = boost::make_shared<_AccessDataTOCache>(simController->getGpuSettings());
+        auto dataTO = simController->getSimulationDataTO({0, 0}, WorldSize, cache);
+        CpuRasterizer rasterizer(4);
+
+        expectSameImage(simController, dataTO, rasterizer, {0, 0}, {160, 120}, 0.8f);
+        expectSameImage(simController, dataTO, rasterizer, {0, 0}, {400, 300}, 2.0f);
+        expectSameImage(simController, dataTO, rasterizer, {-10.5f, 15.25f}, {300, 200}, 6.0f);
+
+        cache->releaseDataTO(dataTO);
+    }
+}
+
+int main()
+{
+    Testing::run("density rendering", testDensityRendering);
+    Testing::run("circle rendering", testCircleRendering);
+    return Testing::getExitCode();
+}
@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "EngineGpuKernels/RenderingKernels.cuh"
+
+#include "Testing.h"
+
+namespace
+{
+    int const NumBlocks = 64;
+    int const NumThreadsPerBlock = 32;
+    int2 const WorldSize{300, 200};
+    int2 const ImageSize{160, 120};
+
+    struct Density
+    {
+        double red = 0;
+        double green = 0;
+        double blue = 0;
+    };
+
+    //entities on the host, tokens refer to their cells by index
+    struct Scene
+    {
+        std::vector<Cell> cells;
+        std::vector<int> tokenCellIndices;
+        std::vector<Particle> particles;
+    };
+
+    /**
+     * Host reference implementation of accumulateCellDensities, accumulateTokenDensities and
+     * accumulateParticleDensities. Each entity adds the total intensity of a small circle with its color to the pixel
+     * containing its position.
+     */
+    class HostDensityImage
+    {
+    public:
+        HostDensityImage(float2 const& rectUpperLeft, float zoom)
+            : _rectUpperLeft(rectUpperLeft)
+            , _zoom(zoom)
+            , _densities(ImageSize.x * ImageSize.y)
+        {
+            _map.init(WorldSize);
+        }
+
+        void accumulate(Scene const& scene)
+        {
+            for (auto const& cell : scene.cells) {
+                addCell(cell);
+            }
+            for (auto const& cellIndex : scene.tokenCellIndices) {
+                auto pos = scene.cells[cellIndex].absPos;
+                _map.mapPosCorrection(pos);
+                add(pos, {0.5, 0.5, 0.5}, _zoom / 2);
+            }
+            for (auto const& particle : scene.particles) {
+                auto intensity = std::max(std::min((static_cast<int>(particle.energy) + 10) * 5, 150), 20) / 266.0;
+                if (0 != particle.selected) {
+                    intensity *= 2.5;
+                }
+                add(particle.absPos, {intensity, 0, 0.08}, 1 == particle.selected ? _zoom / 2 : _zoom / 3);
+            }
+        }
+
+        std::vector<Density> const& getDensities() const { return _densities; }
+
+    private:
+        void addCell(Cell const& cell)
+        {
+            uint32_t const cellColors[] = {
+                Const::IndividualCellColor1,
+                Const::IndividualCellColor2,
+                Const::IndividualCellColor3,
+                Const::IndividualCellColor4,
+                Const::IndividualCellColor5,
+                Const::IndividualCellColor6,
+                Const::IndividualCellColor7};
+            auto cellColor = cellColors[cell.metadata.color % 7];
+            double factor = std::min(300.0f, cell.energy) / 320.0;
+            if (1 == cell.selected) {
+                factor *= 2.5;
+            }
+            if (2 == cell.selected) {
+                factor *= 1.75;
+            }
+            Density color{
+                ((cellColor >> 16) & 0xff) / 256.0 * factor,
+                ((cellColor >> 8) & 0xff) / 256.0 * factor,
+                (cellColor & 0xff) / 256.0 * factor};
+
+            auto pos = cell.absPos;
+            _map.mapPosCorrection(pos);
+            add(pos, color, 1 == cell.selected ? _zoom / 2 : _zoom / 3);
+        }
+
+        void add(float2 const& pos, Density const& color, float radius)
+        {
+            auto x = static_cast<int>(std::floor((pos.x - _rectUpperLeft.x) * _zoom));
+            auto y = static_cast<int>(std::floor((pos.y - _rectUpperLeft.y) * _zoom));
+            if (x < 0 || x >= ImageSize.x || y < 0 || y >= ImageSize.y) {
+                return;
+            }
+            auto weight = radius * 2 * (1.0 + 4 * 0.3);
+            auto& density = _densities[x + y * ImageSize.x];
+            density.red += color.red * weight;
+            density.green += color.green * weight;
+            density.blue += color.blue * weight;
+        }
+
+        float2 _rectUpperLeft;
+        float _zoom;
+        MapInfo _map;
+        std::vector<Density> _densities;
+    };
+
+    //the positions exceed the world in order to test the position correction of cells and tokens
+    Scene createScene(unsigned int seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<float> xDistribution(-20.0f, static_cast<float>(WorldSize.x) + 20.0f);
+        std::uniform_real_distribution<float> yDistribution(-20.0f, static_cast<float>(WorldSize.y) + 20.0f);
+        std::uniform_real_distribution<float> energyDistribution(0, 400.0f);
+        std::uniform_int_distribution<int> intDistribution(0, 1000);
+
+        Scene result;
+        result.cells.resize(20000);
+        for (auto& cell : result.cells) {
+            cell.absPos = {xDistribution(generator), yDistribution(generator)};
+            cell.energy = energyDistribution(generator);
+            cell.metadata.color = static_cast<unsigned char>(intDistribution(generator) % 10);
+            cell.selected = intDistribution(generator) % 3;
+        }
+        for (int i = 0; i < 5000; ++i) {
+            result.tokenCellIndices.emplace_back(intDistribution(generator) % static_cast<int>(result.cells.size()));
+        }
+        result.particles.resize(20000);
+        for (auto& particle : result.particles) {
+            particle.absPos = {xDistribution(generator), yDistribution(generator)};
+            particle.energy = energyDistribution(generator) / 10;
+            particle.selected = intDistribution(generator) % 2;
+        }
+        return result;
+    }
+
+    template <typename Entity>
+    Array<Entity*> createPointerArray(Entity* entitiesOnDevice, int numEntities)
+    {
+        std::vector<Entity*> pointers;
+        for (int i = 0; i < numEntities; ++i) {
+            pointers.emplace_back(entitiesOnDevice + i);
+        }
+        Array<Entity*> result;
+        result.init(numEntities);
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+            result.getArray_host(), pointers.data(), sizeof(Entity*) * numEntities, cudaMemcpyHostToDevice));
+        result.setNumEntries_host(numEntities);
+        return result;
+    }
+
+    std::vector<float3> accumulateDensitiesOnDevice(Scene const& scene, float2 const& rectUpperLeft, float zoom)
+    {
+        auto numCells = static_cast<int>(scene.cells.size());
+        auto numTokens = static_cast<int>(scene.tokenCellIndices.size());
+        auto numParticles = static_cast<int>(scene.particles.size());
+
+        Cell* cellsOnDevice;
+        CHECK_FOR_CUDA_ERROR(cudaMalloc(&cellsOnDevice, sizeof(Cell) * numCells));
+        CHECK_FOR_CUDA_ERROR(
+            cudaMemcpy(cellsOnDevice, scene.cells.data(), sizeof(Cell) * numCells, cudaMemcpyHostToDevice));
+
+        std::vector<Token> tokens(numTokens);
+        for (int i = 0; i < numTokens; ++i) {
+            tokens[i].cell = cellsOnDevice + scene.tokenCellIndices[i];
+        }
+        Token* tokensOnDevice;
+        CHECK_FOR_CUDA_ERROR(cudaMalloc(&tokensOnDevice, sizeof(Token) * numTokens));
+        CHECK_FOR_CUDA_ERROR(
+            cudaMemcpy(tokensOnDevice, tokens.data(), sizeof(Token) * numTokens, cudaMemcpyHostToDevice));
+
+        Particle* particlesOnDevice;
+        CHECK_FOR_CUDA_ERROR(cudaMalloc(&particlesOnDevice, sizeof(Particle) * numParticles));
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+            particlesOnDevice, scene.particles.data(), sizeof(Particle) * numParticles, cudaMemcpyHostToDevice));
+
+        auto cellPointers = createPointerArray(cellsOnDevice, numCells);
+        auto tokenPointers = createPointerArray(tokensOnDevice, numTokens);
+        auto particlePointers = createPointerArray(particlesOnDevice, numParticles);
+
+        auto numPixels = ImageSize.x * ImageSize.y;
+        float3* densityImage;
+        CHECK_FOR_CUDA_ERROR(cudaMalloc(&densityImage, sizeof(float3) * numPixels));
+
+        clearDensityImage<<<NumBlocks, NumThreadsPerBlock>>>(densityImage, ImageSize);
+        accumulateCellDensities<<<NumBlocks, NumThreadsPerBlock>>>(
+            WorldSize, rectUpperLeft, cellPointers, densityImage, ImageSize, zoom);
+        accumulateTokenDensities<<<NumBlocks, NumThreadsPerBlock>>>(
+            WorldSize, rectUpperLeft, tokenPointers, densityImage, ImageSize, zoom);
+        accumulateParticleDensities<<<NumBlocks, NumThreadsPerBlock>>>(
+            rectUpperLeft, particlePointers, densityImage, ImageSize, zoom);
+        CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+
+        std::vector<float3> result(numPixels);
+        CHECK_FOR_CUDA_ERROR(
+            cudaMemcpy(result.data(), densityImage, sizeof(float3) * numPixels, cudaMemcpyDeviceToHost));
+
+        cellPointers.free();
+        tokenPointers.free();
+        particlePointers.free();
+        CHECK_FOR_CUDA_ERROR(cudaFree(cellsOnDevice));
+        CHECK_FOR_CUDA_ERROR(cudaFree(tokensOnDevice));
+        CHECK_FOR_CUDA_ERROR(cudaFree(particlesOnDevice));
+        CHECK_FOR_CUDA_ERROR(cudaFree(densityImage));
+        return result;
+    }
+
+    //the atomic float additions on the device are performed in arbitrary order
+    bool isEqual(float value, double expectedValue)
+    {
+        return std::abs(value - expectedValue) <= 1e-4 * std::max(1.0, std::abs(expectedValue));
+    }
+
+    bool isEqual(std::vector<float3> const& densities, std::vector<Density> const& expectedDensities)
+    {
+        for (size_t i = 0; i < densities.size(); ++i) {
+            auto const& density = densities[i];
+            auto const& expectedDensity = expectedDensities[i];
+            if (!isEqual(density.x, expectedDensity.red) || !isEqual(density.y, expectedDensity.green)
+                || !isEqual(density.z, expectedDensity.blue)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void expectEqualDensities(Scene const& scene, float2 const& rectUpperLeft, float zoom)
+    {
+        HostDensityImage hostImage(rectUpperLeft, zoom);
+        hostImage.accumulate(scene);
+        EXPECT(isEqual(accumulateDensitiesOnDevice(scene, rectUpperLeft, zoom), hostImage.getDensities()));
+    }
+
+    //the image covers more than the world such that all cells and tokens but not all particles are visible
+    void testWholeWorld()
+    {
+        auto scene = createScene(1);
+        auto zoom = toFloat(ImageSize.x) / (toFloat(WorldSize.x) + 100.0f);
+        expectEqualDensities(scene, {-50.0f, -50.0f}, zoom);
+
+        HostDensityImage hostImage({-50.0f, -50.0f}, zoom);
+        hostImage.accumulate(scene);
+        auto const& densities = hostImage.getDensities();
+        auto numNonEmptyPixels = std::count_if(densities.begin(), densities.end(), [](Density const& density) {
+            return density.red > 0 || density.blue > 0;
+        });
+        EXPECT(numNonEmptyPixels > ImageSize.x * ImageSize.y / 4);
+    }
+
+    //entities outside of the image are clipped
+    void testSection()
+    {
+        auto scene = createScene(2);
+        for (auto zoom : {0.1f, 0.3f, Const::MaxZoomLevelForDensityRendering - 0.01f}) {
+            expectEqualDensities(scene, {70.5f, 30.25f}, zoom);
+        }
+    }
+}
+
+int main()
+{
+    Testing::run("whole world", testWholeWorld);
+    Testing::run("section", testSection);
+    return Testing::getExitCode();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <boost/make_shared.hpp>
+#include <boost/optional.hpp>
+
+#include "Base/NumberGenerator.h"
+#include "EngineInterface/Descriptions.h"
+#include "EngineInterface/Settings.h"
+#include "EngineImpl/SimulationController.h"
+
+/**
+ * Helpers for the tests which run the engine. They require a CUDA capable device.
+ */
+namespace EngineTesting
+{
+    inline SimulationController createSimulation(IntVector2D const& worldSize, SimulationParameters const& parameters)
+    {
+        Settings settings;
+        settings.generalSettings.worldSizeX = worldSize.x;
+        settings.generalSettings.worldSizeY = worldSize.y;
+        settings.simulationParameters = parameters;
+        settings.flowFieldSettings.centers[0].posX = static_cast<float>(worldSize.x) / 2;
+        settings.flowFieldSettings.centers[0].posY = static_cast<float>(worldSize.y) / 2;
+
+        auto result = boost::make_shared<_SimulationController>();
+        result->initCuda();
+        result->newSimulation(0, settings, SymbolMap());
+        return result;
+    }
+
+    //parameters without random influences such as radiation
+    inline SimulationParameters createDeterministicParameters()
+    {
+        SimulationParameters result;
+        result.radiationProb = 0;
+        return result;
+    }
+
+    inline CellDescription createCell(RealVector2D const& pos, RealVector2D const& vel = {0, 0})
+    {
+        return CellDescription()
+            .setId(NumberGenerator::getInstance().getId())
+            .setPos(pos)
+            .setVel(vel)
+            .setEnergy(100)
+            .setMaxConnections(2)
+            .setTokenBranchNumber(0)
+            .setFlagTokenBlocked(false)
+            .setTokenUsages(0);
+    }
+
+    inline ClusterDescription createCluster(std::vector<CellDescription> const& cells)
+    {
+        return ClusterDescription().setId(NumberGenerator::getInstance().getId()).addCells(cells);
+    }
+
+    inline DataDescription getAllData(SimulationController const& simController, IntVector2D const& worldSize)
+    {
+        return simController->getSimulationData({0, 0}, worldSize);
+    }
+
+    inline boost::optional<CellDescription> findCell(DataDescription const& data, uint64_t id)
+    {
+        for (auto const& cluster : data.clusters) {
+            for (auto const& cell : cluster.cells) {
+                if (cell.id == id) {
+                    return cell;
+                }
+            }
+        }
+        return boost::none;
+    }
+
+    inline void calcTimesteps(SimulationController const& simController, int numTimesteps)
+    {
+        for (int i = 0; i < numTimesteps; ++i) {
+            simController->calcSingleTimestep();
+        }
+    }
+}
@@ -0,0 +1,250 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "EngineImpl/Socket.h"
+#include "EngineInterface/FrameStreamProtocol.h"
+
+#include "EngineTesting.h"
+#include "Testing.h"
+
+namespace
+{
+    IntVector2D const WorldSize{100, 100};
+    IntVector2D const ImageSize{100, 80};
+    int const TileSize = 32;
+    int const Port = 18780;
+    std::chrono::milliseconds const FrameTimeout(10000);
+
+    std::atomic<bool> const NotCancelled{false};
+
+    struct Frame
+    {
+        FrameStreamFrameHeader header;
+        std::vector<uint32_t> image;
+    };
+
+    FrameStreamSettings createSettings()
+    {
+        FrameStreamSettings result;
+        result.port = Port;
+        result.tileSize = TileSize;
+        return result;
+    }
+
+    FrameStreamRequest createRequest()
+    {
+        FrameStreamRequest result;
+        std::memcpy(result.magic, FrameStream::RequestMagic, sizeof(result.magic));
+        result.version = FrameStream::Version;
+        result.centerX = toFloat(ImageSize.x) / 2;
+        result.centerY = toFloat(ImageSize.y) / 2;
+        result.zoom = 1.0f;
+        result.imageWidth = ImageSize.x;
+        result.imageHeight = ImageSize.y;
+        result.padding = 0;
+        return result;
+    }
+
+    bool sendRequest(Socket& socket, FrameStreamRequest const& request)
+    {
+        return socket.sendAll(&request, sizeof(request), NotCancelled);
+    }
+
+    //receives the next frame and applies its tiles to frame.image which holds the previous image
+    bool receiveFrame(Socket& socket, Frame& frame)
+    {
+        if (!socket.waitForData(FrameTimeout) || !socket.receiveAll(&frame.header, sizeof(frame.header), NotCancelled)
+            || 0 != std::memcmp(frame.header.magic, FrameStream::FrameMagic, sizeof(frame.header.magic))) {
+            return false;
+        }
+        auto const& header = frame.header;
+        frame.image.resize(static_cast<size_t>(header.imageWidth) * header.imageHeight);
+
+        std::vector<uint32_t> row;
+        for (uint32_t i = 0; i < header.numTiles; ++i) {
+            FrameStreamTileHeader tileHeader;
+            if (!socket.receiveAll(&tileHeader, sizeof(tileHeader), NotCancelled)) {
+                return false;
+            }
+            auto startX = tileHeader.tileX * header.tileSize;
+            auto startY = tileHeader.tileY * header.tileSize;
+            if (startX >= header.imageWidth || startY >= header.imageHeight) {
+                return false;
+            }
+            auto width = std::min(header.tileSize, header.imageWidth - startX);
+            auto height = std::min(header.tileSize, header.imageHeight - startY);
+            for (int y = startY; y < startY + height; ++y) {
+                auto offset = static_cast<size_t>(y) * header.imageWidth + startX;
+                if (!socket.receiveAll(&frame.image[offset], sizeof(uint32_t) * width, NotCancelled)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    int getNumTiles()
+    {
+        return ((ImageSize.x + TileSize - 1) / TileSize) * ((ImageSize.y + TileSize - 1) / TileSize);
+    }
+
+    void expectKeyFrame(Frame const& frame)
+    {
+        EXPECT(0 != (frame.header.flags & FrameStream::FrameFlag::KeyFrame));
+        EXPECT(ImageSize.x == frame.header.imageWidth);
+        EXPECT(ImageSize.y == frame.header.imageHeight);
+        EXPECT(TileSize == frame.header.tileSize);
+        EXPECT(getNumTiles() == toInt(frame.header.numTiles));
+    }
+
+    void testKeyFrame()
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+        simController->enableFrameStream(createSettings());
+        {
+            auto socket = Socket::connectTcp("127.0.0.1", Port);
+            EXPECT(sendRequest(socket, createRequest()));
+
+            Frame frame;
+            EXPECT(receiveFrame(socket, frame));
+            expectKeyFrame(frame);
+            EXPECT(1 == frame.header.frameNumber);
+            EXPECT(simController->getCurrentTimestep() == frame.header.timestep);
+        }
+        simController->closeSimulation();
+    }
+
+    //the image composed of a key frame and a delta frame equals a new key frame of the same viewport
+    void testDeltaFrame()
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+        simController->enableFrameStream(createSettings());
+        {
+            auto socket = Socket::connectTcp("127.0.0.1", Port);
+            EXPECT(sendRequest(socket, createRequest()));
+            Frame frame;
+            EXPECT(receiveFrame(socket, frame));
+            expectKeyFrame(frame);
+            auto keyFrameImage = frame.image;
+
+            auto cell = EngineTesting::createCell({10, 10});
+            simController->setSimulationData(DataDescription().addCluster(EngineTesting::createCluster({cell})));
+
+            EXPECT(receiveFrame(socket, frame));
+            EXPECT(0 == (frame.header.flags & FrameStream::FrameFlag::KeyFrame));
+            EXPECT(2 == frame.header.frameNumber);
+            EXPECT(frame.header.numTiles > 0);
+            EXPECT(toInt(frame.header.numTiles) < getNumTiles());
+            EXPECT(keyFrameImage != frame.image);
+
+            Frame newKeyFrame;
+            EXPECT(sendRequest(socket, createRequest()));
+            EXPECT(receiveFrame(socket, newKeyFrame));
+            expectKeyFrame(newKeyFrame);
+            EXPECT(frame.image == newKeyFrame.image);
+        }
+        simController->closeSimulation();
+    }
+
+    void testInvalidRequestClosesConnection()
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+        simController->enableFrameStream(createSettings());
+        {
+            auto socket = Socket::connectTcp("127.0.0.1", Port);
+            auto request = createRequest();
+            request.imageWidth = createSettings().maxImageWidth + 1;
+            EXPECT(sendRequest(socket, request));
+
+            char data;
+            EXPECT(socket.waitForData(FrameTimeout));
+            EXPECT(-1 == socket.receiveSome(&data, sizeof(data)));
+        }
+        simController->closeSimulation();
+    }
+
+    //the outputs of the simulation are continued when it is replaced, e.g. by loading a file
+    void testReplacedSimulation()
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+        simController->enableFrameStream(createSettings());
+        FrameExportSettings frameExportSettings;
+        frameExportSettings.directory =
+            (std::filesystem::temp_directory_path() / "alien_frame_stream_tests_frames").string();
+        simController->enableFrameExport(frameExportSettings);
+
+        simController->replaceSimulation(42, simController->getSettings(), simController->getSymbolMap());
+        EXPECT(simController->getFrameStreamSettings().is_initialized());
+        EXPECT(simController->getFrameExportSettings() == frameExportSettings);
+        {
+            auto socket = Socket::connectTcp("127.0.0.1", Port);
+            EXPECT(sendRequest(socket, createRequest()));
+
+            Frame frame;
+            EXPECT(receiveFrame(socket, frame));
+            expectKeyFrame(frame);
+            EXPECT(42 == frame.header.timestep);
+        }
+        simController->closeSimulation();
+        std::filesystem::remove_all(frameExportSettings.directory);
+    }
+
+    //frames which cannot be written disable the export while the simulation continues
+    void testFailedFrameExport()
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+        FrameExportSettings frameExportSettings;
+        frameExportSettings.directory =
+            (std::filesystem::temp_directory_path() / "alien_frame_stream_tests_failed_frames").string();
+        frameExportSettings.samplingRate = 1;
+        simController->enableFrameExport(frameExportSettings);
+
+        //the directory is replaced by a file such that the frames cannot be written
+        std::filesystem::remove_all(frameExportSettings.directory);
+        std::ofstream(frameExportSettings.directory).put(0);
+
+        EngineTesting::calcTimesteps(simController, 10);
+        EXPECT(!simController->getFrameExportSettings().is_initialized());
+        auto timestep = simController->getCurrentTimestep();
+        EngineTesting::calcTimesteps(simController, 1);
+        EXPECT(timestep + 1 == simController->getCurrentTimestep());
+
+        simController->closeSimulation();
+        std::filesystem::remove_all(frameExportSettings.directory);
+    }
+
+#if !defined(_WIN32)
+    void testUnixSocket()
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+        auto settings = createSettings();
+        settings.useUnixSocket = true;
+        settings.unixSocketPath = "/tmp/alien_frame_stream_tests.sock";
+        simController->enableFrameStream(settings);
+        {
+            auto socket = Socket::connectUnix(settings.unixSocketPath);
+            EXPECT(sendRequest(socket, createRequest()));
+
+            Frame frame;
+            EXPECT(receiveFrame(socket, frame));
+            expectKeyFrame(frame);
+        }
+        simController->closeSimulation();
+    }
+#endif
+}
+
+int main()
+{
+    Testing::run("key frame", testKeyFrame);
+    Testing::run("delta frame", testDeltaFrame);
+    Testing::run("invalid request closes connection", testInvalidRequestClosesConnection);
+    Testing::run("replaced simulation", testReplacedSimulation);
+    Testing::run("failed frame export", testFailedFrameExport);
+#if !defined(_WIN32)
+    Testing::run("unix socket", testUnixSocket);
+#endif
+    return Testing::getExitCode();
+}
@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "EngineGpuKernels/NeighborList.cuh"
+
+#include "Testing.h"
+
+namespace
+{
+    int const NumBlocks = 64;
+    int const NumThreadsPerBlock = 32;
+    int2 const WorldSize{64, 64};
+    float const Radius = CELL_FUNCTION_WEAPON_RANGE;
+
+    __global__ void resetMap(CellMap map) { map.reset(); }
+
+    __global__ void cleanupMap(CellMap map) { map.cleanup_system(); }
+
+    __global__ void updateMap(CellMap map, Array<Cell*> cells)
+    {
+        auto const partition = calcPartition(cells.getNumEntries(), blockIdx.x, gridDim.x);
+        map.set_block(partition.numElements(), &cells.at(partition.startIndex));
+    }
+
+    __global__ void resetUpdateCheck(NeighborList neighborList) { neighborList.resetUpdateCheck(); }
+
+    __global__ void calcDisplacements(NeighborList neighborList, Array<Cell*> cells, CellMap map)
+    {
+        neighborList.calcDisplacements_system(cells, map);
+    }
+
+    __global__ void getUpdateCheck(NeighborList neighborList, Array<Cell> cells, int* result)
+    {
+        result[0] = neighborList.needsRebuild(cells) ? 1 : 0;
+        result[1] = neighborList.hasNewCells() ? 1 : 0;
+    }
+
+    __global__ void prepareBuild(NeighborList neighborList, Array<Cell> cells) { neighborList.prepareBuild(cells); }
+
+    __global__ void build(NeighborList neighborList, Array<Cell*> cells, CellMap map)
+    {
+        neighborList.build_system(cells, map);
+    }
+
+    __global__ void insertNewCells(NeighborList neighborList, Array<Cell*> cells, CellMap map)
+    {
+        neighborList.insertNewCells_system(cells, map);
+    }
+
+    __global__ void buildForNewCells(NeighborList neighborList, Array<Cell*> cells, CellMap map)
+    {
+        neighborList.buildForNewCells_system(cells, map);
+    }
+
+    __global__ void markAsDeleted(Cell** cells, int numCells)
+    {
+        auto const partition = calcAllThreadsPartition(numCells);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            NeighborList::markAsDeleted(cells[index]);
+        }
+    }
+
+    //the map serves as reference since it holds at most one cell per slot in these tests
+    __global__ void countMismatches(NeighborList neighborList, Array<Cell*> cells, CellMap map, int* numMismatches)
+    {
+        auto const partition = calcAllThreadsPartition(cells.getNumEntries());
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& cell = cells.at(index);
+            Cell* listCells[MAX_NEIGHBORS];
+            Cell* mapCells[MAX_NEIGHBORS];
+            int numListCells;
+            int numMapCells;
+            neighborList.get(listCells, MAX_NEIGHBORS, numListCells, cell, Radius, map);
+            map.get(mapCells, MAX_NEIGHBORS, numMapCells, cell->absPos, Radius);
+
+            //both results may include the cell itself
+            bool match = true;
+            for (int i = 0; i < numListCells && match; ++i) {
+                bool found = false;
+                for (int j = 0; j < numMapCells; ++j) {
+                    found |= listCells[i] == mapCells[j];
+                }
+                match = found;
+            }
+            for (int j = 0; j < numMapCells && match; ++j) {
+                bool found = mapCells[j] == cell;
+                for (int i = 0; i < numListCells; ++i) {
+                    found |= listCells[i] == mapCells[j];
+                }
+                match = found;
+            }
+            if (!match) {
+                atomicAdd(numMismatches, 1);
+            }
+        }
+    }
+
+    class NeighborListFixture
+    {
+    public:
+        NeighborListFixture()
+        {
+            SimulationParameters parameters;
+            CHECK_FOR_CUDA_ERROR(
+                cudaMemcpyToSymbol(cudaSimulationParameters, &parameters, sizeof(SimulationParameters)));
+
+            //cells on a jittered grid such that each map slot contains at most one cell
+            std::mt19937 generator(1);
+            std::uniform_real_distribution<float> jitterDistribution(-0.3f, 0.3f);
+            _cells.resize(WorldSize.x * WorldSize.y);
+            for (int y = 0; y < WorldSize.y; ++y) {
+                for (int x = 0; x < WorldSize.x; ++x) {
+                    auto& cell = _cells[x + y * WorldSize.x];
+                    cell.absPos = {
+                        static_cast<float>(x) + 0.5f + jitterDistribution(generator),
+                        static_cast<float>(y) + 0.5f + jitterDistribution(generator)};
+                }
+            }
+            auto numCells = static_cast<int>(_cells.size());
+            _cellArray.init(numCells);
+            _cellArray.setNumEntries_host(numCells);
+            _cellPointers.init(numCells);
+            _map.init(WorldSize);
+            _map.resize(numCells);
+            _neighborList.init();
+            _neighborList.resize(numCells);
+            CHECK_FOR_CUDA_ERROR(cudaMalloc(&_result, sizeof(int) * 2));
+            upload();
+        }
+
+        ~NeighborListFixture()
+        {
+            _cellArray.free();
+            _cellPointers.free();
+            _map.free();
+            _neighborList.free();
+            CHECK_FOR_CUDA_ERROR(cudaFree(_result));
+        }
+
+        std::vector<Cell>& getCells() { return _cells; }
+
+        Cell* getCellOnDevice(int index) { return _cellArray.getArray_host() + index; }
+
+        void upload()
+        {
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                _cellArray.getArray_host(), _cells.data(), sizeof(Cell) * _cells.size(), cudaMemcpyHostToDevice));
+        }
+
+        void download()
+        {
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                _cells.data(), _cellArray.getArray_host(), sizeof(Cell) * _cells.size(), cudaMemcpyDeviceToHost));
+        }
+
+        //the pointer array corresponds to data.entities.cellPointers and the map is updated accordingly
+        void setCellPointers(std::vector<int> const& cellIndices)
+        {
+            std::vector<Cell*> cellPointers;
+            for (auto const& index : cellIndices) {
+                cellPointers.emplace_back(getCellOnDevice(index));
+            }
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                _cellPointers.getArray_host(),
+                cellPointers.data(),
+                sizeof(Cell*) * cellPointers.size(),
+                cudaMemcpyHostToDevice));
+            _cellPointers.setNumEntries_host(static_cast<int>(cellPointers.size()));
+
+            cleanupMap<<<NumBlocks, NumThreadsPerBlock>>>(_map);
+            resetMap<<<1, 1>>>(_map);
+            updateMap<<<NumBlocks, NumThreadsPerBlock>>>(_map, _cellPointers);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+        }
+
+        void checkForUpdate(bool& needsRebuild, bool& hasNewCells)
+        {
+            resetUpdateCheck<<<1, 1>>>(_neighborList);
+            calcDisplacements<<<NumBlocks, NumThreadsPerBlock>>>(_neighborList, _cellPointers, _map);
+            getUpdateCheck<<<1, 1>>>(_neighborList, _cellArray, _result);
+            int result[2];
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(result, _result, sizeof(int) * 2, cudaMemcpyDeviceToHost));
+            needsRebuild = result[0] != 0;
+            hasNewCells = result[1] != 0;
+        }
+
+        void build()
+        {
+            prepareBuild<<<1, 1>>>(_neighborList, _cellArray);
+            ::build<<<NumBlocks, NumThreadsPerBlock>>>(_neighborList, _cellPointers, _map);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+        }
+
+        void insertNewCells()
+        {
+            ::insertNewCells<<<NumBlocks, NumThreadsPerBlock>>>(_neighborList, _cellPointers, _map);
+            buildForNewCells<<<NumBlocks, NumThreadsPerBlock>>>(_neighborList, _cellPointers, _map);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+        }
+
+        void markAsDeleted(std::vector<int> const& cellIndices)
+        {
+            std::vector<Cell*> cellPointers;
+            for (auto const& index : cellIndices) {
+                cellPointers.emplace_back(getCellOnDevice(index));
+            }
+            Cell** cellPointersOnDevice;
+            CHECK_FOR_CUDA_ERROR(cudaMalloc(&cellPointersOnDevice, sizeof(Cell*) * cellPointers.size()));
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                cellPointersOnDevice,
+                cellPointers.data(),
+                sizeof(Cell*) * cellPointers.size(),
+                cudaMemcpyHostToDevice));
+            ::markAsDeleted<<<NumBlocks, NumThreadsPerBlock>>>(
+                cellPointersOnDevice, static_cast<int>(cellPointers.size()));
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+            CHECK_FOR_CUDA_ERROR(cudaFree(cellPointersOnDevice));
+        }
+
+        int countMismatches()
+        {
+            CHECK_FOR_CUDA_ERROR(cudaMemset(_result, 0, sizeof(int)));
+            ::countMismatches<<<NumBlocks, NumThreadsPerBlock>>>(_neighborList, _cellPointers, _map, _result);
+            int result;
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(&result, _result, sizeof(int), cudaMemcpyDeviceToHost));
+            return result;
+        }
+
+        //moves the cells in random directions by at most maxDistance without leaving their map slots
+        void moveCells(std::mt19937& generator, float maxDistance)
+        {
+            download();
+            std::uniform_real_distribution<float> distribution(-maxDistance, maxDistance);
+            for (auto& cell : _cells) {
+                float2 delta{distribution(generator), distribution(generator)};
+                auto length = sqrtf(delta.x * delta.x + delta.y * delta.y);
+                if (length > maxDistance) {
+                    delta = {delta.x * maxDistance / length, delta.y * maxDistance / length};
+                }
+                cell.absPos = {cell.absPos.x + delta.x, cell.absPos.y + delta.y};
+            }
+            upload();
+        }
+
+    private:
+        std::vector<Cell> _cells;
+        Array<Cell> _cellArray;
+        Array<Cell*> _cellPointers;
+        CellMap _map;
+        NeighborList _neighborList;
+        int* _result;
+    };
+
+    std::vector<int> getAllIndices(int numCells)
+    {
+        std::vector<int> result(numCells);
+        for (int i = 0; i < numCells; ++i) {
+            result[i] = i;
+        }
+        return result;
+    }
+
+    void testRebuild()
+    {
+        NeighborListFixture fixture;
+        auto numCells = static_cast<int>(fixture.getCells().size());
+        fixture.setCellPointers(getAllIndices(numCells));
+
+        bool needsRebuild;
+        bool hasNewCells;
+        fixture.checkForUpdate(needsRebuild, hasNewCells);
+        EXPECT(needsRebuild);
+        fixture.build();
+        EXPECT(fixture.countMismatches() == 0);
+
+        //moving cells by less than half of the skin keeps the lists valid
+        std::mt19937 generator(2);
+        fixture.moveCells(generator, NEIGHBOR_LIST_SKIN / 2 * 0.9f);
+        fixture.setCellPointers(getAllIndices(numCells));
+        fixture.checkForUpdate(needsRebuild, hasNewCells);
+        EXPECT(!needsRebuild);
+        EXPECT(!hasNewCells);
+        EXPECT(fixture.countMismatches() == 0);
+
+        fixture.moveCells(generator, NEIGHBOR_LIST_SKIN / 2 * 0.9f);
+        fixture.setCellPointers(getAllIndices(numCells));
+        fixture.checkForUpdate(needsRebuild, hasNewCells);
+        EXPECT(needsRebuild);
+    }
+
+    //new cells are inserted without rebuild, the lists remain valid while the cells keep moving
+    void testInsertion()
+    {
+        NeighborListFixture fixture;
+        auto& cells = fixture.getCells();
+        auto numCells = static_cast<int>(cells.size());
+
+        //a block of new cells exceeds the spare entries of the cell in the center
+        int2 const center{33, 33};
+        auto isNewCell = [&](int index) {
+            auto x = index % WorldSize.x;
+            auto y = index / WorldSize.x;
+            auto isInBlock = abs(x - center.x) <= 1 && abs(y - center.y) <= 1 && !(x == center.x && y == center.y);
+            return index % 10 == 0 || isInBlock;
+        };
+        std::vector<int> oldCellIndices;
+        for (int i = 0; i < numCells; ++i) {
+            if (isNewCell(i)) {
+                cells[i].numNeighbors = NeighborListState::NotInserted;
+            } else {
+                oldCellIndices.emplace_back(i);
+            }
+        }
+        fixture.upload();
+        fixture.setCellPointers(oldCellIndices);
+        fixture.build();
+
+        std::mt19937 generator(3);
+        auto const maxDistance = NEIGHBOR_LIST_SKIN / 4 * 0.9f;
+        fixture.moveCells(generator, maxDistance);
+        fixture.setCellPointers(getAllIndices(numCells));
+        bool needsRebuild;
+        bool hasNewCells;
+        fixture.checkForUpdate(needsRebuild, hasNewCells);
+        EXPECT(!needsRebuild);
+        EXPECT(hasNewCells);
+        fixture.insertNewCells();
+        EXPECT(fixture.countMismatches() == 0);
+
+        fixture.download();
+        auto const& centerCell = cells[center.x + center.y * WorldSize.x];
+        EXPECT(centerCell.numNeighbors == NeighborListState::UseCellMap);
+        for (int i = 0; i < numCells; ++i) {
+            if (isNewCell(i) && cells[i].numNeighbors == NeighborListState::NotInserted) {
+                EXPECT(false);
+                break;
+            }
+        }
+
+        fixture.moveCells(generator, maxDistance);
+        fixture.setCellPointers(getAllIndices(numCells));
+        fixture.checkForUpdate(needsRebuild, hasNewCells);
+        EXPECT(!needsRebuild);
+        EXPECT(!hasNewCells);
+        EXPECT(fixture.countMismatches() == 0);
+    }
+
+    void testDeletion()
+    {
+        NeighborListFixture fixture;
+        auto numCells = static_cast<int>(fixture.getCells().size());
+        fixture.setCellPointers(getAllIndices(numCells));
+        fixture.build();
+
+        std::vector<int> remainingCellIndices;
+        std::vector<int> deletedCellIndices;
+        for (int i = 0; i < numCells; ++i) {
+            if (i % 7 == 0) {
+                deletedCellIndices.emplace_back(i);
+            } else {
+                remainingCellIndices.emplace_back(i);
+            }
+        }
+        fixture.markAsDeleted(deletedCellIndices);
+        fixture.setCellPointers(remainingCellIndices);
+
+        bool needsRebuild;
+        bool hasNewCells;
+        fixture.checkForUpdate(needsRebuild, hasNewCells);
+        EXPECT(!needsRebuild);
+        EXPECT(!hasNewCells);
+        EXPECT(fixture.countMismatches() == 0);
+    }
+}
+
+int main()
+{
+    Testing::run("rebuild", testRebuild);
+    Testing::run("insertion", testInsertion);
+    Testing::run("deletion", testDeletion);
+    return Testing::getExitCode();
+}
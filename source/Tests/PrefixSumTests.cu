@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "EngineGpuKernels/PrefixSum.cuh"
+
+#include "Testing.h"
+
+namespace
+{
+    int const NumBlocks = 64;
+    int const NumThreadsPerBlock = 32;
+
+    __global__ void calcChunkSums(PrefixSum prefixSum, int* values, int numValues)
+    {
+        prefixSum.calcChunkSums_system(values, numValues);
+    }
+
+    __global__ void scanChunkSums(PrefixSum prefixSum, int* result, int numValues)
+    {
+        prefixSum.scanChunkSums(result, numValues);
+    }
+
+    __global__ void calcPrefixSums(PrefixSum prefixSum, int* values, int* result, int numValues)
+    {
+        prefixSum.calcPrefixSums_system(values, result, numValues);
+    }
+
+    void testPrefixSums()
+    {
+        std::mt19937 generator(1);
+        std::uniform_int_distribution<int> valueDistribution(0, 9);
+        int const chunkSize = PREFIX_SUM_CHUNK_SIZE;
+        for (int numValues : {0, 1, chunkSize - 1, chunkSize, chunkSize + 1, 100000}) {
+            std::vector<int> values(numValues);
+            for (auto& value : values) {
+                value = valueDistribution(generator);
+            }
+
+            int* valuesOnDevice;
+            int* resultOnDevice;
+            CHECK_FOR_CUDA_ERROR(cudaMalloc(&valuesOnDevice, sizeof(int) * std::max(1, numValues)));
+            CHECK_FOR_CUDA_ERROR(cudaMalloc(&resultOnDevice, sizeof(int) * (numValues + 1)));
+            CHECK_FOR_CUDA_ERROR(
+                cudaMemcpy(valuesOnDevice, values.data(), sizeof(int) * numValues, cudaMemcpyHostToDevice));
+
+            PrefixSum prefixSum;
+            prefixSum.init(numValues);
+            calcChunkSums<<<NumBlocks, NumThreadsPerBlock>>>(prefixSum, valuesOnDevice, numValues);
+            scanChunkSums<<<1, 1>>>(prefixSum, resultOnDevice, numValues);
+            calcPrefixSums<<<NumBlocks, NumThreadsPerBlock>>>(prefixSum, valuesOnDevice, resultOnDevice, numValues);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+
+            std::vector<int> result(numValues + 1);
+            CHECK_FOR_CUDA_ERROR(
+                cudaMemcpy(result.data(), resultOnDevice, sizeof(int) * (numValues + 1), cudaMemcpyDeviceToHost));
+            int sum = 0;
+            for (int i = 0; i < numValues; ++i) {
+                EXPECT(result[i] == sum);
+                sum += values[i];
+            }
+            EXPECT(result[numValues] == sum);
+
+            prefixSum.free();
+            CHECK_FOR_CUDA_ERROR(cudaFree(valuesOnDevice));
+            CHECK_FOR_CUDA_ERROR(cudaFree(resultOnDevice));
+        }
+    }
+}
+
+int main()
+{
+    Testing::run("prefix sums", testPrefixSums);
+    return Testing::getExitCode();
+}
@@ -0,0 +1,358 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "EngineGpuKernels/SpatialIndex.cuh"
+
+#include "Testing.h"
+
+namespace
+{
+    int const NumBlocks = 64;
+    int const NumThreadsPerBlock = 32;
+    int const TileSize = SPATIAL_INDEX_TILE_SIZE;
+
+    struct RegionQuery
+    {
+        float2 rectUpperLeft;
+        float2 rectLowerRight;
+    };
+
+    struct RegionQueryResult
+    {
+        int numCells;
+        long long int sumOfCellIndices;
+
+        bool operator==(RegionQueryResult const& other) const
+        {
+            return numCells == other.numCells && sumOfCellIndices == other.sumOfCellIndices;
+        }
+    };
+
+    __global__ void resetIndex(TileIndex<Cell> index) { index.reset_system(); }
+
+    __global__ void countCells(TileIndex<Cell> index, Array<Cell*> cells) { index.count_system(cells); }
+
+    __global__ void calcChunkSums(TileIndex<Cell> index) { index.calcChunkSums_system(); }
+
+    __global__ void reserveCells(TileIndex<Cell> index) { index.reserveEntities(); }
+
+    __global__ void calcTileStarts(TileIndex<Cell> index) { index.calcTileStarts_system(); }
+
+    __global__ void insertCells(TileIndex<Cell> index, Array<Cell*> cells) { index.insert_system(cells); }
+
+    __global__ void getCellsInTile(TileIndex<Cell> index, int2 tile, Cell** result, int* numCells)
+    {
+        auto cells = index.getSlice(TileRange{tile, tile}, 0, *numCells);
+        for (int i = 0; i < *numCells; ++i) {
+            result[i] = cells[i];
+        }
+    }
+
+    //the exact test corresponds to the one in getCellAccessDataWithoutConnections
+    __global__ void runRegionQueries(
+        TileIndex<Cell> index,
+        Cell* cellArrayStart,
+        RegionQuery* queries,
+        RegionQueryResult* results,
+        int numQueries)
+    {
+        auto const partition = calcAllThreadsPartition(numQueries);
+        for (int queryIndex = partition.startIndex; queryIndex <= partition.endIndex; ++queryIndex) {
+            auto const& query = queries[queryIndex];
+            auto const range = index.getTileRange(query.rectUpperLeft, query.rectLowerRight);
+            RegionQueryResult result{0, 0};
+            for (int slice = 0; slice < index.getNumSlices(range); ++slice) {
+                int numCells;
+                auto cells = index.getSlice(range, slice, numCells);
+                for (int i = 0; i < numCells; ++i) {
+                    auto pos = cells[i]->absPos;
+                    index.mapPosCorrection(pos);
+                    if (isContainedInRect(query.rectUpperLeft, query.rectLowerRight, pos)) {
+                        ++result.numCells;
+                        result.sumOfCellIndices += cells[i] - cellArrayStart;
+                    }
+                }
+            }
+            results[queryIndex] = result;
+        }
+    }
+
+    /**
+     * Host implementation of the tile index which serves as reference for the kernels. It sorts the cell indices by
+     * tile via a counting sort and answers region queries from the tiles overlapping the query region.
+     */
+    class HostTileIndex
+    {
+    public:
+        HostTileIndex(int2 const& worldSize, std::vector<Cell> const& cells)
+            : _numTiles{(worldSize.x + TileSize - 1) / TileSize, (worldSize.y + TileSize - 1) / TileSize}
+            , _cells(cells)
+        {
+            _map.init(worldSize);
+            std::vector<int> numCellsByTile(_numTiles.x * _numTiles.y, 0);
+            for (auto const& cell : cells) {
+                ++numCellsByTile[getTileIndex(cell.absPos)];
+            }
+            _tileStarts.resize(numCellsByTile.size() + 1);
+            int sum = 0;
+            for (size_t tile = 0; tile < numCellsByTile.size(); ++tile) {
+                _tileStarts[tile] = sum;
+                sum += numCellsByTile[tile];
+            }
+            _tileStarts.back() = sum;
+
+            _cellIndices.resize(sum);
+            auto tileEnds = std::vector<int>(_tileStarts.begin() + 1, _tileStarts.end());
+            for (int index = static_cast<int>(cells.size()) - 1; index >= 0; --index) {
+                _cellIndices[--tileEnds[getTileIndex(cells[index].absPos)]] = index;
+            }
+        }
+
+        std::vector<int> getCellIndicesInTile(int2 const& tile) const
+        {
+            auto tileIndex = tile.x + tile.y * _numTiles.x;
+            return std::vector<int>(
+                _cellIndices.begin() + _tileStarts[tileIndex], _cellIndices.begin() + _tileStarts[tileIndex + 1]);
+        }
+
+        RegionQueryResult query(RegionQuery const& query) const
+        {
+            int2 fromTile{
+                floorInt(query.rectUpperLeft.x / TileSize) - 1, floorInt(query.rectUpperLeft.y / TileSize) - 1};
+            int2 toTile{
+                floorInt(query.rectLowerRight.x / TileSize) + 1, floorInt(query.rectLowerRight.y / TileSize) + 1};
+            toTile.x = std::min(toTile.x, fromTile.x + _numTiles.x - 1);
+            toTile.y = std::min(toTile.y, fromTile.y + _numTiles.y - 1);
+
+            RegionQueryResult result{0, 0};
+            for (int y = fromTile.y; y <= toTile.y; ++y) {
+                for (int x = fromTile.x; x <= toTile.x; ++x) {
+                    int2 tile{
+                        (x % _numTiles.x + _numTiles.x) % _numTiles.x, (y % _numTiles.y + _numTiles.y) % _numTiles.y};
+                    for (auto const& index : getCellIndicesInTile(tile)) {
+                        auto pos = _cells[index].absPos;
+                        _map.mapPosCorrection(pos);
+                        if (isContainedInRect(query.rectUpperLeft, query.rectLowerRight, pos)) {
+                            ++result.numCells;
+                            result.sumOfCellIndices += index;
+                        }
+                    }
+                }
+            }
+            return result;
+        }
+
+    private:
+        int getTileIndex(float2 pos) const
+        {
+            _map.mapPosCorrection(pos);
+            auto tileX = std::min(floorInt(pos.x) / TileSize, _numTiles.x - 1);
+            auto tileY = std::min(floorInt(pos.y) / TileSize, _numTiles.y - 1);
+            return tileX + tileY * _numTiles.x;
+        }
+
+        int2 _numTiles;
+        MapInfo _map;
+        std::vector<Cell> const& _cells;
+        std::vector<int> _tileStarts;
+        std::vector<int> _cellIndices;
+    };
+
+    //brute force reference for the host implementation
+    RegionQueryResult queryAllCells(int2 const& worldSize, std::vector<Cell> const& cells, RegionQuery const& query)
+    {
+        MapInfo map;
+        map.init(worldSize);
+        RegionQueryResult result{0, 0};
+        for (int index = 0; index < static_cast<int>(cells.size()); ++index) {
+            auto pos = cells[index].absPos;
+            map.mapPosCorrection(pos);
+            if (isContainedInRect(query.rectUpperLeft, query.rectLowerRight, pos)) {
+                ++result.numCells;
+                result.sumOfCellIndices += index;
+            }
+        }
+        return result;
+    }
+
+    class SpatialIndexFixture
+    {
+    public:
+        //the cells may lie slightly outside of the world as before their positions are corrected
+        SpatialIndexFixture(int2 const& worldSize, int numCells, unsigned int seed)
+        {
+            std::mt19937 generator(seed);
+            std::uniform_real_distribution<float> xDistribution(-5.0f, static_cast<float>(worldSize.x) + 5.0f);
+            std::uniform_real_distribution<float> yDistribution(-5.0f, static_cast<float>(worldSize.y) + 5.0f);
+            _cells.resize(numCells);
+            for (auto& cell : _cells) {
+                cell.absPos = {xDistribution(generator), yDistribution(generator)};
+            }
+            CHECK_FOR_CUDA_ERROR(cudaMalloc(&_cellsOnDevice, sizeof(Cell) * numCells));
+            CHECK_FOR_CUDA_ERROR(
+                cudaMemcpy(_cellsOnDevice, _cells.data(), sizeof(Cell) * numCells, cudaMemcpyHostToDevice));
+
+            //null entries as left by deleted cells are skipped
+            std::vector<Cell*> cellPointers;
+            for (int i = 0; i < numCells; ++i) {
+                cellPointers.emplace_back(_cellsOnDevice + i);
+                if (i % 10 == 0) {
+                    cellPointers.emplace_back(nullptr);
+                }
+            }
+            auto numCellPointers = static_cast<int>(cellPointers.size());
+            _cellPointers.init(numCellPointers);
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                _cellPointers.getArray_host(),
+                cellPointers.data(),
+                sizeof(Cell*) * numCellPointers,
+                cudaMemcpyHostToDevice));
+            _cellPointers.setNumEntries_host(numCellPointers);
+
+            _index.init(worldSize, TileSize);
+            _index.resize(numCells);
+        }
+
+        ~SpatialIndexFixture()
+        {
+            _index.free();
+            _cellPointers.free();
+            CHECK_FOR_CUDA_ERROR(cudaFree(_cellsOnDevice));
+        }
+
+        std::vector<Cell> const& getCells() const { return _cells; }
+
+        void buildIndex()
+        {
+            resetIndex<<<NumBlocks, NumThreadsPerBlock>>>(_index);
+            countCells<<<NumBlocks, NumThreadsPerBlock>>>(_index, _cellPointers);
+            calcChunkSums<<<NumBlocks, NumThreadsPerBlock>>>(_index);
+            reserveCells<<<1, 1>>>(_index);
+            calcTileStarts<<<NumBlocks, NumThreadsPerBlock>>>(_index);
+            insertCells<<<NumBlocks, NumThreadsPerBlock>>>(_index, _cellPointers);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+        }
+
+        std::vector<int> getCellIndicesInTile(int2 const& tile)
+        {
+            Cell** resultOnDevice;
+            int* numCellsOnDevice;
+            CHECK_FOR_CUDA_ERROR(cudaMalloc(&resultOnDevice, sizeof(Cell*) * _cells.size()));
+            CHECK_FOR_CUDA_ERROR(cudaMalloc(&numCellsOnDevice, sizeof(int)));
+            getCellsInTile<<<1, 1>>>(_index, tile, resultOnDevice, numCellsOnDevice);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+
+            int numCells;
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(&numCells, numCellsOnDevice, sizeof(int), cudaMemcpyDeviceToHost));
+            std::vector<Cell*> cells(numCells);
+            CHECK_FOR_CUDA_ERROR(
+                cudaMemcpy(cells.data(), resultOnDevice, sizeof(Cell*) * numCells, cudaMemcpyDeviceToHost));
+            CHECK_FOR_CUDA_ERROR(cudaFree(resultOnDevice));
+            CHECK_FOR_CUDA_ERROR(cudaFree(numCellsOnDevice));
+
+            std::vector<int> result;
+            for (auto const& cell : cells) {
+                result.emplace_back(static_cast<int>(cell - _cellsOnDevice));
+            }
+            return result;
+        }
+
+        std::vector<RegionQueryResult> runRegionQueries(std::vector<RegionQuery> const& queries)
+        {
+            auto numQueries = static_cast<int>(queries.size());
+            RegionQuery* queriesOnDevice;
+            RegionQueryResult* resultsOnDevice;
+            CHECK_FOR_CUDA_ERROR(cudaMalloc(&queriesOnDevice, sizeof(RegionQuery) * numQueries));
+            CHECK_FOR_CUDA_ERROR(cudaMalloc(&resultsOnDevice, sizeof(RegionQueryResult) * numQueries));
+            CHECK_FOR_CUDA_ERROR(
+                cudaMemcpy(queriesOnDevice, queries.data(), sizeof(RegionQuery) * numQueries, cudaMemcpyHostToDevice));
+            ::runRegionQueries<<<NumBlocks, NumThreadsPerBlock>>>(
+                _index, _cellsOnDevice, queriesOnDevice, resultsOnDevice, numQueries);
+            CHECK_FOR_CUDA_ERROR(cudaDeviceSynchronize());
+
+            std::vector<RegionQueryResult> result(numQueries);
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+                result.data(), resultsOnDevice, sizeof(RegionQueryResult) * numQueries, cudaMemcpyDeviceToHost));
+            CHECK_FOR_CUDA_ERROR(cudaFree(queriesOnDevice));
+            CHECK_FOR_CUDA_ERROR(cudaFree(resultsOnDevice));
+            return result;
+        }
+
+    private:
+        std::vector<Cell> _cells;
+        Cell* _cellsOnDevice;
+        Array<Cell*> _cellPointers;
+        TileIndex<Cell> _index;
+    };
+
+    //the world sizes are not multiples of the tile size and lead to more tiles than one prefix sum chunk
+    int2 const WorldSize{1000, 700};
+    int const NumCells = 20000;
+
+    //every tile of the index should contain exactly the cells of the host implementation
+    void testTileContent()
+    {
+        SpatialIndexFixture fixture(WorldSize, NumCells, 1);
+        HostTileIndex hostIndex(WorldSize, fixture.getCells());
+        int2 const numTiles{(WorldSize.x + TileSize - 1) / TileSize, (WorldSize.y + TileSize - 1) / TileSize};
+        EXPECT(numTiles.x * numTiles.y > PREFIX_SUM_CHUNK_SIZE);
+
+        //the second build checks that the tile counts are reset
+        for (int build = 0; build < 2; ++build) {
+            fixture.buildIndex();
+            auto match = true;
+            auto totalNumCells = 0;
+            for (int y = 0; y < numTiles.y; ++y) {
+                for (int x = 0; x < numTiles.x; ++x) {
+                    auto cellIndices = fixture.getCellIndicesInTile({x, y});
+                    auto expectedCellIndices = hostIndex.getCellIndicesInTile({x, y});
+                    std::sort(cellIndices.begin(), cellIndices.end());
+                    match &= cellIndices == expectedCellIndices;
+                    totalNumCells += static_cast<int>(cellIndices.size());
+                }
+            }
+            EXPECT(match);
+            EXPECT(NumCells == totalNumCells);
+        }
+    }
+
+    //the queries include regions crossing the world boundaries and regions larger than the world
+    void testRegionQueries()
+    {
+        SpatialIndexFixture fixture(WorldSize, NumCells, 2);
+        fixture.buildIndex();
+        HostTileIndex hostIndex(WorldSize, fixture.getCells());
+
+        std::mt19937 generator(3);
+        std::uniform_real_distribution<float> posDistribution(-100.0f, 1100.0f);
+        std::uniform_real_distribution<float> sizeDistribution(0, 300.0f);
+        std::vector<RegionQuery> queries;
+        for (int i = 0; i < 1000; ++i) {
+            float2 upperLeft{posDistribution(generator), posDistribution(generator)};
+            queries.emplace_back(RegionQuery{
+                upperLeft, {upperLeft.x + sizeDistribution(generator), upperLeft.y + sizeDistribution(generator)}});
+        }
+        queries.emplace_back(RegionQuery{{-10.0f, -10.0f}, {2000.0f, 2000.0f}});
+        queries.emplace_back(RegionQuery{{0, 0}, {0, 0}});
+
+        auto results = fixture.runRegionQueries(queries);
+        auto matchesHostIndex = true;
+        auto matchesAllCells = true;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            auto expectedResult = hostIndex.query(queries[i]);
+            matchesHostIndex &= results[i] == expectedResult;
+            matchesAllCells &= expectedResult == queryAllCells(WorldSize, fixture.getCells(), queries[i]);
+        }
+        EXPECT(matchesHostIndex);
+        EXPECT(matchesAllCells);
+        EXPECT(NumCells == results[results.size() - 2].numCells);
+    }
+}
+
+int main()
+{
+    Testing::run("tile content", testTileContent);
+    Testing::run("region queries", testRegionQueries);
+    return Testing::getExitCode();
+}
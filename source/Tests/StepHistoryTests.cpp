@@ -0,0 +1,221 @@
+#include <map>
+
+#include "EngineImpl/StepHistory.h"
+
+#include "EngineTesting.h"
+#include "Testing.h"
+
+namespace
+{
+    IntVector2D const WorldSize{100, 100};
+
+    //more steps than the key frame interval such that states are restored from deltas over several key frames
+    int const NumSteps = 40;
+
+    struct CellState
+    {
+        RealVector2D pos;
+        RealVector2D vel;
+        double energy;
+        std::vector<TokenDescription> tokens;
+    };
+
+    struct Snapshot
+    {
+        uint64_t timestep = 0;
+        std::map<uint64_t, CellState> cells;
+    };
+
+    Snapshot getSnapshot(SimulationController const& simController)
+    {
+        Snapshot result;
+        result.timestep = simController->getCurrentTimestep();
+        for (auto const& cluster : EngineTesting::getAllData(simController, WorldSize).clusters) {
+            for (auto const& cell : cluster.cells) {
+                result.cells.emplace(cell.id, CellState{cell.pos, cell.vel, cell.energy, cell.tokens});
+            }
+        }
+        return result;
+    }
+
+    bool isEqual(Snapshot const& snapshot, Snapshot const& otherSnapshot)
+    {
+        if (snapshot.timestep != otherSnapshot.timestep || snapshot.cells.size() != otherSnapshot.cells.size()) {
+            return false;
+        }
+        for (auto const& [id, cell] : snapshot.cells) {
+            auto findResult = otherSnapshot.cells.find(id);
+            if (findResult == otherSnapshot.cells.end()) {
+                return false;
+            }
+            auto const& otherCell = findResult->second;
+            if (cell.pos != otherCell.pos || cell.vel != otherCell.vel || cell.energy != otherCell.energy
+                || cell.tokens != otherCell.tokens) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    ClusterDescription createMovingCluster(RealVector2D const& pos, RealVector2D const& vel)
+    {
+        auto cell = EngineTesting::createCell(pos, vel);
+        std::string tokenData(SimulationParameters().tokenMemorySize, 0);
+        tokenData[0] = 1;
+        cell.addToken(TokenDescription().setEnergy(30).setData(tokenData));
+        return EngineTesting::createCluster({cell});
+    }
+
+    SimulationController createSimulationWithMovingCells()
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+        DataDescription data;
+        for (int i = 0; i < 10; ++i) {
+            data.addCluster(createMovingCluster({10.0f + toFloat(i) * 8, 50}, {0.1f, 0.05f * toFloat(i % 3)}));
+        }
+        simController->setSimulationData(data);
+        return simController;
+    }
+
+    //stores the states before each step, new cells are added in between such that records are matched by id
+    std::vector<Snapshot> pushSteps(SimulationController const& simController, StepHistory const& history)
+    {
+        std::vector<Snapshot> result;
+        for (int i = 0; i < NumSteps; ++i) {
+            result.emplace_back(getSnapshot(simController));
+            history->push();
+            if (i % 7 == 3) {
+                simController->addAndSelectSimulationData(
+                    DataDescription().addCluster(createMovingCluster({50, 10.0f + toFloat(i)}, {-0.1f, 0})));
+            }
+            simController->calcSingleTimestep();
+        }
+        return result;
+    }
+
+    void testRestoreAllSteps()
+    {
+        auto simController = createSimulationWithMovingCells();
+        auto history = boost::make_shared<_StepHistory>(simController);
+        auto snapshots = pushSteps(simController, history);
+        EXPECT(NumSteps == history->getNumEntries());
+
+        for (int i = NumSteps - 1; i >= 0; --i) {
+            history->restore();
+            EXPECT(isEqual(snapshots[i], getSnapshot(simController)));
+        }
+        EXPECT(history->isEmpty());
+        EXPECT(0 == history->getMemorySize());
+        simController->closeSimulation();
+    }
+
+    //the oldest entries are dropped and the new oldest entry is converted to a key frame
+    void testMemoryBudget()
+    {
+        auto simController = createSimulationWithMovingCells();
+        auto history = boost::make_shared<_StepHistory>(simController);
+        auto snapshots = pushSteps(simController, history);
+
+        history->setMemoryBudget(history->getMemorySize() / 2);
+        auto numEntries = history->getNumEntries();
+        EXPECT(numEntries > 0 && numEntries < NumSteps);
+        EXPECT(history->getMemorySize() <= history->getMemoryBudget() || 1 == numEntries);
+
+        for (int i = NumSteps - 1; i >= NumSteps - numEntries; --i) {
+            history->restore();
+            EXPECT(isEqual(snapshots[i], getSnapshot(simController)));
+        }
+        EXPECT(history->isEmpty());
+        simController->closeSimulation();
+    }
+
+    //a history which is continued after restoring encodes the new states against the restored state
+    void testPushAfterRestore()
+    {
+        auto simController = createSimulationWithMovingCells();
+        auto history = boost::make_shared<_StepHistory>(simController);
+        auto snapshots = pushSteps(simController, history);
+        for (int i = 0; i < NumSteps / 2; ++i) {
+            history->restore();
+        }
+
+        auto snapshot = getSnapshot(simController);
+        history->push();
+        simController->calcSingleTimestep();
+        history->restore();
+        EXPECT(isEqual(snapshot, getSnapshot(simController)));
+        history->restore();
+        EXPECT(isEqual(snapshots[NumSteps / 2 - 1], getSnapshot(simController)));
+        simController->closeSimulation();
+    }
+
+    //states of a replaced simulation are discarded instead of being set into the new simulation
+    void testReplacedSimulation()
+    {
+        auto simController = createSimulationWithMovingCells();
+        auto history = boost::make_shared<_StepHistory>(simController);
+        pushSteps(simController, history);
+
+        simController->replaceSimulation(0, simController->getSettings(), simController->getSymbolMap());
+        EXPECT(history->isEmpty());
+        history->restore();
+        EXPECT(getSnapshot(simController).cells.empty());
+
+        auto snapshot = getSnapshot(simController);
+        history->push();
+        simController->calcSingleTimestep();
+        history->restore();
+        EXPECT(isEqual(snapshot, getSnapshot(simController)));
+        simController->closeSimulation();
+    }
+
+    //states of the previous world size are discarded
+    void testResizedWorld()
+    {
+        auto simController = createSimulationWithMovingCells();
+        auto history = boost::make_shared<_StepHistory>(simController);
+        pushSteps(simController, history);
+
+        simController->resizeWorld({WorldSize.x * 2, WorldSize.y}, WorldResizeMode::Remap);
+        auto snapshot = getSnapshot(simController);
+        EXPECT(history->isEmpty());
+        EXPECT(0 == history->getNumEntries());
+        history->restore();
+        EXPECT(isEqual(snapshot, getSnapshot(simController)));
+        simController->closeSimulation();
+    }
+
+    //states with the previous token memory size are discarded
+    void testChangedTokenMemorySize()
+    {
+        auto simController = createSimulationWithMovingCells();
+        auto history = boost::make_shared<_StepHistory>(simController);
+        pushSteps(simController, history);
+
+        auto parameters = simController->getSimulationParameters();
+        parameters.tokenMemorySize /= 2;
+        simController->setSimulationParameters(parameters);
+        EXPECT(history->isEmpty());
+        auto timestep = simController->getCurrentTimestep();
+        history->restore();
+        EXPECT(timestep == simController->getCurrentTimestep());
+
+        //parameter changes which do not affect the token memory size keep the states
+        history->push();
+        parameters.radiationProb /= 2;
+        simController->setSimulationParameters(parameters);
+        EXPECT(1 == history->getNumEntries());
+        simController->closeSimulation();
+    }
+}
+
+int main()
+{
+    Testing::run("restore all steps", testRestoreAllSteps);
+    Testing::run("memory budget", testMemoryBudget);
+    Testing::run("push after restore", testPushAfterRestore);
+    Testing::run("replaced simulation", testReplacedSimulation);
+    Testing::run("resized world", testResizedWorld);
+    Testing::run("changed token memory size", testChangedTokenMemorySize);
+    return Testing::getExitCode();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+/**
+ * Minimal checks for the test executables registered with CTest. A test executable returns a non-zero exit code if
+ * any check has failed.
+ */
+namespace Testing
+{
+    inline int& getNumFailures()
+    {
+        static int result = 0;
+        return result;
+    }
+
+    inline void check(bool condition, char const* expression, char const* file, int line)
+    {
+        if (!condition) {
+            ++getNumFailures();
+            std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+        }
+    }
+
+    template <typename Test>
+    void run(char const* name, Test const& test)
+    {
+        auto numFailuresBefore = getNumFailures();
+        try {
+            test();
+        } catch (std::exception const& exception) {
+            ++getNumFailures();
+            std::cerr << name << ": unexpected exception: " << exception.what() << std::endl;
+        }
+        std::cout << (numFailuresBefore == getNumFailures() ? "[  OK  ] " : "[FAILED] ") << name << std::endl;
+    }
+
+    inline int getExitCode() { return getNumFailures() == 0 ? 0 : 1; }
+}
+
+#define EXPECT(condition) Testing::check((condition), #condition, __FILE__, __LINE__)
@@ -0,0 +1,234 @@
+#include <cmath>
+#include <map>
+#include <set>
+
+#include "EngineTesting.h"
+#include "Testing.h"
+
+namespace
+{
+    IntVector2D const WorldSize{100, 100};
+
+    ConnectionDescription createConnection(uint64_t cellId, float distance, float angleFromPrevious)
+    {
+        ConnectionDescription result;
+        result.cellId = cellId;
+        result.distance = distance;
+        result.angleFromPrevious = angleFromPrevious;
+        return result;
+    }
+
+    std::map<uint64_t, CellDescription> getCells(
+        SimulationController const& simController,
+        IntVector2D const& worldSize)
+    {
+        std::map<uint64_t, CellDescription> result;
+        for (auto const& cluster : EngineTesting::getAllData(simController, worldSize).clusters) {
+            for (auto const& cell : cluster.cells) {
+                result.emplace(cell.id, cell);
+            }
+        }
+        return result;
+    }
+
+    int getNumConnections(std::map<uint64_t, CellDescription> const& cells)
+    {
+        int result = 0;
+        for (auto const& [id, cell] : cells) {
+            result += static_cast<int>(cell.connections.size());
+        }
+        return result;
+    }
+
+    bool isConnected(CellDescription const& cell, uint64_t otherCellId)
+    {
+        for (auto const& connection : cell.connections) {
+            if (connection.cellId == otherCellId) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //each bond is contained in the connections of both cells
+    bool areConnectionsSymmetric(std::map<uint64_t, CellDescription> const& cells)
+    {
+        for (auto const& [id, cell] : cells) {
+            for (auto const& connection : cell.connections) {
+                auto findResult = cells.find(connection.cellId);
+                if (findResult == cells.end() || !isConnected(findResult->second, id)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    float getDistance(RealVector2D const& pos1, RealVector2D const& pos2, IntVector2D const& worldSize)
+    {
+        auto delta = pos2 - pos1;
+        delta.x -= static_cast<float>(worldSize.x) * std::round(delta.x / static_cast<float>(worldSize.x));
+        delta.y -= static_cast<float>(worldSize.y) * std::round(delta.y / static_cast<float>(worldSize.y));
+        return std::sqrt(delta.x * delta.x + delta.y * delta.y);
+    }
+
+    //cells of an original world which is 100 x 100 belong to the copy of their 100 x 100 tile
+    std::pair<int, int> getCopyIndex(CellDescription const& cell)
+    {
+        return {static_cast<int>(cell.pos.x) / WorldSize.x, static_cast<int>(cell.pos.y) / WorldSize.y};
+    }
+
+    //a bonded pair whose cells lie on both sides of the seam in x direction is moved as a whole
+    void testRemapAcrossSeam()
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+        auto cell1 = EngineTesting::createCell({99, 50});
+        auto cell2 = EngineTesting::createCell({1, 50});
+        cell1.setConnectingCells({createConnection(cell2.id, 2, 360)});
+        cell2.setConnectingCells({createConnection(cell1.id, 2, 360)});
+        simController->setSimulationData(DataDescription().addCluster(EngineTesting::createCluster({cell1, cell2})));
+
+        IntVector2D newSize{WorldSize.x * 2, WorldSize.y * 2};
+        simController->resizeWorld(newSize, WorldResizeMode::Remap);
+
+        auto cells = getCells(simController, newSize);
+        EXPECT(2 == cells.size());
+        EXPECT(1 == cells.count(cell1.id) && 1 == cells.count(cell2.id));
+        if (2 == cells.size() && 1 == cells.count(cell1.id) && 1 == cells.count(cell2.id)) {
+            auto const& remappedCell1 = cells.at(cell1.id);
+            auto const& remappedCell2 = cells.at(cell2.id);
+            EXPECT(isConnected(remappedCell1, cell2.id) && isConnected(remappedCell2, cell1.id));
+            EXPECT(std::abs(getDistance(remappedCell1.pos, remappedCell2.pos, newSize) - 2.0f) < 0.01f);
+        }
+        simController->closeSimulation();
+    }
+
+    //a bonded chain with a token near the origin and a single cell in the center of the original world, clusters of
+    //copies which would be placed beyond the new world size are dropped
+    void checkTile(IntVector2D const& newSize, int expectedNumChainCopies, int expectedNumCenterCopies)
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+        auto chainCell1 = EngineTesting::createCell({10, 10});
+        auto chainCell2 = EngineTesting::createCell({11, 10});
+        auto chainCell3 = EngineTesting::createCell({12, 10});
+        chainCell2.addToken(TokenDescription().setEnergy(30).setData(
+            std::string(simController->getSimulationParameters().tokenMemorySize, 1)));
+        auto centerCell = EngineTesting::createCell({60, 60});
+        auto chain = EngineTesting::createCluster({chainCell1, chainCell2, chainCell3});
+        std::unordered_map<uint64_t, int> cache;
+        chain.addConnection(chainCell1.id, chainCell2.id, cache);
+        chain.addConnection(chainCell2.id, chainCell3.id, cache);
+        simController->setSimulationData(
+            DataDescription().addCluster(chain).addCluster(EngineTesting::createCluster({centerCell})));
+        std::set<uint64_t> origIds{chainCell1.id, chainCell2.id, chainCell3.id, centerCell.id};
+
+        simController->resizeWorld(newSize, WorldResizeMode::Tile);
+
+        auto cells = getCells(simController, newSize);
+        EXPECT(expectedNumChainCopies * 3 + expectedNumCenterCopies == static_cast<int>(cells.size()));
+        for (auto const& id : origIds) {
+            EXPECT(1 == cells.count(id));
+        }
+
+        //the copies of the chain are identified by the tile of the original world they lie in
+        std::map<std::pair<int, int>, int> numChainCellsByCopy;
+        int numCenterCells = 0;
+        int numTokens = 0;
+        for (auto const& [id, cell] : cells) {
+            auto pos = RealVector2D{std::fmod(cell.pos.x, 100.0f), std::fmod(cell.pos.y, 100.0f)};
+            if (pos.x > 50) {
+                ++numCenterCells;
+                EXPECT(cell.connections.empty());
+                continue;
+            }
+            ++numChainCellsByCopy[getCopyIndex(cell)];
+            EXPECT((std::abs(pos.x - 11.0f) < 0.01f ? 2 : 1) == static_cast<int>(cell.connections.size()));
+            for (auto const& connection : cell.connections) {
+                auto findResult = cells.find(connection.cellId);
+                EXPECT(findResult != cells.end());
+                if (findResult != cells.end()) {
+                    EXPECT(getCopyIndex(findResult->second) == getCopyIndex(cell));
+                    EXPECT(std::abs(getDistance(cell.pos, findResult->second.pos, newSize) - 1.0f) < 0.01f);
+                }
+            }
+            if (!cell.tokens.empty()) {
+                ++numTokens;
+                EXPECT(1 == cell.tokens.size());
+                EXPECT(std::abs(pos.x - 11.0f) < 0.01f);
+                EXPECT(chainCell2.tokens.front() == cell.tokens.front());
+            }
+        }
+        EXPECT(expectedNumChainCopies == static_cast<int>(numChainCellsByCopy.size()));
+        for (auto const& [copyIndex, numChainCells] : numChainCellsByCopy) {
+            EXPECT(3 == numChainCells);
+        }
+        EXPECT(expectedNumCenterCopies == numCenterCells);
+        EXPECT(expectedNumChainCopies == numTokens);
+        EXPECT(areConnectionsSymmetric(cells));
+        simController->closeSimulation();
+    }
+
+    void testTileInX()
+    {
+        checkTile({WorldSize.x * 2, WorldSize.y}, 2, 2);
+    }
+
+    void testTileInY()
+    {
+        checkTile({WorldSize.x, WorldSize.y * 2}, 2, 2);
+    }
+
+    void testTileInBothDirections()
+    {
+        checkTile({WorldSize.x * 2, WorldSize.y * 2}, 4, 4);
+    }
+
+    void testTileBeyondNewWorldSize()
+    {
+        checkTile({WorldSize.x * 3 / 2, WorldSize.y * 3 / 2}, 4, 1);
+    }
+
+    //a ring of bonded cells around the whole world in x direction, it cannot be closed in a shrunk world
+    void testShrinkRemovesSeamConnections()
+    {
+        auto simController = EngineTesting::createSimulation(WorldSize, EngineTesting::createDeterministicParameters());
+        int const NumCells = 10;
+        std::vector<CellDescription> ring;
+        for (int i = 0; i < NumCells; ++i) {
+            ring.emplace_back(EngineTesting::createCell({5.0f + 10.0f * static_cast<float>(i), 50}));
+        }
+        for (int i = 0; i < NumCells; ++i) {
+            ring[i].setConnectingCells(
+                {createConnection(ring[(i + NumCells - 1) % NumCells].id, 10, 180),
+                 createConnection(ring[(i + 1) % NumCells].id, 10, 180)});
+        }
+        simController->setSimulationData(DataDescription().addCluster(EngineTesting::createCluster(ring)));
+
+        IntVector2D newSize{WorldSize.x * 3 / 5, WorldSize.y};
+        simController->resizeWorld(newSize, WorldResizeMode::Remap);
+
+        auto cells = getCells(simController, newSize);
+        EXPECT(NumCells == static_cast<int>(cells.size()));
+        EXPECT((NumCells - 1) * 2 == getNumConnections(cells));
+        EXPECT(areConnectionsSymmetric(cells));
+        for (auto const& [id, cell] : cells) {
+            for (auto const& connection : cell.connections) {
+                if (cells.count(connection.cellId) == 1) {
+                    EXPECT(std::abs(getDistance(cell.pos, cells.at(connection.cellId).pos, newSize) - 10.0f) < 0.01f);
+                }
+            }
+        }
+        simController->closeSimulation();
+    }
+}
+
+int main()
+{
+    Testing::run("remap across seam", testRemapAcrossSeam);
+    Testing::run("tile in x", testTileInX);
+    Testing::run("tile in y", testTileInY);
+    Testing::run("tile in both directions", testTileInBothDirections);
+    Testing::run("tile beyond new world size", testTileBeyondNewWorldSize);
+    Testing::run("shrink removes seam connections", testShrinkRemovesSeamConnections);
+    return Testing::getExitCode();
+}